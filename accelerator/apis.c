@@ -9,11 +9,11 @@
 #include "apis.h"
 #include "map/mode.h"
 #include "utils/handles/lock.h"
+#include "utils/task_pool.h"
 
 #define APIS_LOGGER "apis"
 
 static logger_id_t logger_id;
-lock_handle_t cjson_lock;
 
 void apis_logger_init() { logger_id = logger_helper_enable(APIS_LOGGER, LOGGER_DEBUG, true); }
 
@@ -27,6 +27,25 @@ int apis_logger_release() {
   return 0;
 }
 
+/**
+ * Copy a request body into the arena of the thread, where the in-situ deserializers tokenize it
+ */
+static char* api_arena_copy_req(arena_t* const arena, char const* const obj) {
+  if (arena == NULL || obj == NULL) {
+    return NULL;
+  }
+  return arena_strndup(arena, obj, strlen(obj));
+}
+
+/**
+ * Release the allocations of a request, the blocks of the arena are kept for the next request of the thread
+ */
+static void api_arena_rewind(arena_t* const arena) {
+  if (arena) {
+    arena_rewind(arena);
+  }
+}
+
 status_t api_get_ta_info(char** json_result, ta_config_t* const info, iota_config_t* const tangle,
                          ta_cache_t* const cache, iota_client_service_t* const service) {
   status_t ret = SC_OK;
@@ -40,20 +59,6 @@ status_t api_get_ta_info(char** json_result, ta_config_t* const info, iota_confi
   return ret;
 }
 
-status_t apis_lock_init() {
-  if (lock_handle_init(&cjson_lock)) {
-    return SC_CONF_LOCK_INIT;
-  }
-  return SC_OK;
-}
-
-status_t apis_lock_destroy() {
-  if (lock_handle_destroy(&cjson_lock)) {
-    return SC_CONF_LOCK_DESTROY;
-  }
-  return SC_OK;
-}
-
 status_t api_get_tips(const iota_client_service_t* const service, char** json_result) {
   status_t ret = SC_OK;
   get_tips_res_t* res = get_tips_res_new();
@@ -64,14 +69,10 @@ status_t api_get_tips(const iota_client_service_t* const service, char** json_re
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
-  if (iota_client_get_tips(service, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  ret = iri_pool_get_tips(service, res);
+  if (ret != SC_OK) {
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   ret = ta_get_tips_res_serialize(res, json_result);
   if (ret != SC_OK) {
@@ -99,14 +100,10 @@ status_t api_get_tips_pair(const iota_config_t* const iconf, const iota_client_s
   }
 
   get_transactions_to_approve_req_set_depth(req, iconf->milestone_depth);
-  lock_handle_lock(&cjson_lock);
-  if (iota_client_get_transactions_to_approve(service, req, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  ret = iri_pool_get_transactions_to_approve(service, req, res);
+  if (ret != SC_OK) {
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   if (service->serializer.vtable.get_transactions_to_approve_serialize_response(res, res_buff) != RC_OK) {
     ret = SC_CCLIENT_JSON_PARSE;
@@ -139,13 +136,10 @@ status_t api_generate_address(const iota_config_t* const iconf, const iota_clien
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
   ret = ta_generate_address(iconf, service, res);
   if (ret) {
-    lock_handle_unlock(&cjson_lock);
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   ret = ta_generate_address_res_serialize(res, json_result);
 
@@ -155,69 +149,74 @@ done:
 }
 
 status_t api_find_transaction_object_single(const iota_client_service_t* const service, const char* const obj,
-                                            char** json_result) {
+                                            ta_txn_serialize_opt_t const* const opt, char** result,
+                                            size_t* const result_len) {
   status_t ret = SC_OK;
   flex_trit_t txn_hash[NUM_FLEX_TRITS_HASH];
+  arena_t* arena = arena_thread_local();
   ta_find_transaction_objects_req_t* req = ta_find_transaction_objects_req_new();
   transaction_array_t* res = transaction_array_new();
-  if (req == NULL || res == NULL) {
+  if (arena == NULL || req == NULL || res == NULL) {
     ret = SC_TA_OOM;
     ta_log_error("%s\n", "SC_TA_OOM");
     goto done;
   }
 
   flex_trits_from_trytes(txn_hash, NUM_TRITS_HASH, (const tryte_t*)obj, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
-  hash243_queue_push(&req->hashes, txn_hash);
+  if (hash243_vector_push(&req->hashes, txn_hash) != SC_OK) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
 
-  lock_handle_lock(&cjson_lock);
-  ret = ta_find_transaction_objects(service, req, res);
+  ret = ta_find_transaction_objects(service, arena, req, res);
   if (ret) {
-    lock_handle_unlock(&cjson_lock);
     ta_log_error("%d\n", ret);
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  ret = ta_find_transaction_object_single_res_serialize(res, json_result);
+  ret = ta_transaction_object_serialize(res, opt, result, result_len);
 
 done:
+  api_arena_rewind(arena);
   ta_find_transaction_objects_req_free(&req);
   transaction_array_free(res);
   return ret;
 }
 
 status_t api_find_transaction_objects(const iota_client_service_t* const service, const char* const obj,
-                                      char** json_result) {
+                                      ta_txn_serialize_opt_t const* const opt, char** result,
+                                      size_t* const result_len) {
   status_t ret = SC_OK;
+  arena_t* arena = arena_thread_local();
+  char* buf = api_arena_copy_req(arena, obj);
   ta_find_transaction_objects_req_t* req = ta_find_transaction_objects_req_new();
   transaction_array_t* res = transaction_array_new();
-  if (req == NULL || res == NULL) {
+  if (buf == NULL || req == NULL || res == NULL) {
     ret = SC_TA_OOM;
     ta_log_error("%s\n", "SC_TA_OOM");
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
-  ret = ta_find_transaction_objects_req_deserialize(obj, req);
+  ret = ta_find_transaction_objects_req_deserialize_insitu(buf, arena, req);
   if (ret != SC_OK) {
-    lock_handle_unlock(&cjson_lock);
     ta_log_error("%d\n", ret);
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  lock_handle_lock(&cjson_lock);
-  ret = ta_find_transaction_objects(service, req, res);
+  ret = ta_find_transaction_objects(service, arena, req, res);
   if (ret) {
-    lock_handle_unlock(&cjson_lock);
     ta_log_error("%d\n", ret);
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  ret = ta_find_transaction_objects_res_serialize(res, json_result);
+  // Fields given along with the request, e.g. in the query string, take precedence over the ones in the body
+  ta_txn_serialize_opt_t res_opt = {.format = opt ? opt->format : TA_RESPONSE_FORMAT_JSON,
+                                    .fields = (opt && opt->fields) ? opt->fields : req->fields};
+  ret = ta_transaction_array_serialize(res, &res_opt, result, result_len);
 
 done:
+  api_arena_rewind(arena);
   ta_find_transaction_objects_req_free(&req);
   transaction_array_free(res);
   return ret;
@@ -227,8 +226,11 @@ status_t api_find_transactions_by_tag(const iota_client_service_t* const service
                                       char** json_result) {
   status_t ret = SC_OK;
   flex_trit_t tag_trits[NUM_FLEX_TRITS_TAG];
+  arena_t* arena = arena_thread_local();
+  ta_find_transactions_by_tag_res_t tag_res;
   find_transactions_req_t* req = find_transactions_req_new();
   find_transactions_res_t* res = find_transactions_res_new();
+  hash243_vector_init(&tag_res.hashes, arena);
   if (req == NULL || res == NULL) {
     ret = SC_TA_OOM;
     ta_log_error("%s\n", "SC_TA_OOM");
@@ -253,30 +255,35 @@ status_t api_find_transactions_by_tag(const iota_client_service_t* const service
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
-  if (iota_client_find_transactions(service, req, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  ret = iri_pool_find_transactions(service, req, res);
+  if (ret != SC_OK) {
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  ret = ta_find_transactions_by_tag_res_serialize((ta_find_transactions_by_tag_res_t*)res, json_result);
+  ret = hash243_vector_append_queue(&tag_res.hashes, res->hashes);
+  if (ret != SC_OK) {
+    ta_log_error("%d\n", ret);
+    goto done;
+  }
+  ret = ta_find_transactions_by_tag_res_serialize(&tag_res, json_result);
 
 done:
+  hash243_vector_free(&tag_res.hashes);
+  api_arena_rewind(arena);
   find_transactions_req_free(&req);
   find_transactions_res_free(&res);
   return ret;
 }
 
 status_t api_find_transactions_obj_by_tag(const iota_client_service_t* const service, const char* const obj,
-                                          char** json_result) {
+                                          ta_txn_serialize_opt_t const* const opt, char** result,
+                                          size_t* const result_len) {
   status_t ret = SC_OK;
   flex_trit_t tag_trits[NUM_FLEX_TRITS_TAG];
+  arena_t* arena = arena_thread_local();
   find_transactions_req_t* req = find_transactions_req_new();
   transaction_array_t* res = transaction_array_new();
-  if (req == NULL || res == NULL) {
+  if (arena == NULL || req == NULL || res == NULL) {
     ret = SC_TA_OOM;
     ta_log_error("%s\n", "SC_TA_OOM");
     goto done;
@@ -300,27 +307,422 @@ status_t api_find_transactions_obj_by_tag(const iota_client_service_t* const ser
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
-  ret = ta_find_transactions_obj_by_tag(service, req, res);
+  ret = ta_find_transactions_obj_by_tag(service, arena, req, res);
   if (ret) {
-    lock_handle_unlock(&cjson_lock);
     ta_log_error("%d\n", ret);
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  ret = ta_find_transaction_objects_res_serialize(res, json_result);
+  ret = ta_transaction_array_serialize(res, opt, result, result_len);
+
+done:
+  api_arena_rewind(arena);
+  find_transactions_req_free(&req);
+  transaction_array_free(res);
+  return ret;
+}
+
+/**
+ * Add a tag of 1 to 27 trytes to a request, padded with '9'
+ */
+static status_t api_find_transactions_req_tag(find_transactions_req_t* const req, const char* const obj) {
+  flex_trit_t tag_trits[NUM_FLEX_TRITS_TAG];
+  char tag[NUM_TRYTES_TAG + 1];
+  size_t len = obj ? strnlen(obj, NUM_TRYTES_TAG + 1) : 0;
+
+  if (len == 0 || len > NUM_TRYTES_TAG || !ta_trytes_validate((tryte_t const*)obj, len)) {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
+  }
+  fill_nines(tag, obj, NUM_TRYTES_TAG);
+  tag[NUM_TRYTES_TAG] = '\0';
+  flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)tag, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
+  if (find_transactions_req_tag_add(req, tag_trits) != RC_OK) {
+    ta_log_error("%s\n", "SC_CCLIENT_INVALID_FLEX_TRITS");
+    return SC_CCLIENT_INVALID_FLEX_TRITS;
+  }
+  return SC_OK;
+}
+
+/**
+ * Find a page of the transaction hashes of a tag, in the arena of the thread
+ */
+static status_t api_find_transactions_tag_page(const iota_client_service_t* const service, arena_t* const arena,
+                                               const char* const obj, ta_page_req_t const* const page,
+                                               hash243_vector_t* const hashes, size_t* const next_cursor) {
+  status_t ret = SC_OK;
+  find_transactions_req_t* req = find_transactions_req_new();
+  if (req == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  ret = api_find_transactions_req_tag(req, obj);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  ret = ta_find_transactions_page(service, arena, req, page, hashes, next_cursor);
+  if (ret != SC_OK) {
+    ta_log_error("%d\n", ret);
+  }
+
+done:
+  find_transactions_req_free(&req);
+  return ret;
+}
+
+status_t api_find_transactions_page(const iota_client_service_t* const service, const char* const obj,
+                                    ta_page_req_t const* const page, char** json_result) {
+  status_t ret = SC_OK;
+  size_t next_cursor = 0;
+  hash243_vector_t hashes;
+  arena_t* arena = arena_thread_local();
+  find_transactions_req_t* req = find_transactions_req_new();
+  hash243_vector_init(&hashes, arena);
+  if (arena == NULL || req == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  if (service->serializer.vtable.find_transactions_deserialize_request(obj, req) != RC_OK) {
+    ret = SC_CCLIENT_JSON_PARSE;
+    ta_log_error("%s\n", "SC_CCLIENT_JSON_PARSE");
+    goto done;
+  }
+  ret = ta_find_transactions_page(service, arena, req, page, &hashes, &next_cursor);
+  if (ret != SC_OK) {
+    ta_log_error("%d\n", ret);
+    goto done;
+  }
+
+  ret = ta_hash_page_res_serialize(&hashes, next_cursor, json_result);
 
 done:
+  hash243_vector_free(&hashes);
+  api_arena_rewind(arena);
   find_transactions_req_free(&req);
+  return ret;
+}
+
+status_t api_find_transactions_by_tag_page(const iota_client_service_t* const service, const char* const obj,
+                                           ta_page_req_t const* const page, char** json_result) {
+  status_t ret = SC_OK;
+  size_t next_cursor = 0;
+  hash243_vector_t hashes;
+  arena_t* arena = arena_thread_local();
+  hash243_vector_init(&hashes, arena);
+  if (arena == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  ret = api_find_transactions_tag_page(service, arena, obj, page, &hashes, &next_cursor);
+  if (ret != SC_OK) {
+    goto done;
+  }
+  ret = ta_hash_page_res_serialize(&hashes, next_cursor, json_result);
+
+done:
+  hash243_vector_free(&hashes);
+  api_arena_rewind(arena);
+  return ret;
+}
+
+status_t api_find_transactions_obj_by_tag_page(const iota_client_service_t* const service, const char* const obj,
+                                               ta_page_req_t const* const page, ta_txn_serialize_opt_t const* const opt,
+                                               char** result, size_t* const result_len) {
+  status_t ret = SC_OK;
+  size_t next_cursor = 0;
+  arena_t* arena = arena_thread_local();
+  ta_find_transaction_objects_req_t obj_req = {.fields = 0};
+  transaction_array_t* res = transaction_array_new();
+  hash243_vector_init(&obj_req.hashes, arena);
+  if (arena == NULL || res == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  ret = api_find_transactions_tag_page(service, arena, obj, page, &obj_req.hashes, &next_cursor);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  if (hash243_vector_count(&obj_req.hashes) > 0) {
+    ret = ta_find_transaction_objects(service, arena, &obj_req, res);
+    if (ret != SC_OK) {
+      ta_log_error("%d\n", ret);
+      goto done;
+    }
+  }
+
+  ret = ta_transaction_page_res_serialize(res, opt, next_cursor, result, result_len);
+
+done:
+  hash243_vector_free(&obj_req.hashes);
+  api_arena_rewind(arena);
+  transaction_array_free(res);
+  return ret;
+}
+
+/**
+ * Find the transaction hashes of a query, or a page of them if `page` is not NULL
+ */
+static status_t api_find_transactions_hashes(const iota_client_service_t* const service, arena_t* const arena,
+                                             const find_transactions_req_t* const req, ta_page_req_t const* const page,
+                                             char** json_result) {
+  status_t ret = SC_OK;
+  size_t next_cursor = 0;
+  hash243_vector_t hashes;
+  find_transactions_res_t* res = NULL;
+  hash243_vector_init(&hashes, arena);
+
+  if (page) {
+    ret = ta_find_transactions_page(service, arena, req, page, &hashes, &next_cursor);
+    if (ret != SC_OK) {
+      ta_log_error("%d\n", ret);
+      goto done;
+    }
+    ret = ta_hash_page_res_serialize(&hashes, next_cursor, json_result);
+    goto done;
+  }
+
+  res = find_transactions_res_new();
+  if (res == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+  ret = iri_pool_find_transactions(service, req, res);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  ret = hash243_vector_append_queue(&hashes, res->hashes);
+  if (ret != SC_OK) {
+    ta_log_error("%d\n", ret);
+    goto done;
+  }
+  ta_find_transactions_by_tag_res_t hash_res = {.hashes = hashes};
+  ret = ta_find_transactions_by_tag_res_serialize(&hash_res, json_result);
+
+done:
+  hash243_vector_free(&hashes);
+  find_transactions_res_free(&res);
+  return ret;
+}
+
+/**
+ * Find the transaction objects of a query, or a page of them if `page` is not NULL. The objects of all the hashes
+ * are read with one batched lookup.
+ */
+static status_t api_find_transactions_objects(const iota_client_service_t* const service, arena_t* const arena,
+                                              const find_transactions_req_t* const req, ta_page_req_t const* const page,
+                                              ta_txn_serialize_opt_t const* const opt, char** result,
+                                              size_t* const result_len) {
+  status_t ret = SC_OK;
+  size_t next_cursor = 0;
+  ta_find_transaction_objects_req_t obj_req = {.fields = 0};
+  transaction_array_t* res = transaction_array_new();
+  hash243_vector_init(&obj_req.hashes, arena);
+  if (res == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  if (page) {
+    ret = ta_find_transactions_page(service, arena, req, page, &obj_req.hashes, &next_cursor);
+    if (ret == SC_OK && hash243_vector_count(&obj_req.hashes) > 0) {
+      ret = ta_find_transaction_objects(service, arena, &obj_req, res);
+    }
+  } else {
+    ret = ta_find_transactions_obj_by_tag(service, arena, req, res);
+  }
+  if (ret != SC_OK) {
+    ta_log_error("%d\n", ret);
+    goto done;
+  }
+
+  ret = page ? ta_transaction_page_res_serialize(res, opt, next_cursor, result, result_len)
+             : ta_transaction_array_serialize(res, opt, result, result_len);
+
+done:
+  hash243_vector_free(&obj_req.hashes);
   transaction_array_free(res);
   return ret;
 }
 
+status_t api_find_transactions_multi(const iota_client_service_t* const service, const char* const obj,
+                                     ta_page_req_t const* const page, char** json_result) {
+  status_t ret = SC_OK;
+  arena_t* arena = arena_thread_local();
+  char* buf = api_arena_copy_req(arena, obj);
+  find_transactions_req_t* req = find_transactions_req_new();
+  if (buf == NULL || req == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  ret = ta_find_transactions_req_deserialize_insitu(buf, arena, req, NULL);
+  if (ret != SC_OK) {
+    goto done;
+  }
+  ret = api_find_transactions_hashes(service, arena, req, page, json_result);
+
+done:
+  api_arena_rewind(arena);
+  find_transactions_req_free(&req);
+  return ret;
+}
+
+status_t api_find_transactions_obj_multi(const iota_client_service_t* const service, const char* const obj,
+                                         ta_page_req_t const* const page, ta_txn_serialize_opt_t const* const opt,
+                                         char** result, size_t* const result_len) {
+  status_t ret = SC_OK;
+  uint32_t fields = 0;
+  arena_t* arena = arena_thread_local();
+  char* buf = api_arena_copy_req(arena, obj);
+  find_transactions_req_t* req = find_transactions_req_new();
+  if (buf == NULL || req == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  ret = ta_find_transactions_req_deserialize_insitu(buf, arena, req, &fields);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  // Fields given along with the request, e.g. in the query string, take precedence over the ones in the body
+  ta_txn_serialize_opt_t res_opt = {.format = opt ? opt->format : TA_RESPONSE_FORMAT_JSON,
+                                    .fields = (opt && opt->fields) ? opt->fields : fields};
+  ret = api_find_transactions_objects(service, arena, req, page, &res_opt, result, result_len);
+
+done:
+  api_arena_rewind(arena);
+  find_transactions_req_free(&req);
+  return ret;
+}
+
+status_t api_find_transactions_by_addr(const iota_client_service_t* const service, const char* const obj,
+                                       ta_page_req_t const* const page, char** json_result) {
+  status_t ret = SC_OK;
+  flex_trit_t trits[FLEX_TRIT_SIZE_243];
+  size_t len = obj ? strnlen(obj, NUM_TRYTES_HASH + 1) : 0;
+  arena_t* arena = arena_thread_local();
+  find_transactions_req_t* req = find_transactions_req_new();
+  if (arena == NULL || req == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  if (len != NUM_TRYTES_HASH || !ta_trytes_validate((tryte_t const*)obj, len)) {
+    ret = SC_SERIALIZER_INVALID_REQ;
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    goto done;
+  }
+  ta_flex_trits_from_trytes(trits, NUM_TRITS_HASH, (const tryte_t*)obj, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  if (find_transactions_req_address_add(req, trits) != RC_OK) {
+    ret = SC_CCLIENT_INVALID_FLEX_TRITS;
+    ta_log_error("%s\n", "SC_CCLIENT_INVALID_FLEX_TRITS");
+    goto done;
+  }
+  ret = api_find_transactions_hashes(service, arena, req, page, json_result);
+
+done:
+  api_arena_rewind(arena);
+  find_transactions_req_free(&req);
+  return ret;
+}
+
+status_t api_txn_stream_open(const iota_client_service_t* const service, const ta_txn_query_t query,
+                             const char* const obj, ta_txn_stream_t* const stream) {
+  status_t ret = SC_OK;
+  flex_trit_t trits[FLEX_TRIT_SIZE_243];
+  retcode_t rc = RC_OK;
+  size_t len = obj ? strnlen(obj, NUM_TRYTES_HASH + 1) : 0;
+  arena_t* arena = arena_thread_local();
+  find_transactions_req_t* req = find_transactions_req_new();
+  if (arena == NULL || req == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  if (query == TA_TXN_QUERY_TAG) {
+    ret = api_find_transactions_req_tag(req, obj);
+    if (ret != SC_OK) {
+      goto done;
+    }
+  } else {
+    if (len != NUM_TRYTES_HASH || !ta_trytes_validate((tryte_t const*)obj, len)) {
+      ret = SC_SERIALIZER_INVALID_REQ;
+      ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+      goto done;
+    }
+    ta_flex_trits_from_trytes(trits, NUM_TRITS_HASH, (const tryte_t*)obj, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+    rc = query == TA_TXN_QUERY_ADDRESS ? find_transactions_req_address_add(req, trits)
+                                       : find_transactions_req_bundle_add(req, trits);
+  }
+  if (rc != RC_OK) {
+    ret = SC_CCLIENT_INVALID_FLEX_TRITS;
+    ta_log_error("%s\n", "SC_CCLIENT_INVALID_FLEX_TRITS");
+    goto done;
+  }
+
+  ret = ta_txn_stream_open(service, arena, req, TA_TXN_STREAM_PAGE_SIZE, stream);
+  if (ret != SC_OK) {
+    ta_log_error("%d\n", ret);
+  }
+
+done:
+  api_arena_rewind(arena);
+  find_transactions_req_free(&req);
+  return ret;
+}
+
+status_t api_txn_stream_read(const iota_client_service_t* const service, ta_txn_stream_t* const stream,
+                             const uint32_t fields, char** json_result, size_t* const json_result_len) {
+  status_t ret = SC_OK;
+  arena_t* arena = arena_thread_local();
+  transaction_array_t* page = transaction_array_new();
+  if (arena == NULL || page == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  // Nothing of a page stays in the arena, pages of streams of other connections may be read by the same thread
+  const bool first = stream->next == 0;
+  ret = ta_txn_stream_next(service, arena, stream, page);
+  if (ret != SC_OK) {
+    ta_log_error("%d\n", ret);
+    goto done;
+  }
+
+  ret = ta_transaction_page_serialize(page, fields, first, stream->done, json_result, json_result_len);
+
+done:
+  api_arena_rewind(arena);
+  transaction_array_free(page);
+  return ret;
+}
+
+void api_txn_stream_free(ta_txn_stream_t* const stream) { ta_txn_stream_free(stream); }
+
 status_t api_receive_mam_message(const iota_config_t* const iconf, const iota_client_service_t* const service,
                                  const char* const chid, char** json_result) {
   status_t ret = SC_OK;
   char* payload = NULL;
+  arena_t* arena = arena_thread_local();
   mam_api_t mam;
   bundle_transactions_t* bundle = NULL;
   bundle_transactions_new(&bundle);
@@ -341,7 +743,7 @@ status_t api_receive_mam_message(const iota_config_t* const iconf, const iota_cl
   }
 
   mam_api_add_trusted_channel_pk(&mam, (tryte_t*)chid);
-  ret = ta_get_bundle_by_addr(service, (tryte_t*)chid, bundle);
+  ret = ta_get_bundle_by_addr(service, arena, (tryte_t*)chid, bundle);
   if (ret != SC_OK) {
     goto done;
   }
@@ -365,14 +767,17 @@ done:
       ta_log_error("%s\n", "SC_MAM_FAILED_DESTROYED");
     }
   }
+  api_arena_rewind(arena);
   bundle_transactions_free(&bundle);
   free(payload);
   return ret;
 }
 
-status_t api_mam_send_message(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                              char const* const payload, char** json_result) {
-  status_t ret = SC_OK;
+status_t api_mam_send_message(const iota_config_t* const iconf, char const* const payload, char** json_result) {
+  status_t ret = pow_admission_acquire();
+  if (ret != SC_OK) {
+    return ret;
+  }
   mam_api_t mam;
   const bool last_packet = true;
   bundle_transactions_t* bundle = NULL;
@@ -380,17 +785,16 @@ status_t api_mam_send_message(const iota_config_t* const iconf, const iota_clien
   tryte_t* prng = NULL;
   tryte_t channel_id[MAM_CHANNEL_ID_TRYTE_SIZE];
   trit_t msg_id[MAM_MSG_ID_SIZE];
+  arena_t* arena = arena_thread_local();
+  char* buf = api_arena_copy_req(arena, payload);
   ta_send_mam_req_t* req = send_mam_req_new();
   ta_send_mam_res_t* res = send_mam_res_new();
 
-  lock_handle_lock(&cjson_lock);
-  if (send_mam_req_deserialize(payload, req)) {
-    lock_handle_unlock(&cjson_lock);
+  if (buf == NULL || send_mam_req_deserialize_insitu(buf, arena, req)) {
     ret = SC_MAM_FAILED_INIT;
     ta_log_error("%s\n", "SC_MAM_FAILED_INIT");
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   // Creating MAM API
   prng = (req->prng[0]) ? req->prng : (tryte_t*)SEED;
@@ -449,14 +853,11 @@ status_t api_mam_send_message(const iota_config_t* const iconf, const iota_clien
   send_mam_res_set_channel_id(res, channel_id);
 
   // Sending bundle
-  lock_handle_lock(&cjson_lock);
-  if (ta_send_bundle(iconf, service, bundle) != SC_OK) {
-    lock_handle_unlock(&cjson_lock);
+  if (ta_send_bundle(iconf, bundle) != SC_OK) {
     ret = SC_MAM_FAILED_RESPONSE;
     ta_log_error("%s\n", "SC_MAM_FAILED_RESPONSE");
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
   ret = send_mam_res_set_bundle_hash(res, transaction_bundle((iota_transaction_t*)utarray_front(bundle)));
   if (ret != SC_OK) {
     ta_log_error("%d\n", ret);
@@ -482,89 +883,421 @@ done:
       ta_log_error("%s\n", "SC_MAM_FAILED_DESTROYED");
     }
   }
+  api_arena_rewind(arena);
   bundle_transactions_free(&bundle);
   send_mam_req_free(&req);
   send_mam_res_free(&res);
+  pow_admission_release();
   return ret;
 }
 
-status_t api_send_transfer(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                           const char* const obj, char** json_result) {
-  status_t ret = SC_OK;
+status_t api_send_transfer(const iota_config_t* const iconf, const char* const obj, char** json_result) {
+  status_t ret = pow_admission_acquire();
+  if (ret != SC_OK) {
+    return ret;
+  }
+  arena_t* arena = arena_thread_local();
+  char* buf = api_arena_copy_req(arena, obj);
   ta_send_transfer_req_t* req = ta_send_transfer_req_new();
   ta_send_transfer_res_t* res = ta_send_transfer_res_new();
   ta_find_transaction_objects_req_t* txn_obj_req = ta_find_transaction_objects_req_new();
   transaction_array_t* res_txn_array = transaction_array_new();
 
-  if (req == NULL || res == NULL || txn_obj_req == NULL || res_txn_array == NULL) {
+  if (buf == NULL || req == NULL || res == NULL || txn_obj_req == NULL || res_txn_array == NULL) {
     ret = SC_TA_OOM;
     ta_log_error("%s\n", "SC_TA_OOM");
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
-  ret = ta_send_transfer_req_deserialize(obj, req);
+  ret = ta_send_transfer_req_deserialize_insitu(buf, arena, req);
   if (ret) {
-    lock_handle_unlock(&cjson_lock);
     goto done;
   }
 
-  ret = ta_send_transfer(iconf, service, req, res);
+  ret = ta_send_transfer(iconf, req, res);
   if (ret) {
-    lock_handle_unlock(&cjson_lock);
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   // return transaction object
-  hash243_queue_push(&txn_obj_req->hashes, hash243_queue_peek(res->hash));
+  ret = hash243_vector_push(&txn_obj_req->hashes, hash243_queue_peek(res->hash));
+  if (ret) {
+    goto done;
+  }
 
-  lock_handle_lock(&cjson_lock);
-  ret = ta_find_transaction_objects(service, txn_obj_req, res_txn_array);
+  iota_client_service_t* service = iri_pool_acquire();
+  ret = ta_find_transaction_objects(service, arena, txn_obj_req, res_txn_array);
+  iri_pool_release(service);
   if (ret) {
-    lock_handle_unlock(&cjson_lock);
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   ret = ta_send_transfer_res_serialize(res_txn_array, json_result);
 
 done:
+  api_arena_rewind(arena);
   ta_send_transfer_req_free(&req);
   ta_send_transfer_res_free(&res);
   ta_find_transaction_objects_req_free(&txn_obj_req);
   transaction_array_free(res_txn_array);
+  pow_admission_release();
   return ret;
 }
 
-status_t api_send_trytes(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                         const char* const obj, char** json_result) {
-  status_t ret = SC_OK;
+status_t api_send_trytes(const iota_config_t* const iconf, const char* const obj, char** json_result) {
+  status_t ret = pow_admission_acquire();
+  if (ret != SC_OK) {
+    return ret;
+  }
+  arena_t* arena = arena_thread_local();
+  char* buf = api_arena_copy_req(arena, obj);
   hash8019_array_p trytes = hash8019_array_new();
 
-  if (!trytes) {
+  if (buf == NULL || !trytes) {
     ret = SC_TA_OOM;
     ta_log_error("%s\n", "SC_TA_OOM");
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
-  ret = ta_send_trytes_req_deserialize(obj, trytes);
+  ret = ta_send_trytes_req_deserialize_insitu(buf, arena, trytes);
   if (ret != SC_OK) {
-    lock_handle_unlock(&cjson_lock);
     goto done;
   }
 
-  ret = ta_send_trytes(iconf, service, trytes);
+  ret = ta_send_trytes(iconf, trytes);
   if (ret != SC_OK) {
-    lock_handle_unlock(&cjson_lock);
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   ret = ta_send_trytes_res_serialize(trytes, json_result);
 
 done:
+  api_arena_rewind(arena);
   hash_array_free(trytes);
+  pow_admission_release();
+  return ret;
+}
+
+/** Size of the stack buffer of the arena a batch request is parsed into */
+#define API_BATCH_ARENA_SIZE 8192
+
+/** The connection of a batch request, lent to its sub-requests when the pool has no idle one */
+typedef struct api_batch_conn_s {
+  const iota_client_service_t* service;
+  lock_handle_t lock; /**< Held by the sub-request using `service` */
+} api_batch_conn_t;
+
+/** A sub-request of a batch, run as a task of the task pool */
+typedef struct api_batch_task_s {
+  const iota_config_t* iconf;
+  api_batch_conn_t* conn;
+  ta_batch_sub_req_t const* req;
+  struct api_batch_task_s const* same; /**< Earlier sub-request with the same result, NULL if none */
+  char* result;
+  status_t ret;
+} api_batch_task_t;
+
+/** The "find_transaction_objects" sub-requests of a batch, looked up together by one task */
+typedef struct api_batch_objects_s {
+  api_batch_conn_t* conn;
+  api_batch_task_t* tasks;
+  size_t num;
+} api_batch_objects_t;
+
+/**
+ * Tell whether two sub-requests are lookups with the same result. Address generation and tips selection are left
+ * out, since every call of them gives a new answer.
+ */
+static bool api_batch_same_lookup(ta_batch_sub_req_t const* const a, ta_batch_sub_req_t const* const b) {
+  if (a->cmd != b->cmd || a->fields != b->fields) {
+    return false;
+  }
+  switch (a->cmd) {
+    case TA_BATCH_FIND_TXN_BY_TAG:
+    case TA_BATCH_FIND_TXN_OBJ_BY_TAG:
+      return !strcmp(a->tag, b->tag);
+    case TA_BATCH_FIND_TRANSACTION_OBJECTS:
+      return hash243_vector_count(&a->hashes) == hash243_vector_count(&b->hashes) &&
+             !memcmp(a->hashes.hashes, b->hashes.hashes, hash243_vector_count(&a->hashes) * FLEX_TRIT_SIZE_243);
+    default:
+      return false;
+  }
+}
+
+/**
+ * Check out a connection for a sub-request, so sub-requests run by different threads never share one. When every
+ * connection of the pool is in use, the sub-request waits for the connection of the batch instead of the pool, which
+ * cannot deadlock since the batch holds it until all of its sub-requests are done.
+ */
+static iota_client_service_t* api_batch_conn_take(api_batch_conn_t* const conn) {
+  iota_client_service_t* service = iri_pool_try_acquire();
+  if (service == NULL) {
+    lock_handle_lock(&conn->lock);
+    service = (iota_client_service_t*)conn->service;
+  }
+  return service;
+}
+
+/**
+ * Return a connection taken with `api_batch_conn_take()`. The pool never hands out the connection of the batch, since
+ * the batch has it checked out.
+ */
+static void api_batch_conn_give(api_batch_conn_t* const conn, iota_client_service_t* const service) {
+  if (service == conn->service) {
+    lock_handle_unlock(&conn->lock);
+  } else {
+    iri_pool_release(service);
+  }
+}
+
+static void api_batch_run(void* arg) {
+  api_batch_task_t* task = (api_batch_task_t*)arg;
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_JSON, .fields = task->req->fields};
+  iota_client_service_t* service = api_batch_conn_take(task->conn);
+
+  switch (task->req->cmd) {
+    case TA_BATCH_GENERATE_ADDRESS:
+      task->ret = api_generate_address(task->iconf, service, &task->result);
+      break;
+    case TA_BATCH_GET_TIPS_PAIR:
+      task->ret = api_get_tips_pair(task->iconf, service, &task->result);
+      break;
+    case TA_BATCH_GET_TIPS:
+      task->ret = api_get_tips(service, &task->result);
+      break;
+    case TA_BATCH_FIND_TXN_BY_TAG:
+      task->ret = api_find_transactions_by_tag(service, task->req->tag, &task->result);
+      break;
+    case TA_BATCH_FIND_TXN_OBJ_BY_TAG:
+      task->ret = api_find_transactions_obj_by_tag(service, task->req->tag, &opt, &task->result, NULL);
+      break;
+    default:
+      task->ret = SC_SERIALIZER_INVALID_REQ;
+      break;
+  }
+  api_batch_conn_give(task->conn, service);
+}
+
+static int api_batch_hash_cmp(const void* a, const void* b) { return memcmp(a, b, FLEX_TRIT_SIZE_243); }
+
+static int api_batch_txn_cmp(const void* a, const void* b) {
+  return memcmp(transaction_hash(*(iota_transaction_t* const*)a), transaction_hash(*(iota_transaction_t* const*)b),
+                FLEX_TRIT_SIZE_243);
+}
+
+static int api_batch_txn_hash_cmp(const void* key, const void* elem) {
+  return memcmp(key, transaction_hash(*(iota_transaction_t* const*)elem), FLEX_TRIT_SIZE_243);
+}
+
+/**
+ * Pick the transactions of one sub-request out of the merged result, sorted by hash, and serialize them
+ */
+static status_t api_batch_objects_split(iota_transaction_t* const* const sorted, const size_t num,
+                                        api_batch_task_t* const task) {
+  status_t ret = SC_OK;
+  flex_trit_t const* hash = NULL;
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_JSON, .fields = task->req->fields};
+  transaction_array_t* res = transaction_array_new();
+  if (res == NULL) {
+    ta_log_error("%s\n", "SC_TA_OOM");
+    return SC_TA_OOM;
+  }
+
+  HASH243_VECTOR_FOREACH(&task->req->hashes, hash) {
+    iota_transaction_t* const* txn =
+        (iota_transaction_t* const*)bsearch(hash, sorted, num, sizeof(iota_transaction_t*), api_batch_txn_hash_cmp);
+    if (txn == NULL) {
+      ret = SC_CCLIENT_NOT_FOUND;
+      ta_log_error("%s\n", "SC_CCLIENT_NOT_FOUND");
+      goto done;
+    }
+    transaction_array_push_back(res, *txn);
+  }
+  ret = ta_transaction_array_serialize(res, &opt, &task->result, NULL);
+
+done:
+  transaction_array_free(res);
+  return ret;
+}
+
+/**
+ * Look up the transaction objects of every "find_transaction_objects" sub-request at once. The hashes are merged
+ * without duplicates, so each of them is read from the cache or IRI only once. Should the merged lookup fail, e.g. on
+ * a hash IRI does not know, each sub-request is looked up on its own so only the failing ones get an error.
+ */
+static void api_batch_find_objects(void* arg) {
+  api_batch_objects_t* objs = (api_batch_objects_t*)arg;
+  status_t ret = SC_OK;
+  arena_t* arena = arena_thread_local();
+  flex_trit_t const* hash = NULL;
+  iota_transaction_t** sorted = NULL;
+  ta_find_transaction_objects_req_t req = {.fields = 0};
+  transaction_array_t* res = transaction_array_new();
+  iota_client_service_t* service = api_batch_conn_take(objs->conn);
+  hash243_vector_init(&req.hashes, NULL);
+  if (arena == NULL || res == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  for (size_t i = 0; i < objs->num; i++) {
+    if (objs->tasks[i].req->cmd != TA_BATCH_FIND_TRANSACTION_OBJECTS || objs->tasks[i].same) {
+      continue;
+    }
+    HASH243_VECTOR_FOREACH(&objs->tasks[i].req->hashes, hash) {
+      if (hash243_vector_push(&req.hashes, hash) != SC_OK) {
+        ret = SC_TA_OOM;
+        ta_log_error("%s\n", "SC_TA_OOM");
+        goto done;
+      }
+    }
+  }
+  // Sort the hashes and drop the duplicates in place
+  size_t count = hash243_vector_count(&req.hashes);
+  size_t unique = count ? 1 : 0;
+  qsort(req.hashes.hashes, count, FLEX_TRIT_SIZE_243, api_batch_hash_cmp);
+  for (size_t i = 1; i < count; i++) {
+    if (memcmp(req.hashes.hashes + i * FLEX_TRIT_SIZE_243, req.hashes.hashes + (unique - 1) * FLEX_TRIT_SIZE_243,
+               FLEX_TRIT_SIZE_243)) {
+      memmove(req.hashes.hashes + unique * FLEX_TRIT_SIZE_243, req.hashes.hashes + i * FLEX_TRIT_SIZE_243,
+              FLEX_TRIT_SIZE_243);
+      unique++;
+    }
+  }
+  req.hashes.count = unique;
+
+  ret = ta_find_transaction_objects(service, arena, &req, res);
+  if (ret == SC_OK && transaction_array_len(res) > 0) {
+    sorted = (iota_transaction_t**)malloc(transaction_array_len(res) * sizeof(iota_transaction_t*));
+    if (sorted == NULL) {
+      ret = SC_TA_OOM;
+      ta_log_error("%s\n", "SC_TA_OOM");
+    } else {
+      for (size_t i = 0; i < transaction_array_len(res); i++) {
+        sorted[i] = transaction_array_at(res, i);
+      }
+      qsort(sorted, transaction_array_len(res), sizeof(iota_transaction_t*), api_batch_txn_cmp);
+    }
+  }
+
+  for (size_t i = 0; i < objs->num; i++) {
+    api_batch_task_t* task = &objs->tasks[i];
+    if (task->req->cmd != TA_BATCH_FIND_TRANSACTION_OBJECTS || task->same) {
+      continue;
+    }
+    if (ret == SC_OK) {
+      task->ret = api_batch_objects_split(sorted, transaction_array_len(res), task);
+      continue;
+    }
+
+    transaction_array_t* single = transaction_array_new();
+    ta_find_transaction_objects_req_t single_req = {.hashes = task->req->hashes, .fields = task->req->fields};
+    ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_JSON, .fields = task->req->fields};
+    if (single == NULL) {
+      task->ret = SC_TA_OOM;
+      continue;
+    }
+    task->ret = ta_find_transaction_objects(service, arena, &single_req, single);
+    if (task->ret == SC_OK) {
+      task->ret = ta_transaction_array_serialize(single, &opt, &task->result, NULL);
+    }
+    transaction_array_free(single);
+  }
+
+done:
+  api_batch_conn_give(objs->conn, service);
+  api_arena_rewind(arena);
+  hash243_vector_free(&req.hashes);
+  transaction_array_free(res);
+  free(sorted);
+  // Sub-requests left without a result when running out of memory before the lookup
+  for (size_t i = 0; i < objs->num; i++) {
+    api_batch_task_t* task = &objs->tasks[i];
+    if (task->req->cmd == TA_BATCH_FIND_TRANSACTION_OBJECTS && !task->same && task->ret == SC_OK &&
+        task->result == NULL) {
+      task->ret = SC_TA_OOM;
+    }
+  }
+}
+
+status_t api_batch(const iota_config_t* const iconf, const iota_client_service_t* const service, const char* const obj,
+                   char** json_result) {
+  status_t ret = SC_OK;
+  char arena_buf[API_BATCH_ARENA_SIZE];
+  arena_t arena;
+  ta_batch_req_t* req = (ta_batch_req_t*)malloc(sizeof(ta_batch_req_t));
+  api_batch_task_t tasks[TA_BATCH_MAX_REQUESTS];
+  task_pool_task_t pool_tasks[TA_BATCH_MAX_REQUESTS + 1];
+  api_batch_conn_t conn = {.service = service};
+  api_batch_objects_t objs = {.conn = &conn, .tasks = tasks, .num = 0};
+  char* results[TA_BATCH_MAX_REQUESTS];
+  status_t rets[TA_BATCH_MAX_REQUESTS];
+  size_t num_tasks = 0;
+  bool has_objects = false;
+
+  // The sub-requests are run by other threads too, so they are parsed into an arena of this call instead of the one
+  // of the thread, which the APIs run by this thread rewind
+  arena_init(&arena, arena_buf, sizeof(arena_buf));
+  lock_handle_init(&conn.lock);
+  char* buf = obj ? arena_strndup(&arena, obj, strlen(obj)) : NULL;
+  if (buf == NULL || req == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  ret = ta_batch_req_deserialize_insitu(buf, &arena, req);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  objs.num = req->num;
+  for (size_t i = 0; i < req->num; i++) {
+    api_batch_task_t* task = &tasks[i];
+    *task = (api_batch_task_t){
+        .iconf = iconf, .conn = &conn, .req = &req->reqs[i], .same = NULL, .result = NULL, .ret = SC_OK};
+    for (size_t j = 0; j < i && task->same == NULL; j++) {
+      if (tasks[j].same == NULL && api_batch_same_lookup(&req->reqs[j], &req->reqs[i])) {
+        task->same = &tasks[j];
+      }
+    }
+    if (task->same) {
+      continue;
+    }
+    if (task->req->cmd == TA_BATCH_FIND_TRANSACTION_OBJECTS) {
+      has_objects = true;
+    } else {
+      pool_tasks[num_tasks++] = (task_pool_task_t){.func = api_batch_run, .arg = task};
+    }
+  }
+  if (has_objects) {
+    pool_tasks[num_tasks++] = (task_pool_task_t){.func = api_batch_find_objects, .arg = &objs};
+  }
+  task_pool_run(pool_tasks, num_tasks);
+
+  for (size_t i = 0; i < req->num; i++) {
+    if (tasks[i].same) {
+      tasks[i].ret = tasks[i].same->ret;
+      if (tasks[i].ret == SC_OK && tasks[i].same->result) {
+        tasks[i].result = strdup(tasks[i].same->result);
+        if (tasks[i].result == NULL) {
+          tasks[i].ret = SC_TA_OOM;
+        }
+      }
+    }
+    results[i] = tasks[i].result;
+    rets[i] = tasks[i].ret;
+  }
+  ret = ta_batch_res_serialize(results, rets, req->num, json_result);
+
+  for (size_t i = 0; i < req->num; i++) {
+    free(tasks[i].result);
+  }
+
+done:
+  lock_handle_destroy(&conn.lock);
+  arena_reset(&arena);
+  free(req);
   return ret;
 }
@@ -58,24 +58,6 @@ int apis_logger_release();
 status_t api_get_ta_info(char** json_result, ta_config_t* const info, iota_config_t* const tangle,
                          ta_cache_t* const cache, iota_client_service_t* const service);
 
-/**
- * Initialize lock
- *
- * @return
- * - zero on success
- * - SC_CONF_LOCK_INIT on error
- */
-status_t apis_lock_init();
-
-/**
- * Destroy lock
- *
- * @return
- * - zero on success
- * - SC_CONF_LOCK_DESTROY on error
- */
-status_t apis_lock_destroy();
-
 /**
  * @brief Generate an unused address.
  *
@@ -149,35 +131,35 @@ status_t api_receive_mam_message(const iota_config_t* const iconf, const iota_cl
  * api_mam_send_message() will take this job.
  *
  * @param[in] iconf IOTA API parameter configurations
- * @param[in] service IRI node end point service
  * @param[in] payload message to send undecoded ascii string.
  * @param[out] json_result Result containing channel id and bundle hash
  *
  * @return
  * - SC_OK on success
+ * - SC_UTILS_POW_OVERLOADED if the PoW path is too busy to admit the request
  * - non-zero on error
  */
-status_t api_mam_send_message(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                              char const* const payload, char** json_result);
+status_t api_mam_send_message(const iota_config_t* const iconf, char const* const payload, char** json_result);
 
 /**
  * @brief Send transfer to tangle.
  *
  * Build the transfer bundle from request and broadcast to the tangle. Input
  * fields include address, value, tag, and message. This API would also try to
- * find the transactions after bundle sent.
+ * find the transactions after bundle sent. The IRI connections are checked out
+ * of the pool by the API itself, so none is held while the request waits for
+ * the PoW.
  *
  * @param[in] iconf IOTA API parameter configurations
- * @param[in] service IRI node end point service
  * @param[in] obj Input data in JSON
  * @param[out] json_result Result containing transaction objects in json format
  *
  * @return
  * - SC_OK on success
+ * - SC_UTILS_POW_OVERLOADED if the PoW path is too busy to admit the request
  * - non-zero on error
  */
-status_t api_send_transfer(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                           const char* const obj, char** json_result);
+status_t api_send_transfer(const iota_config_t* const iconf, const char* const obj, char** json_result);
 
 /**
  * @brief Return transaction object with given single transaction hash.
@@ -187,14 +169,17 @@ status_t api_send_transfer(const iota_config_t* const iconf, const iota_client_s
  *
  * @param[in] service IRI node end point service
  * @param[in] obj transaction hash in trytes
- * @param[out] json_result Result containing the only one transaction object in json format
+ * @param[in] opt Serialization options of the result, NULL for JSON
+ * @param[out] result Result containing the only one transaction object in the requested format
+ * @param[out] result_len Length of `result`, may be NULL for JSON
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
 status_t api_find_transaction_object_single(const iota_client_service_t* const service, const char* const obj,
-                                            char** json_result);
+                                            ta_txn_serialize_opt_t const* const opt, char** result,
+                                            size_t* const result_len);
 
 /**
  * @brief Return transaction object with given transaction hash.
@@ -203,15 +188,19 @@ status_t api_find_transaction_object_single(const iota_client_service_t* const s
  * return whole transaction object details in json format instead of raw trytes.
  *
  * @param[in] service IRI node end point service
- * @param[in] obj transaction hash in trytes
- * @param[out] json_result Result containing transaction objects in json format
+ * @param[in] obj transaction hashes in JSON, with the optional `fields` to project the objects on
+ * @param[in] opt Serialization options of the result, NULL for JSON. Its `fields` take precedence over the ones of
+ *            `obj`.
+ * @param[out] result Result containing transaction objects in the requested format
+ * @param[out] result_len Length of `result`, may be NULL for JSON
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
 status_t api_find_transaction_objects(const iota_client_service_t* const service, const char* const obj,
-                                      char** json_result);
+                                      ta_txn_serialize_opt_t const* const opt, char** result,
+                                      size_t* const result_len);
 
 /**
  * @brief Return list of transaction hash with given tag.
@@ -239,15 +228,185 @@ status_t api_find_transactions_by_tag(const iota_client_service_t* const service
  *
  * @param[in] service IRI node end point service
  * @param[in] obj tag in trytes
- * @param[out] json_result Result containing list of transaction objects in json
- * format
+ * @param[in] opt Serialization options of the result, NULL for JSON
+ * @param[out] result Result containing list of transaction objects in the requested format
+ * @param[out] result_len Length of `result`, may be NULL for JSON
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
 status_t api_find_transactions_obj_by_tag(const iota_client_service_t* const service, const char* const obj,
-                                          char** json_result);
+                                          ta_txn_serialize_opt_t const* const opt, char** result,
+                                          size_t* const result_len);
+
+/**
+ * @brief Return a page of the transaction hashes of bundle hashes, addresses, tags or approvees.
+ *
+ * Pages are ordered as described in `ta_find_transactions_page()`, so a client polling with the `cursor` of its last
+ * page only receives the transactions found since.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] obj bundle hashes, addresses, tags, or approvees in JSON, as the `findTransactions` command of IRI
+ * @param[in] page Requested page
+ * @param[out] json_result Result containing the page of transaction hashes and the `cursor` of the next one
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_TA_PAGING_OFF without the cache
+ * - non-zero on error
+ */
+status_t api_find_transactions_page(const iota_client_service_t* const service, const char* const obj,
+                                    ta_page_req_t const* const page, char** json_result);
+
+/**
+ * @brief Return a page of the transaction hashes with given tag.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] obj tag in trytes
+ * @param[in] page Requested page
+ * @param[out] json_result Result containing the page of transaction hashes and the `cursor` of the next one
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ if `obj` is not a valid tag
+ * - SC_TA_PAGING_OFF without the cache
+ * - non-zero on error
+ */
+status_t api_find_transactions_by_tag_page(const iota_client_service_t* const service, const char* const obj,
+                                           ta_page_req_t const* const page, char** json_result);
+
+/**
+ * @brief Return a page of the transaction objects with given tag.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] obj tag in trytes
+ * @param[in] page Requested page
+ * @param[in] opt Serialization options of the result, NULL for JSON
+ * @param[out] result Result containing the page of transaction objects and the `cursor` of the next one
+ * @param[out] result_len Length of `result`, may be NULL for JSON
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ if `obj` is not a valid tag
+ * - SC_TA_PAGING_OFF without the cache
+ * - non-zero on error
+ */
+status_t api_find_transactions_obj_by_tag_page(const iota_client_service_t* const service, const char* const obj,
+                                               ta_page_req_t const* const page, ta_txn_serialize_opt_t const* const opt,
+                                               char** result, size_t* const result_len);
+
+/**
+ * @brief Return list of transaction hashes of several tags, addresses, bundles and approvees.
+ *
+ * The query `{"tags":[...],"addresses":[...],"bundles":[...],"approvees":[...]}` is sent to IRI as one
+ * `findTransactions`, so, as in IRI, hashes matching any item of a member are returned, and hashes have to match
+ * every member given.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] obj Query in JSON, tags may be shorter than 27 trytes
+ * @param[in] page Requested page, NULL for all the hashes
+ * @param[out] json_result Result containing list of transaction hashes, or `{"hashes", "cursor"}` for a page
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ on an empty query, invalid trytes or more than TA_FIND_TXN_MAX_TERMS items
+ * - SC_TA_PAGING_OFF for a page without the cache
+ * - non-zero on error
+ */
+status_t api_find_transactions_multi(const iota_client_service_t* const service, const char* const obj,
+                                     ta_page_req_t const* const page, char** json_result);
+
+/**
+ * @brief Return list of transaction objects of several tags, addresses, bundles and approvees.
+ *
+ * The hashes are found as in `api_find_transactions_multi()`, and the objects of all of them are read with one
+ * batched lookup of the cache and IRI.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] obj Query in JSON, with an optional `fields`
+ * @param[in] page Requested page, NULL for all the objects
+ * @param[in] opt Serialization options of the result, NULL for JSON. Its fields take precedence over the query.
+ * @param[out] result Result containing the transaction objects, with the `cursor` of the next one for a page
+ * @param[out] result_len Length of `result`, may be NULL for JSON
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ on an empty query, invalid trytes or more than TA_FIND_TXN_MAX_TERMS items
+ * - SC_TA_PAGING_OFF for a page without the cache
+ * - non-zero on error
+ */
+status_t api_find_transactions_obj_multi(const iota_client_service_t* const service, const char* const obj,
+                                         ta_page_req_t const* const page, ta_txn_serialize_opt_t const* const opt,
+                                         char** result, size_t* const result_len);
+
+/**
+ * @brief Return list of transaction hashes of an address.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] obj Address of 81 trytes
+ * @param[in] page Requested page, NULL for all the hashes
+ * @param[out] json_result Result containing list of transaction hashes, or `{"hashes", "cursor"}` for a page
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ if `obj` is not a valid address
+ * - non-zero on error
+ */
+status_t api_find_transactions_by_addr(const iota_client_service_t* const service, const char* const obj,
+                                       ta_page_req_t const* const page, char** json_result);
+
+/** Queries of the transaction object streams */
+typedef enum ta_txn_query_e {
+  TA_TXN_QUERY_TAG,     /**< Transactions with a tag of 1 to 27 trytes */
+  TA_TXN_QUERY_ADDRESS, /**< Transactions of an address of 81 trytes */
+  TA_TXN_QUERY_BUNDLE,  /**< Transactions of a bundle hash of 81 trytes, reattachments included */
+} ta_txn_query_t;
+
+/**
+ * @brief Start a streamed response of the transaction objects of a tag, an address or a bundle.
+ *
+ * Only the transaction hashes are found here. The objects are fetched and serialized one page at a time by
+ * `api_txn_stream_read()`, so the memory of a response does not grow with the number of transactions.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] query What `obj` is
+ * @param[in] obj Tag, address or bundle hash in trytes
+ * @param[out] stream The stream, released with `api_txn_stream_free()`
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ if `obj` is not a valid tag or hash
+ * - non-zero on error
+ */
+status_t api_txn_stream_open(const iota_client_service_t* const service, const ta_txn_query_t query,
+                             const char* const obj, ta_txn_stream_t* const stream);
+
+/**
+ * @brief Fetch the next page of a stream and serialize it as a fragment of a JSON array.
+ *
+ * The fragments of a stream, concatenated in order, are the same JSON array as the buffered APIs respond with. Nothing
+ * is left to read once `stream->done` is set.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] stream The stream
+ * @param[in] fields Members of the transaction objects as a mask of ta_txn_field_t, 0 for all of them
+ * @param[out] json_result JSON fragment, possibly empty
+ * @param[out] json_result_len Length of `json_result`
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t api_txn_stream_read(const iota_client_service_t* const service, ta_txn_stream_t* const stream,
+                             const uint32_t fields, char** json_result, size_t* const json_result_len);
+
+/**
+ * @brief Release a stream
+ *
+ * @param[in] stream The stream
+ */
+void api_txn_stream_free(ta_txn_stream_t* const stream);
 
 /**
  * @brief Attach trytes to Tangle and return transaction hashes
@@ -257,17 +416,38 @@ status_t api_find_transactions_obj_by_tag(const iota_client_service_t* const ser
  * be recovered by querying the network after broadcasting.
  *
  * @param[in] iconf IOTA API parameter configurations
- * @param[in] service IRI node end point service
  * @param[in] obj trytes to attach, store and broadcast in json array
  * @param[out] json_result Result containing list of attached transaction hashes
  * in json format
  *
  * @return
  * - SC_OK on success
+ * - SC_UTILS_POW_OVERLOADED if the PoW path is too busy to admit the request
  * - non-zero on error
  */
-status_t api_send_trytes(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                         const char* const obj, char** json_result);
+status_t api_send_trytes(const iota_config_t* const iconf, const char* const obj, char** json_result);
+
+/**
+ * @brief Run several lookups in one request
+ *
+ * The sub-requests of `{"requests":[{"command":"...", ...}, ...]}` are run concurrently on the task pool. Identical
+ * lookups are run once, and the hashes of all the "find_transaction_objects" sub-requests are looked up together, so
+ * a transaction asked for several times is read from the cache or IRI only once. Each sub-request checks out a
+ * connection of its own, and takes turns on `service` when the pool has none idle.
+ *
+ * @param[in] iconf IOTA API parameter configurations
+ * @param[in] service IRI node end point service, checked out for the whole batch
+ * @param[in] obj Batch request in JSON
+ * @param[out] json_result `{"results":[...]}` in the order of the sub-requests, `{"error":<status code>}` in place of
+ *                         the result of a failed one
+ *
+ * @return
+ * - SC_OK on success, even if some sub-requests failed
+ * - SC_SERIALIZER_INVALID_REQ on unknown commands, missing arguments or more than TA_BATCH_MAX_REQUESTS sub-requests
+ * - non-zero on other errors
+ */
+status_t api_batch(const iota_config_t* const iconf, const iota_client_service_t* const service, const char* const obj,
+                   char** json_result);
 
 #ifdef __cplusplus
 }
@@ -40,9 +40,10 @@ status_t ta_attach_to_tangle(const attach_to_tangle_req_t* const req, attach_to_
     bundle_transactions_add(bundle, &tx);
 
     // store transaction to cache
-    flex_trits_to_trytes((tryte_t*)cache_key, NUM_TRYTES_HASH, transaction_hash(&tx), NUM_TRITS_HASH, NUM_TRITS_HASH);
-    flex_trits_to_trytes((tryte_t*)cache_value, NUM_TRYTES_SERIALIZED_TRANSACTION, elt,
-                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
+    ta_flex_trits_to_trytes((tryte_t*)cache_key, NUM_TRYTES_HASH, transaction_hash(&tx), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
+    ta_flex_trits_to_trytes((tryte_t*)cache_value, NUM_TRYTES_SERIALIZED_TRANSACTION, elt,
+                            NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
     ret = cache_set(cache_key, cache_value);
     if (ret != SC_OK && ret != SC_CACHE_OFF) {
       goto done;
@@ -75,9 +76,9 @@ done:
   return ret;
 }
 
-status_t ta_send_trytes(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                        hash8019_array_p trytes) {
+status_t ta_send_trytes(const iota_config_t* const iconf, hash8019_array_p trytes) {
   status_t ret = SC_OK;
+  iota_client_service_t* service = NULL;
   get_transactions_to_approve_req_t* tx_approve_req = get_transactions_to_approve_req_new();
   get_transactions_to_approve_res_t* tx_approve_res = get_transactions_to_approve_res_new();
   attach_to_tangle_req_t* attach_req = attach_to_tangle_req_new();
@@ -88,10 +89,12 @@ status_t ta_send_trytes(const iota_config_t* const iconf, const iota_client_serv
     goto done;
   }
 
+  // A connection is only checked out around the IRI calls, never while the PoW is queued or running
   get_transactions_to_approve_req_set_depth(tx_approve_req, iconf->milestone_depth);
-  if (iota_client_get_transactions_to_approve(service, tx_approve_req, tx_approve_res)) {
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  service = iri_pool_acquire();
+  ret = iri_pool_get_transactions_to_approve(service, tx_approve_req, tx_approve_res);
+  iri_pool_release(service);
+  if (ret != SC_OK) {
     goto done;
   }
 
@@ -104,10 +107,12 @@ status_t ta_send_trytes(const iota_config_t* const iconf, const iota_client_serv
     goto done;
   }
 
-  // store and broadcast
-  if (iota_client_store_and_broadcast(service, (store_transactions_req_t*)attach_res) != RC_OK) {
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  // store and broadcast, coalesced with the trytes of concurrent requests
+  service = iri_pool_acquire();
+  ret = broadcast_batcher_submit(service, attach_res->trytes);
+  iri_pool_release(service);
+  if (ret != SC_OK) {
+    ta_log_error("%d\n", ret);
     goto done;
   }
 
@@ -132,9 +137,14 @@ status_t ta_generate_address(const iota_config_t* const iconf, const iota_client
   status_t ret = SC_OK;
   hash243_queue_t out_address = NULL;
   flex_trit_t seed_trits[FLEX_TRIT_SIZE_243];
-  flex_trits_from_trytes(seed_trits, NUM_TRITS_HASH, (const tryte_t*)iconf->seed, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  ta_flex_trits_from_trytes(seed_trits, NUM_TRITS_HASH, (const tryte_t*)iconf->seed, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
   address_opt_t opt = {.security = 3, .start = 0, .total = 0};
 
+  // Extended API calls cannot go through the breaker of the node, they are only sent while it is closed
+  ret = iri_pool_check(service);
+  if (ret != SC_OK) {
+    return ret;
+  }
   ret = iota_client_get_new_address(service, seed_trits, opt, &out_address);
 
   if (ret) {
@@ -146,14 +156,15 @@ status_t ta_generate_address(const iota_config_t* const iconf, const iota_client
   return ret;
 }
 
-status_t ta_send_transfer(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                          const ta_send_transfer_req_t* const req, ta_send_transfer_res_t* res) {
+status_t ta_send_transfer(const iota_config_t* const iconf, const ta_send_transfer_req_t* const req,
+                          ta_send_transfer_res_t* res) {
   if (req == NULL || res == NULL) {
     ta_log_error("%s\n", "SC_TA_NULL");
     return SC_TA_NULL;
   }
 
   status_t ret = SC_OK;
+  iota_client_service_t* service = NULL;
   flex_trit_t* serialized_txn;
   find_transactions_req_t* find_tx_req = find_transactions_req_new();
   find_transactions_res_t* find_tx_res = find_transactions_res_new();
@@ -171,7 +182,7 @@ status_t ta_send_transfer(const iota_config_t* const iconf, const iota_client_se
   // TODO Maybe we can replace the variable type of message from flex_trit_t to
   // tryte_t
   tryte_t msg_tryte[NUM_TRYTES_SERIALIZED_TRANSACTION];
-  flex_trits_to_trytes(msg_tryte, req->msg_len / 3, req->message, req->msg_len, req->msg_len);
+  ta_flex_trits_to_trytes(msg_tryte, req->msg_len / 3, req->message, req->msg_len, req->msg_len);
 
   transfer_t transfer = {.value = 0, .timestamp = current_timestamp_ms(), .msg_len = req->msg_len / 3};
 
@@ -187,11 +198,17 @@ status_t ta_send_transfer(const iota_config_t* const iconf, const iota_client_se
   // TODO we may need args `remainder_address`, `inputs`, `timestampe` in the
   // future and declare `security` field in `iota_config_t`
   flex_trit_t seed[NUM_FLEX_TRITS_ADDRESS];
-  flex_trits_from_trytes(seed, NUM_TRITS_HASH, (tryte_t const*)iconf->seed, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
-  if (iota_client_prepare_transfers(service, seed, 2, transfers, NULL, NULL, false, current_timestamp_ms(),
-                                    out_bundle) != RC_OK) {
+  ta_flex_trits_from_trytes(seed, NUM_TRITS_HASH, (tryte_t const*)iconf->seed, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  // The connection is returned before `ta_send_trytes()`, which waits for the PoW
+  service = iri_pool_acquire();
+  ret = iri_pool_check(service);
+  if (ret == SC_OK && iota_client_prepare_transfers(service, seed, 2, transfers, NULL, NULL, false,
+                                                    current_timestamp_ms(), out_bundle) != RC_OK) {
     ret = SC_CCLIENT_FAILED_RESPONSE;
     ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  }
+  iri_pool_release(service);
+  if (ret != SC_OK) {
     goto done;
   }
 
@@ -206,7 +223,7 @@ status_t ta_send_transfer(const iota_config_t* const iconf, const iota_client_se
     free(serialized_txn);
   }
 
-  ret = ta_send_trytes(iconf, service, raw_tx);
+  ret = ta_send_trytes(iconf, raw_tx);
   if (ret) {
     goto done;
   }
@@ -219,10 +236,10 @@ status_t ta_send_transfer(const iota_config_t* const iconf, const iota_client_se
     goto done;
   }
 
-  ret = iota_client_find_transactions(service, find_tx_req, find_tx_res);
-  if (ret) {
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  service = iri_pool_acquire();
+  ret = iri_pool_find_transactions(service, find_tx_req, find_tx_res);
+  iri_pool_release(service);
+  if (ret != SC_OK) {
     goto done;
   }
 
@@ -239,109 +256,126 @@ done:
   return ret;
 }
 
-status_t ta_find_transactions_obj_by_tag(const iota_client_service_t* const service,
-                                         const find_transactions_req_t* const req, transaction_array_t* res) {
-  if (req == NULL || res == NULL) {
-    ta_log_error("%s\n", "SC_TA_NULL");
-    return SC_TA_NULL;
-  }
-
-  status_t ret = SC_OK;
-  find_transactions_res_t* txn_res = find_transactions_res_new();
-  ta_find_transaction_objects_req_t* obj_req = ta_find_transaction_objects_req_new();
-  if (txn_res == NULL || obj_req == NULL) {
-    ta_log_error("%s\n", "SC_TA_OOM");
-    goto done;
-  }
-
-  // get transaction hash
-  if (iota_client_find_transactions(service, req, txn_res) != RC_OK) {
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
-    goto done;
-  }
-
-  hash243_queue_copy(&obj_req->hashes, txn_res->hashes, hash243_queue_count(txn_res->hashes));
-
-  ret = ta_find_transaction_objects(service, obj_req, res);
-  if (ret) {
-    ta_log_error("%d\n", ret);
-    goto done;
-  }
-
-done:
-  find_transactions_res_free(&txn_res);
-  ta_find_transaction_objects_req_free(&obj_req);
-  return ret;
-}
-
-status_t ta_find_transaction_objects(const iota_client_service_t* const service,
-                                     const ta_find_transaction_objects_req_t* const req, transaction_array_t* res) {
+/** Hashes looked up in one cache round trip by ta_find_transaction_objects() */
+#define TA_CACHE_MGET_CHUNK 16
+
+/** Buffers of ta_find_transaction_objects(), kept off the stack of the server threads */
+typedef struct find_txn_objs_scratch_s {
+  iota_transaction_t txn;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  char txn_hash[NUM_TRYTES_HASH + 1];
+  char cache_value[NUM_TRYTES_SERIALIZED_TRANSACTION + 1];
+  char keys[TA_CACHE_MGET_CHUNK * NUM_TRYTES_HASH];
+  char values[TA_CACHE_MGET_CHUNK * NUM_TRYTES_SERIALIZED_TRANSACTION];
+  bool found[TA_CACHE_MGET_CHUNK];
+} find_txn_objs_scratch_t;
+
+/**
+ * Objects of the transactions of `req`, from the cache or IRI. With `cached_only`, the transactions missing from the
+ * cache are left out instead of being asked to IRI.
+ */
+static status_t find_transaction_objects(const iota_client_service_t* const service, arena_t* const arena,
+                                         const ta_find_transaction_objects_req_t* const req, transaction_array_t* res,
+                                         const bool cached_only) {
   status_t ret = SC_OK;
-  flex_trit_t tx_trits[NUM_TRITS_SERIALIZED_TRANSACTION];
   iota_transaction_t* temp = NULL;
+  flex_trit_t const* hash = NULL;
+  hash243_vector_t uncached_hashes;
+  hash8019_queue_entry_t* trytes_iter = NULL;
   get_trytes_req_t* req_get_trytes = get_trytes_req_new();
+  get_trytes_res_t* res_get_trytes = get_trytes_res_new();
   transaction_array_t* uncached_txn_array = transaction_array_new();
-  if (req == NULL || res == NULL || req_get_trytes == NULL || uncached_txn_array == NULL) {
+  if (arena == NULL || req == NULL || res == NULL || req_get_trytes == NULL || res_get_trytes == NULL ||
+      uncached_txn_array == NULL) {
     ret = SC_TA_NULL;
     ta_log_error("%s\n", "SC_TA_NULL");
     goto done;
   }
-  char txn_hash[NUM_TRYTES_HASH + 1] = {0};
-  char cache_value[NUM_TRYTES_SERIALIZED_TRANSACTION + 1] = {0};
+  find_txn_objs_scratch_t* scratch = (find_txn_objs_scratch_t*)arena_alloc(arena, sizeof(find_txn_objs_scratch_t));
+  if (scratch == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+  hash243_vector_init(&uncached_hashes, arena);
+  char* txn_hash = scratch->txn_hash;
+  char* cache_value = scratch->cache_value;
   txn_hash[NUM_TRYTES_HASH] = '\0';
+  cache_value[0] = '\0';
   cache_value[NUM_TRYTES_SERIALIZED_TRANSACTION] = '\0';
 
   // append transaction object which is already cached to transaction_array_t
   // if not, append uncached to request object of `iota_client_find_transaction_objectss`
-  hash243_queue_entry_t* q_iter = NULL;
-  CDL_FOREACH(req->hashes, q_iter) {
-    flex_trits_to_trytes((tryte_t*)txn_hash, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
-
-    ret = cache_get(txn_hash, cache_value);
-    if (ret == SC_OK) {
-      flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t*)cache_value,
-                             NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
-
-      // deserialize raw data to transaction object
-      temp = transaction_deserialize(tx_trits, true);
-      if (temp == NULL) {
-        ret = SC_CCLIENT_OOM;
-        ta_log_error("%s\n", "SC_CCLIENT_OOM");
-        goto done;
-      }
-
-      transaction_array_push_back(res, temp);
-      transaction_free(temp);
+  // The cache is asked for TA_CACHE_MGET_CHUNK hashes in each round trip
+  for (size_t base = 0; base < hash243_vector_count(&req->hashes); base += TA_CACHE_MGET_CHUNK) {
+    size_t num = hash243_vector_count(&req->hashes) - base;
+    if (num > TA_CACHE_MGET_CHUNK) {
+      num = TA_CACHE_MGET_CHUNK;
+    }
+    for (size_t i = 0; i < num; i++) {
+      ta_flex_trits_to_trytes((tryte_t*)(scratch->keys + i * NUM_TRYTES_HASH), NUM_TRYTES_HASH,
+                              hash243_vector_at(&req->hashes, base + i), NUM_TRITS_HASH, NUM_TRITS_HASH);
+    }
+    if (cache_mget(scratch->keys, NUM_TRYTES_HASH, num, scratch->values, NUM_TRYTES_SERIALIZED_TRANSACTION,
+                   scratch->found) != SC_OK) {
+      // Without the cache every hash is fetched from IRI
+      memset(scratch->found, 0, sizeof(scratch->found));
+    }
 
-      // reset the string `cache_value`
-      cache_value[0] = '\0';
-    } else {
-      if (hash243_queue_push(&req_get_trytes->hashes, q_iter->hash) != RC_OK) {
+    for (size_t i = 0; i < num; i++) {
+      hash = hash243_vector_at(&req->hashes, base + i);
+      if (scratch->found[i]) {
+        ta_flex_trits_from_trytes(scratch->tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                                  (const tryte_t*)(scratch->values + i * NUM_TRYTES_SERIALIZED_TRANSACTION),
+                                  NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+
+        // deserialize raw data into the scratch transaction object, which the array copies
+        transaction_reset(&scratch->txn);
+        if (transaction_deserialize_from_trits(&scratch->txn, scratch->tx_trits, true) == 0) {
+          ret = SC_CCLIENT_INVALID_FLEX_TRITS;
+          ta_log_error("%s\n", "SC_CCLIENT_INVALID_FLEX_TRITS");
+          goto done;
+        }
+        transaction_array_push_back(res, &scratch->txn);
+      } else if (!cached_only && hash243_vector_push(&uncached_hashes, hash) != SC_OK) {
         ret = SC_CCLIENT_HASH;
         ta_log_error("%s\n", "SC_CCLIENT_HASH");
         goto done;
       }
-      ret = SC_OK;
     }
   }
 
+  // The request queue is laid out in the arena in one go, instead of one allocation per uncached hash
+  if (hash243_vector_to_queue(&uncached_hashes, arena, &req_get_trytes->hashes) != SC_OK) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
   if (req_get_trytes->hashes != NULL) {
-    if (iota_client_get_transaction_objects(service, req_get_trytes, uncached_txn_array) != RC_OK) {
-      ret = SC_CCLIENT_FAILED_RESPONSE;
-      ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+    // getTrytes is called by itself instead of through `iota_client_get_transaction_objects()`, so that it is hedged
+    ret = iri_pool_get_trytes(service, req_get_trytes, res_get_trytes);
+    if (ret != SC_OK) {
       goto done;
     }
+    CDL_FOREACH(res_get_trytes->trytes, trytes_iter) {
+      transaction_reset(&scratch->txn);
+      if (transaction_deserialize_from_trits(&scratch->txn, trytes_iter->hash, true) == 0) {
+        ret = SC_CCLIENT_INVALID_FLEX_TRITS;
+        ta_log_error("%s\n", "SC_CCLIENT_INVALID_FLEX_TRITS");
+        goto done;
+      }
+      transaction_array_push_back(uncached_txn_array, &scratch->txn);
+    }
   }
 
   // append response of `iota_client_find_transaction_objects` into cache
-  flex_trit_t* temp_txn_trits = NULL;
   TX_OBJS_FOREACH(uncached_txn_array, temp) {
-    temp_txn_trits = transaction_serialize(temp);
-    if (!flex_trits_are_null(temp_txn_trits, FLEX_TRIT_SIZE_8019)) {
-      flex_trits_to_trytes((tryte_t*)txn_hash, NUM_TRYTES_HASH, transaction_hash(temp), NUM_TRITS_HASH, NUM_TRITS_HASH);
-      flex_trits_to_trytes((tryte_t*)cache_value, NUM_TRYTES_SERIALIZED_TRANSACTION, temp_txn_trits,
-                           NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
+    transaction_serialize_on_flex_trits(temp, scratch->tx_trits);
+    if (!flex_trits_are_null(scratch->tx_trits, FLEX_TRIT_SIZE_8019)) {
+      ta_flex_trits_to_trytes((tryte_t*)txn_hash, NUM_TRYTES_HASH, transaction_hash(temp), NUM_TRITS_HASH,
+                              NUM_TRITS_HASH);
+      ta_flex_trits_to_trytes((tryte_t*)cache_value, NUM_TRYTES_SERIALIZED_TRANSACTION, scratch->tx_trits,
+                              NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
       ret = cache_set(txn_hash, cache_value);
       if (ret != SC_OK) {
         if (ret != SC_CACHE_OFF) {
@@ -350,22 +384,357 @@ status_t ta_find_transaction_objects(const iota_client_service_t* const service,
         ret = SC_OK;
       }
 
-      iota_transaction_t* append_txn = transaction_deserialize(temp_txn_trits, true);
-      transaction_array_push_back(res, append_txn);
-      transaction_free(append_txn);
+      transaction_array_push_back(res, temp);
     } else {
       ret = SC_CCLIENT_NOT_FOUND;
       ta_log_error("%s\n", "SC_CCLIENT_NOT_FOUND");
       goto done;
     }
-    free(temp_txn_trits);
-    temp_txn_trits = NULL;
   }
 
 done:
+  if (req_get_trytes) {
+    // The queue entries belong to the arena
+    req_get_trytes->hashes = NULL;
+  }
   get_trytes_req_free(&req_get_trytes);
+  get_trytes_res_free(&res_get_trytes);
   transaction_array_free(uncached_txn_array);
-  free(temp_txn_trits);
+  return ret;
+}
+
+status_t ta_find_transaction_objects(const iota_client_service_t* const service, arena_t* const arena,
+                                     const ta_find_transaction_objects_req_t* const req, transaction_array_t* res) {
+  return find_transaction_objects(service, arena, req, res, false);
+}
+
+/** Prefix of the keys of the sorted sets of the query results */
+#define FIND_TXN_KEY_PREFIX "find:"
+/** Seconds the sorted set of a query is kept after it was last asked */
+#define FIND_TXN_CACHE_TTL (24 * 60 * 60)
+
+/**
+ * Key of the sorted set of a query, made of a letter for the kind of each criterion followed by its trytes. Returns
+ * NULL when the arena is out of memory.
+ */
+static char* find_transactions_cache_key(arena_t* const arena, const find_transactions_req_t* const req) {
+  hash243_queue_entry_t* hash_iter = NULL;
+  hash81_queue_entry_t* tag_iter = NULL;
+  size_t len = strlen(FIND_TXN_KEY_PREFIX);
+
+  CDL_FOREACH(req->bundles, hash_iter) { len += 1 + NUM_TRYTES_HASH; }
+  CDL_FOREACH(req->addresses, hash_iter) { len += 1 + NUM_TRYTES_HASH; }
+  CDL_FOREACH(req->approvees, hash_iter) { len += 1 + NUM_TRYTES_HASH; }
+  CDL_FOREACH(req->tags, tag_iter) { len += 1 + NUM_TRYTES_TAG; }
+
+  char* key = arena_alloc(arena, len + 1);
+  if (key == NULL) {
+    return NULL;
+  }
+  char* pos = key + strlen(FIND_TXN_KEY_PREFIX);
+  memcpy(key, FIND_TXN_KEY_PREFIX, pos - key);
+  hash243_queue_t const queues[] = {req->bundles, req->addresses, req->approvees};
+  char const kinds[] = {'b', 'a', 'p'};
+  for (size_t i = 0; i < sizeof(kinds); i++) {
+    CDL_FOREACH(queues[i], hash_iter) {
+      *pos++ = kinds[i];
+      ta_flex_trits_to_trytes((tryte_t*)pos, NUM_TRYTES_HASH, hash_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+      pos += NUM_TRYTES_HASH;
+    }
+  }
+  CDL_FOREACH(req->tags, tag_iter) {
+    *pos++ = 't';
+    flex_trits_to_trytes((tryte_t*)pos, NUM_TRYTES_TAG, tag_iter->hash, NUM_TRITS_TAG, NUM_TRITS_TAG);
+    pos += NUM_TRYTES_TAG;
+  }
+  *pos = '\0';
+  return key;
+}
+
+/**
+ * Add the hashes found by IRI to the sorted set of the query, scored by the time they are first seen. IRI drops old
+ * transactions with local snapshots, so a set as large as the result may still miss new hashes, and every hash is
+ * added again.
+ */
+static status_t find_transactions_cache_add(arena_t* const arena, char const* const key, hash243_queue_t const found) {
+  hash243_queue_entry_t* q_iter = NULL;
+  size_t num = hash243_queue_count(found);
+  if (num == 0) {
+    return SC_OK;
+  }
+  char* members = arena_alloc(arena, num * NUM_TRYTES_HASH);
+  if (members == NULL) {
+    ta_log_error("%s\n", "SC_TA_OOM");
+    return SC_TA_OOM;
+  }
+  char* pos = members;
+  CDL_FOREACH(found, q_iter) {
+    ta_flex_trits_to_trytes((tryte_t*)pos, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+    pos += NUM_TRYTES_HASH;
+  }
+  return cache_zset_add(key, (double)current_timestamp_ms(), members, NUM_TRYTES_HASH, num, FIND_TXN_CACHE_TTL);
+}
+
+/** Read a page from the sorted set of the query */
+static status_t find_transactions_page_cached(arena_t* const arena, char const* const key,
+                                              ta_page_req_t const* const page, hash243_vector_t* const hashes,
+                                              size_t* const next_cursor) {
+  status_t ret = SC_OK;
+  size_t start = page->cursor, count = 0;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  if (page->since) {
+    size_t older = 0;
+    ret = cache_zset_count_below(key, (double)page->since * 1000, &older);
+    if (ret != SC_OK) {
+      return ret;
+    }
+    start = older > start ? older : start;
+  }
+
+  char* members = arena_alloc(arena, page->limit * NUM_TRYTES_HASH);
+  if (members == NULL) {
+    ta_log_error("%s\n", "SC_TA_OOM");
+    return SC_TA_OOM;
+  }
+  ret = cache_zset_range(key, start, page->limit, members, NUM_TRYTES_HASH, &count);
+  if (ret != SC_OK) {
+    return ret;
+  }
+  for (size_t i = 0; i < count; i++) {
+    flex_trits_from_trytes(hash, NUM_TRITS_HASH, (tryte_t const*)members + i * NUM_TRYTES_HASH, NUM_TRYTES_HASH,
+                           NUM_TRYTES_HASH);
+    ret = hash243_vector_push(hashes, hash);
+    if (ret != SC_OK) {
+      return ret;
+    }
+  }
+  *next_cursor = start + count;
+  return SC_OK;
+}
+
+/**
+ * Count the members of the sorted set of a query, which stands in for IRI while it is unavailable. A query never asked
+ * or whose set expired stays unavailable, as it does without the cache.
+ */
+static status_t find_transactions_cache_known(char const* const key, size_t* const count) {
+  if (cache_zset_count(key, count) != SC_OK || *count == 0) {
+    ta_log_error("%s\n", "SC_CCLIENT_IRI_UNAVAILABLE");
+    return SC_CCLIENT_IRI_UNAVAILABLE;
+  }
+  return SC_OK;
+}
+
+/** Members read in one round trip by find_transactions_cached() */
+#define FIND_TXN_CACHE_CHUNK 100
+
+/**
+ * Append all the hashes of the sorted set of a query, when IRI is unavailable. The hashes found since the query was
+ * last sent to IRI are missing.
+ */
+static status_t find_transactions_cached(arena_t* const arena, char const* const key, hash243_vector_t* const hashes) {
+  size_t total = 0, count = 0;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  status_t ret = find_transactions_cache_known(key, &total);
+  if (ret != SC_OK) {
+    return ret;
+  }
+
+  char* members = arena_alloc(arena, FIND_TXN_CACHE_CHUNK * NUM_TRYTES_HASH);
+  if (members == NULL) {
+    ta_log_error("%s\n", "SC_TA_OOM");
+    return SC_TA_OOM;
+  }
+  for (size_t start = 0; start < total; start += FIND_TXN_CACHE_CHUNK) {
+    ret = cache_zset_range(key, start, FIND_TXN_CACHE_CHUNK, members, NUM_TRYTES_HASH, &count);
+    if (ret != SC_OK) {
+      return ret;
+    }
+    for (size_t i = 0; i < count; i++) {
+      flex_trits_from_trytes(hash, NUM_TRITS_HASH, (tryte_t const*)members + i * NUM_TRYTES_HASH, NUM_TRYTES_HASH,
+                             NUM_TRYTES_HASH);
+      ret = hash243_vector_push(hashes, hash);
+      if (ret != SC_OK) {
+        return ret;
+      }
+    }
+  }
+  return SC_OK;
+}
+
+status_t ta_find_transactions_obj_by_tag(const iota_client_service_t* const service, arena_t* const arena,
+                                         const find_transactions_req_t* const req, transaction_array_t* res) {
+  if (req == NULL || res == NULL) {
+    ta_log_error("%s\n", "SC_TA_NULL");
+    return SC_TA_NULL;
+  }
+
+  status_t ret = SC_OK;
+  bool cached_only = false;
+  ta_find_transaction_objects_req_t obj_req = {.fields = 0};
+  find_transactions_res_t* txn_res = find_transactions_res_new();
+  char* key = find_transactions_cache_key(arena, req);
+  hash243_vector_init(&obj_req.hashes, arena);
+  if (txn_res == NULL || key == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  // get transaction hash
+  ret = iri_pool_find_transactions(service, req, txn_res);
+  if (ret == SC_CCLIENT_IRI_UNAVAILABLE) {
+    // While the breaker is open, the result remembered for the query is served with the objects in the cache
+    cached_only = true;
+    ret = find_transactions_cached(arena, key, &obj_req.hashes);
+  } else if (ret == SC_OK) {
+    // The result is remembered for when IRI is unavailable, a lookup does not fail for want of the cache
+    find_transactions_cache_add(arena, key, txn_res->hashes);
+    ret = hash243_vector_append_queue(&obj_req.hashes, txn_res->hashes);
+    if (ret != SC_OK) {
+      ta_log_error("%s\n", "SC_UTILS_OOM");
+    }
+  }
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  ret = find_transaction_objects(service, arena, &obj_req, res, cached_only);
+  if (ret) {
+    ta_log_error("%d\n", ret);
+    goto done;
+  }
+
+done:
+  find_transactions_res_free(&txn_res);
+  hash243_vector_free(&obj_req.hashes);
+  return ret;
+}
+
+status_t ta_txn_stream_open(const iota_client_service_t* const service, arena_t* const arena,
+                            const find_transactions_req_t* const req, const size_t page_size,
+                            ta_txn_stream_t* const stream) {
+  if (req == NULL || stream == NULL) {
+    ta_log_error("%s\n", "SC_TA_NULL");
+    return SC_TA_NULL;
+  }
+
+  status_t ret = SC_OK;
+  find_transactions_res_t* txn_res = find_transactions_res_new();
+  char* key = find_transactions_cache_key(arena, req);
+  // The hashes outlive the request, so they are kept on the heap instead of the arena of the thread
+  hash243_vector_init(&stream->hashes, NULL);
+  stream->next = 0;
+  stream->page_size = page_size ? page_size : TA_TXN_STREAM_PAGE_SIZE;
+  stream->done = false;
+  stream->cached_only = false;
+  if (txn_res == NULL || key == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  ret = iri_pool_find_transactions(service, req, txn_res);
+  if (ret == SC_CCLIENT_IRI_UNAVAILABLE) {
+    // While the breaker is open, the stream reads the result remembered for the query and the objects in the cache
+    stream->cached_only = true;
+    ret = find_transactions_cached(arena, key, &stream->hashes);
+  } else if (ret == SC_OK) {
+    // Remembered for when IRI is unavailable, like the result of `ta_find_transactions_obj_by_tag()`
+    find_transactions_cache_add(arena, key, txn_res->hashes);
+    ret = hash243_vector_append_queue(&stream->hashes, txn_res->hashes);
+    if (ret != SC_OK) {
+      ta_log_error("%s\n", "SC_UTILS_OOM");
+    }
+  }
+
+done:
+  if (ret != SC_OK) {
+    hash243_vector_free(&stream->hashes);
+  }
+  find_transactions_res_free(&txn_res);
+  return ret;
+}
+
+status_t ta_txn_stream_next(const iota_client_service_t* const service, arena_t* const arena,
+                            ta_txn_stream_t* const stream, transaction_array_t* page) {
+  if (stream == NULL || page == NULL) {
+    ta_log_error("%s\n", "SC_TA_NULL");
+    return SC_TA_NULL;
+  }
+
+  status_t ret = SC_OK;
+  size_t count = hash243_vector_count(&stream->hashes) - stream->next;
+  if (count > stream->page_size) {
+    count = stream->page_size;
+  }
+
+  if (count > 0) {
+    // The request borrows the hashes of the page, it must not be freed
+    ta_find_transaction_objects_req_t obj_req = {
+        .hashes = {.hashes = hash243_vector_at(&stream->hashes, stream->next), .count = count, .capacity = count},
+        .fields = 0};
+    ret = find_transaction_objects(service, arena, &obj_req, page, stream->cached_only);
+    if (ret != SC_OK) {
+      ta_log_error("%d\n", ret);
+      return ret;
+    }
+    stream->next += count;
+  }
+  stream->done = stream->next == hash243_vector_count(&stream->hashes);
+  return SC_OK;
+}
+
+void ta_txn_stream_free(ta_txn_stream_t* const stream) {
+  if (stream) {
+    hash243_vector_free(&stream->hashes);
+  }
+}
+
+status_t ta_find_transactions_page(const iota_client_service_t* const service, arena_t* const arena,
+                                   const find_transactions_req_t* const req, ta_page_req_t const* const page,
+                                   hash243_vector_t* const hashes, size_t* const next_cursor) {
+  if (req == NULL || page == NULL || hashes == NULL || next_cursor == NULL) {
+    ta_log_error("%s\n", "SC_TA_NULL");
+    return SC_TA_NULL;
+  }
+
+  status_t ret = SC_OK;
+  size_t total = 0;
+  find_transactions_res_t* txn_res = find_transactions_res_new();
+  char* key = find_transactions_cache_key(arena, req);
+  if (txn_res == NULL || key == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  ret = iri_pool_find_transactions(service, req, txn_res);
+  if (ret == SC_CCLIENT_IRI_UNAVAILABLE) {
+    // While the breaker is open, the page is read from the result remembered for the query
+    ret = find_transactions_cache_known(key, &total);
+    if (ret == SC_OK) {
+      ret = find_transactions_page_cached(arena, key, page, hashes, next_cursor);
+    }
+    goto done;
+  }
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  ret = find_transactions_cache_add(arena, key, txn_res->hashes);
+  if (ret == SC_OK) {
+    ret = find_transactions_page_cached(arena, key, page, hashes, next_cursor);
+  }
+  if (ret == SC_CACHE_OFF) {
+    // An offset into the hashes found now may skip or repeat hashes once new transactions are found, so the only
+    // stable order is the one the cache remembers
+    ret = SC_TA_PAGING_OFF;
+    ta_log_error("%s\n", "SC_TA_PAGING_OFF");
+  }
+
+done:
+  find_transactions_res_free(&txn_res);
   return ret;
 }
 
@@ -411,8 +780,12 @@ status_t ta_get_bundle(const iota_client_service_t* const service, tryte_t const
   }
 
   // find transactions by bundle hash
-  flex_trits_from_trytes(bundle_hash_flex, NUM_TRITS_BUNDLE, bundle_hash, NUM_TRITS_HASH, NUM_TRYTES_BUNDLE);
+  ta_flex_trits_from_trytes(bundle_hash_flex, NUM_TRITS_BUNDLE, bundle_hash, NUM_TRITS_HASH, NUM_TRYTES_BUNDLE);
   hash243_queue_push(&find_tx_req->bundles, bundle_hash_flex);
+  ret = iri_pool_check(service);
+  if (ret != SC_OK) {
+    goto done;
+  }
   ret = iota_client_find_transaction_objects(service, find_tx_req, tx_objs);
   if (ret) {
     ret = SC_CCLIENT_FAILED_RESPONSE;
@@ -429,8 +802,7 @@ done:
   return ret;
 }
 
-status_t ta_send_bundle(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                        bundle_transactions_t* const bundle) {
+status_t ta_send_bundle(const iota_config_t* const iconf, bundle_transactions_t* const bundle) {
   Kerl kerl;
   kerl_init(&kerl);
   bundle_finalize(bundle, &kerl);
@@ -444,7 +816,7 @@ status_t ta_send_bundle(const iota_config_t* const iconf, const iota_client_serv
     hash_array_push(raw_trytes, trits_8019);
   }
 
-  ta_send_trytes(iconf, service, raw_trytes);
+  ta_send_trytes(iconf, raw_trytes);
 
   hash_array_free(raw_trytes);
   transaction_array_free(out_tx_objs);
@@ -452,8 +824,8 @@ status_t ta_send_bundle(const iota_config_t* const iconf, const iota_client_serv
   return SC_OK;
 }
 
-status_t ta_get_bundle_by_addr(const iota_client_service_t* const service, tryte_t const* const addr,
-                               bundle_transactions_t* bundle) {
+status_t ta_get_bundle_by_addr(const iota_client_service_t* const service, arena_t* const arena,
+                               tryte_t const* const addr, bundle_transactions_t* bundle) {
   status_t ret = SC_OK;
   tryte_t bundle_hash[NUM_TRYTES_BUNDLE];
   find_transactions_req_t* txn_req = find_transactions_req_new();
@@ -468,32 +840,32 @@ status_t ta_get_bundle_by_addr(const iota_client_service_t* const service, tryte
   }
 
   flex_trit_t addr_trits[NUM_TRITS_HASH];
-  flex_trits_from_trytes(addr_trits, NUM_TRITS_HASH, (const tryte_t*)addr, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  ta_flex_trits_from_trytes(addr_trits, NUM_TRITS_HASH, (const tryte_t*)addr, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
   find_transactions_req_address_add(txn_req, addr_trits);
 
-  if (iota_client_find_transactions(service, txn_req, txn_res) != RC_OK) {
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
-    ret = SC_CCLIENT_FAILED_RESPONSE;
+  ret = iri_pool_find_transactions(service, txn_req, txn_res);
+  if (ret != SC_OK) {
     goto done;
   }
 
   // In case the requested transction hashes is an empty one
   if (hash243_queue_count(txn_res->hashes) > 0) {
-    hash243_queue_push(&obj_req->hashes, find_transactions_res_hashes_get(txn_res, 0));
+    hash243_vector_push(&obj_req->hashes, find_transactions_res_hashes_get(txn_res, 0));
   } else {
     ta_log_error("%s\n", "SC_MAM_NOT_FOUND");
     ret = SC_MAM_NOT_FOUND;
     goto done;
   }
 
-  ret = ta_find_transaction_objects(service, obj_req, obj_res);
+  ret = ta_find_transaction_objects(service, arena, obj_req, obj_res);
   if (ret != SC_OK) {
     ta_log_error("%d\n", ret);
     goto done;
   }
 
   iota_transaction_t* curr_tx = transaction_array_at(obj_res, 0);
-  flex_trits_to_trytes(bundle_hash, NUM_TRYTES_BUNDLE, transaction_bundle(curr_tx), NUM_TRITS_BUNDLE, NUM_TRITS_BUNDLE);
+  ta_flex_trits_to_trytes(bundle_hash, NUM_TRYTES_BUNDLE, transaction_bundle(curr_tx), NUM_TRITS_BUNDLE,
+                          NUM_TRITS_BUNDLE);
   ret = ta_get_bundle(service, bundle_hash, bundle);
   if (ret != SC_OK) {
     ta_log_error("%d\n", ret);
@@ -13,7 +13,9 @@
 #include "common/model/transfer.h"
 #include "request/request.h"
 #include "response/response.h"
+#include "utils/arena.h"
 #include "utils/time.h"
+#include "utils/trinary_kernels.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,6 +30,9 @@ extern "C" {
  * The arguments and return data structure are specified in different
  * requests.
  *
+ * Functions taking an `arena` put their scratch buffers in it. It is usually
+ * the one of the calling thread, rewound by the API once the request is done.
+ *
  * @example test_common.cc
  */
 
@@ -68,10 +73,10 @@ status_t ta_generate_address(const iota_config_t* const iconf, const iota_client
  *
  * Build the transfer bundle from request and broadcast to the tangle. Input
  * fields include address, value, tag, and message. This API would also try to
- * find the transactions after bundle sent.
+ * find the transactions after bundle sent. IRI connections are checked out of
+ * the pool around each IRI call, none is held while waiting for the PoW.
  *
  * @param[in] iconf IOTA API parameter configurations
- * @param[in] service IRI node end point service
  * @param[in] req Request containing address value, message, tag in
  *                ta_send_transfer_req_t
  * @param[out] res Result containing transaction hash in ta_send_transfer_res_t
@@ -80,26 +85,25 @@ status_t ta_generate_address(const iota_config_t* const iconf, const iota_client
  * - SC_OK on success
  * - non-zero on error
  */
-status_t ta_send_transfer(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                          const ta_send_transfer_req_t* const req, ta_send_transfer_res_t* res);
+status_t ta_send_transfer(const iota_config_t* const iconf, const ta_send_transfer_req_t* const req,
+                          ta_send_transfer_res_t* res);
 
 /**
  * @brief Send trytes to tangle.
  *
  * Get trunk and branch in `cclient_get_txn_to_approve`, create
  * bundle and do PoW in `ta_attach_to_tangle` and store and broadcast
- * transaction to tangle.
+ * transaction to tangle. IRI connections are checked out of the pool around
+ * each IRI call, none is held while waiting for the PoW.
  *
  * @param[in] iconf IOTA API parameter configurations
- * @param[in] service IRI node end point service
  * @param[in] trytes Trytes that will be attached to tangle
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
-status_t ta_send_trytes(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                        hash8019_array_p trytes);
+status_t ta_send_trytes(const iota_config_t* const iconf, hash8019_array_p trytes);
 
 /**
  * @brief Return list of transaction hash with given tag.
@@ -125,7 +129,11 @@ status_t ta_find_transactions_by_tag(const iota_client_service_t* const service,
  * Retreive all transactions that have same given tag. The result is a list of
  * transaction objects in ta_find_transactions_obj_res_t.
  *
+ * While IRI is unavailable, the result remembered in the cache for the same query is served instead, with only the
+ * transactions whose objects are cached.
+ *
  * @param[in] service IRI node end point service
+ * @param[in] arena Arena for the scratch buffers
  * @param[in] req find_transactions_req_t object which contains tags
  * @param[out] res Result containing list of transaction objects in
  *                 transaction_array_t
@@ -134,7 +142,7 @@ status_t ta_find_transactions_by_tag(const iota_client_service_t* const service,
  * - SC_OK on success
  * - non-zero on error
  */
-status_t ta_find_transactions_obj_by_tag(const iota_client_service_t* const service,
+status_t ta_find_transactions_obj_by_tag(const iota_client_service_t* const service, arena_t* const arena,
                                          const find_transactions_req_t* const req, transaction_array_t* res);
 
 /**
@@ -145,6 +153,7 @@ status_t ta_find_transactions_obj_by_tag(const iota_client_service_t* const serv
  * instead of raw trytes, includes address, value, timestamp, mwm, nonce...
  *
  * @param[in] service IRI node end point service
+ * @param[in] arena Arena for the scratch buffers
  * @param[in] req Given transaction hashes
  * @param[out] res Result containing transaction objects in transaction_array_t.
  *
@@ -152,9 +161,95 @@ status_t ta_find_transactions_obj_by_tag(const iota_client_service_t* const serv
  * - SC_OK on success
  * - non-zero on error
  */
-status_t ta_find_transaction_objects(const iota_client_service_t* const service,
+status_t ta_find_transaction_objects(const iota_client_service_t* const service, arena_t* const arena,
                                      const ta_find_transaction_objects_req_t* const req, transaction_array_t* res);
 
+/** Transactions fetched at a time by `ta_txn_stream_next()` */
+#define TA_TXN_STREAM_PAGE_SIZE 100
+
+/**
+ * Transaction objects of a query, fetched page by page. Only the hashes of the whole result are held, the objects are
+ * fetched from the cache or IRI when their page is read.
+ */
+typedef struct ta_txn_stream_s {
+  hash243_vector_t hashes; /**< Hashes of the result, on the heap */
+  size_t next;             /**< Index of the first hash not read yet */
+  size_t page_size;        /**< Maximum number of transactions of a page */
+  bool done;               /**< The last page was read */
+  bool cached_only;        /**< IRI was unavailable on open, the objects missing from the cache are left out */
+} ta_txn_stream_t;
+
+/**
+ * @brief Find the transactions of a query, and get ready to read their objects page by page.
+ *
+ * While IRI is unavailable, the stream reads the result remembered in the cache for the same query instead.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] arena Arena for the scratch buffers
+ * @param[in] req find_transactions_req_t object which contains tags, addresses or bundles
+ * @param[in] page_size Maximum number of transactions of a page, TA_TXN_STREAM_PAGE_SIZE if zero
+ * @param[out] stream The stream, released with `ta_txn_stream_free()`
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_txn_stream_open(const iota_client_service_t* const service, arena_t* const arena,
+                            const find_transactions_req_t* const req, const size_t page_size,
+                            ta_txn_stream_t* const stream);
+
+/**
+ * @brief Read the next page of transaction objects of a stream.
+ *
+ * The page is empty for an empty result. `stream->done` is set once the last page was read.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] arena Arena for the scratch buffers
+ * @param[in] stream The stream
+ * @param[out] page Transaction objects of the page, appended in the order of the hashes
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_txn_stream_next(const iota_client_service_t* const service, arena_t* const arena,
+                            ta_txn_stream_t* const stream, transaction_array_t* page);
+
+/**
+ * @brief Release the hashes of a stream.
+ *
+ * @param[in] stream The stream
+ */
+void ta_txn_stream_free(ta_txn_stream_t* const stream);
+
+/**
+ * @brief Return a page of the transaction hashes of a query.
+ *
+ * With the cache, the hashes of a query are kept in a sorted set scored by the time tangle-accelerator first found
+ * them, so a page keeps its order while new transactions are appended, and a `cursor` only skips the hashes a client
+ * already received. `since` skips the hashes first found before it.
+ *
+ * Without the cache there is no order which new transactions cannot shift, so queries are not paged at all.
+ *
+ * While IRI is unavailable, pages are read from the sorted set of the query as long as it is cached, without the hashes
+ * found since it was last sent to IRI.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] arena Arena for the scratch buffers
+ * @param[in] req find_transactions_req_t object which contains tags, addresses, bundles or approvees
+ * @param[in] page Requested page
+ * @param[out] hashes Hashes of the page, appended to an initialized vector
+ * @param[out] next_cursor `cursor` of the next page
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_TA_PAGING_OFF without the cache
+ * - non-zero on error
+ */
+status_t ta_find_transactions_page(const iota_client_service_t* const service, arena_t* const arena,
+                                   const find_transactions_req_t* const req, ta_page_req_t const* const page,
+                                   hash243_vector_t* const hashes, size_t* const next_cursor);
+
 /**
  * @brief Return bundle object with given bundle hash.
  *
@@ -179,7 +274,7 @@ status_t ta_get_bundle(const iota_client_service_t* const service, tryte_t const
  * Send the unpacked bundle which contains transactions. MAM functions should
  * send message with this function.
  *
- * @param[in] service IRI node end point service
+ * @param[in] iconf IOTA API parameter configurations
  * @param[in] bundle bundle object to send
  * @param[out] bundle Result containing bundle object in bundle_transactions_t
  *
@@ -187,8 +282,7 @@ status_t ta_get_bundle(const iota_client_service_t* const service, tryte_t const
  * - SC_OK on success
  * - non-zero on error
  */
-status_t ta_send_bundle(const iota_config_t* const iconf, const iota_client_service_t* const service,
-                        bundle_transactions_t* const bundle);
+status_t ta_send_bundle(const iota_config_t* const iconf, bundle_transactions_t* const bundle);
 
 /**
  * @brief Get the bundle that contains assigned address
@@ -197,6 +291,7 @@ status_t ta_send_bundle(const iota_config_t* const iconf, const iota_client_serv
  * of a transaction, we can use this function to search which bundle contains the message transaction we want to fetch.
  *
  * @param[in] service IRI node end point service
+ * @param[in] arena Arena for the scratch buffers
  * @param[in] addr searched address in tryte_t
  * @param[in] bundle pointer of bundle object that will contain the MAM transacitons
  *
@@ -204,8 +299,8 @@ status_t ta_send_bundle(const iota_config_t* const iconf, const iota_client_serv
  * - SC_OK on success
  * - non-zero on error
  */
-status_t ta_get_bundle_by_addr(const iota_client_service_t* const service, tryte_t const* const addr,
-                               bundle_transactions_t* bundle);
+status_t ta_get_bundle_by_addr(const iota_client_service_t* const service, arena_t* const arena,
+                               tryte_t const* const addr, bundle_transactions_t* bundle);
 
 #ifdef __cplusplus
 }
@@ -7,6 +7,7 @@
  */
 
 #include "config.h"
+#include <errno.h>
 #include "utils/logger_helper.h"
 #include "utils/macros.h"
 #include "yaml.h"
@@ -36,6 +37,21 @@ struct option* cli_build_options() {
   return long_options;
 }
 
+/**
+ * Parse a decimal CLI value of at most `max`, so that a value too large for its field is rejected instead of wrapping
+ * around
+ */
+static status_t cli_config_range(char const* const value, unsigned long const max, unsigned long* const num) {
+  char* end = NULL;
+  errno = 0;
+  *num = strtoul(value, &end, 10);
+  if (!isdigit((unsigned char)value[0]) || *end != '\0' || errno == ERANGE || *num > max) {
+    ta_log_error("%s\n", "SC_CONF_OUT_OF_RANGE");
+    return SC_CONF_OUT_OF_RANGE;
+  }
+  return SC_OK;
+}
+
 status_t cli_config_set(char* conf_file, ta_config_t* const info, iota_config_t* const iconf, ta_cache_t* const cache,
                         iota_client_service_t* const service, int key, char* const value) {
   if (value == NULL || info == NULL || iconf == NULL || cache == NULL || service == NULL) {
@@ -43,6 +59,7 @@ status_t cli_config_set(char* conf_file, ta_config_t* const info, iota_config_t*
     return SC_CONF_NULL;
   }
 
+  unsigned long num = 0;
   switch (key) {
     // TA configuration
     case TA_HOST_CLI:
@@ -54,6 +71,45 @@ status_t cli_config_set(char* conf_file, ta_config_t* const info, iota_config_t*
     case TA_THREAD_COUNT_CLI:
       info->thread_count = atoi(value);
       break;
+    case POW_WORKERS_CLI:
+      if (cli_config_range(value, UINT8_MAX, &num) != SC_OK) {
+        return SC_CONF_OUT_OF_RANGE;
+      }
+      info->pow_workers = num;
+      break;
+    case POW_QUEUE_SIZE_CLI:
+      info->pow_queue_size = atoi(value);
+      break;
+    case POW_SLA_CLI:
+      info->pow_sla = atoi(value);
+      break;
+    case BROADCAST_WINDOW_CLI:
+      info->broadcast_window = atoi(value);
+      break;
+    case BROADCAST_BATCH_SIZE_CLI:
+      info->broadcast_batch_size = atoi(value);
+      break;
+    case HTTP_THREAD_POOL_CLI:
+      info->http_thread_pool = (toupper(value[0]) == 'T');
+      break;
+    case HTTP_CONN_LIMIT_CLI:
+      info->http_conn_limit = strtoul(value, NULL, 10);
+      break;
+    case HTTP_CONN_MEMORY_CLI:
+      info->http_conn_memory = strtoul(value, NULL, 10);
+      break;
+    case HTTP_CONN_TIMEOUT_CLI:
+      info->http_conn_timeout = atoi(value);
+      break;
+    case HTTP_MAX_BODY_CLI:
+      info->http_max_body = strtoul(value, NULL, 10);
+      break;
+    case BATCH_WORKERS_CLI:
+      if (cli_config_range(value, UINT8_MAX, &num) != SC_OK) {
+        return SC_CONF_OUT_OF_RANGE;
+      }
+      info->batch_workers = num;
+      break;
 
     // IRI configuration
     case IRI_HOST_CLI:
@@ -62,6 +118,27 @@ status_t cli_config_set(char* conf_file, ta_config_t* const info, iota_config_t*
     case IRI_PORT_CLI:
       service->http.port = atoi(value);
       break;
+    case IRI_POOL_SIZE_CLI:
+      info->iri_pool_size = atoi(value);
+      break;
+    case IRI_NODES_CLI:
+      info->iri_nodes = value;
+      break;
+    case IRI_MILESTONE_LAG_CLI:
+      info->iri_milestone_lag = strtoul(value, NULL, 10);
+      break;
+    case IRI_HEDGE_BUDGET_CLI:
+      info->iri_hedge_budget = atoi(value);
+      break;
+    case IRI_BREAKER_RATE_CLI:
+      info->iri_breaker_rate = atoi(value);
+      break;
+    case IRI_BREAKER_LATENCY_CLI:
+      info->iri_breaker_latency = strtoul(value, NULL, 10);
+      break;
+    case IRI_BREAKER_COOLDOWN_CLI:
+      info->iri_breaker_cooldown = strtoul(value, NULL, 10);
+      break;
 
     // Cache configuration
     case REDIS_HOST_CLI:
@@ -70,6 +147,9 @@ status_t cli_config_set(char* conf_file, ta_config_t* const info, iota_config_t*
     case REDIS_PORT_CLI:
       cache->port = atoi(value);
       break;
+    case CONFIRMED_SET_SIZE_CLI:
+      cache->confirmed_set_size = atoi(value);
+      break;
 
     // iconf IOTA configuration
     case MILESTONE_DEPTH_CLI:
@@ -118,6 +198,24 @@ status_t ta_config_default_init(ta_config_t* const info, iota_config_t* const ic
   info->host = TA_HOST;
   info->port = TA_PORT;
   info->thread_count = TA_THREAD_COUNT;
+  info->pow_workers = POW_WORKERS;
+  info->pow_queue_size = POW_QUEUE_SIZE;
+  info->pow_sla = POW_SLA;
+  info->broadcast_window = BROADCAST_WINDOW;
+  info->broadcast_batch_size = BROADCAST_BATCH_SIZE;
+  info->http_thread_pool = HTTP_THREAD_POOL;
+  info->http_conn_limit = HTTP_CONN_LIMIT;
+  info->http_conn_memory = HTTP_CONN_MEMORY;
+  info->http_conn_timeout = HTTP_CONN_TIMEOUT;
+  info->http_max_body = HTTP_MAX_BODY;
+  info->batch_workers = BATCH_WORKERS;
+  info->iri_pool_size = IRI_POOL_SIZE;
+  info->iri_nodes = NULL;
+  info->iri_milestone_lag = IRI_MAX_MILESTONE_LAG;
+  info->iri_hedge_budget = IRI_HEDGE_BUDGET;
+  info->iri_breaker_rate = IRI_BREAKER_RATE;
+  info->iri_breaker_latency = IRI_BREAKER_LATENCY;
+  info->iri_breaker_cooldown = IRI_BREAKER_COOLDOWN;
 #ifdef ENABLE_MQTT
   info->mqtt_host = MQTT_HOST;
   info->mqtt_topic_root = TOPIC_ROOT;
@@ -125,6 +223,7 @@ status_t ta_config_default_init(ta_config_t* const info, iota_config_t* const ic
   ta_log_info("Initializing Redis information\n");
   cache->host = REDIS_HOST;
   cache->port = REDIS_PORT;
+  cache->confirmed_set_size = CONFIRMED_SET_SIZE;
   cache->cache_state = false;
 
   ta_log_info("Initializing IRI configuration\n");
@@ -296,9 +395,9 @@ status_t ta_config_cli_init(ta_core_t* const conf, int argc, char** argv) {
   return ret;
 }
 
-status_t ta_config_set(ta_cache_t* const cache, iota_client_service_t* const service) {
-  status_t ret = SC_OK;
-  if (cache == NULL || service == NULL) {
+status_t ta_config_set(ta_config_t* const info, ta_cache_t* const cache, iota_client_service_t* const service) {
+  status_t ret = SC_OK, status = SC_OK;
+  if (info == NULL || cache == NULL || service == NULL) {
     ta_log_error("%s\n", "SC_TA_NULL");
     return SC_TA_NULL;
   }
@@ -308,12 +407,38 @@ status_t ta_config_set(ta_cache_t* const cache, iota_client_service_t* const ser
     ret = SC_TA_OOM;
   }
   iota_client_extended_init();
+  status = iri_pool_init(service, info->iri_nodes, info->iri_pool_size, info->iri_milestone_lag, info->iri_hedge_budget,
+                         info->iri_breaker_rate, info->iri_breaker_latency, info->iri_breaker_cooldown);
+  if (status != SC_OK) {
+    ta_log_critical("Initializing IRI connection pool failed!\n");
+    ret = status;
+  }
 
   ta_log_info("Initializing PoW implementation context\n");
   pow_init();
+  status = pow_scheduler_start(info->pow_workers);
+  if (status != SC_OK) {
+    ta_log_critical("Starting PoW scheduler failed!\n");
+    ret = status;
+  }
+  pow_admission_init(info->pow_queue_size, info->pow_sla);
+  broadcast_batcher_init(info->broadcast_window, info->broadcast_batch_size);
+
+  ta_log_info("Initializing task pool\n");
+  task_pool_init();
+  status = task_pool_start(info->batch_workers);
+  if (status != SC_OK) {
+    ta_log_critical("Starting task pool failed!\n");
+    ret = status;
+  }
 
   ta_log_info("Initializing cache state\n");
   cache_init(cache->cache_state, cache->host, cache->port);
+  status = confirmed_set_init(cache->confirmed_set_size);
+  if (status != SC_OK) {
+    ta_log_critical("Initializing confirmed set failed!\n");
+    ret = status;
+  }
 
   return ret;
 }
@@ -321,9 +446,13 @@ status_t ta_config_set(ta_cache_t* const cache, iota_client_service_t* const ser
 void ta_config_destroy(iota_client_service_t* const service) {
   ta_log_info("Destroying IRI connection\n");
   iota_client_extended_destroy();
+  iri_pool_destroy();
   iota_client_core_destroy(service);
 
   pow_destroy();
+  broadcast_batcher_destroy();
+  task_pool_destroy();
+  confirmed_set_destroy();
   cache_stop();
   logger_helper_release(logger_id);
   br_logger_release();
@@ -15,8 +15,12 @@
 #include "accelerator/message.h"
 #include "cclient/api/core/core_api.h"
 #include "cclient/api/extended/extended_api.h"
+#include "utils/broadcast_batcher.h"
 #include "utils/cache.h"
+#include "utils/confirmed_set.h"
+#include "utils/iri_pool.h"
 #include "utils/pow.h"
+#include "utils/task_pool.h"
 
 #define FILE_PATH_SIZE 128
 
@@ -39,8 +43,25 @@ extern "C" {
 
 #define TA_PORT "8000"
 #define TA_THREAD_COUNT 10
+#define POW_WORKERS 2
+#define POW_QUEUE_SIZE 100
+#define POW_SLA 30000
+#define BROADCAST_WINDOW 10
+#define BROADCAST_BATCH_SIZE 100
+#define HTTP_THREAD_POOL false
+#define HTTP_CONN_LIMIT 0
+#define HTTP_CONN_MEMORY 0
+#define HTTP_CONN_TIMEOUT 0
+#define HTTP_MAX_BODY (4 * 1024 * 1024)
+#define BATCH_WORKERS 4
 #define IRI_HOST "localhost"
 #define IRI_PORT 14265
+#define IRI_POOL_SIZE 10
+#define IRI_MAX_MILESTONE_LAG 3
+#define IRI_HEDGE_BUDGET 0
+#define IRI_BREAKER_RATE 50
+#define IRI_BREAKER_LATENCY 5000
+#define IRI_BREAKER_COOLDOWN 10000
 #define MILESTONE_DEPTH 3
 #define MWM 14
 #define SEED                                                                   \
@@ -50,16 +71,35 @@ extern "C" {
 
 /** @name Redis connection config */
 /** @{ */
-#define REDIS_HOST "localhost" /**< Address of Redis server */
-#define REDIS_PORT 6379        /**< port of Redis server */
+#define REDIS_HOST "localhost"    /**< Address of Redis server */
+#define REDIS_PORT 6379           /**< port of Redis server */
+#define CONFIRMED_SET_SIZE 100000 /**< Confirmed transactions kept in memory */
 /** @} */
 
 /** struct type of accelerator configuration */
 typedef struct ta_info_s {
-  char* version;        /**< Binding version of tangle-accelerator */
-  char* host;           /**< Binding address of tangle-accelerator */
-  char* port;           /**< Binding port of tangle-accelerator */
-  uint8_t thread_count; /**< Thread count of tangle-accelerator instance */
+  char* version;                 /**< Binding version of tangle-accelerator */
+  char* host;                    /**< Binding address of tangle-accelerator */
+  char* port;                    /**< Binding port of tangle-accelerator */
+  uint8_t thread_count;          /**< Thread count of tangle-accelerator instance */
+  uint8_t pow_workers;           /**< Number of PoW scheduler workers, 0 to do PoW in the request thread */
+  uint16_t pow_queue_size;       /**< Maximum number of admitted PoW requests, 0 for unlimited */
+  uint32_t pow_sla;              /**< Maximum estimated PoW wait in milliseconds, 0 for unlimited */
+  uint16_t broadcast_window;     /**< Window to coalesce broadcasts in milliseconds, 0 to disable */
+  uint16_t broadcast_batch_size; /**< Number of transactions which flushes a broadcast batch early */
+  bool http_thread_pool;         /**< Serve HTTP with an epoll pool of `thread_count` threads, needs `pow_workers` */
+  uint32_t http_conn_limit;      /**< Maximum concurrent HTTP connections, 0 for the libmicrohttpd default */
+  uint32_t http_conn_memory;     /**< Memory limit of each HTTP connection in bytes, 0 for the libmicrohttpd default */
+  uint16_t http_conn_timeout;    /**< Idle timeout of HTTP connections in seconds, 0 for no timeout */
+  uint32_t http_max_body;        /**< Maximum size of HTTP request bodies in bytes */
+  uint8_t batch_workers;         /**< Workers running batch sub-requests, 0 to run them in the request thread */
+  uint8_t iri_pool_size;         /**< IRI connections to each node checked out by the requests, 0 to share one */
+  char* iri_nodes;               /**< Other IRI full nodes as host:port separated by commas, NULL for none */
+  uint32_t iri_milestone_lag;    /**< Milestones an IRI node may lag behind before it is taken out of rotation */
+  uint8_t iri_hedge_budget;      /**< Percentage of IRI read calls which may be hedged on another node, 0 for none */
+  uint8_t iri_breaker_rate;      /**< Percentage of failed or slow IRI calls tripping a node breaker, 0 for none */
+  uint32_t iri_breaker_latency;  /**< Milliseconds after which an IRI call counts as failed, 0 for no limit */
+  uint32_t iri_breaker_cooldown; /**< Milliseconds a tripped IRI node breaker fails calls fast before a probe */
 #ifdef ENABLE_MQTT
   char* mqtt_host;       /**< Address of MQTT broker host */
   char* mqtt_topic_root; /**< The topic root of MQTT topic */
@@ -77,9 +117,10 @@ typedef struct ta_config_s {
 
 /** struct type of accelerator cache */
 typedef struct ta_cache_s {
-  bool cache_state; /** set it true to turn on cache server */
-  char* host;       /**< Binding address of redis server */
-  uint16_t port;    /**< Binding port of redis server */
+  bool cache_state;            /** set it true to turn on cache server */
+  char* host;                  /**< Binding address of redis server */
+  uint16_t port;               /**< Binding port of redis server */
+  uint32_t confirmed_set_size; /**< Confirmed transactions kept in memory, 0 to keep them in redis only */
 } ta_cache_t;
 
 /** struct type of accelerator core */
@@ -148,6 +189,7 @@ status_t ta_config_cli_init(ta_core_t* const ta_conf, int argc, char** argv);
 /**
  * Start services after configurations are set
  *
+ * @param info[in] Tangle-accelerator configuration variables
  * @param cache[in] Redis server configuration variables
  * @param service[in] IRI connection configuration variables
  *
@@ -155,7 +197,7 @@ status_t ta_config_cli_init(ta_core_t* const ta_conf, int argc, char** argv);
  * - SC_OK on success
  * - non-zero on error
  */
-status_t ta_config_set(ta_cache_t* const cache, iota_client_service_t* const service);
+status_t ta_config_set(ta_config_t* const info, ta_cache_t* const cache, iota_client_service_t* const service);
 
 /**
  * Free memory of configuration variables
@@ -32,7 +32,7 @@ int main(int argc, char *argv[]) {
     return EXIT_FAILURE;
   }
 
-  if (ta_config_set(&ta_core.cache, &ta_core.service) != SC_OK) {
+  if (ta_config_set(&ta_core.info, &ta_core.cache, &ta_core.service) != SC_OK) {
     ta_log_critical("Configure failed %s.\n", CONN_MQTT_LOGGER);
     return EXIT_FAILURE;
   }
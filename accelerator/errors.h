@@ -115,6 +115,10 @@ typedef enum {
   SC_HTTP_NOT_FOUND = 404,   /**< HTTP request not found */
   SC_HTTP_INTERNAL_SERVICE_ERROR = 500,
   /**< HTTP response, other errors in TA */
+  SC_HTTP_NOT_IMPLEMENTED = 501,
+  /**< HTTP response, the request needs a feature TA runs without */
+  SC_HTTP_SERVICE_UNAVAILABLE = 503,
+  /**< HTTP response, TA is too busy to take the request */
 
   SC_TA_OOM = 0x01 | SC_MODULE_TA | SC_SEVERITY_FATAL,
   /**< Fail to create TA object */
@@ -122,6 +126,8 @@ typedef enum {
   /**< NULL TA objects */
   SC_TA_WRONG_REQUEST_OBJ = 0x03 | SC_MODULE_TA | SC_SEVERITY_FATAL,
   /**< wrong TA request object */
+  SC_TA_PAGING_OFF = 0x04 | SC_MODULE_TA | SC_SEVERITY_MAJOR,
+  /**< Pages need the cache to keep the order of the results */
 
   // CClient module
   SC_CCLIENT_OOM = 0x01 | SC_MODULE_CCLIENT | SC_SEVERITY_FATAL,
@@ -142,6 +148,8 @@ typedef enum {
   /**< Flex trits converting error */
   SC_CCLIENT_JSON_CREATE = 0x0A | SC_MODULE_CCLIENT | SC_SEVERITY_MAJOR,
   /**< json create object error, might OOM. */
+  SC_CCLIENT_IRI_UNAVAILABLE = 0x0B | SC_MODULE_CCLIENT | SC_SEVERITY_MAJOR,
+  /**< IRI node is failing, its calls fail fast until it recovers */
 
   // Serializer module
   SC_SERIALIZER_JSON_CREATE = 0x01 | SC_MODULE_SERIALIZER | SC_SEVERITY_FATAL,
@@ -154,6 +162,8 @@ typedef enum {
   /**< unicode value in JSON */
   SC_SERIALIZER_INVALID_REQ = 0x05 | SC_MODULE_SERIALIZER | SC_SEVERITY_FATAL,
   /**< invald request value in JSON */
+  SC_SERIALIZER_OOM = 0x06 | SC_MODULE_SERIALIZER | SC_SEVERITY_FATAL,
+  /**< Fail to grow the JSON output buffer */
 
   // Cache module
   SC_CACHE_NULL = 0x01 | SC_MODULE_CACHE | SC_SEVERITY_FATAL,
@@ -162,6 +172,8 @@ typedef enum {
   /**< Fail in cache operations */
   SC_CACHE_OFF = 0x03 | SC_MODULE_CACHE | SC_SEVERITY_MINOR,
   /**< Cache server doesn't turn on */
+  SC_CACHE_OOM = 0x04 | SC_MODULE_CACHE | SC_SEVERITY_FATAL,
+  /**< Fail to create the arguments of a cache command */
 
   // MAM module
   SC_MAM_OOM = 0x01 | SC_MODULE_MAM | SC_SEVERITY_FATAL,
@@ -204,23 +216,37 @@ typedef enum {
   /**< fail to initialize yaml parser */
   SC_CONF_FOPEN_ERROR = 0x07 | SC_MODULE_CONF | SC_SEVERITY_FATAL,
   /**< fail to open file */
+  SC_CONF_OUT_OF_RANGE = 0x08 | SC_MODULE_CONF | SC_SEVERITY_FATAL,
+  /**< option value out of range */
 
   // UTILS module
   SC_UTILS_NULL = 0x01 | SC_MODULE_UTILS | SC_SEVERITY_FATAL,
   SC_UTILS_WRONG_REQUEST_OBJ = 0x02 | SC_MODULE_UTILS | SC_SEVERITY_FATAL,
   /**< wrong TA request object */
+  SC_UTILS_THREAD_CREATE = 0x03 | SC_MODULE_UTILS | SC_SEVERITY_FATAL,
+  /**< Fail to create worker thread */
+  SC_UTILS_POW_SCHEDULER_STOPPED = 0x04 | SC_MODULE_UTILS | SC_SEVERITY_MAJOR,
+  /**< PoW scheduler stopped before the bundle was done */
+  SC_UTILS_POW_OVERLOADED = 0x05 | SC_MODULE_UTILS | SC_SEVERITY_MINOR,
+  /**< PoW queue is full or the estimated wait exceeds the SLA */
+  SC_UTILS_OOM = 0x06 | SC_MODULE_UTILS | SC_SEVERITY_FATAL,
+  /**< Fail to allocate memory in utils */
 
   // HTTP module
   SC_HTTP_OOM = 0x01 | SC_MODULE_HTTP | SC_SEVERITY_FATAL,
   /**< Fail to create http object */
   SC_HTTP_NULL = 0x02 | SC_MODULE_HTTP | SC_SEVERITY_FATAL,
   /**< NULL object in http */
-  SC_HTTP_INVALID_REGEX = 0x03 | SC_MODULE_HTTP | SC_SEVERITY_MAJOR,
-  /**< Invalid URL regular expression rule in http */
+  SC_HTTP_INVALID_ROUTE = 0x03 | SC_MODULE_HTTP | SC_SEVERITY_MAJOR,
+  /**< Invalid or duplicated route pattern in http */
   SC_HTTP_URL_NOT_MATCH = 0x04 | SC_MODULE_HTTP | SC_SEVERITY_MAJOR,
-  /**< URL doesn't match regular expression rule */
+  /**< URL doesn't match any route */
   SC_HTTP_URL_PARSE_ERROR = 0x05 | SC_MODULE_HTTP | SC_SEVERITY_MAJOR,
   /**< URL parameter parsing error */
+  SC_HTTP_BODY_TOO_LARGE = 0x06 | SC_MODULE_HTTP | SC_SEVERITY_MAJOR,
+  /**< Request body exceeds the size limit */
+  SC_HTTP_THREAD_POOL_POW_OFF = 0x07 | SC_MODULE_HTTP | SC_SEVERITY_FATAL,
+  /**< HTTP thread pool asked for while the PoW scheduler is off */
 
   // MQTT module
   SC_MQTT_OOM = 0x01 | SC_MODULE_MQTT | SC_SEVERITY_FATAL,
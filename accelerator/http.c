@@ -1,21 +1,40 @@
 #include <arpa/inet.h>
 #include <microhttpd.h>
-#include <regex.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <time.h>
 
 #include "accelerator/http.h"
-#include "cJSON.h"
+#include "serializer/json_tokenizer.h"
 
 #define HTTP_LOGGER "http"
+#define HTTP_BODY_INITIAL_SIZE 1024
+/** Largest body buffer allocated from Content-Length before the body arrives, larger ones grow with the data */
+#define HTTP_BODY_RESERVE_MAX (16 * 1024)
+/** Size of the buffer libmicrohttpd fills from a streamed response at a time */
+#define HTTP_STREAM_BLOCK_SIZE (32 * 1024)
 
 static logger_id_t logger_id;
 
 typedef struct ta_http_request_s {
   bool valid_content_type;
-  char *request;
+  status_t status;        /**< Error found while receiving the body, whose remaining chunks are then discarded */
+  char *request;          /**< Body of the request, NUL terminated */
+  size_t len;             /**< Length of the body */
+  size_t capacity;        /**< Size of the `request` buffer */
+  json_scanner_t scanner; /**< Structure of the body received so far */
 } ta_http_request_t;
 
+/** A response sent with chunked transfer encoding, one page of transaction objects at a time */
+typedef struct ta_http_stream_s {
+  ta_txn_stream_t txns;
+  uint32_t fields; /**< Members of the transaction objects, as a mask of ta_txn_field_t */
+  char *chunk;     /**< Serialized page being sent */
+  size_t len;      /**< Length of `chunk` */
+  size_t pos;      /**< Bytes of `chunk` already sent */
+} ta_http_stream_t;
+
 void http_logger_init() { logger_id = logger_helper_enable(HTTP_LOGGER, LOGGER_DEBUG, true); }
 
 int http_logger_release() {
@@ -28,224 +47,561 @@ int http_logger_release() {
   return 0;
 }
 
-static status_t ta_http_url_matcher(char const *const url, char *const regex_rule) {
-  if (regex_rule == NULL) {
-    ta_log_error("%s\n", "SC_HTTP_NULL");
-    return SC_HTTP_NULL;
-  }
-  regex_t reg;
-  status_t ret = SC_OK;
-  int reg_flag = REG_EXTENDED | REG_NOSUB;
-
-  if (regcomp(&reg, regex_rule, reg_flag) != 0) {
-    ta_log_error("%s\n", "SC_HTTP_INVALID_REGEX");
-    return SC_HTTP_INVALID_REGEX;
+typedef enum ta_http_route_e {
+  TA_HTTP_ROUTE_GENERATE_ADDRESS,
+  TA_HTTP_ROUTE_FIND_TXN_HASH,
+  TA_HTTP_ROUTE_FIND_TXN_OBJ,
+  TA_HTTP_ROUTE_GET_TIPS_PAIR,
+  TA_HTTP_ROUTE_GET_TIPS,
+  TA_HTTP_ROUTE_SEND_TRANSFER,
+  TA_HTTP_ROUTE_RECV_MAM_MSG,
+  TA_HTTP_ROUTE_MAM_SEND_MSG,
+  TA_HTTP_ROUTE_SEND_TRYTES,
+  TA_HTTP_ROUTE_FIND_TXN_BY_TAG,
+  TA_HTTP_ROUTE_FIND_TXN_OBJ_BY_TAG,
+  TA_HTTP_ROUTE_FIND_TXN_OBJ_BY_ADDR,
+  TA_HTTP_ROUTE_FIND_TXN_OBJ_BY_BUNDLE,
+  TA_HTTP_ROUTE_BATCH,
+  TA_HTTP_ROUTE_FIND_HASHES,
+  TA_HTTP_ROUTE_FIND_OBJ,
+  TA_HTTP_ROUTE_FIND_TXN_BY_ADDR,
+  TA_HTTP_ROUTE_PROXY,
+  TA_HTTP_ROUTE_NUM
+} ta_http_route_t;
+
+// Routes of the API, registered into the route table of `ta_http_init()`
+static const struct {
+  char const *pattern;
+  bool post; /**< Whether the route needs a request body */
+  bool iri;  /**< Whether the route is handed an IRI connection, the PoW routes check theirs out around each call */
+} ta_http_routes[TA_HTTP_ROUTE_NUM] = {
+    [TA_HTTP_ROUTE_GENERATE_ADDRESS] = {"/address", false, true},
+    [TA_HTTP_ROUTE_FIND_TXN_HASH] = {"/transaction/hash", true, true},
+    [TA_HTTP_ROUTE_FIND_TXN_OBJ] = {"/transaction/object", true, true},
+    [TA_HTTP_ROUTE_GET_TIPS_PAIR] = {"/tips/pair", false, true},
+    [TA_HTTP_ROUTE_GET_TIPS] = {"/tips", false, true},
+    [TA_HTTP_ROUTE_SEND_TRANSFER] = {"/transaction", true, false},
+    [TA_HTTP_ROUTE_RECV_MAM_MSG] = {"/mam/{hash}", false, true},
+    [TA_HTTP_ROUTE_MAM_SEND_MSG] = {"/mam", true, false},
+    [TA_HTTP_ROUTE_SEND_TRYTES] = {"/tryte", true, false},
+    [TA_HTTP_ROUTE_FIND_TXN_BY_TAG] = {"/tag/{tag}/hashes", false, true},
+    [TA_HTTP_ROUTE_FIND_TXN_OBJ_BY_TAG] = {"/tag/{tag}", false, true},
+    [TA_HTTP_ROUTE_FIND_TXN_OBJ_BY_ADDR] = {"/address/{hash}", false, true},
+    [TA_HTTP_ROUTE_FIND_TXN_OBJ_BY_BUNDLE] = {"/bundle/{hash}", false, true},
+    [TA_HTTP_ROUTE_BATCH] = {"/batch", true, true},
+    [TA_HTTP_ROUTE_FIND_HASHES] = {"/find/hashes", true, true},
+    [TA_HTTP_ROUTE_FIND_OBJ] = {"/find/object", true, true},
+    [TA_HTTP_ROUTE_FIND_TXN_BY_ADDR] = {"/address/{hash}/hashes", false, true},
+    [TA_HTTP_ROUTE_PROXY] = {"/", true, true},
+};
+
+static status_t ta_http_request_reserve(ta_http_request_t *const req, const size_t capacity) {
+  if (capacity <= req->capacity) {
+    return SC_OK;
   }
-  if (regexec(&reg, url, 0, NULL, 0) != 0) {
-    // Did not match pattern
-    ta_log_error("%s\n", "SC_HTTP_URL_NOT_MATCH");
-    ret = SC_HTTP_URL_NOT_MATCH;
+  char *request = (char *)realloc(req->request, capacity);
+  if (request == NULL) {
+    ta_log_error("%s\n", "SC_HTTP_OOM");
+    return SC_HTTP_OOM;
   }
-
-  regfree(&reg);
-  return ret;
+  req->request = request;
+  req->capacity = capacity;
+  return SC_OK;
 }
 
-static status_t ta_get_url_parameter(char const *const url, int index, char **param) {
-  if (param == NULL) {
-    ta_log_error("%s\n", "SC_HTTP_NULL");
-    return SC_HTTP_NULL;
-  }
-  if (index < 0) {
-    index = 0;
+static status_t ta_http_request_append(ta_http_request_t *const req, char const *const data, const size_t size,
+                                       const size_t max_size) {
+  if (size > max_size - req->len) {
+    ta_log_error("%s\n", "SC_HTTP_BODY_TOO_LARGE");
+    return SC_HTTP_BODY_TOO_LARGE;
   }
-
-  // Copy url for parsing
-  int url_len = strlen(url) + 1;
-  char *tmp = NULL;
-  char url_parse[url_len];
-  snprintf(url_parse, url_len, "%s", url);
-
-  // Parse URL with '/' and get parameter
-  tmp = strtok(url_parse, "/");
-  while (index) {
-    --index;
-    tmp = strtok(NULL, "/");
+  if (req->len + size + 1 > req->capacity) {
+    size_t capacity = req->capacity ? req->capacity : HTTP_BODY_INITIAL_SIZE;
+    while (capacity < req->len + size + 1) {
+      capacity *= 2;
+    }
+    status_t ret = ta_http_request_reserve(req, capacity < max_size + 1 ? capacity : max_size + 1);
+    if (ret != SC_OK) {
+      return ret;
+    }
   }
-  if (tmp == NULL) {
-    ta_log_error("%s\n", "SC_HTTP_URL_PARSE_ERROR");
-    return SC_HTTP_URL_PARSE_ERROR;
+  memcpy(req->request + req->len, data, size);
+  req->len += size;
+  req->request[req->len] = '\0';
+
+  // Each chunk is scanned as it arrives, so a malformed body is rejected without waiting for the rest of it
+  if (json_scanner_feed(&req->scanner, data, size) != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
   }
-
-  // Copy found parameter
-  int token_len = strlen(tmp);
-  *param = (char *)malloc(token_len * sizeof(char));
-  if (param == NULL) {
-    ta_log_error("%s\n", "SC_HTTP_OOM");
-    return SC_HTTP_OOM;
-  }
-  strncpy(*param, tmp, token_len);
   return SC_OK;
 }
 
+typedef enum ta_http_body_e {
+  TA_HTTP_BODY_NOT_FOUND,
+  TA_HTTP_BODY_INVALID_HEADER,
+  TA_HTTP_BODY_INVALID_REQUEST,
+  TA_HTTP_BODY_TOO_LARGE,
+  TA_HTTP_BODY_BUSY,
+  TA_HTTP_BODY_IRI_UNAVAILABLE,
+  TA_HTTP_BODY_PAGING_OFF,
+  TA_HTTP_BODY_INTERNAL_ERROR,
+  TA_HTTP_BODY_INVALID_PATH,
+  TA_HTTP_BODY_METHOD_NOT_ALLOWED,
+  TA_HTTP_BODY_OPTIONS,
+  TA_HTTP_BODY_NUM
+} ta_http_body_t;
+
+// Bodies of the error and OPTIONS responses, handed to libmicrohttpd without copy. They are kept in one array so
+// `ta_http_is_static_body()` tells them apart from the allocated results of the APIs.
+static char const ta_http_static_bodies[TA_HTTP_BODY_NUM][48] = {
+    [TA_HTTP_BODY_NOT_FOUND] = "{\"message\":\"Request not found\"}",
+    [TA_HTTP_BODY_INVALID_HEADER] = "{\"message\":\"Invalid request header\"}",
+    [TA_HTTP_BODY_INVALID_REQUEST] = "{\"message\":\"Invalid request\"}",
+    [TA_HTTP_BODY_TOO_LARGE] = "{\"message\":\"Request body too large\"}",
+    [TA_HTTP_BODY_BUSY] = "{\"message\":\"Service is busy, retry later\"}",
+    [TA_HTTP_BODY_IRI_UNAVAILABLE] = "{\"message\":\"IRI node unavailable, retry later\"}",
+    [TA_HTTP_BODY_PAGING_OFF] = "{\"message\":\"Paging needs the cache\"}",
+    [TA_HTTP_BODY_INTERNAL_ERROR] = "{\"message\":\"Internal service error\"}",
+    [TA_HTTP_BODY_INVALID_PATH] = "{\"message\":\"Invalid path\"}",
+    [TA_HTTP_BODY_METHOD_NOT_ALLOWED] = "{\"message\":\"Method not allowed\"}",
+    [TA_HTTP_BODY_OPTIONS] = "{\"message\":\"OPTIONS request\"}",
+};
+
+static inline char *ta_http_static_body(const ta_http_body_t body) { return (char *)ta_http_static_bodies[body]; }
+
+static inline bool ta_http_is_static_body(char const *const body) {
+  uintptr_t addr = (uintptr_t)body;
+  return addr >= (uintptr_t)ta_http_static_bodies && addr < (uintptr_t)(ta_http_static_bodies + TA_HTTP_BODY_NUM);
+}
+
 static int set_response_content(status_t ret, char **json_result) {
   int http_ret;
+  ta_http_body_t body;
   if (ret == SC_OK) {
     return MHD_HTTP_OK;
   }
 
-  cJSON *json_obj = cJSON_CreateObject();
   switch (ret) {
     case SC_CCLIENT_NOT_FOUND:
     case SC_MAM_NOT_FOUND:
       http_ret = MHD_HTTP_NOT_FOUND;
       ta_log_error("%s\n", "MHD_HTTP_NOT_FOUND");
-      cJSON_AddStringToObject(json_obj, "message", "Request not found");
+      body = TA_HTTP_BODY_NOT_FOUND;
       break;
     case SC_CCLIENT_JSON_KEY:
     case SC_MAM_NO_PAYLOAD:
       http_ret = MHD_HTTP_BAD_REQUEST;
       ta_log_error("%s\n", "MHD_HTTP_BAD_REQUEST");
-      cJSON_AddStringToObject(json_obj, "message", "Invalid request header");
+      body = TA_HTTP_BODY_INVALID_HEADER;
+      break;
+    case SC_SERIALIZER_INVALID_REQ:
+      http_ret = MHD_HTTP_BAD_REQUEST;
+      ta_log_error("%s\n", "MHD_HTTP_BAD_REQUEST");
+      body = TA_HTTP_BODY_INVALID_REQUEST;
+      break;
+    case SC_HTTP_BODY_TOO_LARGE:
+      http_ret = MHD_HTTP_PAYLOAD_TOO_LARGE;
+      ta_log_error("%s\n", "MHD_HTTP_PAYLOAD_TOO_LARGE");
+      body = TA_HTTP_BODY_TOO_LARGE;
+      break;
+    case SC_UTILS_POW_OVERLOADED:
+      http_ret = MHD_HTTP_SERVICE_UNAVAILABLE;
+      ta_log_error("%s\n", "MHD_HTTP_SERVICE_UNAVAILABLE");
+      body = TA_HTTP_BODY_BUSY;
+      break;
+    case SC_CCLIENT_IRI_UNAVAILABLE:
+      http_ret = MHD_HTTP_SERVICE_UNAVAILABLE;
+      ta_log_error("%s\n", "MHD_HTTP_SERVICE_UNAVAILABLE");
+      body = TA_HTTP_BODY_IRI_UNAVAILABLE;
+      break;
+    case SC_TA_PAGING_OFF:
+      http_ret = MHD_HTTP_NOT_IMPLEMENTED;
+      ta_log_error("%s\n", "MHD_HTTP_NOT_IMPLEMENTED");
+      body = TA_HTTP_BODY_PAGING_OFF;
       break;
     default:
       http_ret = MHD_HTTP_INTERNAL_SERVER_ERROR;
       ta_log_error("%s\n", "MHD_HTTP_INTERNAL_SERVER_ERROR");
-      cJSON_AddStringToObject(json_obj, "message", "Internal service error");
+      body = TA_HTTP_BODY_INTERNAL_ERROR;
       break;
   }
-  *json_result = cJSON_PrintUnformatted(json_obj);
-  cJSON_Delete(json_obj);
+  // A partial result of the API is dropped
+  free(*json_result);
+  *json_result = ta_http_static_body(body);
   return http_ret;
 }
 
-static inline int process_generate_address_request(ta_http_t *const http, char **const out) {
+/**
+ * Seconds a client rejected with 503 should wait before retrying, after the cooldown of the IRI node breakers when IRI
+ * is unavailable and after the estimated PoW wait when the PoW queue is full. 0 for the other responses.
+ */
+static uint32_t ta_http_retry_after(char const *const body) {
+  if (body == ta_http_static_body(TA_HTTP_BODY_IRI_UNAVAILABLE)) {
+    return iri_pool_retry_after();
+  }
+  if (body == ta_http_static_body(TA_HTTP_BODY_BUSY)) {
+    return pow_admission_retry_after();
+  }
+  return 0;
+}
+
+static inline int process_generate_address_request(ta_http_t *const http, iota_client_service_t *const service,
+                                                   char **const out) {
   status_t ret = SC_OK;
-  ret = api_generate_address(&http->core->iconf, &http->core->service, out);
+  ret = api_generate_address(&http->core->iconf, service, out);
   return set_response_content(ret, out);
 }
 
-static inline int process_find_txn_hash_request(ta_http_t *const http, char const *const payload, char **const out) {
+/** Parse the `limit`, `cursor` and `since` arguments of the query string, `paged` is false without any of them */
+static inline status_t ta_http_page_parse(struct MHD_Connection *connection, ta_page_req_t *const page,
+                                          bool *const paged) {
+  return ta_page_req_parse(MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "limit"),
+                           MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "cursor"),
+                           MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "since"), page, paged);
+}
+
+static inline int process_find_txn_hash_request(iota_client_service_t *const service, struct MHD_Connection *connection,
+                                                char const *const payload, char **const out) {
   status_t ret = SC_OK;
-  ret = api_find_transactions(&http->core->service, payload, out);
+  ta_page_req_t page;
+  bool paged = false;
+
+  ret = ta_http_page_parse(connection, &page, &paged);
+  if (ret == SC_OK) {
+    ret = paged ? api_find_transactions_page(service, payload, &page, out)
+                : api_find_transactions(service, payload, out);
+  }
   return set_response_content(ret, out);
 }
 
-static inline int process_find_txn_obj_request(ta_http_t *const http, char const *const payload, char **const out) {
+static inline int process_find_txn_by_tag_request(iota_client_service_t *const service,
+                                                  struct MHD_Connection *connection,
+                                                  http_route_param_t const *const param, char **const out) {
   status_t ret = SC_OK;
-  ret = api_find_transaction_objects(&http->core->service, payload, out);
+  ta_page_req_t page;
+  bool paged = false;
+  char tag[NUM_TRYTES_TAG + 1];
+  memcpy(tag, param->value, param->len);
+  tag[param->len] = '\0';
+
+  ret = ta_http_page_parse(connection, &page, &paged);
+  if (ret == SC_OK) {
+    ret = paged ? api_find_transactions_by_tag_page(service, tag, &page, out)
+                : api_find_transactions_by_tag(service, tag, out);
+  }
   return set_response_content(ret, out);
 }
 
-static inline int process_get_tips_pair_request(ta_http_t *const http, char **const out) {
+static inline int process_find_hashes_request(iota_client_service_t *const service, struct MHD_Connection *connection,
+                                              char const *const payload, char **const out) {
   status_t ret = SC_OK;
-  ret = api_get_tips_pair(&http->core->iconf, &http->core->service, out);
+  ta_page_req_t page;
+  bool paged = false;
+
+  ret = ta_http_page_parse(connection, &page, &paged);
+  if (ret == SC_OK) {
+    ret = api_find_transactions_multi(service, payload, paged ? &page : NULL, out);
+  }
   return set_response_content(ret, out);
 }
 
-static inline int process_get_tips_request(ta_http_t *const http, char **const out) {
+static inline int process_find_obj_request(iota_client_service_t *const service, struct MHD_Connection *connection,
+                                           char const *const payload, char **const out, size_t *const out_len) {
   status_t ret = SC_OK;
-  ret = api_get_tips(&http->core->service, out);
+  size_t len = 0;
+  ta_page_req_t page;
+  bool paged = false;
+  ta_txn_serialize_opt_t opt = {.format = ta_response_format_from_accept(
+                                    MHD_lookup_connection_value(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_ACCEPT))};
+
+  ret = ta_http_page_parse(connection, &page, &paged);
+  if (ret == SC_OK) {
+    ret = ta_txn_fields_parse(MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "fields"), &opt.fields);
+  }
+  if (ret == SC_OK) {
+    ret = api_find_transactions_obj_multi(service, payload, paged ? &page : NULL, &opt, out, &len);
+  }
+  // Only binary results report their length, errors are always JSON
+  if (ret == SC_OK && opt.format != TA_RESPONSE_FORMAT_JSON) {
+    *out_len = len;
+  }
   return set_response_content(ret, out);
 }
 
-static inline int process_send_transfer_request(ta_http_t *const http, char const *const payload, char **const out) {
+static inline int process_find_txn_by_addr_request(iota_client_service_t *const service,
+                                                   struct MHD_Connection *connection,
+                                                   http_route_param_t const *const param, char **const out) {
   status_t ret = SC_OK;
-  ret = api_send_transfer(&http->core->iconf, &http->core->service, payload, out);
+  ta_page_req_t page;
+  bool paged = false;
+  char address[NUM_TRYTES_HASH + 1];
+  memcpy(address, param->value, param->len);
+  address[param->len] = '\0';
+
+  ret = ta_http_page_parse(connection, &page, &paged);
+  if (ret == SC_OK) {
+    ret = api_find_transactions_by_addr(service, address, paged ? &page : NULL, out);
+  }
   return set_response_content(ret, out);
 }
 
-static inline int process_recv_mam_msg_request(ta_http_t *const http, char const *const url, char **const out) {
+static inline int process_find_txn_obj_request(iota_client_service_t *const service, struct MHD_Connection *connection,
+                                               char const *const payload, char **const out, size_t *const out_len) {
   status_t ret = SC_OK;
-  char *bundle = NULL;
-  ret = ta_get_url_parameter(url, 1, &bundle);
+  size_t len = 0;
+  // Transaction objects are encoded in CBOR instead of JSON if the client accepts it
+  ta_txn_serialize_opt_t opt = {.format = ta_response_format_from_accept(
+                                    MHD_lookup_connection_value(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_ACCEPT))};
+
+  ret = ta_txn_fields_parse(MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "fields"), &opt.fields);
   if (ret == SC_OK) {
-    ret = api_receive_mam_message(&http->core->iconf, &http->core->service, bundle, out);
+    ret = api_find_transaction_objects(service, payload, &opt, out, &len);
+  }
+  // Only binary results report their length, errors are always JSON
+  if (ret == SC_OK && opt.format != TA_RESPONSE_FORMAT_JSON) {
+    *out_len = len;
   }
   return set_response_content(ret, out);
 }
 
+static inline int process_get_tips_pair_request(ta_http_t *const http, iota_client_service_t *const service,
+                                                char **const out) {
+  status_t ret = SC_OK;
+  ret = api_get_tips_pair(&http->core->iconf, service, out);
+  return set_response_content(ret, out);
+}
+
+static inline int process_get_tips_request(iota_client_service_t *const service, char **const out) {
+  status_t ret = SC_OK;
+  ret = api_get_tips(service, out);
+  return set_response_content(ret, out);
+}
+
+static inline int process_send_transfer_request(ta_http_t *const http, char const *const payload, char **const out) {
+  status_t ret = SC_OK;
+  ret = api_send_transfer(&http->core->iconf, payload, out);
+  return set_response_content(ret, out);
+}
+
+static inline int process_recv_mam_msg_request(ta_http_t *const http, iota_client_service_t *const service,
+                                               http_route_param_t const *const param, char **const out) {
+  status_t ret = SC_OK;
+  char bundle[NUM_TRYTES_HASH + 1];
+  // The route only matches a parameter of 81 trytes
+  memcpy(bundle, param->value, NUM_TRYTES_HASH);
+  bundle[NUM_TRYTES_HASH] = '\0';
+  ret = api_receive_mam_message(&http->core->iconf, service, bundle, out);
+  return set_response_content(ret, out);
+}
+
 static inline int process_mam_send_msg_request(ta_http_t *const http, char const *const payload, char **const out) {
   status_t ret = SC_OK;
-  ret = api_mam_send_message(&http->core->iconf, &http->core->service, payload, out);
+  ret = api_mam_send_message(&http->core->iconf, payload, out);
   return set_response_content(ret, out);
 }
 
 static inline int process_send_trytes_request(ta_http_t *const http, char const *const payload, char **const out) {
   status_t ret = SC_OK;
-  ret = api_send_trytes(&http->core->iconf, &http->core->service, payload, out);
+  ret = api_send_trytes(&http->core->iconf, payload, out);
+  return set_response_content(ret, out);
+}
+
+static inline int process_batch_request(ta_http_t *const http, iota_client_service_t *const service,
+                                        char const *const payload, char **const out) {
+  status_t ret = SC_OK;
+  ret = api_batch(&http->core->iconf, service, payload, out);
+  return set_response_content(ret, out);
+}
+
+static inline int process_proxy_request(iota_client_service_t *const service, char const *const payload,
+                                        char **const out) {
+  status_t ret = SC_OK;
+  ret = proxy_api_wrapper(service, payload, out);
+  return set_response_content(ret, out);
+}
+
+static ssize_t ta_http_stream_read(void *cls, uint64_t pos, char *buf, size_t max) {
+  ta_http_stream_t *stream = cls;
+
+  // Pages are fetched only once the previous one was sent, so one page at most is held per connection
+  while (stream->pos == stream->len) {
+    free(stream->chunk);
+    stream->chunk = NULL;
+    stream->len = stream->pos = 0;
+    if (stream->txns.done) {
+      return MHD_CONTENT_READER_END_OF_STREAM;
+    }
+    iota_client_service_t *service = iri_pool_acquire();
+    status_t ret = api_txn_stream_read(service, &stream->txns, stream->fields, &stream->chunk, &stream->len);
+    iri_pool_release(service);
+    if (ret != SC_OK) {
+      // The status line is already sent, closing the connection before the last chunk tells the client it failed
+      ta_log_error("%s\n", "MHD_CONTENT_READER_END_WITH_ERROR");
+      return MHD_CONTENT_READER_END_WITH_ERROR;
+    }
+  }
+
+  size_t size = stream->len - stream->pos < max ? stream->len - stream->pos : max;
+  memcpy(buf, stream->chunk + stream->pos, size);
+  stream->pos += size;
+  return size;
+}
+
+static void ta_http_stream_free(void *cls) {
+  ta_http_stream_t *stream = cls;
+  api_txn_stream_free(&stream->txns);
+  free(stream->chunk);
+  free(stream);
+}
+
+static inline int process_txn_stream_request(iota_client_service_t *const service, struct MHD_Connection *connection,
+                                             const ta_txn_query_t query, http_route_param_t const *const param,
+                                             char **const out, ta_http_stream_t **const stream) {
+  status_t ret = SC_OK;
+  char obj[NUM_TRYTES_HASH + 1];
+  // The routes only match a tag or a hash, which fit in `obj`
+  memcpy(obj, param->value, param->len);
+  obj[param->len] = '\0';
+
+  ta_http_stream_t *txn_stream = calloc(1, sizeof(ta_http_stream_t));
+  if (txn_stream == NULL) {
+    ret = SC_HTTP_OOM;
+    ta_log_error("%s\n", "SC_HTTP_OOM");
+    return set_response_content(ret, out);
+  }
+  ret = ta_txn_fields_parse(MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "fields"),
+                            &txn_stream->fields);
+  if (ret == SC_OK) {
+    // Errors found before the first page get a status code, the transaction objects are fetched while sending
+    ret = api_txn_stream_open(service, query, obj, &txn_stream->txns);
+    if (ret == SC_OK) {
+      *stream = txn_stream;
+      return MHD_HTTP_OK;
+    }
+  }
+  free(txn_stream);
+  return set_response_content(ret, out);
+}
+
+/**
+ * Transaction objects of a tag, one page of them if the query string asks for it, otherwise all of them streamed
+ */
+static inline int process_find_txn_obj_by_tag_request(iota_client_service_t *const service,
+                                                      struct MHD_Connection *connection,
+                                                      http_route_param_t const *const param, char **const out,
+                                                      size_t *const out_len, ta_http_stream_t **const stream) {
+  status_t ret = SC_OK;
+  size_t len = 0;
+  ta_page_req_t page;
+  bool paged = false;
+  char tag[NUM_TRYTES_TAG + 1];
+  ta_txn_serialize_opt_t opt = {.format = ta_response_format_from_accept(
+                                    MHD_lookup_connection_value(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_ACCEPT))};
+
+  ret = ta_http_page_parse(connection, &page, &paged);
+  // Only the JSON array is streamed, CBOR results are buffered like on the served front end
+  if (ret == SC_OK && !paged && opt.format == TA_RESPONSE_FORMAT_JSON) {
+    return process_txn_stream_request(service, connection, TA_TXN_QUERY_TAG, param, out, stream);
+  }
+
+  memcpy(tag, param->value, param->len);
+  tag[param->len] = '\0';
+  if (ret == SC_OK) {
+    ret = ta_txn_fields_parse(MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "fields"), &opt.fields);
+  }
+  if (ret == SC_OK) {
+    ret = paged ? api_find_transactions_obj_by_tag_page(service, tag, &page, &opt, out, &len)
+                : api_find_transactions_obj_by_tag(service, tag, &opt, out, &len);
+  }
+  // Only binary results report their length, errors are always JSON
+  if (ret == SC_OK && opt.format != TA_RESPONSE_FORMAT_JSON) {
+    *out_len = len;
+  }
   return set_response_content(ret, out);
 }
 
 static inline int process_invalid_path_request(char **const out) {
-  cJSON *json_obj = cJSON_CreateObject();
-  cJSON_AddStringToObject(json_obj, "message", "Invalid path");
-  *out = cJSON_PrintUnformatted(json_obj);
+  *out = ta_http_static_body(TA_HTTP_BODY_INVALID_PATH);
   return MHD_HTTP_BAD_REQUEST;
 }
 
 static inline int process_method_not_allowed_request(char **const out) {
-  cJSON *json_obj = cJSON_CreateObject();
-  cJSON_AddStringToObject(json_obj, "message", "Method not allowed");
-  *out = cJSON_PrintUnformatted(json_obj);
+  *out = ta_http_static_body(TA_HTTP_BODY_METHOD_NOT_ALLOWED);
   return MHD_HTTP_METHOD_NOT_ALLOWED;
 }
 
 static inline int process_options_request(char **const out) {
-  cJSON *json_obj = cJSON_CreateObject();
-  cJSON_AddStringToObject(json_obj, "message", "OPTIONS request");
-  *out = cJSON_PrintUnformatted(json_obj);
+  *out = ta_http_static_body(TA_HTTP_BODY_OPTIONS);
   return MHD_HTTP_OK;
 }
 
-static int ta_http_process_request(ta_http_t *const http, char const *const url, char const *const payload,
-                                   char **const out, int options) {
+static int ta_http_route_request(ta_http_t *const http, iota_client_service_t *const service,
+                                 struct MHD_Connection *connection, http_route_match_t const *const match,
+                                 char const *const payload, char **const out, size_t *const out_len,
+                                 ta_http_stream_t **const stream) {
+  switch ((ta_http_route_t)match->route) {
+    case TA_HTTP_ROUTE_GENERATE_ADDRESS:
+      return process_generate_address_request(http, service, out);
+    case TA_HTTP_ROUTE_FIND_TXN_HASH:
+      return process_find_txn_hash_request(service, connection, payload, out);
+    case TA_HTTP_ROUTE_FIND_TXN_OBJ:
+      return process_find_txn_obj_request(service, connection, payload, out, out_len);
+    case TA_HTTP_ROUTE_GET_TIPS_PAIR:
+      return process_get_tips_pair_request(http, service, out);
+    case TA_HTTP_ROUTE_GET_TIPS:
+      return process_get_tips_request(service, out);
+    case TA_HTTP_ROUTE_SEND_TRANSFER:
+      return process_send_transfer_request(http, payload, out);
+    case TA_HTTP_ROUTE_RECV_MAM_MSG:
+      return process_recv_mam_msg_request(http, service, &match->params[0], out);
+    case TA_HTTP_ROUTE_MAM_SEND_MSG:
+      return process_mam_send_msg_request(http, payload, out);
+    case TA_HTTP_ROUTE_SEND_TRYTES:
+      return process_send_trytes_request(http, payload, out);
+    case TA_HTTP_ROUTE_FIND_TXN_BY_TAG:
+      return process_find_txn_by_tag_request(service, connection, &match->params[0], out);
+    case TA_HTTP_ROUTE_FIND_TXN_OBJ_BY_TAG:
+      return process_find_txn_obj_by_tag_request(service, connection, &match->params[0], out, out_len, stream);
+    case TA_HTTP_ROUTE_FIND_TXN_OBJ_BY_ADDR:
+      return process_txn_stream_request(service, connection, TA_TXN_QUERY_ADDRESS, &match->params[0], out, stream);
+    case TA_HTTP_ROUTE_FIND_TXN_OBJ_BY_BUNDLE:
+      return process_txn_stream_request(service, connection, TA_TXN_QUERY_BUNDLE, &match->params[0], out, stream);
+    case TA_HTTP_ROUTE_BATCH:
+      return process_batch_request(http, service, payload, out);
+    case TA_HTTP_ROUTE_FIND_HASHES:
+      return process_find_hashes_request(service, connection, payload, out);
+    case TA_HTTP_ROUTE_FIND_OBJ:
+      return process_find_obj_request(service, connection, payload, out, out_len);
+    case TA_HTTP_ROUTE_FIND_TXN_BY_ADDR:
+      return process_find_txn_by_addr_request(service, connection, &match->params[0], out);
+    case TA_HTTP_ROUTE_PROXY:
+      return process_proxy_request(service, payload, out);
+    default:
+      return process_invalid_path_request(out);
+  }
+}
+
+static int ta_http_process_request(ta_http_t *const http, struct MHD_Connection *connection, char const *const url,
+                                   char const *const payload, char **const out, size_t *const out_len,
+                                   ta_http_stream_t **const stream, int options) {
   if (options) {
     return process_options_request(out);
   }
 
-  if (ta_http_url_matcher(url, "/address") == SC_OK) {
-    return process_generate_address_request(http, out);
-  } else if (ta_http_url_matcher(url, "/transaction/hash") == SC_OK) {
-    if (payload != NULL) {
-      return process_find_txn_hash_request(http, payload, out);
-    } else {
-      return process_method_not_allowed_request(out);
-    }
-  } else if (ta_http_url_matcher(url, "/transaction/object") == SC_OK) {
-    if (payload != NULL) {
-      return process_find_txn_obj_request(http, payload, out);
-    } else {
-      return process_method_not_allowed_request(out);
-    }
-  } else if (ta_http_url_matcher(url, "/tips/pair") == SC_OK) {
-    return process_get_tips_pair_request(http, out);
-  } else if (ta_http_url_matcher(url, "/tips") == SC_OK) {
-    return process_get_tips_request(http, out);
-  } else if (ta_http_url_matcher(url, "/transaction") == SC_OK) {
-    if (payload != NULL) {
-      return process_send_transfer_request(http, payload, out);
-    } else {
-      return process_method_not_allowed_request(out);
-    }
-  } else if (ta_http_url_matcher(url, "/mam/[A-Z9]{81}") == SC_OK) {
-    return process_recv_mam_msg_request(http, url, out);
-  } else if (ta_http_url_matcher(url, "/mam") == SC_OK) {
-    if (payload != NULL) {
-      return process_mam_send_msg_request(http, payload, out);
-    } else {
-      return process_method_not_allowed_request(out);
-    }
-  } else if (ta_http_url_matcher(url, "/tryte") == SC_OK) {
-    if (payload != NULL) {
-      return process_send_trytes_request(http, payload, out);
-    } else {
-      return process_method_not_allowed_request(out);
-    }
-  } else {
+  http_route_match_t match;
+  if (http_router_match(&http->router, url, &match) != SC_OK) {
     return process_invalid_path_request(out);
   }
-  return MHD_HTTP_OK;
+  if (ta_http_routes[match.route].post && payload == NULL) {
+    return process_method_not_allowed_request(out);
+  }
+
+  // The IRI connection is held until the response is ready, a streamed response checks one out for each page
+  iota_client_service_t *service = ta_http_routes[match.route].iri ? iri_pool_acquire() : NULL;
+  int http_ret = ta_http_route_request(http, service, connection, &match, payload, out, out_len, stream);
+  iri_pool_release(service);
+  return http_ret;
 }
 
 static int ta_http_header_iter(void *cls, enum MHD_ValueKind kind, const char *key, const char *value) {
@@ -273,8 +629,11 @@ static int ta_http_handler(void *cls, struct MHD_Connection *connection, const c
   int post = 0, options = 0;
   ta_http_t *api = (ta_http_t *)cls;
   ta_http_request_t *http_req = *ptr;
+  const size_t max_body = api->core->info.http_max_body;
   struct MHD_Response *response = NULL;
   char *response_buf = NULL;
+  size_t response_len = 0;
+  ta_http_stream_t *stream = NULL;
 
   // Only accept POST, GET, OPTIONS
   if (strncmp(method, MHD_HTTP_METHOD_POST, 4) == 0) {
@@ -289,10 +648,26 @@ static int ta_http_handler(void *cls, struct MHD_Connection *connection, const c
   if (http_req == NULL) {
     http_req = calloc(1, sizeof(ta_http_request_t));
     *ptr = http_req;
+    json_scanner_init(&http_req->scanner);
 
     // Only POST request needs to get header information
     if (post) {
       MHD_get_connection_values(connection, MHD_HEADER_KIND, ta_http_header_iter, http_req);
+
+      // Allocate a small body at once when its length is known. The header is not trusted with more, so an idle
+      // connection cannot pin a large buffer before sending any of it.
+      char const *content_length =
+          MHD_lookup_connection_value(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_CONTENT_LENGTH);
+      if (content_length) {
+        unsigned long long body_len = strtoull(content_length, NULL, 10);
+        if (body_len > max_body) {
+          ta_log_error("%s\n", "SC_HTTP_BODY_TOO_LARGE");
+          http_req->status = SC_HTTP_BODY_TOO_LARGE;
+        } else {
+          size_t reserve = body_len < HTTP_BODY_RESERVE_MAX ? body_len + 1 : HTTP_BODY_RESERVE_MAX;
+          http_req->status = ta_http_request_reserve(http_req, reserve);
+        }
+      }
     }
     return MHD_YES;
   }
@@ -304,32 +679,62 @@ static int ta_http_handler(void *cls, struct MHD_Connection *connection, const c
     goto cleanup;
   }
 
-  // While upload_data_size > 0 process upload_data
+  // While upload_data_size > 0 process upload_data, which may come in any number of chunks
   if (*upload_data_size > 0) {
-    if (http_req->request == NULL) {
-      http_req->request = (char *)malloc(*upload_data_size);
-      strncpy(http_req->request, upload_data, *upload_data_size);
-    } else {
-      ret = MHD_NO;
-      ta_log_error("%s\n", "MHD_NO");
-      goto cleanup;
+    if (http_req->status == SC_OK) {
+      http_req->status = ta_http_request_append(http_req, upload_data, *upload_data_size, max_body);
     }
-
     *upload_data_size = 0;
     return MHD_YES;
   }
 
-  if (post && (http_req->request == NULL)) {
+  if (post && http_req->len == 0 && http_req->status == SC_OK) {
     // POST but no body, so we skip this request
     ret = MHD_NO;
     ta_log_error("%s\n", "MHD_NO");
     goto cleanup;
   }
+  if (post && http_req->status == SC_OK && !json_scanner_complete(&http_req->scanner)) {
+    // The body ended before its top-level object was closed
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    http_req->status = SC_SERIALIZER_INVALID_REQ;
+  }
 
-  /* decide which API function should be called */
-  req_ret = ta_http_process_request(api, url, http_req->request, &response_buf, options);
+  if (http_req->status != SC_OK) {
+    req_ret = set_response_content(http_req->status, &response_buf);
+  } else {
+    /* decide which API function should be called */
+    req_ret = ta_http_process_request(api, connection, url, http_req->request, &response_buf, &response_len, &stream,
+                                      options);
+  }
 
-  response = MHD_create_response_from_buffer(strlen(response_buf), response_buf, MHD_RESPMEM_MUST_COPY);
+  // Binary responses come with their length and are CBOR, the others are JSON
+  bool binary = response_len > 0;
+  uint32_t retry_after = ta_http_retry_after(response_buf);
+  if (stream) {
+    // The length is unknown, so libmicrohttpd sends the pages as chunks and frees the stream once done
+    response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, HTTP_STREAM_BLOCK_SIZE, ta_http_stream_read, stream,
+                                                 ta_http_stream_free);
+    if (response == NULL) {
+      ta_http_stream_free(stream);
+    }
+  } else {
+    if (!binary) {
+      response_len = strlen(response_buf);
+    }
+    // The response takes over the result of the API and frees it once sent, static bodies are used as they are
+    response = MHD_create_response_from_buffer(
+        response_len, response_buf,
+        ta_http_is_static_body(response_buf) ? MHD_RESPMEM_PERSISTENT : MHD_RESPMEM_MUST_FREE);
+    if (response) {
+      response_buf = NULL;
+    }
+  }
+  if (response == NULL) {
+    ret = MHD_NO;
+    ta_log_error("%s\n", "SC_HTTP_OOM");
+    goto cleanup;
+  }
   // Set response header
   MHD_add_response_header(response, MHD_HTTP_HEADER_ACCESS_CONTROL_ALLOW_ORIGIN, "*");
   if (options) {
@@ -338,7 +743,13 @@ static int ta_http_handler(void *cls, struct MHD_Connection *connection, const c
     MHD_add_response_header(response, "Access-Control-Allow-Headers", "Origin, Content-Type, Accept");
     MHD_add_response_header(response, "Access-Control-Max-Age", "86400");
   } else {
-    MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_TYPE, "application/json");
+    MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_TYPE,
+                            binary ? TA_CONTENT_TYPE_CBOR : TA_CONTENT_TYPE_JSON);
+  }
+  if (retry_after) {
+    char retry_after_str[11];
+    snprintf(retry_after_str, sizeof(retry_after_str), "%u", retry_after);
+    MHD_add_response_header(response, MHD_HTTP_HEADER_RETRY_AFTER, retry_after_str);
   }
 
   ret = MHD_queue_response(connection, req_ret, response);
@@ -348,7 +759,9 @@ cleanup:
   // Log of incoming request
   printf(" \"%s %s\" %d\n", method, url, req_ret);
 
-  free(response_buf);
+  if (!ta_http_is_static_body(response_buf)) {
+    free(response_buf);
+  }
   if (http_req) {
     if (http_req->request) {
       free(http_req->request);
@@ -367,6 +780,20 @@ status_t ta_http_init(ta_http_t *const http, ta_core_t *const core) {
 
   http->core = core;
   http->running = false;
+
+  status_t ret = http_router_init(&http->router);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", "SC_HTTP_OOM");
+    return ret;
+  }
+  for (int route = 0; route < TA_HTTP_ROUTE_NUM; route++) {
+    ret = http_router_add(&http->router, ta_http_routes[route].pattern, route);
+    if (ret != SC_OK) {
+      ta_log_error("Adding route %s failed\n", ta_http_routes[route].pattern);
+      http_router_free(&http->router);
+      return ret;
+    }
+  }
   return SC_OK;
 }
 
@@ -376,9 +803,39 @@ status_t ta_http_start(ta_http_t *const http) {
     return SC_HTTP_NULL;
   }
 
-  http->daemon =
-      MHD_start_daemon(MHD_USE_AUTO_INTERNAL_THREAD | MHD_USE_THREAD_PER_CONNECTION | MHD_USE_ERROR_LOG | MHD_USE_DEBUG,
-                       atoi(http->core->info.port), request_log, NULL, ta_http_handler, http, MHD_OPTION_END);
+  ta_config_t const *const info = &http->core->info;
+  unsigned int flags = MHD_USE_ERROR_LOG | MHD_USE_DEBUG;
+  struct MHD_OptionItem options[5];
+  int num_options = 0;
+
+  if (info->http_thread_pool) {
+    // Without the scheduler, the PoW of a bundle would take all the cores from the thread of an epoll set, and every
+    // other connection of that thread would stall until the bundle is attached
+    if (info->pow_workers == 0) {
+      ta_log_error("%s\n", "SC_HTTP_THREAD_POOL_POW_OFF");
+      return SC_HTTP_THREAD_POOL_POW_OFF;
+    }
+    // Connections are multiplexed over a fixed number of threads, each one waiting on its own epoll set. A request
+    // waiting for IRI or for its turn on the PoW workers still holds up the other connections of its thread, so size
+    // `thread_count` accordingly.
+    flags |= MHD_USE_EPOLL_INTERNAL_THREAD;
+    options[num_options++] = (struct MHD_OptionItem){MHD_OPTION_THREAD_POOL_SIZE, info->thread_count, NULL};
+  } else {
+    flags |= MHD_USE_AUTO_INTERNAL_THREAD | MHD_USE_THREAD_PER_CONNECTION;
+  }
+  if (info->http_conn_limit) {
+    options[num_options++] = (struct MHD_OptionItem){MHD_OPTION_CONNECTION_LIMIT, info->http_conn_limit, NULL};
+  }
+  if (info->http_conn_memory) {
+    options[num_options++] = (struct MHD_OptionItem){MHD_OPTION_CONNECTION_MEMORY_LIMIT, info->http_conn_memory, NULL};
+  }
+  if (info->http_conn_timeout) {
+    options[num_options++] = (struct MHD_OptionItem){MHD_OPTION_CONNECTION_TIMEOUT, info->http_conn_timeout, NULL};
+  }
+  options[num_options] = (struct MHD_OptionItem){MHD_OPTION_END, 0, NULL};
+
+  http->daemon = MHD_start_daemon(flags, atoi(info->port), request_log, NULL, ta_http_handler, http, MHD_OPTION_ARRAY,
+                                  options, MHD_OPTION_END);
   if (http->daemon == NULL) {
     ta_log_error("%s\n", "SC_HTTP_OOM");
     return SC_HTTP_OOM;
@@ -395,5 +852,6 @@ status_t ta_http_stop(ta_http_t *const http) {
 
   MHD_stop_daemon(http->daemon);
   http->running = false;
+  http_router_free(&http->router);
   return SC_OK;
 }
@@ -5,6 +5,7 @@
 #include "accelerator/apis.h"
 #include "accelerator/config.h"
 #include "accelerator/errors.h"
+#include "accelerator/http_router.h"
 #include "accelerator/proxy_apis.h"
 
 #ifdef __cplusplus
@@ -15,6 +16,7 @@ typedef struct ta_http_s {
   bool running;
   void *daemon;
   ta_core_t *core;
+  http_router_t router;
 } ta_http_t;
 
 /**
@@ -32,7 +34,7 @@ void http_logger_init();
 int http_logger_release();
 
 /**
- * Initializes an HTTP API
+ * Initializes an HTTP API and builds its route table
  *
  * @param http The HTTP status object
  * @param core An TA config information
@@ -51,7 +53,7 @@ status_t ta_http_init(ta_http_t *const http, ta_core_t *const core);
 status_t ta_http_start(ta_http_t *const http);
 
 /**
- * Stops an HTTP API
+ * Stops an HTTP API and releases its route table
  *
  * @param api The HTTP API
  *
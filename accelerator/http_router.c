@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "http_router.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "common/model/transaction.h"
+#include "utils/trinary_kernels.h"
+
+struct http_router_node_s {
+  char* segment;             /**< Literal segment, NULL for a parameter and the root */
+  size_t segment_len;        /**< Length of the literal segment */
+  http_param_type_t param;   /**< Type of the parameter, HTTP_PARAM_NONE for a literal */
+  int route;                 /**< Route ending at this node, HTTP_ROUTE_NONE if none */
+  http_router_node_t* child; /**< First child */
+  http_router_node_t* next;  /**< Next sibling */
+};
+
+static http_router_node_t* router_node_new(char const* const segment, const size_t len,
+                                           const http_param_type_t param) {
+  http_router_node_t* node = (http_router_node_t*)calloc(1, sizeof(http_router_node_t));
+  if (node == NULL) {
+    return NULL;
+  }
+
+  if (segment) {
+    node->segment = (char*)malloc(len + 1);
+    if (node->segment == NULL) {
+      free(node);
+      return NULL;
+    }
+    memcpy(node->segment, segment, len);
+    node->segment[len] = '\0';
+    node->segment_len = len;
+  }
+  node->param = param;
+  node->route = HTTP_ROUTE_NONE;
+  return node;
+}
+
+static void router_node_free(http_router_node_t* node) {
+  while (node) {
+    http_router_node_t* next = node->next;
+    router_node_free(node->child);
+    free(node->segment);
+    free(node);
+    node = next;
+  }
+}
+
+/**
+ * Find the next non-empty segment of a path, starting at `*pos`. `*pos` is moved to the end of the segment, and the
+ * length of the segment is returned, zero at the end of the path.
+ */
+static size_t next_segment(char const* const path, size_t* const pos, char const** const segment) {
+  size_t start = *pos, end;
+
+  while (path[start] == '/') {
+    start++;
+  }
+  for (end = start; path[end] != '\0' && path[end] != '/'; end++) {
+  }
+  *segment = path + start;
+  *pos = end;
+  return end - start;
+}
+
+static http_param_type_t pattern_param_type(char const* const segment, const size_t len) {
+  if (len == strlen("{hash}") && memcmp(segment, "{hash}", len) == 0) {
+    return HTTP_PARAM_HASH;
+  } else if (len == strlen("{tag}") && memcmp(segment, "{tag}", len) == 0) {
+    return HTTP_PARAM_TAG;
+  }
+  return HTTP_PARAM_NONE;
+}
+
+static bool param_validate(const http_param_type_t param, char const* const value, const size_t len) {
+  switch (param) {
+    case HTTP_PARAM_HASH:
+      return len == NUM_TRYTES_HASH && ta_trytes_validate((tryte_t const*)value, len);
+    case HTTP_PARAM_TAG:
+      return len > 0 && len <= NUM_TRYTES_TAG && ta_trytes_validate((tryte_t const*)value, len);
+    default:
+      return false;
+  }
+}
+
+status_t http_router_init(http_router_t* const router) {
+  router->root = router_node_new(NULL, 0, HTTP_PARAM_NONE);
+  return router->root ? SC_OK : SC_HTTP_OOM;
+}
+
+status_t http_router_add(http_router_t* const router, char const* const pattern, const int route) {
+  http_router_node_t* node = router->root;
+  char const* segment = NULL;
+  size_t pos = 0, len = 0, num_params = 0;
+
+  if (route < 0 || pattern == NULL || pattern[0] != '/') {
+    return SC_HTTP_INVALID_ROUTE;
+  }
+
+  while ((len = next_segment(pattern, &pos, &segment)) > 0) {
+    http_param_type_t param = pattern_param_type(segment, len);
+    if (param != HTTP_PARAM_NONE) {
+      if (++num_params > HTTP_ROUTER_MAX_PARAMS) {
+        return SC_HTTP_INVALID_ROUTE;
+      }
+    } else if (segment[0] == '{') {
+      // Unknown parameter type
+      return SC_HTTP_INVALID_ROUTE;
+    }
+
+    http_router_node_t **child = &node->child, *found = NULL;
+    for (; *child; child = &(*child)->next) {
+      if ((*child)->param == param && (param != HTTP_PARAM_NONE || ((*child)->segment_len == len &&
+                                                                    memcmp((*child)->segment, segment, len) == 0))) {
+        found = *child;
+        break;
+      }
+    }
+    if (found == NULL) {
+      // Siblings keep the order of registration
+      found = router_node_new(param == HTTP_PARAM_NONE ? segment : NULL, len, param);
+      if (found == NULL) {
+        return SC_HTTP_OOM;
+      }
+      *child = found;
+    }
+    node = found;
+  }
+
+  if (node->route != HTTP_ROUTE_NONE) {
+    return SC_HTTP_INVALID_ROUTE;
+  }
+  node->route = route;
+  return SC_OK;
+}
+
+status_t http_router_match(http_router_t const* const router, char const* const url, http_route_match_t* const match) {
+  http_router_node_t const* node = router->root;
+  char const* segment = NULL;
+  size_t pos = 0, len = 0;
+
+  match->route = HTTP_ROUTE_NONE;
+  match->num_params = 0;
+
+  // Each segment of the URL is looked up among the children of the previous one only
+  while ((len = next_segment(url, &pos, &segment)) > 0) {
+    http_router_node_t const *next = NULL, *param_node = NULL;
+    for (http_router_node_t const* child = node->child; child; child = child->next) {
+      if (child->param == HTTP_PARAM_NONE) {
+        if (child->segment_len == len && memcmp(child->segment, segment, len) == 0) {
+          next = child;
+          break;
+        }
+      } else if (param_node == NULL && param_validate(child->param, segment, len)) {
+        param_node = child;
+      }
+    }
+
+    if (next == NULL) {
+      if (param_node == NULL) {
+        match->num_params = 0;
+        return SC_HTTP_URL_NOT_MATCH;
+      }
+      next = param_node;
+      match->params[match->num_params].value = segment;
+      match->params[match->num_params].len = len;
+      match->num_params++;
+    }
+    node = next;
+  }
+
+  if (node->route == HTTP_ROUTE_NONE) {
+    match->num_params = 0;
+    return SC_HTTP_URL_NOT_MATCH;
+  }
+  match->route = node->route;
+  return SC_OK;
+}
+
+void http_router_free(http_router_t* const router) {
+  router_node_free(router->root);
+  router->root = NULL;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef ACCELERATOR_HTTP_ROUTER_H_
+#define ACCELERATOR_HTTP_ROUTER_H_
+
+#include <stddef.h>
+#include "accelerator/errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file http_router.h
+ * @brief Route table of the HTTP API
+ *
+ * Routes are registered once with patterns such as "/mam/{hash}", whose segments are either literals or typed
+ * parameters, and are kept in a trie of path segments. A URL is dispatched with one walk over its segments instead of
+ * being tried against every route in turn, and the parameters are handed back as slices of the URL.
+ *
+ * Empty segments are skipped, so "/tips", "/tips/" and "//tips" are the same path. A literal segment is preferred to
+ * a parameter at the same position.
+ *
+ * @example test_http_router.c
+ */
+
+/** Maximum number of parameters in a route */
+#define HTTP_ROUTER_MAX_PARAMS 4
+
+/** Route identifier of an unmatched URL */
+#define HTTP_ROUTE_NONE -1
+
+typedef enum http_param_type_e {
+  HTTP_PARAM_NONE = 0, /**< Literal segment */
+  HTTP_PARAM_HASH,     /**< "{hash}", 81 trytes */
+  HTTP_PARAM_TAG,      /**< "{tag}", 1 to 27 trytes */
+} http_param_type_t;
+
+typedef struct http_router_node_s http_router_node_t;
+
+typedef struct http_router_s {
+  http_router_node_t* root; /**< Node of the empty path */
+} http_router_t;
+
+typedef struct http_route_param_s {
+  char const* value; /**< Points into the URL, not NUL terminated */
+  size_t len;        /**< Length of the parameter */
+} http_route_param_t;
+
+typedef struct http_route_match_s {
+  int route;                                         /**< Identifier of the route, HTTP_ROUTE_NONE if unmatched */
+  size_t num_params;                                 /**< Number of parameters */
+  http_route_param_t params[HTTP_ROUTER_MAX_PARAMS]; /**< Parameters in the order of the pattern */
+} http_route_match_t;
+
+/**
+ * @brief Initialize an empty route table
+ *
+ * @param[out] router The route table
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_HTTP_OOM on error
+ */
+status_t http_router_init(http_router_t* const router);
+
+/**
+ * @brief Register a route
+ *
+ * @param[in] router The route table
+ * @param[in] pattern Path of literal segments and "{hash}" or "{tag}" parameters, e.g. "/mam/{hash}"
+ * @param[in] route Non-negative identifier returned by `http_router_match()`
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_HTTP_INVALID_ROUTE if the pattern is malformed or already registered
+ * - SC_HTTP_OOM on error
+ */
+status_t http_router_add(http_router_t* const router, char const* const pattern, const int route);
+
+/**
+ * @brief Find the route of a URL
+ *
+ * @param[in] router The route table
+ * @param[in] url Path of the request, without query string
+ * @param[out] match The route and its parameters
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_HTTP_URL_NOT_MATCH if no route matches, `match->route` is then HTTP_ROUTE_NONE
+ */
+status_t http_router_match(http_router_t const* const router, char const* const url, http_route_match_t* const match);
+
+/**
+ * @brief Release a route table
+ *
+ * @param[in] router The route table
+ */
+void http_router_free(http_router_t* const router);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ACCELERATOR_HTTP_ROUTER_H_
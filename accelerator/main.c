@@ -42,13 +42,13 @@ int main(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
-  if (ta_config_set(&ta_core.cache, &ta_core.service) != SC_OK) {
+  if (ta_config_set(&ta_core.info, &ta_core.cache, &ta_core.service) != SC_OK) {
     ta_log_critical("Configure failed %s.\n", MAIN_LOGGER);
     return EXIT_FAILURE;
   }
 
-  // Initialize apis cJSON lock
-  if (apis_lock_init() != SC_OK) {
+  // Initialize proxy apis lock
+  if (proxy_apis_lock_init() != SC_OK) {
     ta_log_critical("Lock initialization failed %s.\n", MAIN_LOGGER);
     return EXIT_FAILURE;
   }
@@ -56,6 +56,7 @@ int main(int argc, char* argv[]) {
   // Enable other loggers when verbose mode is on
   if (verbose_mode) {
     http_logger_init();
+    proxy_apis_logger_init();
   } else {
     // Destroy logger when verbose mode is off
     logger_helper_release(logger_id);
@@ -79,7 +80,7 @@ int main(int argc, char* argv[]) {
 
 cleanup:
   log_warning(logger_id, "Destroying API lock\n");
-  if (apis_lock_destroy() != SC_OK) {
+  if (proxy_apis_lock_destroy() != SC_OK) {
     ta_log_critical("Destroying api lock failed %s.\n", MAIN_LOGGER);
     return EXIT_FAILURE;
   }
@@ -88,6 +89,7 @@ cleanup:
 
   if (verbose_mode) {
     http_logger_release();
+    proxy_apis_logger_release();
     logger_helper_release(logger_id);
     if (logger_helper_destroy() != RC_OK) {
       ta_log_critical("Destroying logger failed %s.\n", MAIN_LOGGER);
@@ -23,14 +23,33 @@ typedef enum ta_cli_arg_value_e {
   TA_HOST_CLI = 127,
   TA_PORT_CLI,
   TA_THREAD_COUNT_CLI,
+  POW_WORKERS_CLI,
+  POW_QUEUE_SIZE_CLI,
+  POW_SLA_CLI,
+  BROADCAST_WINDOW_CLI,
+  BROADCAST_BATCH_SIZE_CLI,
+  HTTP_THREAD_POOL_CLI,
+  HTTP_CONN_LIMIT_CLI,
+  HTTP_CONN_MEMORY_CLI,
+  HTTP_CONN_TIMEOUT_CLI,
+  HTTP_MAX_BODY_CLI,
+  BATCH_WORKERS_CLI,
 
   /** IRI */
   IRI_HOST_CLI,
   IRI_PORT_CLI,
+  IRI_POOL_SIZE_CLI,
+  IRI_NODES_CLI,
+  IRI_MILESTONE_LAG_CLI,
+  IRI_HEDGE_BUDGET_CLI,
+  IRI_BREAKER_RATE_CLI,
+  IRI_BREAKER_LATENCY_CLI,
+  IRI_BREAKER_COOLDOWN_CLI,
 
   /** REDIS */
   REDIS_HOST_CLI,
   REDIS_PORT_CLI,
+  CONFIRMED_SET_SIZE_CLI,
 
   /** CONFIG */
   MILESTONE_DEPTH_CLI,
@@ -55,10 +74,39 @@ static struct ta_cli_argument_s {
                           {"ta_host", TA_HOST_CLI, "TA listening host", REQUIRED_ARG},
                           {"ta_port", TA_PORT_CLI, "TA listening port", REQUIRED_ARG},
                           {"ta_thread", TA_THREAD_COUNT_CLI, "TA executing thread", OPTIONAL_ARG},
+                          {"pow_workers", POW_WORKERS_CLI, "PoW scheduler workers, 0 to disable", OPTIONAL_ARG},
+                          {"pow_queue_size", POW_QUEUE_SIZE_CLI, "Maximum admitted PoW requests", OPTIONAL_ARG},
+                          {"pow_sla", POW_SLA_CLI, "Maximum estimated PoW wait in ms", OPTIONAL_ARG},
+                          {"broadcast_window", BROADCAST_WINDOW_CLI, "Broadcast batching window in ms", OPTIONAL_ARG},
+                          {"broadcast_batch_size", BROADCAST_BATCH_SIZE_CLI, "Transactions per broadcast batch",
+                           OPTIONAL_ARG},
+                          {"http_thread_pool", HTTP_THREAD_POOL_CLI,
+                           "Serve HTTP with an epoll thread pool with T, needs pow_workers above 0", OPTIONAL_ARG},
+                          {"http_conn_limit", HTTP_CONN_LIMIT_CLI, "Maximum concurrent HTTP connections", OPTIONAL_ARG},
+                          {"http_conn_memory", HTTP_CONN_MEMORY_CLI, "Memory limit per HTTP connection in bytes",
+                           OPTIONAL_ARG},
+                          {"http_conn_timeout", HTTP_CONN_TIMEOUT_CLI, "Idle HTTP connection timeout in seconds",
+                           OPTIONAL_ARG},
+                          {"http_max_body", HTTP_MAX_BODY_CLI, "Maximum HTTP request body in bytes", OPTIONAL_ARG},
+                          {"batch_workers", BATCH_WORKERS_CLI, "Workers running batch sub-requests", OPTIONAL_ARG},
                           {"iri_host", IRI_HOST_CLI, "IRI listening host", REQUIRED_ARG},
                           {"iri_port", IRI_PORT_CLI, "IRI listening port", REQUIRED_ARG},
+                          {"iri_pool_size", IRI_POOL_SIZE_CLI, "IRI connections, 0 to share one", OPTIONAL_ARG},
+                          {"iri_nodes", IRI_NODES_CLI, "Other IRI nodes as host:port,host:port", REQUIRED_ARG},
+                          {"iri_milestone_lag", IRI_MILESTONE_LAG_CLI, "Milestones an IRI node may lag behind",
+                           OPTIONAL_ARG},
+                          {"iri_hedge_budget", IRI_HEDGE_BUDGET_CLI, "Percentage of IRI reads hedged on another node",
+                           OPTIONAL_ARG},
+                          {"iri_breaker_rate", IRI_BREAKER_RATE_CLI, "Percentage of failed IRI calls tripping a node",
+                           OPTIONAL_ARG},
+                          {"iri_breaker_latency", IRI_BREAKER_LATENCY_CLI, "IRI call time in ms counted as failed",
+                           OPTIONAL_ARG},
+                          {"iri_breaker_cooldown", IRI_BREAKER_COOLDOWN_CLI, "Time in ms a tripped IRI node fails fast",
+                           OPTIONAL_ARG},
                           {"redis_host", REDIS_HOST_CLI, "Redis server listening host", REQUIRED_ARG},
                           {"redis_port", REDIS_PORT_CLI, "Redis server listening port", REQUIRED_ARG},
+                          {"confirmed_set_size", CONFIRMED_SET_SIZE_CLI, "Confirmed transactions kept in memory",
+                           OPTIONAL_ARG},
                           {"milestone_depth", MILESTONE_DEPTH_CLI, "IRI milestone depth", OPTIONAL_ARG},
                           {"mwm", MWM_CLI, "minimum weight magnitude", OPTIONAL_ARG},
                           {"seed", SEED_CLI, "IOTA seed", OPTIONAL_ARG},
@@ -7,12 +7,45 @@
  */
 
 #include "proxy_apis.h"
+#include "common/model/transaction.h"
+#include "serializer/serializer.h"
+#include "utils/cache.h"
+#include "utils/confirmed_set.h"
 #include "utils/handles/lock.h"
+#include "utils/iri_pool.h"
+#include "utils/time.h"
+#include "utils/trinary_kernels.h"
 
 #define PROXY_APIS_LOGGER "proxy_apis"
+/** Transactions asked from or stored into the cache with one round trip */
+#define PROXY_CACHE_CHUNK 16
+/** Milliseconds a getNodeInfo response is served again without asking IRI */
+#define PROXY_NODE_INFO_TTL_MS 1000
 
 static logger_id_t logger_id;
-static lock_handle_t cjson_lock;
+
+/** Last getNodeInfo response, shared by the requests of the following PROXY_NODE_INFO_TTL_MS */
+static struct {
+  lock_handle_t lock;
+  char* json;
+  uint64_t timestamp;
+} node_info_cache;
+
+/**
+ * IRI APIs served by `proxy_api_wrapper()`, named by the `command` of the request. getTrytes, getInclusionStates and
+ * getNodeInfo are answered from the cache when they can, the others are passed to IRI as they are.
+ */
+static struct proxy_api_s {
+  char const* command;
+  status_t (*api)(const iota_client_service_t* const service, const char* const obj, char** json_result);
+  status_t (*api_without_args)(const iota_client_service_t* const service, char** json_result);
+} const proxy_apis_g[] = {{"checkConsistency", api_check_consistency, NULL},
+                          {"findTransactions", api_find_transactions, NULL},
+                          {"getBalances", api_get_balances, NULL},
+                          {"getInclusionStates", api_get_inclusion_states, NULL},
+                          {"getNodeInfo", NULL, api_get_node_info},
+                          {"getTrytes", api_get_trytes, NULL}};
+static const size_t proxy_apis_num = sizeof(proxy_apis_g) / sizeof(struct proxy_api_s);
 
 void proxy_apis_logger_init() { logger_id = logger_helper_enable(PROXY_APIS_LOGGER, LOGGER_DEBUG, true); }
 
@@ -27,14 +60,16 @@ int proxy_apis_logger_release() {
 }
 
 status_t proxy_apis_lock_init() {
-  if (lock_handle_init(&cjson_lock)) {
+  if (lock_handle_init(&node_info_cache.lock)) {
     return SC_CONF_LOCK_INIT;
   }
   return SC_OK;
 }
 
 status_t proxy_apis_lock_destroy() {
-  if (lock_handle_destroy(&cjson_lock)) {
+  free(node_info_cache.json);
+  node_info_cache.json = NULL;
+  if (lock_handle_destroy(&node_info_cache.lock)) {
     return SC_CONF_LOCK_DESTROY;
   }
   return SC_OK;
@@ -60,6 +95,200 @@ status_t char_buffer_to_str(char_buffer_t* res_buff, char** json_result) {
   return SC_OK;
 }
 
+/**
+ * Get the trytes of transactions, from the cache for the ones already seen. Transactions never change, so the trytes
+ * fetched from IRI are cached for good, except the null ones IRI returns for unknown transactions.
+ */
+static status_t proxy_get_trytes(const iota_client_service_t* const service, get_trytes_req_t const* const req,
+                                 get_trytes_res_t* const res) {
+  status_t ret = SC_OK;
+  const size_t num = hash243_queue_count(req->hashes);
+  size_t count = 0;
+  hash243_queue_entry_t *hash_iter = req->hashes, *first = NULL;
+  hash8019_queue_t cached = NULL;
+  hash8019_queue_entry_t *cached_iter = NULL, *uncached_iter = NULL;
+  flex_trit_t trits[FLEX_TRIT_SIZE_8019];
+  get_trytes_req_t* uncached_req = get_trytes_req_new();
+  get_trytes_res_t* uncached_res = get_trytes_res_new();
+  bool* found = (bool*)calloc(num + 1, sizeof(bool));
+  char* keys = (char*)malloc(PROXY_CACHE_CHUNK * NUM_TRYTES_HASH);
+  char* values = (char*)malloc(PROXY_CACHE_CHUNK * NUM_TRYTES_SERIALIZED_TRANSACTION);
+  if (uncached_req == NULL || uncached_res == NULL || found == NULL || keys == NULL || values == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  for (size_t base = 0; base < num; base += count) {
+    count = num - base < PROXY_CACHE_CHUNK ? num - base : PROXY_CACHE_CHUNK;
+    first = hash_iter;
+    for (size_t i = 0; i < count; i++, hash_iter = hash_iter->next) {
+      ta_flex_trits_to_trytes((tryte_t*)(keys + i * NUM_TRYTES_HASH), NUM_TRYTES_HASH, hash_iter->hash, NUM_TRITS_HASH,
+                              NUM_TRITS_HASH);
+    }
+    if (cache_mget(keys, NUM_TRYTES_HASH, count, values, NUM_TRYTES_SERIALIZED_TRANSACTION, found + base) != SC_OK) {
+      // Without the cache every hash is asked to IRI
+      memset(found + base, 0, count * sizeof(bool));
+    }
+
+    hash_iter = first;
+    for (size_t i = 0; i < count; i++, hash_iter = hash_iter->next) {
+      if (found[base + i]) {
+        ta_flex_trits_from_trytes(trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                                  (tryte_t const*)(values + i * NUM_TRYTES_SERIALIZED_TRANSACTION),
+                                  NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+        if (hash8019_queue_push(&cached, trits) != RC_OK) {
+          ret = SC_TA_OOM;
+          ta_log_error("%s\n", "SC_TA_OOM");
+          goto done;
+        }
+      } else if (hash243_queue_push(&uncached_req->hashes, hash_iter->hash) != RC_OK) {
+        ret = SC_TA_OOM;
+        ta_log_error("%s\n", "SC_TA_OOM");
+        goto done;
+      }
+    }
+  }
+
+  if (uncached_req->hashes != NULL) {
+    ret = iri_pool_get_trytes(service, uncached_req, uncached_res);
+    if (ret != SC_OK) {
+      goto done;
+    }
+    if (hash8019_queue_count(uncached_res->trytes) != hash243_queue_count(uncached_req->hashes)) {
+      ret = SC_CCLIENT_FAILED_RESPONSE;
+      ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+      goto done;
+    }
+
+    // A failed cache write only costs another IRI request later, so the response is sent anyway
+    count = 0;
+    hash_iter = uncached_req->hashes;
+    CDL_FOREACH(uncached_res->trytes, uncached_iter) {
+      if (!flex_trits_are_null(uncached_iter->hash, FLEX_TRIT_SIZE_8019)) {
+        ta_flex_trits_to_trytes((tryte_t*)(keys + count * NUM_TRYTES_HASH), NUM_TRYTES_HASH, hash_iter->hash,
+                                NUM_TRITS_HASH, NUM_TRITS_HASH);
+        ta_flex_trits_to_trytes((tryte_t*)(values + count * NUM_TRYTES_SERIALIZED_TRANSACTION),
+                                NUM_TRYTES_SERIALIZED_TRANSACTION, uncached_iter->hash,
+                                NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
+        if (++count == PROXY_CACHE_CHUNK) {
+          cache_mset(keys, NUM_TRYTES_HASH, values, NUM_TRYTES_SERIALIZED_TRANSACTION, count);
+          count = 0;
+        }
+      }
+      hash_iter = hash_iter->next;
+    }
+    cache_mset(keys, NUM_TRYTES_HASH, values, NUM_TRYTES_SERIALIZED_TRANSACTION, count);
+  }
+
+  // Merge both parts back in the order of the request
+  cached_iter = cached;
+  uncached_iter = uncached_res->trytes;
+  for (size_t i = 0; i < num; i++) {
+    hash8019_queue_entry_t** iter = found[i] ? &cached_iter : &uncached_iter;
+    if (hash8019_queue_push(&res->trytes, (*iter)->hash) != RC_OK) {
+      ret = SC_TA_OOM;
+      ta_log_error("%s\n", "SC_TA_OOM");
+      goto done;
+    }
+    *iter = (*iter)->next;
+  }
+
+done:
+  hash8019_queue_free(&cached);
+  get_trytes_req_free(&uncached_req);
+  get_trytes_res_free(&uncached_res);
+  free(found);
+  free(keys);
+  free(values);
+  return ret;
+}
+
+/**
+ * Get the inclusion states of transactions. A confirmed transaction stays confirmed, so the ones in the confirmed set
+ * are answered locally and only the unknown or pending ones are asked to IRI, in one request. IRI ignores `tips` since
+ * 1.8.2 and states tell milestone confirmation.
+ */
+static status_t proxy_get_inclusion_states(const iota_client_service_t* const service,
+                                           get_inclusion_states_req_t const* const req,
+                                           get_inclusion_states_res_t* const res) {
+  status_t ret = SC_OK;
+  const size_t num = hash243_queue_count(req->transactions);
+  size_t uncached_num = 0, uncached_index = 0;
+  hash243_queue_entry_t* hash_iter = NULL;
+  get_inclusion_states_req_t* uncached_req = get_inclusion_states_req_new();
+  get_inclusion_states_res_t* uncached_res = get_inclusion_states_res_new();
+  bool* found = (bool*)calloc(num + 1, sizeof(bool));
+  bool* confirmed = NULL;
+  if (uncached_req == NULL || uncached_res == NULL || found == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+
+  ret = confirmed_set_find(req->transactions, found);
+  if (ret != SC_OK) {
+    goto done;
+  }
+  hash_iter = req->transactions;
+  for (size_t i = 0; i < num; i++, hash_iter = hash_iter->next) {
+    if (!found[i] && hash243_queue_push(&uncached_req->transactions, hash_iter->hash) != RC_OK) {
+      ret = SC_TA_OOM;
+      ta_log_error("%s\n", "SC_TA_OOM");
+      goto done;
+    }
+  }
+
+  if (uncached_req->transactions != NULL) {
+    uncached_num = hash243_queue_count(uncached_req->transactions);
+    if (hash243_queue_copy(&uncached_req->tips, req->tips, hash243_queue_count(req->tips)) != RC_OK) {
+      ret = SC_TA_OOM;
+      ta_log_error("%s\n", "SC_TA_OOM");
+      goto done;
+    }
+    ret = iri_pool_get_inclusion_states(service, uncached_req, uncached_res);
+    if (ret != SC_OK) {
+      goto done;
+    }
+    if (get_inclusion_states_res_states_count(uncached_res) != uncached_num) {
+      ret = SC_CCLIENT_FAILED_RESPONSE;
+      ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+      goto done;
+    }
+
+    confirmed = (bool*)malloc(uncached_num * sizeof(bool));
+    if (confirmed == NULL) {
+      ret = SC_TA_OOM;
+      ta_log_error("%s\n", "SC_TA_OOM");
+      goto done;
+    }
+    for (size_t i = 0; i < uncached_num; i++) {
+      confirmed[i] = get_inclusion_states_res_states_at(uncached_res, i);
+    }
+    ret = confirmed_set_add(uncached_req->transactions, confirmed);
+    if (ret != SC_OK) {
+      goto done;
+    }
+  }
+
+  // Merge both parts back in the order of the request
+  for (size_t i = 0; i < num; i++) {
+    bool state = found[i] ? true : confirmed[uncached_index++];
+    if (get_inclusion_states_res_states_add(res, state) != RC_OK) {
+      ret = SC_TA_OOM;
+      ta_log_error("%s\n", "SC_TA_OOM");
+      goto done;
+    }
+  }
+
+done:
+  get_inclusion_states_req_free(&uncached_req);
+  get_inclusion_states_res_free(&uncached_res);
+  free(found);
+  free(confirmed);
+  return ret;
+}
+
 status_t api_check_consistency(const iota_client_service_t* const service, const char* const obj, char** json_result) {
   status_t ret = SC_OK;
   check_consistency_req_t* req = check_consistency_req_new();
@@ -71,23 +300,16 @@ status_t api_check_consistency(const iota_client_service_t* const service, const
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
   if (service->serializer.vtable.check_consistency_deserialize_request(obj, req) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
     ret = SC_CCLIENT_JSON_PARSE;
     ta_log_error("%s\n", "SC_CCLIENT_JSON_PARSE");
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  lock_handle_lock(&cjson_lock);
-  if (iota_client_check_consistency(service, req, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  ret = iri_pool_check_consistency(service, req, res);
+  if (ret != SC_OK) {
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   if (service->serializer.vtable.check_consistency_serialize_response(res, res_buff) != RC_OK) {
     ret = SC_CCLIENT_JSON_PARSE;
@@ -114,23 +336,16 @@ status_t api_find_transactions(const iota_client_service_t* const service, const
     ta_log_error("%s\n", "SC_TA_OOM");
     goto done;
   }
-  lock_handle_lock(&cjson_lock);
   if (service->serializer.vtable.find_transactions_deserialize_request(obj, req) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
     ret = SC_CCLIENT_JSON_PARSE;
     ta_log_error("%s\n", "SC_CCLIENT_JSON_PARSE");
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  lock_handle_lock(&cjson_lock);
-  if (iota_client_find_transactions(service, req, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  ret = iri_pool_find_transactions(service, req, res);
+  if (ret != SC_OK) {
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   if (service->serializer.vtable.find_transactions_serialize_response(res, res_buff) != RC_OK) {
     ret = SC_CCLIENT_JSON_PARSE;
@@ -158,23 +373,16 @@ status_t api_get_balances(const iota_client_service_t* const service, const char
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
   if (service->serializer.vtable.get_balances_deserialize_request(obj, req) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
     ret = SC_CCLIENT_JSON_PARSE;
     ta_log_error("%s\n", "SC_CCLIENT_JSON_PARSE");
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  lock_handle_lock(&cjson_lock);
-  if (iota_client_get_balances(service, req, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  ret = iri_pool_get_balances(service, req, res);
+  if (ret != SC_OK) {
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   if (service->serializer.vtable.get_balances_serialize_response(res, res_buff) != RC_OK) {
     ret = SC_CCLIENT_JSON_PARSE;
@@ -203,23 +411,16 @@ status_t api_get_inclusion_states(const iota_client_service_t* const service, co
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
   if (service->serializer.vtable.get_inclusion_states_deserialize_request(obj, req) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
     ret = SC_CCLIENT_JSON_PARSE;
     ta_log_error("%s\n", "SC_CCLIENT_JSON_PARSE");
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  lock_handle_lock(&cjson_lock);
-  if (iota_client_get_inclusion_states(service, req, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  ret = proxy_get_inclusion_states(service, req, res);
+  if (ret != SC_OK) {
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   if (service->serializer.vtable.get_inclusion_states_serialize_response(res, res_buff) != RC_OK) {
     ret = SC_CCLIENT_JSON_PARSE;
@@ -238,22 +439,43 @@ done:
 
 status_t api_get_node_info(const iota_client_service_t* const service, char** json_result) {
   status_t ret = SC_OK;
-  get_node_info_res_t* res = get_node_info_res_new();
-  char_buffer_t* res_buff = char_buffer_new();
+  get_node_info_res_t* res = NULL;
+  char_buffer_t* res_buff = NULL;
+
+  lock_handle_lock(&node_info_cache.lock);
+  if (node_info_cache.json && current_timestamp_ms() - node_info_cache.timestamp < PROXY_NODE_INFO_TTL_MS) {
+    *json_result = strdup(node_info_cache.json);
+    lock_handle_unlock(&node_info_cache.lock);
+    if (*json_result == NULL) {
+      ta_log_error("%s\n", "SC_TA_OOM");
+      return SC_TA_OOM;
+    }
+    return SC_OK;
+  }
+  lock_handle_unlock(&node_info_cache.lock);
+
+  res = get_node_info_res_new();
+  res_buff = char_buffer_new();
   if (res == NULL || res_buff == NULL) {
     ret = SC_TA_OOM;
     ta_log_error("%s\n", "SC_TA_OOM");
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
-  if (iota_client_get_node_info(service, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  ret = iri_pool_get_node_info(service, res);
+  if (ret == SC_CCLIENT_IRI_UNAVAILABLE) {
+    // The node is failing, an expired response beats none
+    lock_handle_lock(&node_info_cache.lock);
+    if (node_info_cache.json) {
+      *json_result = strdup(node_info_cache.json);
+      ret = *json_result ? SC_OK : SC_TA_OOM;
+    }
+    lock_handle_unlock(&node_info_cache.lock);
+    goto done;
+  }
+  if (ret != SC_OK) {
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   if (service->serializer.vtable.get_node_info_serialize_response(res, res_buff) != RC_OK) {
     ret = SC_CCLIENT_JSON_PARSE;
@@ -262,6 +484,17 @@ status_t api_get_node_info(const iota_client_service_t* const service, char** js
   }
 
   ret = char_buffer_to_str(res_buff, json_result);
+  if (ret == SC_OK) {
+    // Concurrent requests of an expired response all ask IRI, the last one is kept
+    char* json = strdup(*json_result);
+    if (json) {
+      lock_handle_lock(&node_info_cache.lock);
+      free(node_info_cache.json);
+      node_info_cache.json = json;
+      node_info_cache.timestamp = current_timestamp_ms();
+      lock_handle_unlock(&node_info_cache.lock);
+    }
+  }
 
 done:
   get_node_info_res_free(&res);
@@ -280,23 +513,16 @@ status_t api_get_trytes(const iota_client_service_t* const service, const char*
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
   if (service->serializer.vtable.get_trytes_deserialize_request(obj, req) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
     ret = SC_CCLIENT_JSON_PARSE;
     ta_log_error("%s\n", "SC_CCLIENT_JSON_PARSE");
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  lock_handle_lock(&cjson_lock);
-  if (iota_client_get_trytes(service, req, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
-    ret = SC_CCLIENT_FAILED_RESPONSE;
-    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+  ret = proxy_get_trytes(service, req, res);
+  if (ret != SC_OK) {
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   if (service->serializer.vtable.get_trytes_serialize_response(res, res_buff) != RC_OK) {
     ret = SC_CCLIENT_JSON_PARSE;
@@ -324,23 +550,17 @@ status_t api_remove_neighbors(const iota_client_service_t* const service, const
     goto done;
   }
 
-  lock_handle_lock(&cjson_lock);
   if (service->serializer.vtable.remove_neighbors_deserialize_request(obj, req) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
     ret = SC_CCLIENT_JSON_PARSE;
     ta_log_error("%s\n", "SC_CCLIENT_JSON_PARSE");
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
-  lock_handle_lock(&cjson_lock);
   if (iota_client_remove_neighbors(service, req, res) != RC_OK) {
-    lock_handle_unlock(&cjson_lock);
     ret = SC_CCLIENT_FAILED_RESPONSE;
     ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
     goto done;
   }
-  lock_handle_unlock(&cjson_lock);
 
   if (service->serializer.vtable.remove_neighbors_serialize_response(res, res_buff) != RC_OK) {
     ret = SC_CCLIENT_JSON_PARSE;
@@ -356,3 +576,20 @@ done:
   char_buffer_free(res_buff);
   return ret;
 }
+
+status_t proxy_api_wrapper(const iota_client_service_t* const service, const char* const obj, char** json_result) {
+  char command[TA_PROXY_COMMAND_MAX_LEN + 1];
+  status_t ret = proxy_apis_command_req_deserialize(obj, command);
+  if (ret != SC_OK) {
+    return ret;
+  }
+
+  for (size_t i = 0; i < proxy_apis_num; i++) {
+    if (strcmp(proxy_apis_g[i].command, command) == 0) {
+      return proxy_apis_g[i].api ? proxy_apis_g[i].api(service, obj, json_result)
+                                 : proxy_apis_g[i].api_without_args(service, json_result);
+    }
+  }
+  ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+  return SC_SERIALIZER_INVALID_REQ;
+}
@@ -154,6 +154,24 @@ status_t api_get_trytes(const iota_client_service_t* const service, const char*
  */
 status_t api_remove_neighbors(const iota_client_service_t* const service, const char* const obj, char** json_result);
 
+/**
+ * @brief Dispatch an IRI API request to the proxy API of its `command`
+ *
+ * checkConsistency, findTransactions, getBalances, getInclusionStates, getNodeInfo and getTrytes are served. The
+ * trytes of transactions and the confirmed inclusion states never change and are kept in the cache, and a getNodeInfo
+ * response is shared by the requests of the following second.
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] obj IRI API request in json format
+ * @param[out] json_result Response of the API in json format
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ on missing or unsupported commands
+ * - non-zero on other errors
+ */
+status_t proxy_api_wrapper(const iota_client_service_t* const service, const char* const obj, char** json_result);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,10 @@
  * "LICENSE" at the root of this distribution.
  */
 
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
 #include <served/methods.hpp>
 #include <served/plugins.hpp>
 #include <served/served.hpp>
@@ -13,7 +17,6 @@
 #include "accelerator/config.h"
 #include "accelerator/errors.h"
 #include "accelerator/proxy_apis.h"
-#include "cJSON.h"
 #include "utils/logger_helper.h"
 #include "utils/macros.h"
 
@@ -22,7 +25,22 @@
 static ta_core_t ta_core;
 static logger_id_t logger_id;
 
-void set_method_header(served::response& res, http_method_t method) {
+/**
+ * IRI connection checked out of the pool for as long as the object lives. A temporary one passed to an API is
+ * returned once the API returns.
+ */
+class iri_connection {
+ public:
+  iri_connection() : service(iri_pool_acquire()) {}
+  ~iri_connection() { iri_pool_release(service); }
+  iri_connection(const iri_connection&) = delete;
+  iri_connection& operator=(const iri_connection&) = delete;
+
+  iota_client_service_t* const service;
+};
+
+void set_method_header(served::response& res, http_method_t method,
+                       ta_response_format_t format = TA_RESPONSE_FORMAT_JSON) {
   res.set_header("Server", ta_core.info.version);
   res.set_header("Access-Control-Allow-Origin", "*");
 
@@ -33,38 +51,169 @@ void set_method_header(served::response& res, http_method_t method) {
       res.set_header("Access-Control-Max-Age", "86400");
       break;
     default:
-      res.set_header("Content-Type", "application/json");
+      res.set_header("Content-Type", ta_response_format_content_type(format));
       break;
   }
 }
 
+enum response_body_e {
+  BODY_NOT_FOUND,
+  BODY_INVALID_HEADER,
+  BODY_INVALID_REQUEST,
+  BODY_BUSY,
+  BODY_IRI_UNAVAILABLE,
+  BODY_INTERNAL_ERROR,
+  BODY_INVALID_PATH,
+  BODY_PAGING_OFF,
+  BODY_NUM
+};
+
+// Bodies of the error responses, kept in one array so `is_static_body()` tells them apart from the allocated results
+// of the APIs
+static char const static_bodies[BODY_NUM][48] = {
+    "{\"message\":\"Request not found\"}",                 "{\"message\":\"Invalid request header\"}",
+    "{\"message\":\"Invalid request\"}",                   "{\"message\":\"Service is busy, retry later\"}",
+    "{\"message\":\"IRI node unavailable, retry later\"}", "{\"message\":\"Internal service error\"}",
+    "{\"message\":\"Invalid path\"}",                      "{\"message\":\"Paging needs the cache\"}",
+};
+
+static inline char* static_body(response_body_e body) { return const_cast<char*>(static_bodies[body]); }
+
+static inline bool is_static_body(char const* body) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(body);
+  return addr >= reinterpret_cast<uintptr_t>(static_bodies) &&
+         addr < reinterpret_cast<uintptr_t>(static_bodies + BODY_NUM);
+}
+
+/** A serialized result streamed into the response body as it is, without an intermediate std::string */
+struct response_buffer {
+  char const* buf;
+  size_t len;
+};
+
+inline std::ostream& operator<<(std::ostream& os, response_buffer const& body) {
+  return os.write(body.buf, body.len);
+}
+
+/**
+ * Tell a client rejected with 503 when to retry, after the cooldown of the IRI node breakers when IRI is unavailable
+ * and after the estimated PoW wait when the PoW queue is full
+ */
+static void set_retry_after(served::response& res, char const* body) {
+  if (body == static_body(BODY_IRI_UNAVAILABLE)) {
+    res.set_header("Retry-After", std::to_string(iri_pool_retry_after()));
+  } else if (body == static_body(BODY_BUSY)) {
+    res.set_header("Retry-After", std::to_string(pow_admission_retry_after()));
+  }
+}
+
+/**
+ * Write a result into the response body and release it. Binary results come with their length, the others are NUL
+ * terminated.
+ */
+static void send_body(served::response& res, char* result, size_t result_len = 0) {
+  if (result == NULL) {
+    return;
+  }
+  set_retry_after(res, result);
+  res << response_buffer{result, result_len ? result_len : strlen(result)};
+  if (!is_static_body(result)) {
+    free(result);
+  }
+}
+
 status_t set_response_content(status_t ret, char** json_result) {
   status_t http_ret;
+  response_body_e body;
   if (ret == SC_OK) {
     return SC_HTTP_OK;
   }
 
-  cJSON* json_obj = cJSON_CreateObject();
   switch (ret) {
     case SC_CCLIENT_NOT_FOUND:
     case SC_MAM_NOT_FOUND:
       http_ret = SC_HTTP_NOT_FOUND;
-      cJSON_AddStringToObject(json_obj, "message", "Request not found");
+      body = BODY_NOT_FOUND;
       break;
     case SC_CCLIENT_JSON_KEY:
     case SC_MAM_NO_PAYLOAD:
       http_ret = SC_HTTP_BAD_REQUEST;
-      cJSON_AddStringToObject(json_obj, "message", "Invalid request header");
+      body = BODY_INVALID_HEADER;
+      break;
+    case SC_SERIALIZER_INVALID_REQ:
+      http_ret = SC_HTTP_BAD_REQUEST;
+      body = BODY_INVALID_REQUEST;
+      break;
+    case SC_UTILS_POW_OVERLOADED:
+      http_ret = SC_HTTP_SERVICE_UNAVAILABLE;
+      body = BODY_BUSY;
+      break;
+    case SC_CCLIENT_IRI_UNAVAILABLE:
+      http_ret = SC_HTTP_SERVICE_UNAVAILABLE;
+      body = BODY_IRI_UNAVAILABLE;
+      break;
+    case SC_TA_PAGING_OFF:
+      http_ret = SC_HTTP_NOT_IMPLEMENTED;
+      body = BODY_PAGING_OFF;
       break;
     default:
       http_ret = SC_HTTP_INTERNAL_SERVICE_ERROR;
-      cJSON_AddStringToObject(json_obj, "message", "Internal service error");
+      body = BODY_INTERNAL_ERROR;
       break;
   }
-  *json_result = cJSON_PrintUnformatted(json_obj);
+  // A partial result of the API is dropped
+  free(*json_result);
+  *json_result = static_body(body);
   return http_ret;
 }
 
+/** Parse the `limit`, `cursor` and `since` arguments of the query string, `paged` is false without any of them */
+static status_t parse_page(const served::request& req, ta_page_req_t* page, bool* paged) {
+  return ta_page_req_parse(req.query.get("limit").c_str(), req.query.get("cursor").c_str(),
+                           req.query.get("since").c_str(), page, paged);
+}
+
+/**
+ * Respond with the transaction objects of a tag, an address or a bundle in JSON, fetched and serialized one page at a
+ * time. served sends the body once the handler returns, so the pages are written into it as they are serialized
+ * instead of being collected in a transaction array and a serialized buffer first.
+ */
+static void send_txn_stream(served::response& res, const served::request& req, ta_txn_query_t query,
+                            char const* obj) {
+  status_t ret = SC_OK;
+  char* json_result = NULL;
+  size_t json_result_len = 0;
+  uint32_t fields = 0;
+  ta_txn_stream_t stream;
+  iri_connection iri;
+
+  ret = ta_txn_fields_parse(req.query.get("fields").c_str(), &fields);
+  if (ret == SC_OK) {
+    ret = api_txn_stream_open(iri.service, query, obj, &stream);
+  }
+  if (ret == SC_OK) {
+    while (!stream.done) {
+      ret = api_txn_stream_read(iri.service, &stream, fields, &json_result, &json_result_len);
+      if (ret != SC_OK) {
+        break;
+      }
+      res << response_buffer{json_result, json_result_len};
+      free(json_result);
+      json_result = NULL;
+    }
+    api_txn_stream_free(&stream);
+  }
+
+  ret = set_response_content(ret, &json_result);
+  set_method_header(res, HTTP_METHOD_GET);
+  res.set_status(ret);
+  if (json_result) {
+    // The pages written so far are replaced by the error
+    set_retry_after(res, json_result);
+    res.set_body(json_result);
+  }
+}
+
 int main(int argc, char* argv[]) {
   served::multiplexer mux;
   mux.use_after(served::plugin::access_log);
@@ -91,13 +240,13 @@ int main(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
-  if (ta_config_set(&ta_core.cache, &ta_core.service) != SC_OK) {
+  if (ta_config_set(&ta_core.info, &ta_core.cache, &ta_core.service) != SC_OK) {
     ta_log_critical("Configure failed %s.\n", SERVER_LOGGER);
     return EXIT_FAILURE;
   }
 
-  // Initialize apis cJSON lock
-  if (apis_lock_init() != SC_OK) {
+  // Initialize proxy apis lock
+  if (proxy_apis_lock_init() != SC_OK) {
     ta_log_critical("Lock initialization failed %s.\n", SERVER_LOGGER);
     return EXIT_FAILURE;
   }
@@ -108,6 +257,11 @@ int main(int argc, char* argv[]) {
     cc_logger_init();
     serializer_logger_init();
     pow_logger_init();
+    broadcast_batcher_logger_init();
+    task_pool_logger_init();
+    proxy_apis_logger_init();
+    confirmed_set_logger_init();
+    iri_pool_logger_init();
   } else {
     // Destroy logger when verbose mode is off
     logger_helper_release(logger_id);
@@ -124,12 +278,13 @@ int main(int argc, char* argv[]) {
         status_t ret = SC_OK;
         char* json_result = NULL;
 
-        ret = api_receive_mam_message(&ta_core.iconf, &ta_core.service, req.params["bundle"].c_str(), &json_result);
+        ret = api_receive_mam_message(&ta_core.iconf, iri_connection().service, req.params["bundle"].c_str(),
+                                      &json_result);
         ret = set_response_content(ret, &json_result);
 
         set_method_header(res, HTTP_METHOD_GET);
         res.set_status(ret);
-        res << json_result;
+        send_body(res, json_result);
       });
 
   mux.handle("/mam")
@@ -140,29 +295,29 @@ int main(int argc, char* argv[]) {
               })
       .post([&](served::response& res, const served::request& req) {
         status_t ret = SC_OK;
-        char* json_result;
+        char* json_result = NULL;
 
         if (req.header("content-type").find("application/json") == std::string::npos) {
-          cJSON* json_obj = cJSON_CreateObject();
-          cJSON_AddStringToObject(json_obj, "message", "Invalid request header");
-          json_result = cJSON_PrintUnformatted(json_obj);
-
+          json_result = static_body(BODY_INVALID_HEADER);
           res.set_status(SC_HTTP_BAD_REQUEST);
-          cJSON_Delete(json_obj);
         } else {
-          ret = api_mam_send_message(&ta_core.iconf, &ta_core.service, req.body().c_str(), &json_result);
+          ret = api_mam_send_message(&ta_core.iconf, req.body().c_str(), &json_result);
           ret = set_response_content(ret, &json_result);
           res.set_status(ret);
         }
 
         set_method_header(res, HTTP_METHOD_POST);
-        res << json_result;
+        send_body(res, json_result);
       });
 
   /**
    * @method {post} /transaction/hash Find transaction hash
    *
-   * @return {String[]} hash Transaction hash
+   * @param {Number} [limit] Respond with a page of at most `limit` hashes
+   * @param {String} [cursor] `cursor` of the previous page, to respond with the following hashes
+   * @param {Number} [since] Respond with the hashes first found from this Unix time in seconds
+   *
+   * @return {String[]} hash Transaction hash, or `{"hashes", "cursor"}` when one of the page parameters is given
    */
   mux.handle("/transaction/hash")
       .method(served::method::OPTIONS,
@@ -172,28 +327,34 @@ int main(int argc, char* argv[]) {
               })
       .post([&](served::response& res, const served::request& req) {
         status_t ret = SC_OK;
-        char* json_result;
+        char* json_result = NULL;
+        ta_page_req_t page;
+        bool paged = false;
 
         if (req.header("content-type").find("application/json") == std::string::npos) {
-          cJSON* json_obj = cJSON_CreateObject();
-          cJSON_AddStringToObject(json_obj, "message", "Invalid request header");
-          json_result = cJSON_PrintUnformatted(json_obj);
-
+          json_result = static_body(BODY_INVALID_HEADER);
           res.set_status(SC_HTTP_BAD_REQUEST);
-          cJSON_Delete(json_obj);
         } else {
-          ret = api_find_transactions(&ta_core.service, req.body().c_str(), &json_result);
+          ret = parse_page(req, &page, &paged);
+          if (ret == SC_OK) {
+            ret = paged ? api_find_transactions_page(iri_connection().service, req.body().c_str(), &page, &json_result)
+                        : api_find_transactions(iri_connection().service, req.body().c_str(), &json_result);
+          }
           ret = set_response_content(ret, &json_result);
           res.set_status(ret);
         }
 
         set_method_header(res, HTTP_METHOD_POST);
-        res << json_result;
+        send_body(res, json_result);
       });
 
   /**
    * @method {get} /transaction/<transaction hash> Find transaction object with get request
    *
+   * Transaction objects are encoded in CBOR when the request has `Accept: application/cbor`
+   *
+   * @param {String} [fields] Comma separated members of the transaction objects to respond with, all by default
+   *
    * @return {String[]} hash Transaction object
    */
   mux.handle("/transaction/{hash:[A-Z9]{81}}")
@@ -205,18 +366,34 @@ int main(int argc, char* argv[]) {
       .get([&](served::response& res, const served::request& req) {
         status_t ret = SC_OK;
         char* json_result = NULL;
+        size_t json_result_len = 0;
+        ta_txn_serialize_opt_t opt = {ta_response_format_from_accept(req.header("accept").c_str())};
 
-        ret = api_find_transaction_object_single(&ta_core.service, req.params["hash"].c_str(), &json_result);
+        ret = ta_txn_fields_parse(req.query.get("fields").c_str(), &opt.fields);
+        if (ret == SC_OK) {
+          ret = api_find_transaction_object_single(iri_connection().service, req.params["hash"].c_str(), &opt,
+                                                   &json_result, &json_result_len);
+        }
+        if (ret != SC_OK) {
+          // Errors are always reported in JSON
+          opt.format = TA_RESPONSE_FORMAT_JSON;
+          json_result_len = 0;
+        }
         ret = set_response_content(ret, &json_result);
 
-        set_method_header(res, HTTP_METHOD_GET);
+        set_method_header(res, HTTP_METHOD_GET, opt.format);
         res.set_status(ret);
-        res << json_result;
+        send_body(res, json_result, json_result_len);
       });
 
   /**
    * @method {post} /transaction/object Find transaction object
    *
+   * Transaction objects are encoded in CBOR when the request has `Accept: application/cbor`
+   *
+   * @param {String} [fields] Comma separated members of the transaction objects to respond with, all by default. The
+   *                           request body may have `fields` as well, which the query string overrides.
+   *
    * @return {String[]} object Info of entire transaction object
    */
   mux.handle("/transaction/object")
@@ -227,23 +404,30 @@ int main(int argc, char* argv[]) {
               })
       .post([&](served::response& res, const served::request& req) {
         status_t ret = SC_OK;
-        char* json_result;
+        char* json_result = NULL;
+        size_t json_result_len = 0;
+        ta_txn_serialize_opt_t opt = {ta_response_format_from_accept(req.header("accept").c_str())};
 
         if (req.header("content-type").find("application/json") == std::string::npos) {
-          cJSON* json_obj = cJSON_CreateObject();
-          cJSON_AddStringToObject(json_obj, "message", "Invalid request header");
-          json_result = cJSON_PrintUnformatted(json_obj);
-
+          json_result = static_body(BODY_INVALID_HEADER);
+          opt.format = TA_RESPONSE_FORMAT_JSON;
           res.set_status(SC_HTTP_BAD_REQUEST);
-          cJSON_Delete(json_obj);
         } else {
-          ret = api_find_transaction_objects(&ta_core.service, req.body().c_str(), &json_result);
+          ret = ta_txn_fields_parse(req.query.get("fields").c_str(), &opt.fields);
+          if (ret == SC_OK) {
+            ret = api_find_transaction_objects(iri_connection().service, req.body().c_str(), &opt, &json_result,
+                                               &json_result_len);
+          }
+          if (ret != SC_OK) {
+            opt.format = TA_RESPONSE_FORMAT_JSON;
+            json_result_len = 0;
+          }
           ret = set_response_content(ret, &json_result);
           res.set_status(ret);
         }
 
-        set_method_header(res, HTTP_METHOD_POST);
-        res << json_result;
+        set_method_header(res, HTTP_METHOD_POST, opt.format);
+        send_body(res, json_result, json_result_len);
       });
 
   /**
@@ -260,13 +444,13 @@ int main(int argc, char* argv[]) {
       .get([&](served::response& res, const served::request& req) {
         UNUSED(req);
         status_t ret = SC_OK;
-        char* json_result;
+        char* json_result = NULL;
 
-        ret = api_get_tips_pair(&ta_core.iconf, &ta_core.service, &json_result);
+        ret = api_get_tips_pair(&ta_core.iconf, iri_connection().service, &json_result);
         ret = set_response_content(ret, &json_result);
         set_method_header(res, HTTP_METHOD_GET);
         res.set_status(ret);
-        res << json_result;
+        send_body(res, json_result);
       });
 
   /**
@@ -283,13 +467,13 @@ int main(int argc, char* argv[]) {
       .get([&](served::response& res, const served::request& req) {
         UNUSED(req);
         status_t ret = SC_OK;
-        char* json_result;
+        char* json_result = NULL;
 
-        ret = api_get_tips(&ta_core.service, &json_result);
+        ret = api_get_tips(iri_connection().service, &json_result);
         ret = set_response_content(ret, &json_result);
         set_method_header(res, HTTP_METHOD_GET);
         res.set_status(ret);
-        res << json_result;
+        send_body(res, json_result);
       });
 
   /**
@@ -306,19 +490,23 @@ int main(int argc, char* argv[]) {
       .get([&](served::response& res, const served::request& req) {
         UNUSED(req);
         status_t ret = SC_OK;
-        char* json_result;
+        char* json_result = NULL;
 
-        ret = api_generate_address(&ta_core.iconf, &ta_core.service, &json_result);
+        ret = api_generate_address(&ta_core.iconf, iri_connection().service, &json_result);
         ret = set_response_content(ret, &json_result);
         set_method_header(res, HTTP_METHOD_GET);
         res.set_status(ret);
-        res << json_result;
+        send_body(res, json_result);
       });
 
   /**
    * @method {get} /tag/<transaction tag>/hashes Find transaction hash with tag
    *
-   * @return {String} address hashes
+   * @param {Number} [limit] Respond with a page of at most `limit` hashes
+   * @param {String} [cursor] `cursor` of the previous page, to respond with the following hashes
+   * @param {Number} [since] Respond with the hashes first found from this Unix time in seconds
+   *
+   * @return {String} address hashes, or `{"hashes", "cursor"}` when one of the page parameters is given
    */
   mux.handle("/tag/{tag:[A-Z9]{1,27}}/hashes")
       .method(served::method::OPTIONS,
@@ -328,21 +516,37 @@ int main(int argc, char* argv[]) {
               })
       .get([&](served::response& res, const served::request& req) {
         status_t ret = SC_OK;
-        char* json_result;
-
-        ret = api_find_transactions_by_tag(&ta_core.service, req.params["tag"].c_str(), &json_result);
+        char* json_result = NULL;
+        ta_page_req_t page;
+        bool paged = false;
+
+        ret = parse_page(req, &page, &paged);
+        if (ret == SC_OK) {
+          ret = paged ? api_find_transactions_by_tag_page(iri_connection().service, req.params["tag"].c_str(), &page,
+                                                          &json_result)
+                      : api_find_transactions_by_tag(iri_connection().service, req.params["tag"].c_str(), &json_result);
+        }
         ret = set_response_content(ret, &json_result);
         set_method_header(res, HTTP_METHOD_GET);
         res.set_status(ret);
-        res << json_result;
+        send_body(res, json_result);
       });
 
   /**
    * @method {get} /tag/:tag Find transaction objects by tag
    *
+   * Transaction objects are encoded in CBOR when the request has `Accept: application/cbor`. JSON responses are
+   * written one page of transaction objects at a time.
+   *
+   * @param {String} [fields] Comma separated members of the transaction objects to respond with, all by default
+   * @param {Number} [limit] Respond with a page of at most `limit` transaction objects
+   * @param {String} [cursor] `cursor` of the previous page, to respond with the following transaction objects
+   * @param {Number} [since] Respond with the transaction objects first found from this Unix time in seconds
+   *
    * @param {String} tag Must be 27 trytes long
    *
-   * @return {String[]} transactions List of transaction objects
+   * @return {String[]} transactions List of transaction objects, or `{"transactions", "cursor"}` when one of the page
+   * parameters is given
    */
   mux.handle("/tag/{tag:[A-Z9]{1,27}}")
       .method(served::method::OPTIONS,
@@ -352,13 +556,105 @@ int main(int argc, char* argv[]) {
               })
       .get([&](served::response& res, const served::request& req) {
         status_t ret = SC_OK;
-        char* json_result;
+        char* json_result = NULL;
+        size_t json_result_len = 0;
+        ta_txn_serialize_opt_t opt = {ta_response_format_from_accept(req.header("accept").c_str())};
+        ta_page_req_t page;
+        bool paged = false;
+
+        ret = parse_page(req, &page, &paged);
+        if (ret == SC_OK && !paged && opt.format == TA_RESPONSE_FORMAT_JSON) {
+          send_txn_stream(res, req, TA_TXN_QUERY_TAG, req.params["tag"].c_str());
+          return;
+        }
 
-        ret = api_find_transactions_obj_by_tag(&ta_core.service, req.params["tag"].c_str(), &json_result);
+        if (ret == SC_OK) {
+          ret = ta_txn_fields_parse(req.query.get("fields").c_str(), &opt.fields);
+        }
+        if (ret == SC_OK) {
+          ret = paged ? api_find_transactions_obj_by_tag_page(iri_connection().service, req.params["tag"].c_str(),
+                                                              &page, &opt, &json_result, &json_result_len)
+                      : api_find_transactions_obj_by_tag(iri_connection().service, req.params["tag"].c_str(), &opt,
+                                                         &json_result, &json_result_len);
+        }
+        if (ret != SC_OK) {
+          opt.format = TA_RESPONSE_FORMAT_JSON;
+          json_result_len = 0;
+        }
+        ret = set_response_content(ret, &json_result);
+        set_method_header(res, HTTP_METHOD_GET, opt.format);
+        res.set_status(ret);
+        send_body(res, json_result, json_result_len);
+      });
+
+  /**
+   * @method {get} /address/<address>/hashes Find transaction hashes of an address
+   *
+   * @param {Number} [limit] Respond with a page of at most `limit` hashes
+   * @param {String} [cursor] `cursor` of the previous page, to respond with the following hashes
+   * @param {Number} [since] Respond with the hashes first found from this Unix time in seconds
+   *
+   * @return {String[]} hashes Transaction hashes, or `{"hashes", "cursor"}` when one of the page parameters is given
+   */
+  mux.handle("/address/{address:[A-Z9]{81}}/hashes")
+      .method(served::method::OPTIONS,
+              [&](served::response& res, const served::request& req) {
+                UNUSED(req);
+                set_method_header(res, HTTP_METHOD_OPTIONS);
+              })
+      .get([&](served::response& res, const served::request& req) {
+        status_t ret = SC_OK;
+        char* json_result = NULL;
+        ta_page_req_t page;
+        bool paged = false;
+
+        ret = parse_page(req, &page, &paged);
+        if (ret == SC_OK) {
+          ret = api_find_transactions_by_addr(iri_connection().service, req.params["address"].c_str(),
+                                              paged ? &page : NULL, &json_result);
+        }
         ret = set_response_content(ret, &json_result);
         set_method_header(res, HTTP_METHOD_GET);
         res.set_status(ret);
-        res << json_result;
+        send_body(res, json_result);
+      });
+
+  /**
+   * @method {get} /address/:address Find transaction objects of an address
+   *
+   * Transaction objects are written one page at a time
+   *
+   * @param {String} [fields] Comma separated members of the transaction objects to respond with, all by default
+   *
+   * @return {String[]} transactions List of transaction objects
+   */
+  mux.handle("/address/{address:[A-Z9]{81}}")
+      .method(served::method::OPTIONS,
+              [&](served::response& res, const served::request& req) {
+                UNUSED(req);
+                set_method_header(res, HTTP_METHOD_OPTIONS);
+              })
+      .get([&](served::response& res, const served::request& req) {
+        send_txn_stream(res, req, TA_TXN_QUERY_ADDRESS, req.params["address"].c_str());
+      });
+
+  /**
+   * @method {get} /bundle/:bundle Find transaction objects of a bundle, reattachments included
+   *
+   * Transaction objects are written one page at a time
+   *
+   * @param {String} [fields] Comma separated members of the transaction objects to respond with, all by default
+   *
+   * @return {String[]} transactions List of transaction objects
+   */
+  mux.handle("/bundle/{bundle:[A-Z9]{81}}")
+      .method(served::method::OPTIONS,
+              [&](served::response& res, const served::request& req) {
+                UNUSED(req);
+                set_method_header(res, HTTP_METHOD_OPTIONS);
+              })
+      .get([&](served::response& res, const served::request& req) {
+        send_txn_stream(res, req, TA_TXN_QUERY_BUNDLE, req.params["bundle"].c_str());
       });
 
   /**
@@ -374,23 +670,19 @@ int main(int argc, char* argv[]) {
               })
       .post([&](served::response& res, const served::request& req) {
         status_t ret = SC_OK;
-        char* json_result;
+        char* json_result = NULL;
 
         if (req.header("content-type").find("application/json") == std::string::npos) {
-          cJSON* json_obj = cJSON_CreateObject();
-          cJSON_AddStringToObject(json_obj, "message", "Invalid request header");
-          json_result = cJSON_PrintUnformatted(json_obj);
-
+          json_result = static_body(BODY_INVALID_HEADER);
           res.set_status(SC_HTTP_BAD_REQUEST);
-          cJSON_Delete(json_obj);
         } else {
-          ret = api_send_transfer(&ta_core.iconf, &ta_core.service, req.body().c_str(), &json_result);
+          ret = api_send_transfer(&ta_core.iconf, req.body().c_str(), &json_result);
           ret = set_response_content(ret, &json_result);
           res.set_status(ret);
         }
 
         set_method_header(res, HTTP_METHOD_POST);
-        res << json_result;
+        send_body(res, json_result);
       });
 
   /**
@@ -406,23 +698,148 @@ int main(int argc, char* argv[]) {
               })
       .post([&](served::response& res, const served::request& req) {
         status_t ret = SC_OK;
-        char* json_result;
+        char* json_result = NULL;
+
+        if (req.header("content-type").find("application/json") == std::string::npos) {
+          json_result = static_body(BODY_INVALID_HEADER);
+          res.set_status(SC_HTTP_BAD_REQUEST);
+        } else {
+          ret = api_send_trytes(&ta_core.iconf, req.body().c_str(), &json_result);
+          ret = set_response_content(ret, &json_result);
+          res.set_status(ret);
+        }
+
+        set_method_header(res, HTTP_METHOD_POST);
+        send_body(res, json_result);
+      });
+
+  /**
+   * @method {post} /find/hashes Find transaction hashes of several tags, addresses, bundles and approvees
+   *
+   * @param {String[]} [tags] Tags of 1 to 27 trytes
+   * @param {String[]} [addresses] Addresses
+   * @param {String[]} [bundles] Bundle hashes
+   * @param {String[]} [approvees] Hashes of approved transactions
+   * @param {Number} [limit] Respond with a page of at most `limit` hashes
+   * @param {String} [cursor] `cursor` of the previous page, to respond with the following hashes
+   * @param {Number} [since] Respond with the hashes first found from this Unix time in seconds
+   *
+   * @return {String[]} hashes Transaction hashes, or `{"hashes", "cursor"}` when one of the page parameters is given
+   */
+  mux.handle("/find/hashes")
+      .method(served::method::OPTIONS,
+              [&](served::response& res, const served::request& req) {
+                UNUSED(req);
+                set_method_header(res, HTTP_METHOD_OPTIONS);
+              })
+      .post([&](served::response& res, const served::request& req) {
+        status_t ret = SC_OK;
+        char* json_result = NULL;
+        ta_page_req_t page;
+        bool paged = false;
+
+        if (req.header("content-type").find("application/json") == std::string::npos) {
+          json_result = static_body(BODY_INVALID_HEADER);
+          res.set_status(SC_HTTP_BAD_REQUEST);
+        } else {
+          ret = parse_page(req, &page, &paged);
+          if (ret == SC_OK) {
+            ret = api_find_transactions_multi(iri_connection().service, req.body().c_str(), paged ? &page : NULL,
+                                              &json_result);
+          }
+          ret = set_response_content(ret, &json_result);
+          res.set_status(ret);
+        }
+
+        set_method_header(res, HTTP_METHOD_POST);
+        send_body(res, json_result);
+      });
+
+  /**
+   * @method {post} /find/object Find transaction objects of several tags, addresses, bundles and approvees
+   *
+   * Transaction objects are encoded in CBOR when the request has `Accept: application/cbor`
+   *
+   * @param {String[]} [tags] Tags of 1 to 27 trytes
+   * @param {String[]} [addresses] Addresses
+   * @param {String[]} [bundles] Bundle hashes
+   * @param {String[]} [approvees] Hashes of approved transactions
+   * @param {String} [fields] Comma separated members of the transaction objects to respond with, all by default
+   * @param {Number} [limit] Respond with a page of at most `limit` transaction objects
+   * @param {String} [cursor] `cursor` of the previous page, to respond with the following transaction objects
+   * @param {Number} [since] Respond with the transaction objects first found from this Unix time in seconds
+   *
+   * @return {String[]} transactions List of transaction objects, or `{"transactions", "cursor"}` when one of the page
+   * parameters is given
+   */
+  mux.handle("/find/object")
+      .method(served::method::OPTIONS,
+              [&](served::response& res, const served::request& req) {
+                UNUSED(req);
+                set_method_header(res, HTTP_METHOD_OPTIONS);
+              })
+      .post([&](served::response& res, const served::request& req) {
+        status_t ret = SC_OK;
+        char* json_result = NULL;
+        size_t json_result_len = 0;
+        ta_txn_serialize_opt_t opt = {ta_response_format_from_accept(req.header("accept").c_str())};
+        ta_page_req_t page;
+        bool paged = false;
 
         if (req.header("content-type").find("application/json") == std::string::npos) {
-          cJSON* json_obj = cJSON_CreateObject();
-          cJSON_AddStringToObject(json_obj, "message", "Invalid request header");
-          json_result = cJSON_PrintUnformatted(json_obj);
+          json_result = static_body(BODY_INVALID_HEADER);
+          opt.format = TA_RESPONSE_FORMAT_JSON;
+          res.set_status(SC_HTTP_BAD_REQUEST);
+        } else {
+          ret = parse_page(req, &page, &paged);
+          if (ret == SC_OK) {
+            ret = ta_txn_fields_parse(req.query.get("fields").c_str(), &opt.fields);
+          }
+          if (ret == SC_OK) {
+            ret = api_find_transactions_obj_multi(iri_connection().service, req.body().c_str(), paged ? &page : NULL,
+                                                  &opt, &json_result, &json_result_len);
+          }
+          if (ret != SC_OK) {
+            opt.format = TA_RESPONSE_FORMAT_JSON;
+            json_result_len = 0;
+          }
+          ret = set_response_content(ret, &json_result);
+          res.set_status(ret);
+        }
+
+        set_method_header(res, HTTP_METHOD_POST, opt.format);
+        send_body(res, json_result, json_result_len);
+      });
 
+  /**
+   * @method {post} /batch Run several lookups in one request
+   *
+   * @param {Object[]} requests Sub-requests, each with a `command` among generate_address, get_tips_pair, get_tips,
+   * find_transactions_by_tag, find_transactions_obj_by_tag and find_transaction_objects, and its arguments
+   *
+   * @return {Object[]} results Results in the order of the sub-requests, `{"error":<status code>}` for failed ones
+   */
+  mux.handle("/batch")
+      .method(served::method::OPTIONS,
+              [&](served::response& res, const served::request& req) {
+                UNUSED(req);
+                set_method_header(res, HTTP_METHOD_OPTIONS);
+              })
+      .post([&](served::response& res, const served::request& req) {
+        status_t ret = SC_OK;
+        char* json_result = NULL;
+
+        if (req.header("content-type").find("application/json") == std::string::npos) {
+          json_result = static_body(BODY_INVALID_HEADER);
           res.set_status(SC_HTTP_BAD_REQUEST);
-          cJSON_Delete(json_obj);
         } else {
-          ret = api_send_trytes(&ta_core.iconf, &ta_core.service, req.body().c_str(), &json_result);
+          ret = api_batch(&ta_core.iconf, iri_connection().service, req.body().c_str(), &json_result);
           ret = set_response_content(ret, &json_result);
           res.set_status(ret);
         }
 
         set_method_header(res, HTTP_METHOD_POST);
-        res << json_result;
+        send_body(res, json_result);
       });
 
   /**
@@ -438,21 +855,21 @@ int main(int argc, char* argv[]) {
                 set_method_header(res, HTTP_METHOD_OPTIONS);
               })
       .get([](served::response& res, const served::request&) {
-        cJSON* json_obj = cJSON_CreateObject();
-        cJSON_AddStringToObject(json_obj, "message", "Invalid path");
-        const char* json = cJSON_PrintUnformatted(json_obj);
-
         res.set_status(SC_HTTP_BAD_REQUEST);
         set_method_header(res, HTTP_METHOD_GET);
-        res << json;
-
-        cJSON_Delete(json_obj);
+        send_body(res, static_body(BODY_INVALID_PATH));
       });
 
   /**
    * @method {get} / Dump information about a running accelerator
+   * @method {post} / Call an IRI API, so IRI clients can use the accelerator as their node
+   *
+   * checkConsistency, findTransactions, getBalances, getInclusionStates, getNodeInfo and getTrytes are served, the
+   * immutable results of them from the cache
+   *
+   * @param {String} command IRI API command, for POST
    *
-   * @return {String[]} object Info of a running accelerator
+   * @return {String[]} object Info of a running accelerator, or the response of the IRI API for POST
    */
   mux.handle("/")
       .method(served::method::OPTIONS,
@@ -469,14 +886,30 @@ int main(int argc, char* argv[]) {
 
         set_method_header(res, HTTP_METHOD_GET);
         res.set_status(ret);
-        res << json_result;
+        send_body(res, json_result);
+      })
+      .post([&](served::response& res, const served::request& req) {
+        status_t ret = SC_OK;
+        char* json_result = NULL;
+
+        if (req.header("content-type").find("application/json") == std::string::npos) {
+          json_result = static_body(BODY_INVALID_HEADER);
+          res.set_status(SC_HTTP_BAD_REQUEST);
+        } else {
+          ret = proxy_api_wrapper(iri_connection().service, req.body().c_str(), &json_result);
+          ret = set_response_content(ret, &json_result);
+          res.set_status(ret);
+        }
+
+        set_method_header(res, HTTP_METHOD_POST);
+        send_body(res, json_result);
       });
 
   std::cout << "Starting..." << std::endl;
   served::net::server server(ta_core.info.host, ta_core.info.port, mux);
   server.run(ta_core.info.thread_count);
 
-  if (apis_lock_destroy() != SC_OK) {
+  if (proxy_apis_lock_destroy() != SC_OK) {
     ta_log_critical("Destroying api lock failed %s.\n", SERVER_LOGGER);
     return EXIT_FAILURE;
   }
@@ -487,6 +920,11 @@ int main(int argc, char* argv[]) {
     cc_logger_release();
     serializer_logger_release();
     pow_logger_release();
+    broadcast_batcher_logger_release();
+    task_pool_logger_release();
+    proxy_apis_logger_release();
+    confirmed_set_logger_release();
+    iri_pool_logger_release();
     logger_helper_release(logger_id);
     if (logger_helper_destroy() != RC_OK) {
       return EXIT_FAILURE;
@@ -22,7 +22,9 @@ extern "C" {
  */
 
 #define ID_LEN 32
-#define API_NUM 7
+#define API_NUM 10
+/** Suffix of the topics replying transaction objects in CBOR instead of JSON */
+#define CBOR_TOPIC_SUFFIX "/cbor"
 
 typedef enum client_type_s { client_pub, client_sub, client_duplex } client_type_t;
 
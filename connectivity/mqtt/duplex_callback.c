@@ -27,6 +27,17 @@ int mqtt_callback_logger_release() {
   return 0;
 }
 
+/**
+ * Transaction objects are replied in CBOR on the topics ending with CBOR_TOPIC_SUFFIX
+ */
+static ta_response_format_t mqtt_topic_format(char const *topic) {
+  size_t topic_len = strlen(topic), suffix_len = strlen(CBOR_TOPIC_SUFFIX);
+  if (topic_len >= suffix_len && !strcmp(topic + topic_len - suffix_len, CBOR_TOPIC_SUFFIX)) {
+    return TA_RESPONSE_FORMAT_CBOR;
+  }
+  return TA_RESPONSE_FORMAT_JSON;
+}
+
 static status_t mqtt_request_handler(mosq_config_t *cfg, char *subscribe_topic, char *req) {
   if (cfg == NULL || subscribe_topic == NULL || req == NULL) {
     return SC_MQTT_NULL;
@@ -34,10 +45,12 @@ static status_t mqtt_request_handler(mosq_config_t *cfg, char *subscribe_topic,
 
   status_t ret = SC_OK;
   char *json_result = NULL;
-  char device_id[ID_LEN];
+  size_t json_result_len = 0;
+  char device_id[ID_LEN + 1];
+  ta_txn_serialize_opt_t opt = {.format = mqtt_topic_format(subscribe_topic)};
 
   // get the Device ID.
-  ret = mqtt_device_id_deserialize(req, device_id);
+  ret = mqtt_device_id_deserialize(req, device_id, sizeof(device_id));
   if (ret != SC_OK) {
     ta_log_error("%d\n", ret);
     goto done;
@@ -50,20 +63,32 @@ static status_t mqtt_request_handler(mosq_config_t *cfg, char *subscribe_topic,
   } else if ((p = strstr(api_sub_topic, "tag"))) {
     if (!strncmp(p + 4, "hashes", 6)) {
       char tag[NUM_TRYTES_TAG + 1];
-      mqtt_tag_req_deserialize(req, tag);
-      ret = api_find_transactions_by_tag(&ta_core.service, tag, &json_result);
+      ret = mqtt_tag_req_deserialize(req, tag, sizeof(tag));
+      if (ret == SC_OK) {
+        ret = api_find_transactions_by_tag(&ta_core.service, tag, &json_result);
+      }
     } else if (!strncmp(p + 4, "object", 6)) {
       char tag[NUM_TRYTES_TAG + 1];
-      mqtt_tag_req_deserialize(req, tag);
-      ret = api_find_transactions_obj_by_tag(&ta_core.service, tag, &json_result);
+      ret = mqtt_tag_req_deserialize(req, tag, sizeof(tag));
+      if (ret == SC_OK) {
+        ret = mqtt_txn_fields_req_deserialize(req, &opt.fields);
+      }
+      if (ret == SC_OK) {
+        ret = api_find_transactions_obj_by_tag(&ta_core.service, tag, &opt, &json_result, &json_result_len);
+      }
     }
   } else if ((p = strstr(api_sub_topic, "transaction"))) {
     if (!strncmp(p + 12, "object", 6)) {
       char hash[NUM_TRYTES_HASH + 1];
-      mqtt_transaction_hash_req_deserialize(req, hash);
-      ret = api_find_transaction_object_single(&ta_core.service, hash, &json_result);
+      ret = mqtt_transaction_hash_req_deserialize(req, hash, sizeof(hash));
+      if (ret == SC_OK) {
+        ret = mqtt_txn_fields_req_deserialize(req, &opt.fields);
+      }
+      if (ret == SC_OK) {
+        ret = api_find_transaction_object_single(&ta_core.service, hash, &opt, &json_result, &json_result_len);
+      }
     } else if (!strncmp(p + 12, "send", 4)) {
-      ret = api_send_transfer(&ta_core.iconf, &ta_core.service, req, &json_result);
+      ret = api_send_transfer(&ta_core.iconf, req, &json_result);
     }
   } else if ((p = strstr(api_sub_topic, "tips"))) {
     if (!strncmp(p + 5, "all", 3)) {
@@ -71,6 +96,12 @@ static status_t mqtt_request_handler(mosq_config_t *cfg, char *subscribe_topic,
     } else if (!strncmp(p + 5, "pair", 4)) {
       ret = api_get_tips_pair(&ta_core.iconf, &ta_core.service, &json_result);
     }
+  } else if (strstr(api_sub_topic, "batch")) {
+    ret = api_batch(&ta_core.iconf, &ta_core.service, req, &json_result);
+  }
+  if (ret == SC_UTILS_POW_OVERLOADED) {
+    // Reply with an error instead of dropping the request, so the device knows when to retry
+    ret = mqtt_busy_res_serialize(pow_admission_retry_after(), &json_result);
   }
   if (ret != SC_OK) {
     ta_log_error("%d\n", ret);
@@ -88,7 +119,11 @@ static status_t mqtt_request_handler(mosq_config_t *cfg, char *subscribe_topic,
   }
 
   // Set recv_message as publishing message
-  ret = gossip_message_set(cfg, json_result);
+  if (opt.format == TA_RESPONSE_FORMAT_CBOR && json_result_len) {
+    ret = gossip_binary_message_set(cfg, json_result, json_result_len);
+  } else {
+    ret = gossip_message_set(cfg, json_result);
+  }
   if (ret != SC_OK) {
     ta_log_error("%d\n", ret);
   }
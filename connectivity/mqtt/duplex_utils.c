@@ -104,8 +104,16 @@ status_t gossip_api_channels_set(mosq_config_t *channel_cfg, char *host, char *r
   char *sub_topic = NULL;
   int sub_topic_len, api_name_len;
   int root_path_len = strlen(root_path);
-  char *api_names[API_NUM] = {"address",          "tag/hashes", "tag/object", "transaction/object",
-                              "transaction/send", "tips/all",   "tips/pair"};
+  char *api_names[API_NUM] = {"address",
+                              "tag/hashes",
+                              "tag/object",
+                              "tag/object" CBOR_TOPIC_SUFFIX,
+                              "transaction/object",
+                              "transaction/object" CBOR_TOPIC_SUFFIX,
+                              "transaction/send",
+                              "tips/all",
+                              "tips/pair",
+                              "batch"};
 
   for (int i = 0; i < API_NUM; i++) {
     api_name_len = strlen(api_names[i]);
@@ -144,6 +152,23 @@ status_t gossip_message_set(mosq_config_t *cfg, char *message) {
   return SC_OK;
 }
 
+status_t gossip_binary_message_set(mosq_config_t *cfg, char const *message, size_t len) {
+  if (cfg == NULL || message == NULL) {
+    ta_log_error("%s\n", "SC_TA_NULL");
+    return SC_MQTT_NULL;
+  }
+
+  cfg->pub_config->message = (char *)malloc(len);
+  if (cfg->pub_config->message == NULL) {
+    ta_log_error("%s\n", "SC_MQTT_OOM");
+    return SC_MQTT_OOM;
+  }
+  memcpy(cfg->pub_config->message, message, len);
+  cfg->pub_config->msglen = len;
+
+  return SC_OK;
+}
+
 status_t duplex_client_start(struct mosquitto *mosq, mosq_config_t *cfg) {
   status_t ret = MOSQ_ERR_SUCCESS;
   if (mosq == NULL || cfg == NULL) {
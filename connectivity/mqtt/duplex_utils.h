@@ -91,6 +91,19 @@ status_t gossip_api_channels_set(mosq_config_t *channel_cfg, char *host, char *r
  */
 status_t gossip_message_set(mosq_config_t *channel_cfg, char *message);
 
+/**
+ * @brief Set a binary message that is going to be sent.
+ *
+ * @param[in] channel_cfg pointer of `mosq_config_t` object
+ * @param[in] message message that going to be published, which may contain NUL bytes
+ * @param[in] len length of the message
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t gossip_binary_message_set(mosq_config_t *channel_cfg, char const *message, size_t len);
+
 /**
  * @brief Start duplex client.
  *
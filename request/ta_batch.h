@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef REQUEST_TA_BATCH_H_
+#define REQUEST_TA_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "utils/hash243_vector.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file request/ta_batch.h
+ */
+
+/** Upper bound of the number of sub-requests of a batch */
+#define TA_BATCH_MAX_REQUESTS 64
+
+/** APIs which can be called in a batch, named by the `command` of a sub-request */
+typedef enum {
+  TA_BATCH_GENERATE_ADDRESS,         /**< "generate_address" */
+  TA_BATCH_GET_TIPS_PAIR,            /**< "get_tips_pair" */
+  TA_BATCH_GET_TIPS,                 /**< "get_tips" */
+  TA_BATCH_FIND_TXN_BY_TAG,          /**< "find_transactions_by_tag" with `tag` */
+  TA_BATCH_FIND_TXN_OBJ_BY_TAG,      /**< "find_transactions_obj_by_tag" with `tag` and optional `fields` */
+  TA_BATCH_FIND_TRANSACTION_OBJECTS, /**< "find_transaction_objects" with `hashes` and optional `fields` */
+  TA_BATCH_CMD_NUM
+} ta_batch_cmd_t;
+
+/** struct of ta_batch_sub_req_t */
+typedef struct ta_batch_sub_req_s {
+  /** API to call. */
+  ta_batch_cmd_t cmd;
+  /** NUL terminated `tag` of the tag commands, inside the request buffer. NULL for the others. */
+  char const* tag;
+  /** Transaction hashes of "find_transaction_objects", in the arena of the request. */
+  hash243_vector_t hashes;
+  /** Members of the transaction objects to respond with, as a mask of ta_txn_field_t. 0 for all of them. */
+  uint32_t fields;
+} ta_batch_sub_req_t;
+
+/** struct of ta_batch_req_t */
+typedef struct ta_batch_req_s {
+  /** Number of sub-requests. */
+  size_t num;
+  /** Sub-requests, in the order of the request. Their results are returned in the same order. */
+  ta_batch_sub_req_t reqs[TA_BATCH_MAX_REQUESTS];
+} ta_batch_req_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // REQUEST_TA_BATCH_H_
@@ -12,14 +12,15 @@ ta_find_transaction_objects_req_t* ta_find_transaction_objects_req_new() {
   ta_find_transaction_objects_req_t* req =
       (ta_find_transaction_objects_req_t*)malloc(sizeof(ta_find_transaction_objects_req_t));
   if (req != NULL) {
-    req->hashes = NULL;
+    hash243_vector_init(&req->hashes, NULL);
+    req->fields = 0;
     return req;
   }
   return NULL;
 }
 
 void ta_find_transaction_objects_req_free(ta_find_transaction_objects_req_t** req) {
-  hash243_queue_free(&(*req)->hashes);
+  hash243_vector_free(&(*req)->hashes);
   free((*req));
   *req = NULL;
 }
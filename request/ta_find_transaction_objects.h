@@ -11,7 +11,7 @@
 
 #include "accelerator/errors.h"
 #include "common/model/transaction.h"
-#include "utils/containers/hash/hash243_queue.h"
+#include "utils/hash243_vector.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,8 +23,10 @@ extern "C" {
 
 /** struct of ta_find_transaction_objects_req_t */
 typedef struct ta_find_transaction_objects_req {
-  /** Transaction hashes in ascii with UT_array. */
-  hash243_queue_t hashes;
+  /** Transaction hashes in flex trits, contiguous in hash243_vector_t. */
+  hash243_vector_t hashes;
+  /** Members of the transaction objects to respond with, as a mask of ta_txn_field_t. 0 for all of them. */
+  uint32_t fields;
 } ta_find_transaction_objects_req_t;
 
 /**
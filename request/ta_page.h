@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef REQUEST_TA_PAGE_H_
+#define REQUEST_TA_PAGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file request/ta_page.h
+ */
+
+/** Number of items of a page when the request gives no `limit` */
+#define TA_PAGE_DEFAULT_LIMIT 100
+/** Upper bound of the `limit` of a page */
+#define TA_PAGE_MAX_LIMIT 1000
+
+/** struct of ta_page_req_t */
+typedef struct ta_page_req_s {
+  /** Maximum number of items of the page. */
+  size_t limit;
+  /** Position after the items already received, the `cursor` of the previous page. 0 for the first page. */
+  size_t cursor;
+  /** Only items first seen at or after this Unix time in seconds. 0 for all of them. */
+  uint64_t since;
+} ta_page_req_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // REQUEST_TA_PAGE_H_
@@ -12,7 +12,7 @@ ta_find_transactions_by_tag_res_t* ta_find_transactions_res_new() {
   ta_find_transactions_by_tag_res_t* res =
       (ta_find_transactions_by_tag_res_t*)malloc(sizeof(ta_find_transactions_by_tag_res_t));
   if (res) {
-    res->hashes = NULL;
+    hash243_vector_init(&res->hashes, NULL);
   }
   return res;
 }
@@ -22,9 +22,7 @@ void ta_find_transactions_res_free(ta_find_transactions_by_tag_res_t** res) {
     return;
   }
 
-  if ((*res)->hashes) {
-    hash243_queue_free(&(*res)->hashes);
-  }
+  hash243_vector_free(&(*res)->hashes);
   free(*res);
   *res = NULL;
 }
@@ -10,7 +10,7 @@
 #define RESPONSE_TA_FIND_TRANSACTIONS_H_
 
 #include <stdlib.h>
-#include "utils/containers/hash/hash243_queue.h"
+#include "utils/hash243_vector.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,8 +22,8 @@ extern "C" {
 
 /** struct of ta_find_transactions_by_tag_res_t */
 typedef struct ta_find_transactions_res {
-  /** Transaction hashes is a 243 long flex trits hash queue. */
-  hash243_queue_t hashes;
+  /** Transaction hashes is a 243 long flex trits hash vector. */
+  hash243_vector_t hashes;
 } ta_find_transactions_by_tag_res_t;
 
 /**
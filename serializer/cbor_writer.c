@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "cbor_writer.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** @name Major types, in the top 3 bits of the initial byte */
+/** @{ */
+#define CBOR_UNSIGNED 0x00
+#define CBOR_NEGATIVE 0x20
+#define CBOR_BYTES 0x40
+#define CBOR_TEXT 0x60
+#define CBOR_ARRAY 0x80
+#define CBOR_MAP 0xA0
+/** @} */
+
+/** Additional information telling the argument follows in 1, 2, 4 or 8 bytes */
+#define CBOR_ARG_1 24
+
+status_t cbor_writer_init(cbor_writer_t* const writer, const size_t capacity) {
+  writer->len = 0;
+  writer->cap = capacity ? capacity : 1;
+  writer->buf = (uint8_t*)malloc(writer->cap);
+  if (writer->buf == NULL) {
+    writer->cap = 0;
+    return SC_SERIALIZER_OOM;
+  }
+  return SC_OK;
+}
+
+void cbor_writer_free(cbor_writer_t* const writer) {
+  free(writer->buf);
+  writer->buf = NULL;
+  writer->len = writer->cap = 0;
+}
+
+uint8_t* cbor_writer_detach(cbor_writer_t* const writer, size_t* const len) {
+  uint8_t* out = writer->buf;
+  *len = writer->len;
+  writer->buf = NULL;
+  writer->len = writer->cap = 0;
+  return out;
+}
+
+status_t cbor_writer_reserve(cbor_writer_t* const writer, const size_t size) {
+  size_t needed = writer->len + size;
+  if (needed <= writer->cap) {
+    return SC_OK;
+  }
+
+  size_t cap = writer->cap * 2;
+  if (cap < needed) {
+    cap = needed;
+  }
+  uint8_t* buf = (uint8_t*)realloc(writer->buf, cap);
+  if (buf == NULL) {
+    return SC_SERIALIZER_OOM;
+  }
+  writer->buf = buf;
+  writer->cap = cap;
+  return SC_OK;
+}
+
+/**
+ * Write the head of a data item followed by `size` more bytes, which are reserved along with the head.
+ */
+static status_t writer_head(cbor_writer_t* const writer, const uint8_t major, const uint64_t arg, const size_t size) {
+  if (cbor_writer_reserve(writer, CBOR_WRITER_HEAD_LEN + size) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+
+  uint8_t* p = writer->buf + writer->len;
+  int arg_len = 0;
+  if (arg < CBOR_ARG_1) {
+    *p++ = major | (uint8_t)arg;
+  } else if (arg <= UINT8_MAX) {
+    *p++ = major | CBOR_ARG_1;
+    arg_len = 1;
+  } else if (arg <= UINT16_MAX) {
+    *p++ = major | (CBOR_ARG_1 + 1);
+    arg_len = 2;
+  } else if (arg <= UINT32_MAX) {
+    *p++ = major | (CBOR_ARG_1 + 2);
+    arg_len = 4;
+  } else {
+    *p++ = major | (CBOR_ARG_1 + 3);
+    arg_len = 8;
+  }
+  // The argument is big endian
+  for (int i = arg_len; i-- > 0;) {
+    *p++ = (uint8_t)(arg >> (i * 8));
+  }
+  writer->len = p - writer->buf;
+  return SC_OK;
+}
+
+status_t cbor_writer_array(cbor_writer_t* const writer, const uint64_t count) {
+  return writer_head(writer, CBOR_ARRAY, count, 0);
+}
+
+status_t cbor_writer_map(cbor_writer_t* const writer, const uint64_t count) {
+  return writer_head(writer, CBOR_MAP, count, 0);
+}
+
+status_t cbor_writer_int(cbor_writer_t* const writer, const int64_t number) {
+  if (number < 0) {
+    // -1 - n without overflowing on INT64_MIN
+    return writer_head(writer, CBOR_NEGATIVE, ~(uint64_t)number, 0);
+  }
+  return writer_head(writer, CBOR_UNSIGNED, (uint64_t)number, 0);
+}
+
+status_t cbor_writer_text(cbor_writer_t* const writer, char const* const str, const size_t len) {
+  if (writer_head(writer, CBOR_TEXT, len, len) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+  memcpy(writer->buf + writer->len, str, len);
+  writer->len += len;
+  return SC_OK;
+}
+
+status_t cbor_writer_bytes(cbor_writer_t* const writer, uint8_t const* const data, const size_t len) {
+  uint8_t* p = cbor_writer_bytes_inplace(writer, len);
+  if (p == NULL) {
+    return SC_SERIALIZER_OOM;
+  }
+  if (len) {
+    memcpy(p, data, len);
+  }
+  return SC_OK;
+}
+
+uint8_t* cbor_writer_bytes_inplace(cbor_writer_t* const writer, const size_t len) {
+  if (writer_head(writer, CBOR_BYTES, len, len) != SC_OK) {
+    return NULL;
+  }
+  uint8_t* p = writer->buf + writer->len;
+  writer->len += len;
+  return p;
+}
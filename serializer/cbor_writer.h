@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef SERIALIZER_CBOR_WRITER_H_
+#define SERIALIZER_CBOR_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "accelerator/errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file cbor_writer.h
+ * @brief Streaming CBOR writer
+ *
+ * Writes CBOR (RFC 7049) data items into one growable buffer, the binary counterpart of `json_writer.h`. Arrays and
+ * maps are written with a definite length, so the number of elements or members has to be known when they are
+ * opened. Every head uses the shortest encoding of its argument, which is what the canonical CBOR rules ask for.
+ *
+ * @example test_serializer.c
+ */
+
+/** Streaming CBOR writer */
+typedef struct cbor_writer_s {
+  uint8_t* buf; /**< Output */
+  size_t len;   /**< Length of the output */
+  size_t cap;   /**< Allocated size of `buf` */
+} cbor_writer_t;
+
+/** Longest head of a data item, the initial byte and an 8 bytes argument */
+#define CBOR_WRITER_HEAD_LEN 9
+
+/**
+ * @brief Initialize a writer with an estimated output size
+ *
+ * @param[out] writer The writer
+ * @param[in] capacity Initial size of the buffer, the buffer grows when needed
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t cbor_writer_init(cbor_writer_t* const writer, const size_t capacity);
+
+/**
+ * @brief Release the buffer of the writer
+ *
+ * @param[in] writer The writer
+ */
+void cbor_writer_free(cbor_writer_t* const writer);
+
+/**
+ * @brief Hand the output over to the caller
+ *
+ * The writer is left empty and must be initialized again before reuse.
+ *
+ * @param[in] writer The writer
+ * @param[out] len Length of the output
+ *
+ * @return The output, which should be released with `free()`
+ */
+uint8_t* cbor_writer_detach(cbor_writer_t* const writer, size_t* const len);
+
+/**
+ * @brief Make sure `size` more bytes can be written without growing the buffer
+ *
+ * @param[in] writer The writer
+ * @param[in] size Number of bytes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t cbor_writer_reserve(cbor_writer_t* const writer, const size_t size);
+
+/** @name Containers, followed by `count` elements or `count` pairs of key and value */
+/** @{ */
+status_t cbor_writer_array(cbor_writer_t* const writer, const uint64_t count);
+status_t cbor_writer_map(cbor_writer_t* const writer, const uint64_t count);
+/** @} */
+
+/**
+ * @brief Write an integer, as an unsigned or a negative integer depending on its sign
+ *
+ * @param[in] writer The writer
+ * @param[in] number Integer value
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t cbor_writer_int(cbor_writer_t* const writer, const int64_t number);
+
+/**
+ * @brief Write a UTF-8 text string
+ *
+ * @param[in] writer The writer
+ * @param[in] str String value
+ * @param[in] len Length of the string
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t cbor_writer_text(cbor_writer_t* const writer, char const* const str, const size_t len);
+
+/**
+ * @brief Write a byte string
+ *
+ * @param[in] writer The writer
+ * @param[in] data Bytes
+ * @param[in] len Number of bytes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t cbor_writer_bytes(cbor_writer_t* const writer, uint8_t const* const data, const size_t len);
+
+/**
+ * @brief Reserve a byte string of a known length and let the caller fill it in place
+ *
+ * @param[in] writer The writer
+ * @param[in] len Number of bytes
+ *
+ * @return Position to write the bytes at, or NULL on OOM
+ */
+uint8_t* cbor_writer_bytes_inplace(cbor_writer_t* const writer, const size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SERIALIZER_CBOR_WRITER_H_
@@ -0,0 +1,390 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "json_tokenizer.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Longest number literal accepted, cJSON uses the same limit */
+#define JSON_TOKENIZER_NUMBER_LEN 64
+
+typedef struct json_tokenizer_s {
+  char* p;
+  arena_t* arena;
+  int depth;
+} json_tokenizer_t;
+
+static status_t parse_value(json_tokenizer_t* const t, json_token_t* const token);
+
+static inline void skip_whitespace(json_tokenizer_t* const t) {
+  while (*t->p && (unsigned char)*t->p <= ' ') {
+    t->p++;
+  }
+}
+
+static json_token_t* token_new(json_tokenizer_t* const t) {
+  json_token_t* token = (json_token_t*)arena_alloc(t->arena, sizeof(json_token_t));
+  if (token) {
+    memset(token, 0, sizeof(json_token_t));
+  }
+  return token;
+}
+
+static int parse_hex4(char const* const s) {
+  int value = 0;
+  for (int i = 0; i < 4; i++) {
+    char c = s[i];
+    value <<= 4;
+    if (c >= '0' && c <= '9') {
+      value |= c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      value |= c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      value |= c - 'A' + 10;
+    } else {
+      return -1;
+    }
+  }
+  return value;
+}
+
+/**
+ * Decode a \u escape sequence, with a surrogate pair if any, into UTF-8. `*in` points at the 'u' and is moved past
+ * the sequence. The output is never longer than the sequence.
+ */
+static status_t unescape_utf16(char** const in, char** const out) {
+  char* r = *in;
+  int code = parse_hex4(r + 1);
+  if (code < 0) {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  r += 5;
+
+  if (code >= 0xDC00 && code <= 0xDFFF) {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  if (code >= 0xD800 && code <= 0xDBFF) {
+    int low = (r[0] == '\\' && r[1] == 'u') ? parse_hex4(r + 2) : -1;
+    if (low < 0xDC00 || low > 0xDFFF) {
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+    code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+    r += 6;
+  }
+
+  unsigned char* w = (unsigned char*)*out;
+  if (code < 0x80) {
+    *w++ = code;
+  } else if (code < 0x800) {
+    *w++ = 0xC0 | (code >> 6);
+    *w++ = 0x80 | (code & 0x3F);
+  } else if (code < 0x10000) {
+    *w++ = 0xE0 | (code >> 12);
+    *w++ = 0x80 | ((code >> 6) & 0x3F);
+    *w++ = 0x80 | (code & 0x3F);
+  } else {
+    *w++ = 0xF0 | (code >> 18);
+    *w++ = 0x80 | ((code >> 12) & 0x3F);
+    *w++ = 0x80 | ((code >> 6) & 0x3F);
+    *w++ = 0x80 | (code & 0x3F);
+  }
+  *in = r;
+  *out = (char*)w;
+  return SC_OK;
+}
+
+/**
+ * Unescape a string in place. The closing quote is overwritten with the NUL terminator, unescaping only shrinks the
+ * string so the write position never passes the read position.
+ */
+static status_t parse_string(json_tokenizer_t* const t, char** const str, size_t* const len) {
+  char* r = t->p + 1;
+  char* w = r;
+
+  *str = r;
+  for (;;) {
+    char c = *r;
+    if (c == '\0') {
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+    if (c == '"') {
+      break;
+    }
+    if (c != '\\') {
+      *w++ = *r++;
+      continue;
+    }
+
+    r++;
+    switch (*r) {
+      case '"':
+      case '\\':
+      case '/':
+        *w++ = *r++;
+        break;
+      case 'b':
+        *w++ = '\b';
+        r++;
+        break;
+      case 'f':
+        *w++ = '\f';
+        r++;
+        break;
+      case 'n':
+        *w++ = '\n';
+        r++;
+        break;
+      case 'r':
+        *w++ = '\r';
+        r++;
+        break;
+      case 't':
+        *w++ = '\t';
+        r++;
+        break;
+      case 'u':
+        if (unescape_utf16(&r, &w) != SC_OK) {
+          return SC_SERIALIZER_JSON_PARSE;
+        }
+        break;
+      default:
+        return SC_SERIALIZER_JSON_PARSE;
+    }
+  }
+
+  *w = '\0';
+  *len = w - *str;
+  t->p = r + 1;
+  return SC_OK;
+}
+
+static status_t parse_number(json_tokenizer_t* const t, json_token_t* const token) {
+  char buf[JSON_TOKENIZER_NUMBER_LEN];
+  char* end = NULL;
+  size_t len = 0;
+
+  // Collect the same characters as cJSON and let strtod() decide
+  while (len < sizeof(buf) - 1 && ((t->p[len] >= '0' && t->p[len] <= '9') || t->p[len] == '+' || t->p[len] == '-' ||
+                                   t->p[len] == '.' || t->p[len] == 'e' || t->p[len] == 'E')) {
+    buf[len] = t->p[len];
+    len++;
+  }
+  buf[len] = '\0';
+
+  token->number = strtod(buf, &end);
+  if (end == buf) {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  if (token->number >= INT_MAX) {
+    token->integer = INT_MAX;
+  } else if (token->number <= (double)INT_MIN) {
+    token->integer = INT_MIN;
+  } else {
+    token->integer = (int)token->number;
+  }
+  token->type = JSON_TOKEN_NUMBER;
+  t->p += end - buf;
+  return SC_OK;
+}
+
+static status_t parse_literal(json_tokenizer_t* const t, json_token_t* const token, char const* const literal,
+                              const json_token_type_t type) {
+  size_t len = strlen(literal);
+  if (strncmp(t->p, literal, len)) {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  token->type = type;
+  t->p += len;
+  return SC_OK;
+}
+
+/**
+ * Parse the elements of an array or the members of an object. `t->p` points at the opening bracket.
+ */
+static status_t parse_container(json_tokenizer_t* const t, json_token_t* const token, const bool is_object) {
+  status_t ret = SC_OK;
+  const char close = is_object ? '}' : ']';
+  json_token_t** tail = &token->child;
+
+  if (++t->depth > JSON_TOKENIZER_MAX_DEPTH) {
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  token->type = is_object ? JSON_TOKEN_OBJECT : JSON_TOKEN_ARRAY;
+  t->p++;
+  skip_whitespace(t);
+  if (*t->p == close) {
+    t->p++;
+    t->depth--;
+    return SC_OK;
+  }
+
+  for (;;) {
+    json_token_t* child = token_new(t);
+    if (child == NULL) {
+      return SC_SERIALIZER_OOM;
+    }
+
+    if (is_object) {
+      size_t key_len = 0;
+      skip_whitespace(t);
+      if (*t->p != '"') {
+        return SC_SERIALIZER_JSON_PARSE;
+      }
+      ret = parse_string(t, &child->key, &key_len);
+      if (ret != SC_OK) {
+        return ret;
+      }
+      skip_whitespace(t);
+      if (*t->p != ':') {
+        return SC_SERIALIZER_JSON_PARSE;
+      }
+      t->p++;
+    }
+
+    ret = parse_value(t, child);
+    if (ret != SC_OK) {
+      return ret;
+    }
+    *tail = child;
+    tail = &child->next;
+    token->size++;
+
+    skip_whitespace(t);
+    if (*t->p == ',') {
+      t->p++;
+    } else if (*t->p == close) {
+      t->p++;
+      t->depth--;
+      return SC_OK;
+    } else {
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+  }
+}
+
+static status_t parse_value(json_tokenizer_t* const t, json_token_t* const token) {
+  skip_whitespace(t);
+  switch (*t->p) {
+    case '"':
+      token->type = JSON_TOKEN_STRING;
+      return parse_string(t, &token->str, &token->len);
+    case '{':
+      return parse_container(t, token, true);
+    case '[':
+      return parse_container(t, token, false);
+    case 'n':
+      return parse_literal(t, token, "null", JSON_TOKEN_NULL);
+    case 'f':
+      return parse_literal(t, token, "false", JSON_TOKEN_FALSE);
+    case 't':
+      return parse_literal(t, token, "true", JSON_TOKEN_TRUE);
+    default:
+      if (*t->p == '-' || (*t->p >= '0' && *t->p <= '9')) {
+        return parse_number(t, token);
+      }
+      return SC_SERIALIZER_JSON_PARSE;
+  }
+}
+
+status_t json_tokenize(char* const buf, arena_t* const arena, json_token_t** const root) {
+  status_t ret = SC_OK;
+  json_tokenizer_t t = {.p = buf, .arena = arena, .depth = 0};
+
+  if (buf == NULL || arena == NULL || root == NULL) {
+    return SC_SERIALIZER_NULL;
+  }
+
+  *root = token_new(&t);
+  if (*root == NULL) {
+    return SC_SERIALIZER_OOM;
+  }
+  // Content after the root value is ignored, as cJSON_Parse() does
+  ret = parse_value(&t, *root);
+  if (ret != SC_OK) {
+    *root = NULL;
+  }
+  return ret;
+}
+
+json_token_t* json_token_get(json_token_t const* const obj, char const* const key) {
+  if (obj == NULL || obj->type != JSON_TOKEN_OBJECT) {
+    return NULL;
+  }
+  for (json_token_t* member = obj->child; member; member = member->next) {
+    if (!strcmp(member->key, key)) {
+      return member;
+    }
+  }
+  return NULL;
+}
+
+json_token_t* json_token_get_string(json_token_t const* const obj, char const* const key) {
+  json_token_t* member = json_token_get(obj, key);
+  return (member && member->type == JSON_TOKEN_STRING) ? member : NULL;
+}
+
+void json_scanner_init(json_scanner_t* const scanner) { memset(scanner, 0, sizeof(json_scanner_t)); }
+
+status_t json_scanner_feed(json_scanner_t* const scanner, char const* const chunk, const size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = chunk[i];
+
+    if (c == '\0') {
+      // The body is handled as a NUL terminated string later on
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+    if (scanner->in_string) {
+      if (scanner->escape) {
+        scanner->escape = false;
+      } else if (c == '\\') {
+        scanner->escape = true;
+      } else if (c == '"') {
+        scanner->in_string = false;
+      } else if (c < ' ') {
+        return SC_SERIALIZER_JSON_PARSE;
+      }
+      continue;
+    }
+    if (c <= ' ') {
+      continue;
+    }
+    if (scanner->depth == 0 && (scanner->started || (c != '{' && c != '['))) {
+      // Only whitespace may surround the top-level container
+      return SC_SERIALIZER_JSON_PARSE;
+    }
+
+    switch (c) {
+      case '{':
+      case '[':
+        if (scanner->depth == JSON_TOKENIZER_MAX_DEPTH) {
+          return SC_SERIALIZER_JSON_PARSE;
+        }
+        scanner->objects = (scanner->objects << 1) | (c == '{');
+        scanner->depth++;
+        scanner->started = true;
+        break;
+      case '}':
+      case ']':
+        if ((scanner->objects & 1) != (c == '}')) {
+          return SC_SERIALIZER_JSON_PARSE;
+        }
+        scanner->objects >>= 1;
+        scanner->depth--;
+        break;
+      case '"':
+        scanner->in_string = true;
+        break;
+      default:
+        // Values and separators are checked by the tokenizer
+        break;
+    }
+  }
+  return SC_OK;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef SERIALIZER_JSON_TOKENIZER_H_
+#define SERIALIZER_JSON_TOKENIZER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "accelerator/errors.h"
+#include "utils/arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file json_tokenizer.h
+ * @brief In-situ JSON tokenizer
+ *
+ * The document is parsed in place: strings are unescaped and NUL terminated inside the input buffer, and tokens
+ * point into it instead of holding copies. Tokens are allocated from an arena, so a request is parsed without any
+ * allocation when the arena buffer is large enough, and everything is released with the arena.
+ *
+ * @example test_serializer.c
+ */
+
+/** Deepest nesting of arrays and objects accepted */
+#define JSON_TOKENIZER_MAX_DEPTH 64
+
+/** Types of JSON values */
+typedef enum {
+  JSON_TOKEN_NULL,
+  JSON_TOKEN_FALSE,
+  JSON_TOKEN_TRUE,
+  JSON_TOKEN_NUMBER,
+  JSON_TOKEN_STRING,
+  JSON_TOKEN_ARRAY,
+  JSON_TOKEN_OBJECT
+} json_token_type_t;
+
+/** A JSON value */
+typedef struct json_token_s {
+  json_token_type_t type;
+  char* key;                  /**< Member name when the parent is an object */
+  char* str;                  /**< NUL terminated string value, inside the input buffer */
+  size_t len;                 /**< Length of the string value */
+  double number;              /**< Number value */
+  int integer;                /**< Number value saturated to int, same as `valueint` of cJSON */
+  size_t size;                /**< Number of elements or members */
+  struct json_token_s* child; /**< First element or member */
+  struct json_token_s* next;  /**< Next element or member of the parent */
+} json_token_t;
+
+/**
+ * @brief Parse a NUL terminated JSON document in place
+ *
+ * @param[in,out] buf JSON document, which is modified and must outlive the tokens
+ * @param[in] arena Arena to allocate the tokens from
+ * @param[out] root Root value of the document
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_JSON_PARSE on malformed documents
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t json_tokenize(char* const buf, arena_t* const arena, json_token_t** const root);
+
+/**
+ * @brief Find a member of an object, case sensitive
+ *
+ * @param[in] obj Object token
+ * @param[in] key Member name
+ *
+ * @return The member value, or NULL if `obj` is not an object or has no such member
+ */
+json_token_t* json_token_get(json_token_t const* const obj, char const* const key);
+
+/**
+ * @brief Get a string member of an object
+ *
+ * @param[in] obj Object token
+ * @param[in] key Member name
+ *
+ * @return The string member, or NULL if there is no such member or it is not a string
+ */
+json_token_t* json_token_get_string(json_token_t const* const obj, char const* const key);
+
+/**
+ * @brief Incremental scanner of the structure of a JSON document
+ *
+ * The scanner is fed a document chunk by chunk as it is received, and tracks strings and the nesting of arrays and
+ * objects, so a body which cannot be a JSON object or array is rejected at the chunk that breaks it, and a truncated
+ * one is told apart from a whole one without parsing it. The document is parsed by `json_tokenize()` once complete.
+ */
+typedef struct json_scanner_s {
+  uint64_t objects; /**< One bit per open container, set for objects and clear for arrays */
+  int depth;        /**< Number of open containers */
+  bool started;     /**< The top-level container has been opened */
+  bool in_string;   /**< Inside a string */
+  bool escape;      /**< After a backslash inside a string */
+} json_scanner_t;
+
+/**
+ * @brief Initialize a scanner before the first chunk
+ *
+ * @param[out] scanner The scanner
+ */
+void json_scanner_init(json_scanner_t* const scanner);
+
+/**
+ * @brief Scan the next chunk of a document
+ *
+ * @param[in] scanner The scanner
+ * @param[in] chunk Bytes of the document
+ * @param[in] len Length of the chunk
+ *
+ * @return
+ * - SC_OK if the document is valid so far
+ * - SC_SERIALIZER_JSON_PARSE if it is not an object or array, is unbalanced, nests too deep, or has trailing data
+ */
+status_t json_scanner_feed(json_scanner_t* const scanner, char const* const chunk, const size_t len);
+
+/**
+ * @brief Check whether the chunks scanned so far hold a whole document
+ *
+ * @param[in] scanner The scanner
+ *
+ * @return true if the top-level container has been closed
+ */
+static inline bool json_scanner_complete(json_scanner_t const* const scanner) {
+  return scanner->started && scanner->depth == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SERIALIZER_JSON_TOKENIZER_H_
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "json_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Integers below this magnitude are printed by cJSON with all their digits and no exponent */
+#define JSON_WRITER_EXACT_INT 1000000000000000LL
+/** Longest number printed with `%1.17g` */
+#define JSON_WRITER_NUMBER_LEN 26
+
+status_t json_writer_init(json_writer_t* const writer, const size_t capacity) {
+  writer->cap = capacity ? capacity : 1;
+  writer->buf = (char*)malloc(writer->cap);
+  if (writer->buf == NULL) {
+    writer->cap = 0;
+    return SC_SERIALIZER_OOM;
+  }
+  json_writer_reset(writer);
+  return SC_OK;
+}
+
+void json_writer_reset(json_writer_t* const writer) {
+  writer->len = 0;
+  writer->buf[0] = '\0';
+  writer->need_comma = false;
+}
+
+void json_writer_free(json_writer_t* const writer) {
+  free(writer->buf);
+  writer->buf = NULL;
+  writer->len = writer->cap = 0;
+}
+
+char* json_writer_detach(json_writer_t* const writer) {
+  char* out = writer->buf;
+  writer->buf = NULL;
+  writer->len = writer->cap = 0;
+  return out;
+}
+
+status_t json_writer_reserve(json_writer_t* const writer, const size_t size) {
+  // One more byte for the NUL terminator
+  size_t needed = writer->len + size + 1;
+  if (needed <= writer->cap) {
+    return SC_OK;
+  }
+
+  size_t cap = writer->cap * 2;
+  if (cap < needed) {
+    cap = needed;
+  }
+  char* buf = (char*)realloc(writer->buf, cap);
+  if (buf == NULL) {
+    return SC_SERIALIZER_OOM;
+  }
+  writer->buf = buf;
+  writer->cap = cap;
+  return SC_OK;
+}
+
+static inline void writer_put(json_writer_t* const writer, char const* const data, const size_t len) {
+  memcpy(writer->buf + writer->len, data, len);
+  writer->len += len;
+  writer->buf[writer->len] = '\0';
+}
+
+static inline void writer_put_char(json_writer_t* const writer, const char c) {
+  writer->buf[writer->len++] = c;
+  writer->buf[writer->len] = '\0';
+}
+
+/**
+ * Start a new value, writing the separator from the previous one. The space for the separator has to be reserved.
+ */
+static inline void writer_begin_value(json_writer_t* const writer) {
+  if (writer->need_comma) {
+    writer_put_char(writer, ',');
+  }
+  writer->need_comma = true;
+}
+
+static status_t writer_open(json_writer_t* const writer, const char c) {
+  if (json_writer_reserve(writer, 2) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+  writer_begin_value(writer);
+  writer_put_char(writer, c);
+  writer->need_comma = false;
+  return SC_OK;
+}
+
+static status_t writer_close(json_writer_t* const writer, const char c) {
+  if (json_writer_reserve(writer, 1) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+  writer_put_char(writer, c);
+  writer->need_comma = true;
+  return SC_OK;
+}
+
+status_t json_writer_begin_object(json_writer_t* const writer) { return writer_open(writer, '{'); }
+
+status_t json_writer_end_object(json_writer_t* const writer) { return writer_close(writer, '}'); }
+
+status_t json_writer_begin_array(json_writer_t* const writer) { return writer_open(writer, '['); }
+
+status_t json_writer_end_array(json_writer_t* const writer) { return writer_close(writer, ']'); }
+
+status_t json_writer_key(json_writer_t* const writer, char const* const key) {
+  size_t len = strlen(key);
+  if (json_writer_reserve(writer, len + 4) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+  writer_begin_value(writer);
+  writer_put_char(writer, '"');
+  writer_put(writer, key, len);
+  writer_put(writer, "\":", 2);
+  // The member value follows the colon without a separator
+  writer->need_comma = false;
+  return SC_OK;
+}
+
+char* json_writer_string_inplace(json_writer_t* const writer, const size_t len) {
+  if (json_writer_reserve(writer, len + 3) != SC_OK) {
+    return NULL;
+  }
+  writer_begin_value(writer);
+  writer_put_char(writer, '"');
+  char* str = writer->buf + writer->len;
+  writer->len += len;
+  writer_put_char(writer, '"');
+  return str;
+}
+
+status_t json_writer_string(json_writer_t* const writer, char const* const str, const size_t len) {
+  static char const hex_digits[] = "0123456789abcdef";
+  size_t escaped = 0;
+
+  // Count the extra bytes of escape sequences, using the same rules as cJSON
+  for (size_t i = 0; i < len; i++) {
+    switch (str[i]) {
+      case '\"':
+      case '\\':
+      case '\b':
+      case '\f':
+      case '\n':
+      case '\r':
+      case '\t':
+        escaped++;
+        break;
+      default:
+        if ((unsigned char)str[i] < 32) {
+          escaped += 5;
+        }
+        break;
+    }
+  }
+
+  char* out = json_writer_string_inplace(writer, len + escaped);
+  if (out == NULL) {
+    return SC_SERIALIZER_OOM;
+  }
+  if (escaped == 0) {
+    memcpy(out, str, len);
+    return SC_OK;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = (unsigned char)str[i];
+    if (c >= 32 && c != '\"' && c != '\\') {
+      *out++ = c;
+      continue;
+    }
+    *out++ = '\\';
+    switch (c) {
+      case '\"':
+      case '\\':
+        *out++ = c;
+        break;
+      case '\b':
+        *out++ = 'b';
+        break;
+      case '\f':
+        *out++ = 'f';
+        break;
+      case '\n':
+        *out++ = 'n';
+        break;
+      case '\r':
+        *out++ = 'r';
+        break;
+      case '\t':
+        *out++ = 't';
+        break;
+      default:
+        *out++ = 'u';
+        *out++ = '0';
+        *out++ = '0';
+        *out++ = hex_digits[c >> 4];
+        *out++ = hex_digits[c & 0xF];
+        break;
+    }
+  }
+  return SC_OK;
+}
+
+status_t json_writer_number(json_writer_t* const writer, const double number) {
+  char buf[JSON_WRITER_NUMBER_LEN];
+  double test = 0.0;
+  int len = 0;
+
+  if (number * 0 != 0) {
+    // NaN and infinity
+    len = snprintf(buf, sizeof(buf), "null");
+  } else {
+    // Try 15 digits first and fall back to 17 digits when the value can not be recovered, as cJSON does
+    len = snprintf(buf, sizeof(buf), "%1.15g", number);
+    if (sscanf(buf, "%lg", &test) != 1 || test != number) {
+      len = snprintf(buf, sizeof(buf), "%1.17g", number);
+    }
+  }
+
+  if (json_writer_reserve(writer, len + 1) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+  writer_begin_value(writer);
+  writer_put(writer, buf, len);
+  return SC_OK;
+}
+
+status_t json_writer_int(json_writer_t* const writer, const int64_t number) {
+  char buf[JSON_WRITER_NUMBER_LEN];
+  char* p = buf + sizeof(buf);
+
+  if (number <= -JSON_WRITER_EXACT_INT || number >= JSON_WRITER_EXACT_INT) {
+    return json_writer_number(writer, (double)number);
+  }
+
+  // `%1.15g` prints integers of up to 15 digits as they are, so skip the floating point formatting
+  uint64_t value = number < 0 ? -number : number;
+  do {
+    *--p = '0' + value % 10;
+    value /= 10;
+  } while (value);
+  if (number < 0) {
+    *--p = '-';
+  }
+
+  size_t len = buf + sizeof(buf) - p;
+  if (json_writer_reserve(writer, len + 1) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+  writer_begin_value(writer);
+  writer_put(writer, p, len);
+  return SC_OK;
+}
+
+status_t json_writer_raw(json_writer_t* const writer, char const* const json, const size_t len) {
+  if (json_writer_reserve(writer, len + 1) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+  writer_begin_value(writer);
+  writer_put(writer, json, len);
+  return SC_OK;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef SERIALIZER_JSON_WRITER_H_
+#define SERIALIZER_JSON_WRITER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "accelerator/errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file json_writer.h
+ * @brief Streaming JSON writer
+ *
+ * Values are appended straight into one growable buffer, without building a cJSON tree first. The output is
+ * unformatted and byte-identical to `cJSON_PrintUnformatted()` of the same document, so both can be mixed freely.
+ * Separators are inserted by the writer, callers only open and close containers and write keys and values in order.
+ *
+ * @example test_serializer.c
+ */
+
+/** Streaming JSON writer */
+typedef struct json_writer_s {
+  char* buf;       /**< NUL terminated output */
+  size_t len;      /**< Length of the output */
+  size_t cap;      /**< Allocated size of `buf` */
+  bool need_comma; /**< A value was already written in the current container */
+} json_writer_t;
+
+/**
+ * @brief Initialize a writer with an estimated output size
+ *
+ * @param[out] writer The writer
+ * @param[in] capacity Initial size of the buffer, the buffer grows when needed
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t json_writer_init(json_writer_t* const writer, const size_t capacity);
+
+/**
+ * @brief Discard the output and keep the buffer for the next document
+ *
+ * @param[in] writer The writer
+ */
+void json_writer_reset(json_writer_t* const writer);
+
+/**
+ * @brief Release the buffer of the writer
+ *
+ * @param[in] writer The writer
+ */
+void json_writer_free(json_writer_t* const writer);
+
+/**
+ * @brief Hand the output over to the caller
+ *
+ * The writer is left empty and must be initialized again before reuse.
+ *
+ * @param[in] writer The writer
+ *
+ * @return NUL terminated JSON string, which should be released with `free()`
+ */
+char* json_writer_detach(json_writer_t* const writer);
+
+/**
+ * @brief Make sure `size` more bytes can be written without growing the buffer
+ *
+ * @param[in] writer The writer
+ * @param[in] size Number of bytes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t json_writer_reserve(json_writer_t* const writer, const size_t size);
+
+/** @name Containers */
+/** @{ */
+status_t json_writer_begin_object(json_writer_t* const writer);
+status_t json_writer_end_object(json_writer_t* const writer);
+status_t json_writer_begin_array(json_writer_t* const writer);
+status_t json_writer_end_array(json_writer_t* const writer);
+/** @} */
+
+/**
+ * @brief Write the key of the next object member
+ *
+ * @param[in] writer The writer
+ * @param[in] key NUL terminated key
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t json_writer_key(json_writer_t* const writer, char const* const key);
+
+/**
+ * @brief Write a string value, escaped the same way as cJSON
+ *
+ * @param[in] writer The writer
+ * @param[in] str String value
+ * @param[in] len Length of the string
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t json_writer_string(json_writer_t* const writer, char const* const str, const size_t len);
+
+/**
+ * @brief Reserve a string value of a known length and let the caller fill it in place
+ *
+ * The caller must write exactly `len` bytes which need no escaping, e.g. trytes.
+ *
+ * @param[in] writer The writer
+ * @param[in] len Length of the string
+ *
+ * @return Position to write the string at, or NULL on OOM
+ */
+char* json_writer_string_inplace(json_writer_t* const writer, const size_t len);
+
+/**
+ * @brief Write a number value, formatted the same way as cJSON
+ *
+ * @param[in] writer The writer
+ * @param[in] number Number value
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t json_writer_number(json_writer_t* const writer, const double number);
+
+/**
+ * @brief Write an integer value, formatted the same way as cJSON formats it after conversion to double
+ *
+ * @param[in] writer The writer
+ * @param[in] number Integer value
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t json_writer_int(json_writer_t* const writer, const int64_t number);
+
+/**
+ * @brief Write a value which is already serialized, e.g. the unformatted output of another writer
+ *
+ * @param[in] writer The writer
+ * @param[in] json Serialized JSON value, written as it is
+ * @param[in] len Length of the value
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_OOM on error
+ */
+status_t json_writer_raw(json_writer_t* const writer, char const* const json, const size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SERIALIZER_JSON_WRITER_H_
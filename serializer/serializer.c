@@ -7,12 +7,129 @@
  */
 
 #include "serializer.h"
+#include <errno.h>
+
+#include "serializer/cbor_writer.h"
+#include "serializer/json_tokenizer.h"
+#include "serializer/json_writer.h"
+#include "utils/trinary_kernels.h"
 #include "utils/logger_helper.h"
 
 #define SERI_LOGGER "serializer"
+/** Upper bound of the length of a transaction object in JSON */
+#define TXN_JSON_MAX_LEN 4096
+/** Upper bound of the length of a transaction object in CBOR */
+#define TXN_CBOR_MAX_LEN 2048
+/** Upper bound of the length of a transaction object without its message, in either format */
+#define TXN_NO_MESSAGE_MAX_LEN 1024
+/** Number of members of a transaction object */
+#define TXN_NUM_MEMBERS 16
+/** Stack buffer of the arena used by the deserializers which copy the request body, enough for most requests */
+#define DESERIALIZE_ARENA_SIZE 4096
 
 static logger_id_t logger_id;
 
+ta_response_format_t ta_response_format_from_accept(char const* const accept) {
+  // Clients asking for CBOR at all get it, JSON is the default for everything else
+  if (accept && strstr(accept, TA_CONTENT_TYPE_CBOR)) {
+    return TA_RESPONSE_FORMAT_CBOR;
+  }
+  return TA_RESPONSE_FORMAT_JSON;
+}
+
+char const* ta_response_format_content_type(const ta_response_format_t format) {
+  return format == TA_RESPONSE_FORMAT_CBOR ? TA_CONTENT_TYPE_CBOR : TA_CONTENT_TYPE_JSON;
+}
+
+/** Member names of transaction objects, indexed by the bit of their ta_txn_field_t */
+static char const* const txn_field_names[TXN_NUM_MEMBERS] = {"hash", "signature_and_message_fragment", "address",
+                                                             "value", "obsolete_tag", "timestamp", "current_index",
+                                                             "last_index", "bundle_hash", "trunk_transaction_hash",
+                                                             "branch_transaction_hash", "tag", "attachment_timestamp",
+                                                             "attachment_timestamp_lower_bound",
+                                                             "attachment_timestamp_upper_bound", "nonce"};
+
+static status_t txn_field_from_name(char const* const name, const size_t len, uint32_t* const field) {
+  for (int i = 0; i < TXN_NUM_MEMBERS; i++) {
+    if (strlen(txn_field_names[i]) == len && !strncmp(txn_field_names[i], name, len)) {
+      *field = 1u << i;
+      return SC_OK;
+    }
+  }
+  ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+  return SC_SERIALIZER_INVALID_REQ;
+}
+
+status_t ta_txn_fields_parse(char const* const list, uint32_t* const fields) {
+  uint32_t mask = 0, field = 0;
+  char const* name = list;
+
+  *fields = 0;
+  if (list == NULL) {
+    return SC_OK;
+  }
+  while (*name) {
+    size_t len = strcspn(name, ",");
+    if (txn_field_from_name(name, len, &field) != SC_OK) {
+      return SC_SERIALIZER_INVALID_REQ;
+    }
+    mask |= field;
+    name += len;
+    if (*name == ',') {
+      name++;
+    }
+  }
+  *fields = mask;
+  return SC_OK;
+}
+
+/** Parse a decimal parameter, NULL or empty strings are left out */
+static status_t page_param_parse(char const* const str, uint64_t* const value, bool* const given) {
+  char* end = NULL;
+  if (str == NULL || str[0] == '\0') {
+    return SC_OK;
+  }
+  if (str[0] < '0' || str[0] > '9') {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
+  }
+  errno = 0;
+  *value = strtoull(str, &end, 10);
+  if (errno || *end != '\0') {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
+  }
+  *given = true;
+  return SC_OK;
+}
+
+status_t ta_page_req_parse(char const* const limit, char const* const cursor, char const* const since,
+                           ta_page_req_t* const page, bool* const paged) {
+  uint64_t limit_value = TA_PAGE_DEFAULT_LIMIT, cursor_value = 0, since_value = 0;
+  bool given = false;
+
+  if (page_param_parse(limit, &limit_value, &given) != SC_OK ||
+      page_param_parse(cursor, &cursor_value, &given) != SC_OK ||
+      page_param_parse(since, &since_value, &given) != SC_OK || limit_value == 0 || cursor_value > SIZE_MAX) {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
+  }
+  page->limit = limit_value < TA_PAGE_MAX_LIMIT ? limit_value : TA_PAGE_MAX_LIMIT;
+  page->cursor = cursor_value;
+  page->since = since_value;
+  *paged = given;
+  return SC_OK;
+}
+
+/** Number of members selected by a mask of ta_txn_field_t */
+static size_t txn_fields_count(const uint32_t fields) {
+  size_t count = 0;
+  for (uint32_t mask = fields & TA_TXN_FIELDS_ALL; mask; mask &= mask - 1) {
+    count++;
+  }
+  return count;
+}
+
 void serializer_logger_init() { logger_id = logger_helper_enable(SERI_LOGGER, LOGGER_DEBUG, true); }
 
 int serializer_logger_release() {
@@ -66,7 +183,7 @@ static status_t ta_hash243_stack_to_json_array(hash243_stack_t stack, cJSON* jso
   array_count = hash243_stack_count(stack);
   if (array_count > 0) {
     LL_FOREACH(stack, s_iter) {
-      trits_count = flex_trits_to_trytes(trytes_out, NUM_TRYTES_HASH, s_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+      trits_count = ta_flex_trits_to_trytes(trytes_out, NUM_TRYTES_HASH, s_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
       trytes_out[NUM_TRYTES_HASH] = '\0';
       if (trits_count != 0) {
         cJSON_AddItemToArray(json_root, cJSON_CreateString((const char*)trytes_out));
@@ -82,33 +199,71 @@ static status_t ta_hash243_stack_to_json_array(hash243_stack_t stack, cJSON* jso
   return SC_OK;
 }
 
-static status_t ta_json_array_to_hash243_queue(cJSON const* const obj, char const* const obj_name,
-                                               hash243_queue_t* queue) {
-  status_t ret_code = SC_OK;
-  flex_trit_t hash[FLEX_TRIT_SIZE_243] = {};
-  cJSON* json_item = cJSON_GetObjectItemCaseSensitive(obj, obj_name);
+static status_t ta_json_array_to_hash243_vector(json_token_t const* const obj, char const* const obj_name,
+                                                hash243_vector_t* const vec) {
+  size_t count = 0;
+  json_token_t* json_item = json_token_get(obj, obj_name);
   if (!json_item) {
     ta_log_error("%s\n", "SC_SERIALIZER_NULL");
     return SC_SERIALIZER_NULL;
   }
 
-  if (cJSON_IsArray(json_item)) {
-    cJSON* current_obj = NULL;
-    cJSON_ArrayForEach(current_obj, json_item) {
-      if (current_obj->valuestring != NULL) {
-        flex_trits_from_trytes(hash, NUM_TRITS_HASH, (tryte_t const*)current_obj->valuestring, NUM_TRYTES_HASH,
-                               NUM_TRYTES_HASH);
-        if (hash243_queue_push(queue, hash) != RC_OK) {
-          ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
-          return SC_SERIALIZER_JSON_PARSE;
-        }
-      }
-    }
-  } else {
+  if (json_item->type != JSON_TOKEN_ARRAY) {
     ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
     return SC_SERIALIZER_JSON_PARSE;
   }
-  return ret_code;
+  for (json_token_t* current_obj = json_item->child; current_obj; current_obj = current_obj->next) {
+    count++;
+  }
+  // Grow the vector once, then convert every hash straight into it
+  if (hash243_vector_reserve(vec, hash243_vector_count(vec) + count) != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+    return SC_SERIALIZER_OOM;
+  }
+  for (json_token_t* current_obj = json_item->child; current_obj; current_obj = current_obj->next) {
+    if (current_obj->type != JSON_TOKEN_STRING) {
+      continue;
+    }
+    if (current_obj->len != NUM_TRYTES_HASH ||
+        !ta_trytes_validate((tryte_t const*)current_obj->str, NUM_TRYTES_HASH)) {
+      ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+      return SC_SERIALIZER_INVALID_REQ;
+    }
+    ta_flex_trits_from_trytes(vec->hashes + vec->count * FLEX_TRIT_SIZE_243, NUM_TRITS_HASH,
+                              (tryte_t const*)current_obj->str, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+    vec->count++;
+  }
+  return SC_OK;
+}
+
+/**
+ * Read the optional member projection of a request, either a comma separated string or an array of member names
+ */
+static status_t ta_json_token_to_txn_fields(json_token_t const* const obj, uint32_t* const fields) {
+  uint32_t field = 0;
+  json_token_t* json_item = json_token_get(obj, "fields");
+
+  *fields = 0;
+  if (json_item == NULL) {
+    return SC_OK;
+  }
+  if (json_item->type == JSON_TOKEN_STRING) {
+    return ta_txn_fields_parse(json_item->str, fields);
+  }
+  if (json_item->type != JSON_TOKEN_ARRAY) {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
+  }
+  for (json_token_t* current_obj = json_item->child; current_obj; current_obj = current_obj->next) {
+    if (current_obj->type != JSON_TOKEN_STRING ||
+        txn_field_from_name(current_obj->str, current_obj->len, &field) != SC_OK) {
+      *fields = 0;
+      ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+      return SC_SERIALIZER_INVALID_REQ;
+    }
+    *fields |= field;
+  }
+  return SC_OK;
 }
 
 static status_t ta_hash243_queue_to_json_array(hash243_queue_t queue, cJSON* const json_root) {
@@ -120,7 +275,7 @@ static status_t ta_hash243_queue_to_json_array(hash243_queue_t queue, cJSON* con
     CDL_FOREACH(queue, q_iter) {
       tryte_t trytes_out[NUM_TRYTES_HASH + 1];
       size_t trits_count =
-          flex_trits_to_trytes(trytes_out, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+          ta_flex_trits_to_trytes(trytes_out, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
       trytes_out[NUM_TRYTES_HASH] = '\0';
       if (trits_count != 0) {
         cJSON_AddItemToArray(json_root, cJSON_CreateString((const char*)trytes_out));
@@ -136,29 +291,29 @@ static status_t ta_hash243_queue_to_json_array(hash243_queue_t queue, cJSON* con
   return SC_OK;
 }
 
-static status_t ta_json_array_to_hash8019_array(cJSON const* const obj, char const* const obj_name,
+static status_t ta_json_array_to_hash8019_array(json_token_t const* const obj, char const* const obj_name,
                                                 hash8019_array_p array) {
-  status_t ret = SC_OK;
   flex_trit_t hash[FLEX_TRIT_SIZE_8019] = {};
-  cJSON* json_item = cJSON_GetObjectItemCaseSensitive(obj, obj_name);
-  if (!cJSON_IsArray(json_item)) {
+  json_token_t* json_item = json_token_get(obj, obj_name);
+  if (json_item == NULL || json_item->type != JSON_TOKEN_ARRAY) {
     ta_log_error("%s\n", "SC_CCLIENT_JSON_PARSE");
     return SC_CCLIENT_JSON_PARSE;
   }
 
-  cJSON* current_obj = NULL;
-  cJSON_ArrayForEach(current_obj, json_item) {
-    if (current_obj->valuestring != NULL) {
-      if (strlen(current_obj->valuestring) != NUM_TRYTES_SERIALIZED_TRANSACTION) {
-        ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
-        return SC_SERIALIZER_INVALID_REQ;
-      }
-      flex_trits_from_trytes(hash, NUM_TRITS_SERIALIZED_TRANSACTION, (tryte_t const*)current_obj->valuestring,
-                             NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
-      hash_array_push(array, hash);
+  for (json_token_t* current_obj = json_item->child; current_obj; current_obj = current_obj->next) {
+    if (current_obj->type != JSON_TOKEN_STRING) {
+      continue;
+    }
+    if (current_obj->len != NUM_TRYTES_SERIALIZED_TRANSACTION ||
+        !ta_trytes_validate((tryte_t const*)current_obj->str, NUM_TRYTES_SERIALIZED_TRANSACTION)) {
+      ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+      return SC_SERIALIZER_INVALID_REQ;
     }
+    ta_flex_trits_from_trytes(hash, NUM_TRITS_SERIALIZED_TRANSACTION, (tryte_t const*)current_obj->str,
+                              NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+    hash_array_push(array, hash);
   }
-  return ret;
+  return SC_OK;
 }
 
 status_t ta_hash8019_array_to_json_array(hash8019_array_p array, cJSON* const json_root, char const* const obj_name) {
@@ -178,8 +333,8 @@ status_t ta_hash8019_array_to_json_array(hash8019_array_p array, cJSON* const js
     cJSON_AddItemToObject(json_root, obj_name, array_obj);
 
     HASH_ARRAY_FOREACH(array, elt) {
-      trits_count = flex_trits_to_trytes(trytes_out, NUM_TRYTES_SERIALIZED_TRANSACTION, elt,
-                                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
+      trits_count = ta_flex_trits_to_trytes(trytes_out, NUM_TRYTES_SERIALIZED_TRANSACTION, elt,
+                                            NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
       trytes_out[NUM_TRYTES_SERIALIZED_TRANSACTION] = '\0';
       if (trits_count == 0) {
         ta_log_error("%s\n", "SC_CCLIENT_FLEX_TRITS");
@@ -214,12 +369,94 @@ static status_t ta_json_get_string(cJSON const* const json_obj, char const* cons
   return ret;
 }
 
-status_t iota_transaction_to_json_object(iota_transaction_t const* const txn, cJSON** txn_json) {
+static status_t ta_json_token_get_string(json_token_t const* const json_obj, char const* const obj_name,
+                                         char* const text, const size_t text_size) {
+  json_token_t* json_value = json_token_get(json_obj, obj_name);
+  if (json_value == NULL) {
+    ta_log_error("%s\n", "SC_CCLIENT_JSON_KEY");
+    return SC_CCLIENT_JSON_KEY;
+  }
+
+  if (json_value->type != JSON_TOKEN_STRING) {
+    ta_log_error("%s\n", "SC_CCLIENT_JSON_PARSE");
+    return SC_CCLIENT_JSON_PARSE;
+  }
+  if (json_value->len >= text_size) {
+    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  memcpy(text, json_value->str, json_value->len + 1);
+  return SC_OK;
+}
+
+/**
+ * Tokenize a request body in place
+ */
+static status_t ta_json_tokenize_req(char* const obj, arena_t* const arena, json_token_t** const root) {
+  if (obj == NULL || arena == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_NULL");
+    return SC_SERIALIZER_NULL;
+  }
+
+  status_t ret = json_tokenize(obj, arena, root);
+  if (ret == SC_SERIALIZER_OOM) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+  } else if (ret != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
+    ret = SC_SERIALIZER_JSON_PARSE;
+  }
+  return ret;
+}
+
+/**
+ * Copy a request body into a stack backed arena for the deserializers which take a constant string
+ */
+static char* ta_json_copy_req(char const* const obj, arena_t* const arena, char* const arena_buf) {
+  arena_init(arena, arena_buf, DESERIALIZE_ARENA_SIZE);
+  char* buf = arena_strndup(arena, obj, strlen(obj));
+  if (buf == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+  }
+  return buf;
+}
+
+/**
+ * Get one string member of a request, used by the MQTT request deserializers
+ */
+static status_t ta_json_req_get_string(char const* const obj, char const* const obj_name, char* const text,
+                                       const size_t text_size) {
+  if (obj == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_NULL");
+    return SC_SERIALIZER_NULL;
+  }
+  status_t ret = SC_SERIALIZER_OOM;
+  char arena_buf[DESERIALIZE_ARENA_SIZE];
+  arena_t arena;
+  json_token_t* json_obj = NULL;
+  char* buf = ta_json_copy_req(obj, &arena, arena_buf);
+
+  if (buf == NULL) {
+    goto done;
+  }
+  ret = ta_json_tokenize_req(buf, &arena, &json_obj);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  ret = ta_json_token_get_string(json_obj, obj_name, text, text_size);
+
+done:
+  arena_reset(&arena);
+  return ret;
+}
+
+status_t iota_transaction_to_json_object(iota_transaction_t const* const txn, const uint32_t fields, cJSON** txn_json) {
   if (txn == NULL) {
     ta_log_error("%s\n", "SC_CCLIENT_NOT_FOUND");
     return SC_CCLIENT_NOT_FOUND;
   }
   char msg_trytes[NUM_TRYTES_SIGNATURE + 1], hash_trytes[NUM_TRYTES_HASH + 1], tag_trytes[NUM_TRYTES_TAG + 1];
+  const uint32_t mask = fields ? fields : TA_TXN_FIELDS_ALL;
 
   if (txn_json == NULL) {
     ta_log_error("%s\n", "SC_SERIALIZER_JSON_CREATE");
@@ -227,279 +464,610 @@ status_t iota_transaction_to_json_object(iota_transaction_t const* const txn, cJ
   }
 
   // transaction hash
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_hash(txn), NUM_TRITS_HASH, NUM_TRITS_HASH);
-  hash_trytes[NUM_TRYTES_HASH] = '\0';
-  cJSON_AddStringToObject(*txn_json, "hash", hash_trytes);
+  if (mask & TA_TXN_FIELD_HASH) {
+    ta_flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_hash(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
+    hash_trytes[NUM_TRYTES_HASH] = '\0';
+    cJSON_AddStringToObject(*txn_json, "hash", hash_trytes);
+  }
 
   // message
-  flex_trits_to_trytes((tryte_t*)msg_trytes, NUM_TRYTES_SIGNATURE, transaction_message(txn), NUM_TRITS_SIGNATURE,
-                       NUM_TRITS_SIGNATURE);
-  msg_trytes[NUM_TRYTES_SIGNATURE] = '\0';
-  cJSON_AddStringToObject(*txn_json, "signature_and_message_fragment", msg_trytes);
+  if (mask & TA_TXN_FIELD_SIGNATURE_AND_MESSAGE_FRAGMENT) {
+    ta_flex_trits_to_trytes((tryte_t*)msg_trytes, NUM_TRYTES_SIGNATURE, transaction_message(txn), NUM_TRITS_SIGNATURE,
+                            NUM_TRITS_SIGNATURE);
+    msg_trytes[NUM_TRYTES_SIGNATURE] = '\0';
+    cJSON_AddStringToObject(*txn_json, "signature_and_message_fragment", msg_trytes);
+  }
 
   // address
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_address(txn), NUM_TRITS_HASH,
-                       NUM_TRITS_HASH);
-  hash_trytes[NUM_TRYTES_HASH] = '\0';
-  cJSON_AddStringToObject(*txn_json, "address", hash_trytes);
+  if (mask & TA_TXN_FIELD_ADDRESS) {
+    ta_flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_address(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
+    hash_trytes[NUM_TRYTES_HASH] = '\0';
+    cJSON_AddStringToObject(*txn_json, "address", hash_trytes);
+  }
   // value
-  cJSON_AddNumberToObject(*txn_json, "value", transaction_value(txn));
+  if (mask & TA_TXN_FIELD_VALUE) {
+    cJSON_AddNumberToObject(*txn_json, "value", transaction_value(txn));
+  }
   // obsolete tag
-  flex_trits_to_trytes((tryte_t*)tag_trytes, NUM_TRYTES_TAG, transaction_obsolete_tag(txn), NUM_TRITS_TAG,
-                       NUM_TRITS_TAG);
-  tag_trytes[NUM_TRYTES_TAG] = '\0';
-  cJSON_AddStringToObject(*txn_json, "obsolete_tag", tag_trytes);
+  if (mask & TA_TXN_FIELD_OBSOLETE_TAG) {
+    ta_flex_trits_to_trytes((tryte_t*)tag_trytes, NUM_TRYTES_TAG, transaction_obsolete_tag(txn), NUM_TRITS_TAG,
+                            NUM_TRITS_TAG);
+    tag_trytes[NUM_TRYTES_TAG] = '\0';
+    cJSON_AddStringToObject(*txn_json, "obsolete_tag", tag_trytes);
+  }
 
   // timestamp
-  cJSON_AddNumberToObject(*txn_json, "timestamp", transaction_timestamp(txn));
+  if (mask & TA_TXN_FIELD_TIMESTAMP) {
+    cJSON_AddNumberToObject(*txn_json, "timestamp", transaction_timestamp(txn));
+  }
 
   // current index
-  cJSON_AddNumberToObject(*txn_json, "current_index", transaction_current_index(txn));
+  if (mask & TA_TXN_FIELD_CURRENT_INDEX) {
+    cJSON_AddNumberToObject(*txn_json, "current_index", transaction_current_index(txn));
+  }
 
   // last index
-  cJSON_AddNumberToObject(*txn_json, "last_index", transaction_last_index(txn));
+  if (mask & TA_TXN_FIELD_LAST_INDEX) {
+    cJSON_AddNumberToObject(*txn_json, "last_index", transaction_last_index(txn));
+  }
 
   // bundle hash
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_bundle(txn), NUM_TRITS_HASH, NUM_TRITS_HASH);
-  hash_trytes[NUM_TRYTES_HASH] = '\0';
-  cJSON_AddStringToObject(*txn_json, "bundle_hash", hash_trytes);
+  if (mask & TA_TXN_FIELD_BUNDLE_HASH) {
+    ta_flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_bundle(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
+    hash_trytes[NUM_TRYTES_HASH] = '\0';
+    cJSON_AddStringToObject(*txn_json, "bundle_hash", hash_trytes);
+  }
 
   // trunk transaction hash
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_trunk(txn), NUM_TRITS_HASH, NUM_TRITS_HASH);
-  hash_trytes[NUM_TRYTES_HASH] = '\0';
-  cJSON_AddStringToObject(*txn_json, "trunk_transaction_hash", hash_trytes);
+  if (mask & TA_TXN_FIELD_TRUNK_TRANSACTION_HASH) {
+    ta_flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_trunk(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
+    hash_trytes[NUM_TRYTES_HASH] = '\0';
+    cJSON_AddStringToObject(*txn_json, "trunk_transaction_hash", hash_trytes);
+  }
 
   // branch transaction hash
-  flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_branch(txn), NUM_TRITS_HASH, NUM_TRITS_HASH);
-  hash_trytes[NUM_TRYTES_HASH] = '\0';
-  cJSON_AddStringToObject(*txn_json, "branch_transaction_hash", hash_trytes);
+  if (mask & TA_TXN_FIELD_BRANCH_TRANSACTION_HASH) {
+    ta_flex_trits_to_trytes((tryte_t*)hash_trytes, NUM_TRYTES_HASH, transaction_branch(txn), NUM_TRITS_HASH,
+                            NUM_TRITS_HASH);
+    hash_trytes[NUM_TRYTES_HASH] = '\0';
+    cJSON_AddStringToObject(*txn_json, "branch_transaction_hash", hash_trytes);
+  }
 
   // tag
-  flex_trits_to_trytes((tryte_t*)tag_trytes, NUM_TRYTES_TAG, transaction_tag(txn), NUM_TRITS_TAG, NUM_TRITS_TAG);
-  tag_trytes[NUM_TRYTES_TAG] = '\0';
-  cJSON_AddStringToObject(*txn_json, "tag", tag_trytes);
+  if (mask & TA_TXN_FIELD_TAG) {
+    ta_flex_trits_to_trytes((tryte_t*)tag_trytes, NUM_TRYTES_TAG, transaction_tag(txn), NUM_TRITS_TAG, NUM_TRITS_TAG);
+    tag_trytes[NUM_TRYTES_TAG] = '\0';
+    cJSON_AddStringToObject(*txn_json, "tag", tag_trytes);
+  }
 
   // attachment timestamp
-  cJSON_AddNumberToObject(*txn_json, "attachment_timestamp", transaction_attachment_timestamp(txn));
+  if (mask & TA_TXN_FIELD_ATTACHMENT_TIMESTAMP) {
+    cJSON_AddNumberToObject(*txn_json, "attachment_timestamp", transaction_attachment_timestamp(txn));
+  }
 
   // attachment lower timestamp
-  cJSON_AddNumberToObject(*txn_json, "attachment_timestamp_lower_bound", transaction_attachment_timestamp_lower(txn));
+  if (mask & TA_TXN_FIELD_ATTACHMENT_TIMESTAMP_LOWER_BOUND) {
+    cJSON_AddNumberToObject(*txn_json, "attachment_timestamp_lower_bound",
+                            transaction_attachment_timestamp_lower(txn));
+  }
 
   // attachment upper timestamp
-  cJSON_AddNumberToObject(*txn_json, "attachment_timestamp_upper_bound", transaction_attachment_timestamp_upper(txn));
+  if (mask & TA_TXN_FIELD_ATTACHMENT_TIMESTAMP_UPPER_BOUND) {
+    cJSON_AddNumberToObject(*txn_json, "attachment_timestamp_upper_bound",
+                            transaction_attachment_timestamp_upper(txn));
+  }
 
   // nonce
-  flex_trits_to_trytes((tryte_t*)tag_trytes, NUM_TRYTES_NONCE, transaction_nonce(txn), NUM_TRITS_NONCE,
-                       NUM_TRITS_NONCE);
-  tag_trytes[NUM_TRYTES_TAG] = '\0';
-  cJSON_AddStringToObject(*txn_json, "nonce", tag_trytes);
+  if (mask & TA_TXN_FIELD_NONCE) {
+    ta_flex_trits_to_trytes((tryte_t*)tag_trytes, NUM_TRYTES_NONCE, transaction_nonce(txn), NUM_TRITS_NONCE,
+                            NUM_TRITS_NONCE);
+    tag_trytes[NUM_TRYTES_TAG] = '\0';
+    cJSON_AddStringToObject(*txn_json, "nonce", tag_trytes);
+  }
 
   return SC_OK;
 }
 
-static status_t transaction_array_to_json_array(cJSON* json_root, const transaction_array_t* const txn_array) {
-  status_t ret = SC_OK;
-  iota_transaction_t* txn = NULL;
+/** Output of the transaction object serializers, in either of the response formats */
+typedef struct txn_writer_s {
+  ta_response_format_t format;
+  uint32_t fields;   /**< Mask of ta_txn_field_t to write */
+  size_t object_len; /**< Upper bound of the length of an object with these fields */
+  json_writer_t json;
+  cbor_writer_t cbor;
+} txn_writer_t;
+
+static status_t txn_writer_init(txn_writer_t* const writer, ta_txn_serialize_opt_t const* const opt,
+                                const size_t num_txns) {
+  writer->format = opt ? opt->format : TA_RESPONSE_FORMAT_JSON;
+  writer->fields = (opt && opt->fields) ? opt->fields & TA_TXN_FIELDS_ALL : TA_TXN_FIELDS_ALL;
+  // The message makes up most of an object, so list views leaving it out need far smaller buffers
+  if (!(writer->fields & TA_TXN_FIELD_SIGNATURE_AND_MESSAGE_FRAGMENT)) {
+    writer->object_len = TXN_NO_MESSAGE_MAX_LEN;
+  } else {
+    writer->object_len = writer->format == TA_RESPONSE_FORMAT_CBOR ? TXN_CBOR_MAX_LEN : TXN_JSON_MAX_LEN;
+  }
 
-  TX_OBJS_FOREACH(txn_array, txn) {
-    cJSON* txn_obj = cJSON_CreateObject();
+  if (writer->format == TA_RESPONSE_FORMAT_CBOR) {
+    return cbor_writer_init(&writer->cbor, num_txns * writer->object_len + CBOR_WRITER_HEAD_LEN);
+  }
+  return json_writer_init(&writer->json, num_txns * (writer->object_len + 1) + 2);
+}
 
-    ret = iota_transaction_to_json_object(txn, &txn_obj);
-    if (ret != SC_OK) {
-      return ret;
-    }
-    cJSON_AddItemToArray(json_root, txn_obj);
+static void txn_writer_free(txn_writer_t* const writer) {
+  if (writer->format == TA_RESPONSE_FORMAT_CBOR) {
+    cbor_writer_free(&writer->cbor);
+  } else {
+    json_writer_free(&writer->json);
   }
-  return ret;
 }
 
-status_t ta_generate_address_res_serialize(const ta_generate_address_res_t* const res, char** obj) {
-  cJSON* json_root = cJSON_CreateArray();
-  status_t ret = SC_OK;
-  if (json_root == NULL) {
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_CREATE");
-    return SC_SERIALIZER_JSON_CREATE;
+static void txn_writer_detach(txn_writer_t* const writer, char** obj, size_t* const obj_len) {
+  size_t len = 0;
+  if (writer->format == TA_RESPONSE_FORMAT_CBOR) {
+    *obj = (char*)cbor_writer_detach(&writer->cbor, &len);
+  } else {
+    len = writer->json.len;
+    *obj = json_writer_detach(&writer->json);
   }
-  ret = ta_hash243_queue_to_json_array(res->addresses, json_root);
-  if (ret) {
-    return ret;
+  if (obj_len) {
+    *obj_len = len;
   }
+}
 
-  *obj = cJSON_PrintUnformatted(json_root);
-  if (*obj == NULL) {
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
-    return SC_SERIALIZER_JSON_PARSE;
+/**
+ * Open an array of transaction objects. JSON arrays need to be closed with txn_writer_end_array(), CBOR arrays are
+ * complete after `count` elements.
+ */
+static status_t txn_writer_begin_array(txn_writer_t* const writer, const size_t count) {
+  if (writer->format == TA_RESPONSE_FORMAT_CBOR) {
+    return cbor_writer_array(&writer->cbor, count);
   }
-  cJSON_Delete(json_root);
-  return ret;
+  return json_writer_begin_array(&writer->json);
 }
 
-status_t ta_get_tips_res_serialize(const get_tips_res_t* const res, char** obj) {
-  status_t ret = SC_OK;
+static status_t txn_writer_end_array(txn_writer_t* const writer) {
+  return writer->format == TA_RESPONSE_FORMAT_CBOR ? SC_OK : json_writer_end_array(&writer->json);
+}
 
-  cJSON* json_root = cJSON_CreateArray();
-  if (json_root == NULL) {
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_CREATE");
-    return RC_CCLIENT_JSON_CREATE;
+/**
+ * Open a transaction object with the selected members, reserving the space of the whole object at once so the
+ * members are written without growing the buffer.
+ */
+static status_t txn_writer_begin_object(txn_writer_t* const writer) {
+  if (writer->format == TA_RESPONSE_FORMAT_CBOR) {
+    if (cbor_writer_reserve(&writer->cbor, writer->object_len) != SC_OK) {
+      return SC_SERIALIZER_OOM;
+    }
+    return cbor_writer_map(&writer->cbor, txn_fields_count(writer->fields));
   }
-
-  ret = ta_hash243_stack_to_json_array(res->hashes, json_root);
-  if (ret) {
-    goto err;
+  if (json_writer_reserve(&writer->json, writer->object_len) != SC_OK) {
+    return SC_SERIALIZER_OOM;
   }
+  return json_writer_begin_object(&writer->json);
+}
 
-  *obj = cJSON_PrintUnformatted(json_root);
-  if (*obj == NULL) {
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
-    return SC_SERIALIZER_JSON_PARSE;
+static status_t txn_writer_end_object(txn_writer_t* const writer) {
+  return writer->format == TA_RESPONSE_FORMAT_CBOR ? SC_OK : json_writer_end_object(&writer->json);
+}
+
+/**
+ * Write a trinary member, as a tryte string in JSON or as a byte string of packed trits in CBOR. Members which are not
+ * selected are skipped without converting their trits.
+ */
+static status_t txn_writer_member_trits(txn_writer_t* const writer, const ta_txn_field_t field, char const* const key,
+                                        flex_trit_t const* const trits, const size_t num_trytes,
+                                        const size_t num_trits) {
+  if (!(writer->fields & field)) {
+    return SC_OK;
+  }
+  if (writer->format == TA_RESPONSE_FORMAT_CBOR) {
+    if (cbor_writer_text(&writer->cbor, key, strlen(key)) != SC_OK) {
+      return SC_SERIALIZER_OOM;
+    }
+    uint8_t* bytes = cbor_writer_bytes_inplace(&writer->cbor, TA_PACKED_TRITS_LEN(num_trits));
+    if (bytes == NULL) {
+      return SC_SERIALIZER_OOM;
+    }
+    ta_flex_trits_to_bytes(bytes, TA_PACKED_TRITS_LEN(num_trits), trits, num_trits, num_trits);
+    return SC_OK;
   }
 
-err:
-  cJSON_Delete(json_root);
-  return ret;
+  if (json_writer_key(&writer->json, key) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+  // Trytes need no escaping, so they are converted straight into the output
+  char* trytes = json_writer_string_inplace(&writer->json, num_trytes);
+  if (trytes == NULL) {
+    return SC_SERIALIZER_OOM;
+  }
+  ta_flex_trits_to_trytes((tryte_t*)trytes, num_trytes, trits, num_trits, num_trits);
+  return SC_OK;
 }
 
-status_t ta_send_transfer_req_deserialize(const char* const obj, ta_send_transfer_req_t* req) {
-  if (obj == NULL) {
-    ta_log_error("%s\n", "SC_SERIALIZER_NULL");
-    return SC_SERIALIZER_NULL;
+static status_t txn_writer_member_int(txn_writer_t* const writer, const ta_txn_field_t field, char const* const key,
+                                      const int64_t value) {
+  if (!(writer->fields & field)) {
+    return SC_OK;
   }
-  cJSON* json_obj = cJSON_Parse(obj);
-  cJSON* json_result = NULL;
-  flex_trit_t tag_trits[NUM_TRITS_TAG], address_trits[NUM_TRITS_HASH];
-  int msg_len = 0, tag_len = 0;
-  bool raw_message = true;
+  if (writer->format == TA_RESPONSE_FORMAT_CBOR) {
+    if (cbor_writer_text(&writer->cbor, key, strlen(key)) != SC_OK || cbor_writer_int(&writer->cbor, value) != SC_OK) {
+      return SC_SERIALIZER_OOM;
+    }
+    return SC_OK;
+  }
+  if (json_writer_key(&writer->json, key) != SC_OK || json_writer_int(&writer->json, value) != SC_OK) {
+    return SC_SERIALIZER_OOM;
+  }
+  return SC_OK;
+}
+
+/**
+ * Write a transaction object with the same fields in the same order as iota_transaction_to_json_object()
+ */
+static status_t iota_transaction_write(iota_transaction_t const* const txn, txn_writer_t* const writer) {
   status_t ret = SC_OK;
+  if (txn == NULL) {
+    ta_log_error("%s\n", "SC_CCLIENT_NOT_FOUND");
+    return SC_CCLIENT_NOT_FOUND;
+  }
 
-  if (json_obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
+  ret = txn_writer_begin_object(writer);
+  if (ret != SC_OK) {
     goto done;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "value");
-  if ((json_result != NULL) && cJSON_IsNumber(json_result)) {
-    req->value = json_result->valueint;
-  } else {
-    // 'value' does not exist or invalid, set to 0
-    req->value = 0;
+  // transaction hash
+  ret = txn_writer_member_trits(writer, TA_TXN_FIELD_HASH, "hash", transaction_hash(txn), NUM_TRYTES_HASH,
+                                NUM_TRITS_HASH);
+  if (ret != SC_OK) {
+    goto done;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "tag");
-  if (json_result != NULL && json_result->valuestring != NULL) {
-    tag_len = strnlen(json_result->valuestring, NUM_TRYTES_TAG);
-
-    for (int i = 0; i < tag_len; i++) {
-      if (json_result->valuestring[i] & (unsigned)128) {
-        ret = SC_SERIALIZER_JSON_PARSE_ASCII;
-        ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE_ASCII");
-        goto done;
-      }
-    }
+  // message
+  ret = txn_writer_member_trits(writer, TA_TXN_FIELD_SIGNATURE_AND_MESSAGE_FRAGMENT, "signature_and_message_fragment",
+                                transaction_message(txn), NUM_TRYTES_SIGNATURE, NUM_TRITS_SIGNATURE);
+  if (ret != SC_OK) {
+    goto done;
+  }
 
-    // If 'tag' is less than 27 trytes (NUM_TRYTES_TAG), expands it
-    if (tag_len < NUM_TRYTES_TAG) {
-      char new_tag[NUM_TRYTES_TAG + 1];
-      // Fill in '9' to get valid tag (27 trytes)
-      fill_nines(new_tag, json_result->valuestring, NUM_TRYTES_TAG);
-      new_tag[NUM_TRYTES_TAG] = '\0';
-      flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)new_tag, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
-    } else {
-      // Valid tag from request, use it directly
-      flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)json_result->valuestring, NUM_TRYTES_TAG,
-                             NUM_TRYTES_TAG);
-    }
-  } else {
-    // 'tag' does not exists, set to DEFAULT_TAG
-    flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)DEFAULT_TAG, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
+  // address
+  ret = txn_writer_member_trits(writer, TA_TXN_FIELD_ADDRESS, "address", transaction_address(txn), NUM_TRYTES_HASH,
+                                NUM_TRITS_HASH);
+  if (ret != SC_OK) {
+    goto done;
   }
-  ret = hash81_queue_push(&req->tag, tag_trits);
-  if (ret) {
-    ret = SC_CCLIENT_HASH;
-    ta_log_error("%s\n", "SC_CCLIENT_HASH");
+
+  // value
+  ret = txn_writer_member_int(writer, TA_TXN_FIELD_VALUE, "value", transaction_value(txn));
+  if (ret != SC_OK) {
     goto done;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "message_format");
-  if (json_result != NULL) {
-    if (!strncmp("trytes", json_result->valuestring, 6)) {
-      raw_message = false;
-    }
+  // obsolete tag
+  ret = txn_writer_member_trits(writer, TA_TXN_FIELD_OBSOLETE_TAG, "obsolete_tag", transaction_obsolete_tag(txn),
+                                NUM_TRYTES_TAG, NUM_TRITS_TAG);
+  if (ret != SC_OK) {
+    goto done;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "message");
-  if (json_result != NULL && json_result->valuestring != NULL) {
-    msg_len = strlen(json_result->valuestring);
+  // timestamp
+  ret = txn_writer_member_int(writer, TA_TXN_FIELD_TIMESTAMP, "timestamp", transaction_timestamp(txn));
+  if (ret != SC_OK) {
+    goto done;
+  }
 
-    // In case the payload is unicode, char more than 128 will result to an
-    // error status_t code
-    for (int i = 0; i < msg_len; i++) {
-      if (json_result->valuestring[i] & 0x80) {
-        ret = SC_SERIALIZER_JSON_PARSE_ASCII;
-        ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE_ASCII");
-        goto done;
-      }
-    }
+  // current index
+  ret = txn_writer_member_int(writer, TA_TXN_FIELD_CURRENT_INDEX, "current_index", transaction_current_index(txn));
+  if (ret != SC_OK) {
+    goto done;
+  }
 
-    if (raw_message) {
+  // last index
+  ret = txn_writer_member_int(writer, TA_TXN_FIELD_LAST_INDEX, "last_index", transaction_last_index(txn));
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  // bundle hash
+  ret = txn_writer_member_trits(writer, TA_TXN_FIELD_BUNDLE_HASH, "bundle_hash", transaction_bundle(txn),
+                                NUM_TRYTES_HASH, NUM_TRITS_HASH);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  // trunk transaction hash
+  ret = txn_writer_member_trits(writer, TA_TXN_FIELD_TRUNK_TRANSACTION_HASH, "trunk_transaction_hash",
+                                transaction_trunk(txn), NUM_TRYTES_HASH, NUM_TRITS_HASH);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  // branch transaction hash
+  ret = txn_writer_member_trits(writer, TA_TXN_FIELD_BRANCH_TRANSACTION_HASH, "branch_transaction_hash",
+                                transaction_branch(txn), NUM_TRYTES_HASH, NUM_TRITS_HASH);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  // tag
+  ret = txn_writer_member_trits(writer, TA_TXN_FIELD_TAG, "tag", transaction_tag(txn), NUM_TRYTES_TAG, NUM_TRITS_TAG);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  // attachment timestamp
+  ret = txn_writer_member_int(writer, TA_TXN_FIELD_ATTACHMENT_TIMESTAMP, "attachment_timestamp",
+                              transaction_attachment_timestamp(txn));
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  // attachment lower timestamp
+  ret = txn_writer_member_int(writer, TA_TXN_FIELD_ATTACHMENT_TIMESTAMP_LOWER_BOUND, "attachment_timestamp_lower_bound",
+                              transaction_attachment_timestamp_lower(txn));
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  // attachment upper timestamp
+  ret = txn_writer_member_int(writer, TA_TXN_FIELD_ATTACHMENT_TIMESTAMP_UPPER_BOUND, "attachment_timestamp_upper_bound",
+                              transaction_attachment_timestamp_upper(txn));
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  // nonce
+  ret = txn_writer_member_trits(writer, TA_TXN_FIELD_NONCE, "nonce", transaction_nonce(txn), NUM_TRYTES_NONCE,
+                                NUM_TRITS_NONCE);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+  ret = txn_writer_end_object(writer);
+  if (ret != SC_OK) {
+    goto done;
+  }
+
+done:
+  if (ret != SC_OK) {
+    ta_log_error("%d\n", ret);
+  }
+  return ret;
+}
+
+/**
+ * Serialize a single transaction object
+ */
+static status_t iota_transaction_serialize(iota_transaction_t const* const txn, ta_txn_serialize_opt_t const* const opt,
+                                           char** obj, size_t* const obj_len) {
+  status_t ret = SC_OK;
+  txn_writer_t writer;
+
+  if (txn_writer_init(&writer, opt, 1) != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+    return SC_SERIALIZER_OOM;
+  }
+
+  ret = iota_transaction_write(txn, &writer);
+  if (ret != SC_OK) {
+    goto done;
+  }
+  txn_writer_detach(&writer, obj, obj_len);
+
+done:
+  txn_writer_free(&writer);
+  return ret;
+}
+
+status_t ta_generate_address_res_serialize(const ta_generate_address_res_t* const res, char** obj) {
+  cJSON* json_root = cJSON_CreateArray();
+  status_t ret = SC_OK;
+  if (json_root == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_JSON_CREATE");
+    return SC_SERIALIZER_JSON_CREATE;
+  }
+  ret = ta_hash243_queue_to_json_array(res->addresses, json_root);
+  if (ret) {
+    return ret;
+  }
+
+  *obj = cJSON_PrintUnformatted(json_root);
+  if (*obj == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+  cJSON_Delete(json_root);
+  return ret;
+}
+
+status_t ta_get_tips_res_serialize(const get_tips_res_t* const res, char** obj) {
+  status_t ret = SC_OK;
+
+  cJSON* json_root = cJSON_CreateArray();
+  if (json_root == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_JSON_CREATE");
+    return RC_CCLIENT_JSON_CREATE;
+  }
+
+  ret = ta_hash243_stack_to_json_array(res->hashes, json_root);
+  if (ret) {
+    goto err;
+  }
+
+  *obj = cJSON_PrintUnformatted(json_root);
+  if (*obj == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
+    return SC_SERIALIZER_JSON_PARSE;
+  }
+
+err:
+  cJSON_Delete(json_root);
+  return ret;
+}
+
+status_t ta_send_transfer_req_deserialize_insitu(char* const obj, arena_t* const arena, ta_send_transfer_req_t* req) {
+  json_token_t* json_obj = NULL;
+  json_token_t* json_result = NULL;
+  flex_trit_t tag_trits[NUM_TRITS_TAG], address_trits[NUM_TRITS_HASH];
+  int msg_len = 0, tag_len = 0;
+  bool raw_message = true;
+  status_t ret = ta_json_tokenize_req(obj, arena, &json_obj);
+
+  if (ret != SC_OK) {
+    return ret;
+  }
+
+  json_result = json_token_get(json_obj, "value");
+  if (json_result != NULL && json_result->type == JSON_TOKEN_NUMBER) {
+    req->value = json_result->integer;
+  } else {
+    // 'value' does not exist or invalid, set to 0
+    req->value = 0;
+  }
+
+  json_result = json_token_get_string(json_obj, "tag");
+  if (json_result != NULL) {
+    tag_len = strnlen(json_result->str, NUM_TRYTES_TAG);
+
+    for (int i = 0; i < tag_len; i++) {
+      if (json_result->str[i] & (unsigned)128) {
+        ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE_ASCII");
+        return SC_SERIALIZER_JSON_PARSE_ASCII;
+      }
+    }
+
+    // If 'tag' is less than 27 trytes (NUM_TRYTES_TAG), expands it
+    if (tag_len < NUM_TRYTES_TAG) {
+      char new_tag[NUM_TRYTES_TAG + 1];
+      // Fill in '9' to get valid tag (27 trytes)
+      fill_nines(new_tag, json_result->str, NUM_TRYTES_TAG);
+      new_tag[NUM_TRYTES_TAG] = '\0';
+      ta_flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)new_tag, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
+    } else {
+      // Valid tag from request, use it directly
+      ta_flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)json_result->str, NUM_TRYTES_TAG,
+                                NUM_TRYTES_TAG);
+    }
+  } else {
+    // 'tag' does not exists, set to DEFAULT_TAG
+    ta_flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)DEFAULT_TAG, NUM_TRYTES_TAG, NUM_TRYTES_TAG);
+  }
+  if (hash81_queue_push(&req->tag, tag_trits)) {
+    ta_log_error("%s\n", "SC_CCLIENT_HASH");
+    return SC_CCLIENT_HASH;
+  }
+
+  json_result = json_token_get_string(json_obj, "message_format");
+  if (json_result != NULL && !strncmp("trytes", json_result->str, 6)) {
+    raw_message = false;
+  }
+
+  json_result = json_token_get_string(json_obj, "message");
+  if (json_result != NULL) {
+    msg_len = json_result->len;
+
+    // In case the payload is unicode, char more than 128 will result to an
+    // error status_t code
+    for (int i = 0; i < msg_len; i++) {
+      if (json_result->str[i] & 0x80) {
+        ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE_ASCII");
+        return SC_SERIALIZER_JSON_PARSE_ASCII;
+      }
+    }
+
+    if (raw_message) {
       msg_len = msg_len * 2;
       req->msg_len = msg_len * 3;
-      tryte_t trytes_buffer[msg_len];
+      tryte_t* trytes_buffer = (tryte_t*)arena_alloc(arena, msg_len);
+      if (trytes_buffer == NULL) {
+        ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+        return SC_SERIALIZER_OOM;
+      }
 
-      ascii_to_trytes(json_result->valuestring, trytes_buffer);
-      flex_trits_from_trytes(req->message, req->msg_len, trytes_buffer, msg_len, msg_len);
+      ascii_to_trytes(json_result->str, trytes_buffer);
+      ta_flex_trits_from_trytes(req->message, req->msg_len, trytes_buffer, msg_len, msg_len);
     } else {
+      if (!ta_trytes_validate((const tryte_t*)json_result->str, msg_len)) {
+        ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+        return SC_SERIALIZER_INVALID_REQ;
+      }
       req->msg_len = msg_len * 3;
-      flex_trits_from_trytes(req->message, req->msg_len, (const tryte_t*)json_result->valuestring, msg_len, msg_len);
+      ta_flex_trits_from_trytes(req->message, req->msg_len, (const tryte_t*)json_result->str, msg_len, msg_len);
     }
   } else {
     // 'message' does not exists, set to DEFAULT_MSG
     req->msg_len = DEFAULT_MSG_LEN * 3;
-    flex_trits_from_trytes(req->message, req->msg_len, (const tryte_t*)DEFAULT_MSG, DEFAULT_MSG_LEN, DEFAULT_MSG_LEN);
+    ta_flex_trits_from_trytes(req->message, req->msg_len, (const tryte_t*)DEFAULT_MSG, DEFAULT_MSG_LEN,
+                              DEFAULT_MSG_LEN);
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "address");
-  if (json_result != NULL && json_result->valuestring != NULL && (strnlen(json_result->valuestring, 81) == 81)) {
-    flex_trits_from_trytes(address_trits, NUM_TRITS_HASH, (const tryte_t*)json_result->valuestring, NUM_TRYTES_HASH,
-                           NUM_TRYTES_HASH);
+  json_result = json_token_get_string(json_obj, "address");
+  if (json_result != NULL && json_result->len == NUM_TRYTES_HASH) {
+    ta_flex_trits_from_trytes(address_trits, NUM_TRITS_HASH, (const tryte_t*)json_result->str, NUM_TRYTES_HASH,
+                              NUM_TRYTES_HASH);
   } else {
     // 'address' does not exists, set to DEFAULT_ADDRESS
-    flex_trits_from_trytes(address_trits, NUM_TRITS_HASH, (const tryte_t*)DEFAULT_ADDRESS, NUM_TRYTES_HASH,
-                           NUM_TRYTES_HASH);
+    ta_flex_trits_from_trytes(address_trits, NUM_TRITS_HASH, (const tryte_t*)DEFAULT_ADDRESS, NUM_TRYTES_HASH,
+                              NUM_TRYTES_HASH);
   }
-  ret = hash243_queue_push(&req->address, address_trits);
-  if (ret) {
-    ret = SC_CCLIENT_HASH;
+  if (hash243_queue_push(&req->address, address_trits)) {
     ta_log_error("%s\n", "SC_CCLIENT_HASH");
-    goto done;
+    return SC_CCLIENT_HASH;
   }
 
-done:
-  cJSON_Delete(json_obj);
-  return ret;
+  return SC_OK;
 }
 
-status_t ta_send_trytes_req_deserialize(const char* const obj, hash8019_array_p out_trytes) {
-  if (obj == NULL || out_trytes == NULL) {
+status_t ta_send_transfer_req_deserialize(const char* const obj, ta_send_transfer_req_t* req) {
+  if (obj == NULL) {
     ta_log_error("%s\n", "SC_SERIALIZER_NULL");
     return SC_SERIALIZER_NULL;
   }
-  status_t ret = SC_OK;
-  cJSON* json_obj = cJSON_Parse(obj);
+  status_t ret = SC_SERIALIZER_OOM;
+  char arena_buf[DESERIALIZE_ARENA_SIZE];
+  arena_t arena;
+  char* buf = ta_json_copy_req(obj, &arena, arena_buf);
 
-  if (json_obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
-    goto done;
+  if (buf != NULL) {
+    ret = ta_send_transfer_req_deserialize_insitu(buf, &arena, req);
+  }
+  arena_reset(&arena);
+  return ret;
+}
+
+status_t ta_send_trytes_req_deserialize_insitu(char* const obj, arena_t* const arena, hash8019_array_p out_trytes) {
+  if (out_trytes == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_NULL");
+    return SC_SERIALIZER_NULL;
   }
+  json_token_t* json_obj = NULL;
+  status_t ret = ta_json_tokenize_req(obj, arena, &json_obj);
 
-  ret = ta_json_array_to_hash8019_array(json_obj, "trytes", out_trytes);
   if (ret != SC_OK) {
-    goto done;
+    return ret;
   }
+  return ta_json_array_to_hash8019_array(json_obj, "trytes", out_trytes);
+}
 
-done:
-  cJSON_Delete(json_obj);
+status_t ta_send_trytes_req_deserialize(const char* const obj, hash8019_array_p out_trytes) {
+  if (obj == NULL || out_trytes == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_NULL");
+    return SC_SERIALIZER_NULL;
+  }
+  status_t ret = SC_SERIALIZER_OOM;
+  char arena_buf[DESERIALIZE_ARENA_SIZE];
+  arena_t arena;
+  char* buf = ta_json_copy_req(obj, &arena, arena_buf);
+
+  if (buf != NULL) {
+    ret = ta_send_trytes_req_deserialize_insitu(buf, &arena, out_trytes);
+  }
+  arena_reset(&arena);
   return ret;
 }
 
@@ -528,128 +1096,502 @@ done:
   return ret;
 }
 
+status_t ta_find_transaction_objects_req_deserialize_insitu(char* const obj, arena_t* const arena,
+                                                            ta_find_transaction_objects_req_t* const req) {
+  json_token_t* json_obj = NULL;
+  status_t ret = ta_json_tokenize_req(obj, arena, &json_obj);
+
+  if (ret != SC_OK) {
+    return ret;
+  }
+
+  ret = ta_json_array_to_hash243_vector(json_obj, "hashes", &req->hashes);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
+    return ret;
+  }
+  return ta_json_token_to_txn_fields(json_obj, &req->fields);
+}
+
 status_t ta_find_transaction_objects_req_deserialize(const char* const obj,
                                                      ta_find_transaction_objects_req_t* const req) {
-  status_t ret = SC_OK;
   if (obj == NULL) {
     ta_log_error("%s\n", "SC_SERIALIZER_NULL");
     return SC_SERIALIZER_NULL;
   }
+  status_t ret = SC_SERIALIZER_OOM;
+  char arena_buf[DESERIALIZE_ARENA_SIZE];
+  arena_t arena;
+  char* buf = ta_json_copy_req(obj, &arena, arena_buf);
 
-  cJSON* json_obj = cJSON_Parse(obj);
-  if (json_obj == NULL) {
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
-    return SC_SERIALIZER_JSON_PARSE;
+  if (buf != NULL) {
+    ret = ta_find_transaction_objects_req_deserialize_insitu(buf, &arena, req);
   }
+  arena_reset(&arena);
+  return ret;
+}
+
+/** Members of a query of several tags, addresses, bundles and approvees */
+static struct ta_find_txn_member_s {
+  char const* name;
+  size_t len; /**< Number of trytes, tags may be shorter */
+  retcode_t (*add)(find_transactions_req_t* const req, flex_trit_t const* const trits);
+} const ta_find_txn_members[] = {
+    {"tags", NUM_TRYTES_TAG, find_transactions_req_tag_add},
+    {"addresses", NUM_TRYTES_HASH, find_transactions_req_address_add},
+    {"bundles", NUM_TRYTES_HASH, find_transactions_req_bundle_add},
+    {"approvees", NUM_TRYTES_HASH, find_transactions_req_approvee_add},
+};
+
+/**
+ * Add the strings of one array member of a query to a find_transactions_req_t. Tags of less than NUM_TRYTES_TAG trytes
+ * are padded with '9'.
+ */
+static status_t ta_json_array_to_find_transactions_req(json_token_t const* const obj,
+                                                       struct ta_find_txn_member_s const* const member,
+                                                       find_transactions_req_t* const req, size_t* const count) {
+  flex_trit_t trits[FLEX_TRIT_SIZE_243];
+  char tag[NUM_TRYTES_TAG + 1];
+  json_token_t* json_item = json_token_get(obj, member->name);
+
+  if (json_item == NULL) {
+    return SC_OK;
+  }
+  if (json_item->type != JSON_TOKEN_ARRAY) {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
+  }
+  for (json_token_t* current_obj = json_item->child; current_obj; current_obj = current_obj->next) {
+    bool valid_len = member->len == NUM_TRYTES_TAG ? current_obj->len > 0 && current_obj->len <= NUM_TRYTES_TAG
+                                                   : current_obj->len == member->len;
+    if (current_obj->type != JSON_TOKEN_STRING || !valid_len ||
+        !ta_trytes_validate((tryte_t const*)current_obj->str, current_obj->len) || ++*count > TA_FIND_TXN_MAX_TERMS) {
+      ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+      return SC_SERIALIZER_INVALID_REQ;
+    }
+
+    char const* str = current_obj->str;
+    if (current_obj->len < member->len) {
+      fill_nines(tag, current_obj->str, NUM_TRYTES_TAG);
+      str = tag;
+    }
+    ta_flex_trits_from_trytes(trits, member->len * 3, (tryte_t const*)str, member->len, member->len);
+    if (member->add(req, trits) != RC_OK) {
+      ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+      return SC_SERIALIZER_OOM;
+    }
+  }
+  return SC_OK;
+}
+
+status_t ta_find_transactions_req_deserialize_insitu(char* const obj, arena_t* const arena,
+                                                     find_transactions_req_t* const req, uint32_t* const fields) {
+  if (req == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_NULL");
+    return SC_SERIALIZER_NULL;
+  }
+  json_token_t* json_obj = NULL;
+  size_t count = 0;
+  status_t ret = ta_json_tokenize_req(obj, arena, &json_obj);
 
-  ret = ta_json_array_to_hash243_queue(json_obj, "hashes", &req->hashes);
   if (ret != SC_OK) {
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
+    return ret;
+  }
+  for (size_t i = 0; i < sizeof(ta_find_txn_members) / sizeof(ta_find_txn_members[0]); i++) {
+    ret = ta_json_array_to_find_transactions_req(json_obj, &ta_find_txn_members[i], req, &count);
+    if (ret != SC_OK) {
+      return ret;
+    }
+  }
+  if (count == 0) {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
   }
+  return fields ? ta_json_token_to_txn_fields(json_obj, fields) : SC_OK;
+}
 
-  cJSON_Delete(json_obj);
-  return ret;
+/** Names of the batch commands, indexed by ta_batch_cmd_t */
+static char const* const ta_batch_cmd_names[TA_BATCH_CMD_NUM] = {
+    [TA_BATCH_GENERATE_ADDRESS] = "generate_address",
+    [TA_BATCH_GET_TIPS_PAIR] = "get_tips_pair",
+    [TA_BATCH_GET_TIPS] = "get_tips",
+    [TA_BATCH_FIND_TXN_BY_TAG] = "find_transactions_by_tag",
+    [TA_BATCH_FIND_TXN_OBJ_BY_TAG] = "find_transactions_obj_by_tag",
+    [TA_BATCH_FIND_TRANSACTION_OBJECTS] = "find_transaction_objects",
+};
+
+/**
+ * Read one sub-request of a batch
+ */
+static status_t ta_batch_sub_req_deserialize(json_token_t const* const obj, arena_t* const arena,
+                                             ta_batch_sub_req_t* const req) {
+  json_token_t* json_result = json_token_get_string(obj, "command");
+  int cmd = 0;
+
+  if (json_result == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
+  }
+  for (cmd = 0; cmd < TA_BATCH_CMD_NUM; cmd++) {
+    if (!strcmp(json_result->str, ta_batch_cmd_names[cmd])) {
+      break;
+    }
+  }
+  if (cmd == TA_BATCH_CMD_NUM) {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
+  }
+
+  req->cmd = (ta_batch_cmd_t)cmd;
+  req->tag = NULL;
+  req->fields = 0;
+  hash243_vector_init(&req->hashes, arena);
+  switch (req->cmd) {
+    case TA_BATCH_FIND_TXN_BY_TAG:
+    case TA_BATCH_FIND_TXN_OBJ_BY_TAG:
+      json_result = json_token_get_string(obj, "tag");
+      if (json_result == NULL || json_result->len == 0) {
+        ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+        return SC_SERIALIZER_INVALID_REQ;
+      }
+      req->tag = json_result->str;
+      if (req->cmd == TA_BATCH_FIND_TXN_OBJ_BY_TAG) {
+        return ta_json_token_to_txn_fields(obj, &req->fields);
+      }
+      return SC_OK;
+    case TA_BATCH_FIND_TRANSACTION_OBJECTS:
+      if (ta_json_array_to_hash243_vector(obj, "hashes", &req->hashes) != SC_OK) {
+        ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+        return SC_SERIALIZER_INVALID_REQ;
+      }
+      return ta_json_token_to_txn_fields(obj, &req->fields);
+    default:
+      return SC_OK;
+  }
 }
 
-status_t ta_find_transaction_object_single_res_serialize(transaction_array_t* res, char** obj) {
-  status_t ret = SC_OK;
-  cJSON* json_root = cJSON_CreateObject();
-  if (json_root == NULL) {
-    ta_log_error("%s\n", "SC_CCLIENT_JSON_CREATE");
-    return SC_CCLIENT_JSON_CREATE;
+status_t ta_batch_req_deserialize_insitu(char* const obj, arena_t* const arena, ta_batch_req_t* const req) {
+  if (req == NULL) {
+    ta_log_error("%s\n", "SC_SERIALIZER_NULL");
+    return SC_SERIALIZER_NULL;
   }
+  json_token_t* json_obj = NULL;
+  status_t ret = ta_json_tokenize_req(obj, arena, &json_obj);
 
-  ret = iota_transaction_to_json_object(transaction_array_at(res, 0), &json_root);
   if (ret != SC_OK) {
-    goto done;
+    return ret;
   }
 
-  *obj = cJSON_PrintUnformatted(json_root);
-  if (*obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
+  json_token_t* json_item = json_token_get(json_obj, "requests");
+  if (json_item == NULL || json_item->type != JSON_TOKEN_ARRAY || json_item->size == 0 ||
+      json_item->size > TA_BATCH_MAX_REQUESTS) {
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    return SC_SERIALIZER_INVALID_REQ;
+  }
+  req->num = 0;
+  for (json_token_t* current_obj = json_item->child; current_obj; current_obj = current_obj->next) {
+    if (current_obj->type != JSON_TOKEN_OBJECT) {
+      ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+      return SC_SERIALIZER_INVALID_REQ;
+    }
+    ret = ta_batch_sub_req_deserialize(current_obj, arena, &req->reqs[req->num]);
+    if (ret != SC_OK) {
+      return ret;
+    }
+    req->num++;
+  }
+  return SC_OK;
+}
+
+status_t ta_batch_res_serialize(char* const* const results, status_t const* const rets, const size_t num,
+                                char** obj) {
+  status_t ret = SC_OK;
+  json_writer_t writer;
+  size_t capacity = 32;
+
+  for (size_t i = 0; i < num; i++) {
+    capacity += (rets[i] == SC_OK && results[i] ? strlen(results[i]) : 32) + 1;
+  }
+  if (json_writer_init(&writer, capacity) != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+    return SC_SERIALIZER_OOM;
+  }
+
+  if (json_writer_begin_object(&writer) != SC_OK || json_writer_key(&writer, "results") != SC_OK ||
+      json_writer_begin_array(&writer) != SC_OK) {
+    ret = SC_SERIALIZER_OOM;
+    goto done;
+  }
+  for (size_t i = 0; i < num; i++) {
+    if (rets[i] == SC_OK && results[i]) {
+      // The results are serialized by the APIs already
+      ret = json_writer_raw(&writer, results[i], strlen(results[i]));
+    } else if (json_writer_begin_object(&writer) != SC_OK || json_writer_key(&writer, "error") != SC_OK ||
+               json_writer_int(&writer, rets[i] == SC_OK ? SC_SERIALIZER_NULL : rets[i]) != SC_OK) {
+      ret = SC_SERIALIZER_OOM;
+    } else {
+      ret = json_writer_end_object(&writer);
+    }
+    if (ret != SC_OK) {
+      goto done;
+    }
+  }
+  if (json_writer_end_array(&writer) != SC_OK || json_writer_end_object(&writer) != SC_OK) {
+    ret = SC_SERIALIZER_OOM;
+    goto done;
   }
+  *obj = json_writer_detach(&writer);
 
 done:
-  cJSON_Delete(json_root);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+  }
+  json_writer_free(&writer);
   return ret;
 }
 
+status_t ta_find_transaction_object_single_res_serialize(transaction_array_t* res, char** obj) {
+  return iota_transaction_serialize(transaction_array_at(res, 0), NULL, obj, NULL);
+}
+
 status_t ta_find_transaction_objects_res_serialize(const transaction_array_t* const res, char** obj) {
+  return ta_transaction_array_serialize(res, NULL, obj, NULL);
+}
+
+status_t ta_transaction_array_serialize(const transaction_array_t* const res, ta_txn_serialize_opt_t const* const opt,
+                                        char** obj, size_t* const obj_len) {
   status_t ret = SC_OK;
-  cJSON* json_root = cJSON_CreateArray();
-  if (json_root == NULL) {
-    ta_log_error("%s\n", "SC_CCLIENT_JSON_CREATE");
-    return SC_CCLIENT_JSON_CREATE;
+  txn_writer_t writer;
+  iota_transaction_t* txn = NULL;
+  size_t txn_count = 0;
+
+  TX_OBJS_FOREACH(res, txn) { txn_count++; }
+  // Size the buffer for the whole response up front, so it never grows while writing
+  if (txn_writer_init(&writer, opt, txn_count) != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+    return SC_SERIALIZER_OOM;
   }
 
-  ret = transaction_array_to_json_array(json_root, res);
+  ret = txn_writer_begin_array(&writer, txn_count);
   if (ret != SC_OK) {
     goto done;
   }
-
-  *obj = cJSON_PrintUnformatted(json_root);
-  if (*obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
+  TX_OBJS_FOREACH(res, txn) {
+    ret = iota_transaction_write(txn, &writer);
+    if (ret != SC_OK) {
+      goto done;
+    }
+  }
+  ret = txn_writer_end_array(&writer);
+  if (ret != SC_OK) {
+    goto done;
   }
+  txn_writer_detach(&writer, obj, obj_len);
 
 done:
-  cJSON_Delete(json_root);
+  txn_writer_free(&writer);
   return ret;
 }
 
-status_t ta_find_transactions_by_tag_res_serialize(const ta_find_transactions_by_tag_res_t* const res, char** obj) {
+status_t ta_hash_page_res_serialize(hash243_vector_t const* const hashes, const size_t cursor, char** obj) {
   status_t ret = SC_OK;
-  cJSON* json_root = cJSON_CreateArray();
-  if (json_root == NULL) {
-    ret = SC_SERIALIZER_JSON_CREATE;
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_CREATE");
-    goto done;
+  json_writer_t writer;
+  flex_trit_t const* hash = NULL;
+  char cursor_str[24];
+  int cursor_len = snprintf(cursor_str, sizeof(cursor_str), "%zu", cursor);
+
+  // Every hash takes its trytes, the quotes and a comma, plus the keys, the cursor and the brackets
+  if (json_writer_init(&writer, hash243_vector_count(hashes) * (NUM_TRYTES_HASH + 3) + 64) != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+    return SC_SERIALIZER_OOM;
   }
 
-  ret = ta_hash243_queue_to_json_array(res->hashes, json_root);
-  if (ret) {
+  if (json_writer_begin_object(&writer) != SC_OK || json_writer_key(&writer, "hashes") != SC_OK ||
+      json_writer_begin_array(&writer) != SC_OK) {
+    ret = SC_SERIALIZER_OOM;
     goto done;
   }
-  *obj = cJSON_PrintUnformatted(json_root);
-  if (*obj == NULL) {
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
-    ret = SC_SERIALIZER_JSON_PARSE;
+  HASH243_VECTOR_FOREACH(hashes, hash) {
+    char* trytes = json_writer_string_inplace(&writer, NUM_TRYTES_HASH);
+    if (trytes == NULL) {
+      ret = SC_SERIALIZER_OOM;
+      goto done;
+    }
+    ta_flex_trits_to_trytes((tryte_t*)trytes, NUM_TRYTES_HASH, hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+  }
+  if (json_writer_end_array(&writer) != SC_OK || json_writer_key(&writer, "cursor") != SC_OK ||
+      json_writer_string(&writer, cursor_str, cursor_len) != SC_OK || json_writer_end_object(&writer) != SC_OK) {
+    ret = SC_SERIALIZER_OOM;
     goto done;
   }
+  *obj = json_writer_detach(&writer);
 
 done:
-  cJSON_Delete(json_root);
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+  }
+  json_writer_free(&writer);
   return ret;
 }
 
-status_t ta_send_transfer_res_serialize(transaction_array_t* res, char** obj) {
+status_t ta_transaction_page_res_serialize(const transaction_array_t* const res,
+                                           ta_txn_serialize_opt_t const* const opt, const size_t cursor, char** obj,
+                                           size_t* const obj_len) {
   status_t ret = SC_OK;
-  cJSON* json_root = cJSON_CreateObject();
-  if (json_root == NULL) {
-    ret = SC_SERIALIZER_JSON_CREATE;
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_CREATE");
+  txn_writer_t writer;
+  iota_transaction_t* txn = NULL;
+  size_t txn_count = 0;
+  char cursor_str[24];
+  int cursor_len = snprintf(cursor_str, sizeof(cursor_str), "%zu", cursor);
+
+  TX_OBJS_FOREACH(res, txn) { txn_count++; }
+  if (txn_writer_init(&writer, opt, txn_count) != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+    return SC_SERIALIZER_OOM;
+  }
+
+  if (writer.format == TA_RESPONSE_FORMAT_CBOR) {
+    ret = (cbor_writer_map(&writer.cbor, 2) != SC_OK || cbor_writer_text(&writer.cbor, "transactions", 12) != SC_OK)
+              ? SC_SERIALIZER_OOM
+              : SC_OK;
+  } else {
+    ret = (json_writer_begin_object(&writer.json) != SC_OK || json_writer_key(&writer.json, "transactions") != SC_OK)
+              ? SC_SERIALIZER_OOM
+              : SC_OK;
+  }
+  if (ret != SC_OK || txn_writer_begin_array(&writer, txn_count) != SC_OK) {
+    ret = SC_SERIALIZER_OOM;
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
     goto done;
   }
+  // The transaction writer logs its own failures
+  TX_OBJS_FOREACH(res, txn) {
+    ret = iota_transaction_write(txn, &writer);
+    if (ret != SC_OK) {
+      goto done;
+    }
+  }
 
-  ret = iota_transaction_to_json_object(transaction_array_at(res, 0), &json_root);
+  if (txn_writer_end_array(&writer) != SC_OK) {
+    ret = SC_SERIALIZER_OOM;
+  } else if (writer.format == TA_RESPONSE_FORMAT_CBOR) {
+    ret = (cbor_writer_text(&writer.cbor, "cursor", 6) != SC_OK ||
+           cbor_writer_text(&writer.cbor, cursor_str, cursor_len) != SC_OK)
+              ? SC_SERIALIZER_OOM
+              : SC_OK;
+  } else {
+    ret = (json_writer_key(&writer.json, "cursor") != SC_OK ||
+           json_writer_string(&writer.json, cursor_str, cursor_len) != SC_OK ||
+           json_writer_end_object(&writer.json) != SC_OK)
+              ? SC_SERIALIZER_OOM
+              : SC_OK;
+  }
   if (ret != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
     goto done;
   }
+  txn_writer_detach(&writer, obj, obj_len);
 
-  *obj = cJSON_PrintUnformatted(json_root);
-  if (*obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_CREATE");
+done:
+  txn_writer_free(&writer);
+  return ret;
+}
+
+status_t ta_transaction_page_serialize(const transaction_array_t* const page, const uint32_t fields, const bool first,
+                                       const bool last, char** obj, size_t* const obj_len) {
+  status_t ret = SC_OK;
+  txn_writer_t writer;
+  iota_transaction_t* txn = NULL;
+  size_t txn_count = 0;
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_JSON, .fields = fields};
+
+  TX_OBJS_FOREACH(page, txn) { txn_count++; }
+  if (txn_writer_init(&writer, &opt, txn_count) != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+    return SC_SERIALIZER_OOM;
+  }
+
+  if (first) {
+    ret = txn_writer_begin_array(&writer, txn_count);
+    if (ret != SC_OK) {
+      goto done;
+    }
+  } else {
+    // The previous page ended with an element, so the first one of this page needs a separator
+    writer.json.need_comma = true;
+  }
+  TX_OBJS_FOREACH(page, txn) {
+    ret = iota_transaction_write(txn, &writer);
+    if (ret != SC_OK) {
+      goto done;
+    }
+  }
+  if (last) {
+    ret = txn_writer_end_array(&writer);
+    if (ret != SC_OK) {
+      goto done;
+    }
+  }
+  txn_writer_detach(&writer, obj, obj_len);
+
+done:
+  txn_writer_free(&writer);
+  return ret;
+}
+
+status_t ta_transaction_object_serialize(const transaction_array_t* const res, ta_txn_serialize_opt_t const* const opt,
+                                         char** obj, size_t* const obj_len) {
+  return iota_transaction_serialize(transaction_array_at((transaction_array_t*)res, 0), opt, obj, obj_len);
+}
+
+status_t ta_find_transactions_by_tag_res_serialize(const ta_find_transactions_by_tag_res_t* const res, char** obj) {
+  status_t ret = SC_OK;
+  json_writer_t writer;
+  flex_trit_t const* hash = NULL;
+  size_t count = hash243_vector_count(&res->hashes);
+
+  if (count == 0) {
+    ta_log_error("%s\n", "SC_CCLIENT_NOT_FOUND");
+    return SC_CCLIENT_NOT_FOUND;
+  }
+  // Every hash takes its trytes, the quotes and a comma, plus the brackets of the array and the NUL
+  if (json_writer_init(&writer, count * (NUM_TRYTES_HASH + 3) + 3) != SC_OK) {
+    ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+    return SC_SERIALIZER_OOM;
+  }
+
+  ret = json_writer_begin_array(&writer);
+  if (ret != SC_OK) {
     goto done;
   }
+  HASH243_VECTOR_FOREACH(&res->hashes, hash) {
+    char* trytes = json_writer_string_inplace(&writer, NUM_TRYTES_HASH);
+    if (trytes == NULL) {
+      ret = SC_SERIALIZER_OOM;
+      ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+      goto done;
+    }
+    if (ta_flex_trits_to_trytes((tryte_t*)trytes, NUM_TRYTES_HASH, hash, NUM_TRITS_HASH, NUM_TRITS_HASH) == 0) {
+      ret = SC_CCLIENT_INVALID_FLEX_TRITS;
+      ta_log_error("%s\n", "SC_CCLIENT_INVALID_FLEX_TRITS");
+      goto done;
+    }
+  }
+  ret = json_writer_end_array(&writer);
+  if (ret != SC_OK) {
+    goto done;
+  }
+  *obj = json_writer_detach(&writer);
 
 done:
-  cJSON_Delete(json_root);
+  json_writer_free(&writer);
   return ret;
 }
 
+status_t ta_send_transfer_res_serialize(transaction_array_t* res, char** obj) {
+  return iota_transaction_serialize(transaction_array_at(res, 0), NULL, obj, NULL);
+}
+
 status_t receive_mam_message_res_serialize(char* const message, char** obj) {
   status_t ret = SC_OK;
   cJSON* json_root = cJSON_CreateObject();
@@ -734,134 +1676,158 @@ done:
   return ret;
 }
 
-status_t send_mam_req_deserialize(const char* const obj, ta_send_mam_req_t* req) {
-  if (obj == NULL) {
-    ta_log_error("%s\n", "SC_SERIALIZER_NULL");
-    return SC_SERIALIZER_NULL;
-  }
-  cJSON* json_obj = cJSON_Parse(obj);
-  cJSON* json_result = NULL;
-  status_t ret = SC_OK;
+status_t send_mam_req_deserialize_insitu(char* const obj, arena_t* const arena, ta_send_mam_req_t* req) {
+  json_token_t* json_obj = NULL;
+  json_token_t* json_result = NULL;
+  status_t ret = ta_json_tokenize_req(obj, arena, &json_obj);
 
-  if (json_obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
-    goto done;
+  if (ret != SC_OK) {
+    return ret;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "prng");
+  json_result = json_token_get(json_obj, "prng");
   if (json_result != NULL) {
-    size_t prng_size = strlen(json_result->valuestring);
-
-    if (prng_size != NUM_TRYTES_HASH) {
-      ret = SC_SERIALIZER_INVALID_REQ;
+    if (json_result->type != JSON_TOKEN_STRING || json_result->len != NUM_TRYTES_HASH) {
       ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
-      goto done;
+      return SC_SERIALIZER_INVALID_REQ;
     }
-    snprintf((char*)req->prng, prng_size + 1, "%s", json_result->valuestring);
+    memcpy(req->prng, json_result->str, NUM_TRYTES_HASH + 1);
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "message");
+  json_result = json_token_get_string(json_obj, "message");
   if (json_result != NULL) {
-    size_t payload_size = strlen(json_result->valuestring);
-    char* payload = (char*)malloc((payload_size + 1) * sizeof(char));
-
     // In case the payload is unicode, char more than 128 will result to an
     // error status_t code
-    for (size_t i = 0; i < payload_size; i++) {
-      if (json_result->valuestring[i] & 0x80) {
-        ret = SC_SERIALIZER_JSON_PARSE_ASCII;
+    for (size_t i = 0; i < json_result->len; i++) {
+      if (json_result->str[i] & 0x80) {
         ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE_ASCII");
-        goto done;
+        return SC_SERIALIZER_JSON_PARSE_ASCII;
       }
     }
 
-    snprintf(payload, payload_size + 1, "%s", json_result->valuestring);
-    req->payload = payload;
+    // The payload outlives the request body, so it is the only field copied out
+    req->payload = (char*)malloc(json_result->len + 1);
+    if (req->payload == NULL) {
+      ta_log_error("%s\n", "SC_SERIALIZER_OOM");
+      return SC_SERIALIZER_OOM;
+    }
+    memcpy(req->payload, json_result->str, json_result->len + 1);
   } else {
     ta_log_error("%s\n", "SC_SERIALIZER_NULL");
     ret = SC_SERIALIZER_NULL;
   }
 
-  json_result = cJSON_GetObjectItemCaseSensitive(json_obj, "channel_ord");
-  if ((json_result != NULL) && cJSON_IsNumber(json_result)) {
-    req->channel_ord = json_result->valueint;
+  json_result = json_token_get(json_obj, "channel_ord");
+  if (json_result != NULL && json_result->type == JSON_TOKEN_NUMBER) {
+    req->channel_ord = json_result->integer;
   } else {
     // 'value' does not exist or invalid, set to 0
     req->channel_ord = 0;
   }
 
-done:
-  cJSON_Delete(json_obj);
   return ret;
 }
 
-status_t mqtt_device_id_deserialize(const char* const obj, char* device_id) {
+status_t send_mam_req_deserialize(const char* const obj, ta_send_mam_req_t* req) {
   if (obj == NULL) {
     ta_log_error("%s\n", "SC_SERIALIZER_NULL");
     return SC_SERIALIZER_NULL;
   }
-  status_t ret = SC_OK;
-  cJSON* json_obj = cJSON_Parse(obj);
+  status_t ret = SC_SERIALIZER_OOM;
+  char arena_buf[DESERIALIZE_ARENA_SIZE];
+  arena_t arena;
+  char* buf = ta_json_copy_req(obj, &arena, arena_buf);
 
-  if (json_obj == NULL) {
-    ret = SC_SERIALIZER_JSON_PARSE;
-    ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
-    goto done;
+  if (buf != NULL) {
+    ret = send_mam_req_deserialize_insitu(buf, &arena, req);
   }
+  arena_reset(&arena);
+  return ret;
+}
 
-  ret = ta_json_get_string(json_obj, "device_id", device_id);
-  if (ret != SC_OK) {
-    ta_log_error("%d\n", ret);
-  }
+status_t mqtt_device_id_deserialize(const char* const obj, char* device_id, const size_t device_id_size) {
+  return ta_json_req_get_string(obj, "device_id", device_id, device_id_size);
+}
 
-done:
-  cJSON_Delete(json_obj);
-  return ret;
+status_t mqtt_tag_req_deserialize(const char* const obj, char* tag, const size_t tag_size) {
+  return ta_json_req_get_string(obj, "tag", tag, tag_size);
+}
+
+status_t mqtt_transaction_hash_req_deserialize(const char* const obj, char* hash, const size_t hash_size) {
+  return ta_json_req_get_string(obj, "hash", hash, hash_size);
 }
 
-status_t mqtt_tag_req_deserialize(const char* const obj, char* tag) {
+status_t mqtt_txn_fields_req_deserialize(const char* const obj, uint32_t* const fields) {
   if (obj == NULL) {
     ta_log_error("%s\n", "SC_SERIALIZER_NULL");
     return SC_SERIALIZER_NULL;
   }
+  status_t ret = SC_SERIALIZER_OOM;
+  char arena_buf[DESERIALIZE_ARENA_SIZE];
+  arena_t arena;
+  json_token_t* json_obj = NULL;
+  char* buf = ta_json_copy_req(obj, &arena, arena_buf);
+
+  if (buf == NULL) {
+    goto done;
+  }
+  ret = ta_json_tokenize_req(buf, &arena, &json_obj);
+  if (ret != SC_OK) {
+    goto done;
+  }
+  ret = ta_json_token_to_txn_fields(json_obj, fields);
+
+done:
+  arena_reset(&arena);
+  return ret;
+}
+
+status_t mqtt_busy_res_serialize(const uint32_t retry_after, char** obj) {
   status_t ret = SC_OK;
-  cJSON* json_obj = cJSON_Parse(obj);
+  cJSON* json_root = cJSON_CreateObject();
+  if (json_root == NULL) {
+    ret = SC_SERIALIZER_JSON_CREATE;
+    ta_log_error("%s\n", "SC_SERIALIZER_JSON_CREATE");
+    goto done;
+  }
 
-  if (json_obj == NULL) {
+  cJSON_AddStringToObject(json_root, "message", "Service is busy, retry later");
+
+  cJSON_AddNumberToObject(json_root, "retry_after", retry_after);
+
+  *obj = cJSON_PrintUnformatted(json_root);
+  if (*obj == NULL) {
     ret = SC_SERIALIZER_JSON_PARSE;
     ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
     goto done;
   }
 
-  ret = ta_json_get_string(json_obj, "tag", tag);
-  if (ret != SC_OK) {
-    ta_log_error("%d\n", ret);
-  }
-
 done:
-  cJSON_Delete(json_obj);
+  cJSON_Delete(json_root);
   return ret;
 }
 
-status_t mqtt_transaction_hash_req_deserialize(const char* const obj, char* hash) {
-  if (obj == NULL) {
+status_t proxy_apis_command_req_deserialize(const char* const obj, char* const command) {
+  status_t ret = SC_OK;
+  if (obj == NULL || command == NULL) {
     ta_log_error("%s\n", "SC_SERIALIZER_NULL");
     return SC_SERIALIZER_NULL;
   }
-  status_t ret = SC_OK;
   cJSON* json_obj = cJSON_Parse(obj);
-
   if (json_obj == NULL) {
     ret = SC_SERIALIZER_JSON_PARSE;
     ta_log_error("%s\n", "SC_SERIALIZER_JSON_PARSE");
     goto done;
   }
 
-  ret = ta_json_get_string(json_obj, "hash", hash);
-  if (ret != SC_OK) {
-    ta_log_error("%d\n", ret);
+  cJSON const* json_value = cJSON_GetObjectItemCaseSensitive(json_obj, "command");
+  if (!cJSON_IsString(json_value) || json_value->valuestring == NULL ||
+      strlen(json_value->valuestring) > TA_PROXY_COMMAND_MAX_LEN) {
+    ret = SC_SERIALIZER_INVALID_REQ;
+    ta_log_error("%s\n", "SC_SERIALIZER_INVALID_REQ");
+    goto done;
   }
+  strcpy(command, json_value->valuestring);
 
 done:
   cJSON_Delete(json_obj);
@@ -11,10 +11,12 @@
 
 #include "accelerator/config.h"
 #include "cJSON.h"
+#include "cclient/request/requests.h"
 #include "cclient/response/responses.h"
 #include "common/trinary/tryte_ascii.h"
 #include "request/request.h"
 #include "response/response.h"
+#include "utils/arena.h"
 #include "utils/char_buffer.h"
 #include "utils/containers/hash/hash_array.h"
 #include "utils/fill_nines.h"
@@ -43,6 +45,94 @@ extern "C" {
 #define DEFAULT_MSG_LEN 58
 /** @} */
 
+/** @name Content types of responses */
+/** @{ */
+#define TA_CONTENT_TYPE_JSON "application/json"
+#define TA_CONTENT_TYPE_CBOR "application/cbor"
+/** @} */
+
+/** Encodings of transaction object responses */
+typedef enum {
+  TA_RESPONSE_FORMAT_JSON, /**< JSON with tryte strings */
+  TA_RESPONSE_FORMAT_CBOR, /**< CBOR with trits packed into byte strings, see ta_flex_trits_to_bytes() */
+} ta_response_format_t;
+
+/** Members of transaction objects, in the order they are serialized */
+typedef enum {
+  TA_TXN_FIELD_HASH = 1 << 0,
+  TA_TXN_FIELD_SIGNATURE_AND_MESSAGE_FRAGMENT = 1 << 1,
+  TA_TXN_FIELD_ADDRESS = 1 << 2,
+  TA_TXN_FIELD_VALUE = 1 << 3,
+  TA_TXN_FIELD_OBSOLETE_TAG = 1 << 4,
+  TA_TXN_FIELD_TIMESTAMP = 1 << 5,
+  TA_TXN_FIELD_CURRENT_INDEX = 1 << 6,
+  TA_TXN_FIELD_LAST_INDEX = 1 << 7,
+  TA_TXN_FIELD_BUNDLE_HASH = 1 << 8,
+  TA_TXN_FIELD_TRUNK_TRANSACTION_HASH = 1 << 9,
+  TA_TXN_FIELD_BRANCH_TRANSACTION_HASH = 1 << 10,
+  TA_TXN_FIELD_TAG = 1 << 11,
+  TA_TXN_FIELD_ATTACHMENT_TIMESTAMP = 1 << 12,
+  TA_TXN_FIELD_ATTACHMENT_TIMESTAMP_LOWER_BOUND = 1 << 13,
+  TA_TXN_FIELD_ATTACHMENT_TIMESTAMP_UPPER_BOUND = 1 << 14,
+  TA_TXN_FIELD_NONCE = 1 << 15,
+} ta_txn_field_t;
+
+/** All the members of transaction objects */
+#define TA_TXN_FIELDS_ALL 0xFFFF
+
+/** Options of the transaction object serializers */
+typedef struct ta_txn_serialize_opt_s {
+  ta_response_format_t format; /**< Encoding of the response */
+  uint32_t fields;             /**< Mask of ta_txn_field_t to serialize, 0 for all of them */
+} ta_txn_serialize_opt_t;
+
+/**
+ * @brief Parse a comma separated list of transaction object members, like `hash,address,value`
+ *
+ * @param[in] list Member names as in the serialized objects, NULL or empty for all of them
+ * @param[out] fields Mask of ta_txn_field_t, 0 for all of them
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ on unknown member names
+ */
+status_t ta_txn_fields_parse(char const* const list, uint32_t* const fields);
+
+/**
+ * @brief Parse the `limit`, `cursor` and `since` parameters of a paged request
+ *
+ * @param[in] limit Maximum number of items, NULL or empty for TA_PAGE_DEFAULT_LIMIT. Larger limits than
+ *                  TA_PAGE_MAX_LIMIT are lowered to it.
+ * @param[in] cursor `cursor` of the previous page, NULL or empty for the first page
+ * @param[in] since Unix time in seconds, NULL or empty for all the items
+ * @param[out] page The page
+ * @param[out] paged Whether any of the parameters is given, otherwise the request is not paged
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ if a parameter is not a number, or `limit` is 0
+ */
+status_t ta_page_req_parse(char const* const limit, char const* const cursor, char const* const since,
+                           ta_page_req_t* const page, bool* const paged);
+
+/**
+ * @brief Pick the response format from the value of an `Accept` header
+ *
+ * @param[in] accept Value of the header, may be NULL
+ *
+ * @return TA_RESPONSE_FORMAT_CBOR if `application/cbor` is accepted, otherwise TA_RESPONSE_FORMAT_JSON
+ */
+ta_response_format_t ta_response_format_from_accept(char const* const accept);
+
+/**
+ * @brief Content type of a response format
+ *
+ * @param[in] format The response format
+ *
+ * @return MIME type string
+ */
+char const* ta_response_format_content_type(const ta_response_format_t format);
+
 /**
  * Initialize logger
  */
@@ -73,6 +163,21 @@ int serializer_logger_release();
 status_t ta_get_info_serialize(char** obj, ta_config_t* const info, iota_config_t* const tangle,
                                ta_cache_t* const cache, iota_client_service_t* const service);
 
+/**
+ * @brief Serialze a transaction into a cJSON object
+ *
+ * The hot response paths use the streaming writer instead, which emits the same fields in the same order.
+ *
+ * @param[in] txn Transaction object
+ * @param[in] fields Mask of ta_txn_field_t to add, 0 for all of them
+ * @param[out] txn_json cJSON object to add the fields to
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t iota_transaction_to_json_object(iota_transaction_t const* const txn, const uint32_t fields, cJSON** txn_json);
+
 /**
  * @brief Serialze type of ta_generate_address_res_t to JSON string
  *
@@ -109,6 +214,21 @@ status_t ta_get_tips_res_serialize(const get_tips_res_t* const res, char** obj);
  */
 status_t ta_send_transfer_req_deserialize(const char* const obj, ta_send_transfer_req_t* req);
 
+/**
+ * @brief Deserialze JSON string to type of ta_send_transfer_req_t in place
+ *
+ * Same as ta_send_transfer_req_deserialize(), but tokenizes the body in place instead of building a cJSON tree.
+ *
+ * @param[in,out] obj Input values in JSON, modified by the tokenizer
+ * @param[in] arena Arena for the tokens, which can be released once this returns
+ * @param[out] req Request data in type of ta_send_transfer_req_t
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_send_transfer_req_deserialize_insitu(char* const obj, arena_t* const arena, ta_send_transfer_req_t* req);
+
 /**
  * @brief Serialze the response of api_send_transfer()
  *
@@ -134,6 +254,19 @@ status_t ta_send_transfer_res_serialize(transaction_array_t* res, char** obj);
  */
 status_t ta_send_trytes_req_deserialize(const char* const obj, hash8019_array_p out_trytes);
 
+/**
+ * @brief Deserialze JSON string to hash8019_array_p in place
+ *
+ * @param[in,out] obj Input values in JSON, modified by the tokenizer
+ * @param[in] arena Arena for the tokens
+ * @param[out] out_trytes trytes arrary in the request data in type of hash8019_array_p
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_send_trytes_req_deserialize_insitu(char* const obj, arena_t* const arena, hash8019_array_p out_trytes);
+
 /**
  * @brief Serialze hash8019_array_p to JSON string
  *
@@ -161,6 +294,9 @@ status_t ta_find_transaction_object_single_res_serialize(transaction_array_t* re
 /**
  * @brief Deserialze type of ta_find_transaction_objects_req_t from JSON string
  *
+ * Besides `hashes`, the request may have `fields` to project the objects on, either a comma separated string or an
+ * array of member names.
+ *
  * @param[in] obj List of transaction hashes
  * @param[out] res Response data in type of ta_find_transaction_objects_req_t
  *
@@ -171,6 +307,74 @@ status_t ta_find_transaction_object_single_res_serialize(transaction_array_t* re
 status_t ta_find_transaction_objects_req_deserialize(const char* const obj,
                                                      ta_find_transaction_objects_req_t* const req);
 
+/**
+ * @brief Deserialze type of ta_find_transaction_objects_req_t from JSON string in place
+ *
+ * @param[in,out] obj List of transaction hashes, modified by the tokenizer
+ * @param[in] arena Arena for the tokens
+ * @param[out] req Request data in type of ta_find_transaction_objects_req_t
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_find_transaction_objects_req_deserialize_insitu(char* const obj, arena_t* const arena,
+                                                            ta_find_transaction_objects_req_t* const req);
+
+/** Upper bound of the number of tags, addresses, bundles and approvees of a query */
+#define TA_FIND_TXN_MAX_TERMS 1000
+
+/**
+ * @brief Deserialize a query of several tags, addresses, bundles and approvees in place
+ *
+ * The query is `{"tags":[...],"addresses":[...],"bundles":[...],"approvees":[...]}` with any of the members, like the
+ * `findTransactions` command of IRI. Tags may be shorter than 27 trytes, and are padded with '9'.
+ *
+ * @param[in,out] obj Query in JSON, modified by the tokenizer
+ * @param[in] arena Arena for the tokens
+ * @param[out] req Request with all the members of the query
+ * @param[out] fields Members of the transaction objects to respond with, as in `ta_txn_fields_parse()`. May be NULL
+ *                    when the query is only for hashes.
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ on an empty query, invalid trytes or more than TA_FIND_TXN_MAX_TERMS members
+ * - non-zero on other errors
+ */
+status_t ta_find_transactions_req_deserialize_insitu(char* const obj, arena_t* const arena,
+                                                     find_transactions_req_t* const req, uint32_t* const fields);
+
+/**
+ * @brief Deserialize a batch request `{"requests":[{"command":"...", ...}, ...]}` in place
+ *
+ * @param[in,out] obj Batch request in JSON, modified by the tokenizer
+ * @param[in] arena Arena for the tokens and the hashes of the sub-requests
+ * @param[out] req Sub-requests, which point into `obj`
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ on unknown commands, missing arguments or more than TA_BATCH_MAX_REQUESTS sub-requests
+ * - non-zero on other errors
+ */
+status_t ta_batch_req_deserialize_insitu(char* const obj, arena_t* const arena, ta_batch_req_t* const req);
+
+/**
+ * @brief Serialize the results of a batch, as `{"results":[...]}` in the order of the sub-requests
+ *
+ * A failed sub-request takes `{"error":<status code>}` in place of its result.
+ *
+ * @param[in] results JSON results of the sub-requests
+ * @param[in] rets Status of the sub-requests
+ * @param[in] num Number of sub-requests
+ * @param[out] obj Results in JSON
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_batch_res_serialize(char* const* const results, status_t const* const rets, const size_t num,
+                                char** obj);
+
 /**
  * @brief Serialze type of ta_find_transaction_objects_res_t to JSON string
  *
@@ -183,6 +387,90 @@ status_t ta_find_transaction_objects_req_deserialize(const char* const obj,
  */
 status_t ta_find_transaction_objects_res_serialize(const transaction_array_t* const res, char** obj);
 
+/**
+ * @brief Serialize an array of transaction objects in the requested format
+ *
+ * Both formats carry the same members in the same order. CBOR holds a definite length array of maps, where trinary
+ * members are byte strings of packed trits and numbers are integers.
+ *
+ * @param[in] res Transaction objects
+ * @param[in] opt Serialization options, NULL for JSON
+ * @param[out] obj Serialized transaction objects, NUL terminated in JSON but not in CBOR
+ * @param[out] obj_len Length of `obj`, may be NULL for JSON
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_transaction_array_serialize(const transaction_array_t* const res, ta_txn_serialize_opt_t const* const opt,
+                                        char** obj, size_t* const obj_len);
+
+/**
+ * @brief Serialize a page of transaction hashes, as `{"hashes":[...],"cursor":"..."}`
+ *
+ * @param[in] hashes Transaction hashes of the page, may be empty
+ * @param[in] cursor Cursor of the next page
+ * @param[out] obj Page in JSON
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_hash_page_res_serialize(hash243_vector_t const* const hashes, const size_t cursor, char** obj);
+
+/**
+ * @brief Serialize a page of transaction objects in the requested format, as `{"transactions":[...],"cursor":"..."}`
+ *
+ * @param[in] res Transaction objects of the page, may be empty
+ * @param[in] opt Serialization options, NULL for JSON
+ * @param[in] cursor Cursor of the next page
+ * @param[out] obj Serialized page, NUL terminated in JSON but not in CBOR
+ * @param[out] obj_len Length of `obj`, may be NULL for JSON
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_transaction_page_res_serialize(const transaction_array_t* const res,
+                                           ta_txn_serialize_opt_t const* const opt, const size_t cursor, char** obj,
+                                           size_t* const obj_len);
+
+/**
+ * @brief Serialize a page of a JSON array of transaction objects
+ *
+ * The pages of an array are serialized one at a time and sent in order, so the whole array is never held at once. The
+ * first page opens the array, the last one closes it, and the others start with the separator from the previous page.
+ * The concatenated pages are the same as `ta_transaction_array_serialize()` of the whole array in JSON.
+ *
+ * @param[in] page Transaction objects of the page, may be empty
+ * @param[in] fields Members of the transaction objects as a mask of ta_txn_field_t, 0 for all of them
+ * @param[in] first Whether the page is the first of the array
+ * @param[in] last Whether the page is the last of the array
+ * @param[out] obj NUL terminated JSON fragment
+ * @param[out] obj_len Length of `obj`
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_transaction_page_serialize(const transaction_array_t* const page, const uint32_t fields, const bool first,
+                                       const bool last, char** obj, size_t* const obj_len);
+
+/**
+ * @brief Serialize the first transaction object of an array in the requested format
+ *
+ * @param[in] res Transaction objects, only the first one is taken
+ * @param[in] opt Serialization options, NULL for JSON
+ * @param[out] obj Serialized transaction object, NUL terminated in JSON but not in CBOR
+ * @param[out] obj_len Length of `obj`, may be NULL for JSON
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t ta_transaction_object_serialize(const transaction_array_t* const res, ta_txn_serialize_opt_t const* const opt,
+                                         char** obj, size_t* const obj_len);
+
 /**
  * @brief Serialze type of ta_find_transactions_by_tag_res_t to JSON string
  *
@@ -219,6 +507,19 @@ status_t receive_mam_message_res_serialize(char* const message, char** obj);
  */
 status_t send_mam_req_deserialize(const char* const obj, ta_send_mam_req_t* req);
 
+/**
+ * @brief Deserialze JSON string to type of ta_send_mam_req_t in place
+ *
+ * @param[in,out] obj Input values in JSON, modified by the tokenizer
+ * @param[in] arena Arena for the tokens
+ * @param[out] req Request data in type of ta_send_mam_req_t
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t send_mam_req_deserialize_insitu(char* const obj, arena_t* const arena, ta_send_mam_req_t* req);
+
 /**
  * @brief Deserialze JSON string to type of ta_send_mam_res_t
  *
@@ -248,36 +549,81 @@ status_t send_mam_res_serialize(const ta_send_mam_res_t* const res, char** obj);
  *
  * @param[in] obj Input request in JSON with device ID
  * @param[out] device_id Device ID in string
+ * @param[in] device_id_size Size of the `device_id` buffer, including the terminating NUL
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
-status_t mqtt_device_id_deserialize(const char* const obj, char* device_id);
+status_t mqtt_device_id_deserialize(const char* const obj, char* device_id, const size_t device_id_size);
 
 /**
  * @brief Deserialze tag in string from MQTT JSON request.
  *
  * @param[in] obj Input request in JSON with tag field
  * @param[out] tag Tag in string
+ * @param[in] tag_size Size of the `tag` buffer, including the terminating NUL
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
-status_t mqtt_tag_req_deserialize(const char* const obj, char* tag);
+status_t mqtt_tag_req_deserialize(const char* const obj, char* tag, const size_t tag_size);
 
 /**
  * @brief Deserialze transaction hash in string from MQTT JSON request.
  *
  * @param[in] obj Input request in JSON with hash field
  * @param[out] hash Transaction hash in string
+ * @param[in] hash_size Size of the `hash` buffer, including the terminating NUL
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mqtt_transaction_hash_req_deserialize(const char* const obj, char* hash, const size_t hash_size);
+
+/**
+ * @brief Deserialze the optional member projection from MQTT JSON request.
+ *
+ * The `fields` member is either a comma separated string or an array of member names.
+ *
+ * @param[in] obj Input request in JSON
+ * @param[out] fields Mask of ta_txn_field_t, 0 for all the members when the request has no `fields`
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
-status_t mqtt_transaction_hash_req_deserialize(const char* const obj, char* hash);
+status_t mqtt_txn_fields_req_deserialize(const char* const obj, uint32_t* const fields);
+
+/**
+ * @brief Serialze the MQTT reply of a request rejected by PoW admission control.
+ *
+ * @param[in] retry_after Seconds the device should wait before retrying
+ * @param[out] obj Error message and retry delay in JSON
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t mqtt_busy_res_serialize(const uint32_t retry_after, char** obj);
+
+/** Longest `command` of an IRI API request, without the NUL terminator */
+#define TA_PROXY_COMMAND_MAX_LEN 31
+
+/**
+ * @brief Deserialze the `command` of an IRI API request.
+ *
+ * @param[in] obj IRI API request in JSON
+ * @param[out] command Command in string, with room for TA_PROXY_COMMAND_MAX_LEN + 1 bytes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_SERIALIZER_INVALID_REQ without a string `command` of at most TA_PROXY_COMMAND_MAX_LEN characters
+ * - non-zero on other errors
+ */
+status_t proxy_apis_command_req_deserialize(const char* const obj, char* const command);
 
 #ifdef __cplusplus
 }
@@ -633,8 +633,8 @@ exit:
   return ret;
 }
 
-static status_t push_columns_into_queue(CassSession* session, CassStatement* statement,
-                                        hash243_queue_t* const res_queue, const char* column_name) {
+static status_t push_columns_into_vector(CassSession* session, CassStatement* statement,
+                                         hash243_vector_t* const res_hashes, const char* column_name) {
   status_t ret = SC_OK;
   CassFuture* future = NULL;
   const CassResult* result;
@@ -661,7 +661,7 @@ static status_t push_columns_into_queue(CassSession* session, CassStatement* sta
       ret = SC_STORAGE_CASSANDRA_QUREY_FAIL;
       goto end_iterate;
     }
-    if (hash243_queue_push(res_queue, (flex_trit_t const* const)buf) != RC_OK) {
+    if (hash243_vector_push(res_hashes, (flex_trit_t const* const)buf) != SC_OK) {
       ta_log_error("%s\n", "SC_STORAGE_OOM");
       ret = SC_STORAGE_OOM;
       goto end_iterate;
@@ -710,7 +710,7 @@ status_t select_transactions_with_bundle(CassSession* session, const select_meth
   return ret;
 }
 
-static status_t get_column_from_bundleTable(CassSession* session, hash243_queue_t* res_queue,
+static status_t get_column_from_bundleTable(CassSession* session, hash243_vector_t* res_hashes,
                                             const select_method_t select_method, const select_where_t* select_where,
                                             const char* column_name) {
   status_t ret = SC_OK;
@@ -726,12 +726,12 @@ static status_t get_column_from_bundleTable(CassSession* session, hash243_queue_
   }
 
   statement = ret_select_from_bundleTable_statement(select_prepared, select_method, select_where);
-  ret = push_columns_into_queue(session, statement, res_queue, column_name);
+  ret = push_columns_into_vector(session, statement, res_hashes, column_name);
 
   cass_prepared_free(select_prepared);
   return ret;
 }
-status_t get_column_from_edgeTable(CassSession* session, hash243_queue_t* res_queue, cass_byte_t* edge,
+status_t get_column_from_edgeTable(CassSession* session, hash243_vector_t* res_hashes, cass_byte_t* edge,
                                    const char* column_name) {
   status_t ret = SC_OK;
   static const char* query = "SELECT * FROM edgeTable WHERE edge = ?";
@@ -745,51 +745,53 @@ status_t get_column_from_edgeTable(CassSession* session, hash243_queue_t* res_qu
 
   statement = cass_prepared_bind(select_prepared);
   cass_statement_bind_bytes_by_name(statement, "edge", edge, FLEX_TRIT_SIZE_243);
-  ret = push_columns_into_queue(session, statement, res_queue, column_name);
+  ret = push_columns_into_vector(session, statement, res_hashes, column_name);
 
   cass_prepared_free(select_prepared);
   return ret;
 }
 
-status_t get_transactions(CassSession* session, hash243_queue_t* res_queue, hash243_queue_t bundles,
+status_t get_transactions(CassSession* session, hash243_vector_t* res_hashes, hash243_queue_t bundles,
                           hash243_queue_t addresses, hash243_queue_t approves) {
   status_t ret = SC_OK;
   hash243_queue_t itr243 = NULL;
-  hash243_queue_t itr243_2 = NULL;
+  flex_trit_t const* bundle_hash = NULL;
+  hash243_vector_t bundle_hashes;
   select_where_t select_where;
 
+  hash243_vector_init(&bundle_hashes, NULL);
+
   CDL_FOREACH(bundles, itr243) {
     select_where.bundle = (cass_byte_t*)itr243->hash;
-    ret = get_column_from_bundleTable(session, res_queue, WITH_BUNDLE, &select_where, "hash");
+    ret = get_column_from_bundleTable(session, res_hashes, WITH_BUNDLE, &select_where, "hash");
     if (ret != SC_OK) {
       goto exit;
     }
   }
   CDL_FOREACH(addresses, itr243) {
-    hash243_queue_t bundle_hashes = NULL;
+    // The vector keeps its buffer from one address to the next
+    bundle_hashes.count = 0;
     ret = get_column_from_edgeTable(session, &bundle_hashes, (cass_byte_t*)itr243->hash, "bundle");
     if (ret != SC_OK) {
-      hash243_queue_free(&bundle_hashes);
       goto exit;
     }
     select_where.address = (cass_byte_t*)itr243->hash;
-    CDL_FOREACH(bundle_hashes, itr243_2) {
-      select_where.bundle = (cass_byte_t*)itr243_2->hash;
-      ret = get_column_from_bundleTable(session, res_queue, WITH_BUNDLE_AND_ADDRESS, &select_where, "hash");
+    HASH243_VECTOR_FOREACH(&bundle_hashes, bundle_hash) {
+      select_where.bundle = (cass_byte_t*)bundle_hash;
+      ret = get_column_from_bundleTable(session, res_hashes, WITH_BUNDLE_AND_ADDRESS, &select_where, "hash");
       if (ret != SC_OK) {
-        hash243_queue_free(&bundle_hashes);
         goto exit;
       }
     }
-    hash243_queue_free(&bundle_hashes);
   }
   CDL_FOREACH(approves, itr243) {
-    ret = get_column_from_edgeTable(session, res_queue, (cass_byte_t*)itr243->hash, "hash");
+    ret = get_column_from_edgeTable(session, res_hashes, (cass_byte_t*)itr243->hash, "hash");
     if (ret != SC_OK) {
       goto exit;
     }
   }
 
 exit:
+  hash243_vector_free(&bundle_hashes);
   return ret;
 }
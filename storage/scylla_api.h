@@ -15,6 +15,7 @@ extern "C" {
 #include "cassandra.h"
 #include "common/model/transaction.h"
 #include "utils/containers/hash/hash243_queue.h"
+#include "utils/hash243_vector.h"
 #include "utils/logger_helper.h"
 
 typedef struct scylla_iota_transaction_s scylla_iota_transaction_t;
@@ -283,13 +284,13 @@ status_t insert_transaction_into_edgeTable(CassSession* session, scylla_iota_tra
  * @param[in] session Scylla cluster session
  * @param[in] edge primary key for select bundles
  * @param[in] column_name the column we want to select
- * @param[out] res_queue response transactions queue
+ * @param[out] res_hashes response hashes, appended to the vector
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
-status_t get_column_from_edgeTable(CassSession* session, hash243_queue_t* res_queue, cass_byte_t* edge,
+status_t get_column_from_edgeTable(CassSession* session, hash243_vector_t* res_hashes, cass_byte_t* edge,
                                    const char* column_name);
 
 /**
@@ -299,13 +300,13 @@ status_t get_column_from_edgeTable(CassSession* session, hash243_queue_t* res_qu
  * @param[in] bundles query bundles queue
  * @param[in] bundles query addresses queue
  * @param[in] bundles query approves queue
- * @param[out] res_queue response transactions queue
+ * @param[out] res_hashes response transaction hashes, appended to the vector
  *
  * @return
  * - SC_OK on success
  * - non-zero on error
  */
-status_t get_transactions(CassSession* session, hash243_queue_t* res_queue, hash243_queue_t bundles,
+status_t get_transactions(CassSession* session, hash243_vector_t* res_hashes, hash243_queue_t bundles,
                           hash243_queue_t addresses, hash243_queue_t approves);
 
 #ifdef __cplusplus
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+/**
+ * Request parsing benchmark
+ *
+ * Compare building a cJSON tree of a request body, which the deserializers did before, with tokenizing the body in
+ * place into an arena. Heap allocations of cJSON are counted through `cJSON_InitHooks()`, those of the tokenizer are
+ * the heap blocks added to the arena behind its stack buffer.
+ *
+ * Usage:
+ *   bazel run //tests:bench_deserializer -- [-n hashes] [-i iterations]
+ */
+
+#include <getopt.h>
+#include <time.h>
+#include "serializer/json_tokenizer.h"
+#include "serializer/serializer.h"
+#include "test_define.h"
+
+#define BENCH_HASHES 100
+#define BENCH_ITERATIONS 1000
+/** Same as the stack buffer of the deserializers */
+#define BENCH_ARENA_SIZE 4096
+
+static size_t cjson_allocs = 0;
+
+static void* counting_malloc(size_t size) {
+  cjson_allocs++;
+  return malloc(size);
+}
+
+static double diff_time(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1000000000.0;
+}
+
+static void bench_body(char const* const name, char const* const body, const int iterations) {
+  struct timespec start, end;
+  size_t len = strlen(body), arena_blocks = 0;
+  char arena_buf[BENCH_ARENA_SIZE];
+  arena_t arena;
+  json_token_t* root = NULL;
+
+  cjson_allocs = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    cJSON_Delete(cJSON_Parse(body));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double cjson_time = diff_time(start, end) / iterations;
+
+  arena_init(&arena, arena_buf, sizeof(arena_buf));
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    // The body is copied first, as the compatibility wrappers do
+    char* buf = arena_strndup(&arena, body, len);
+    if (buf == NULL || json_tokenize(buf, &arena, &root) != SC_OK) {
+      fprintf(stderr, "Tokenizing %s failed\n", name);
+      exit(EXIT_FAILURE);
+    }
+    arena_reset(&arena);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  arena_blocks = arena.num_blocks;
+  double tokenizer_time = diff_time(start, end) / iterations;
+
+  printf("%s (%zu bytes)\n", name, len);
+  printf("  cJSON tree: %lf us, %.1f allocations\n", cjson_time * 1000000, (double)cjson_allocs / iterations);
+  printf("  In-situ tokenizer: %lf us, %.1f allocations\n", tokenizer_time * 1000000,
+         (double)arena_blocks / iterations);
+}
+
+/** Build `{"<key>":["<item>",...]}` with `num` items */
+static char* json_string_array(char const* const key, char const* const item, const int num) {
+  size_t item_len = strlen(item);
+  char* json = (char*)malloc(strlen(key) + num * (item_len + 3) + 8);
+  char* p = json + sprintf(json, "{\"%s\":[", key);
+  for (int i = 0; i < num; i++) {
+    p += sprintf(p, "%s\"%s\"", i ? "," : "", item);
+  }
+  strcpy(p, "]}");
+  return json;
+}
+
+int main(int argc, char** argv) {
+  int hash_num = BENCH_HASHES, iterations = BENCH_ITERATIONS, opt_char;
+  cJSON_Hooks hooks = {.malloc_fn = counting_malloc, .free_fn = free};
+  char message[NUM_TRYTES_SIGNATURE + 1];
+
+  while ((opt_char = getopt(argc, argv, "n:i:")) != -1) {
+    switch (opt_char) {
+      case 'n':
+        hash_num = atoi(optarg);
+        break;
+      case 'i':
+        iterations = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-n hashes] [-i iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  cJSON_InitHooks(&hooks);
+
+  memcpy(message, TRYTES_2673_1, NUM_TRYTES_SIGNATURE);
+  message[NUM_TRYTES_SIGNATURE] = '\0';
+  char* send_transfer = (char*)malloc(NUM_TRYTES_SIGNATURE + NUM_TRYTES_HASH + 128);
+  sprintf(send_transfer,
+          "{\"value\":0,\"message_format\":\"trytes\",\"message\":\"%s\",\"tag\":\"%s\",\"address\":\"%s\"}", message,
+          TAG_MSG, TRYTES_81_1);
+  char* find_objects = json_string_array("hashes", TRYTES_81_1, hash_num);
+  char* send_trytes = json_string_array("trytes", TRYTES_2673_1, hash_num);
+
+  printf("Iterations: %d\n", iterations);
+  bench_body("send_transfer request", send_transfer, iterations);
+  bench_body("find_transaction_objects request", find_objects, iterations);
+  bench_body("send_trytes request", send_trytes, iterations);
+
+  free(send_transfer);
+  free(find_objects);
+  free(send_trytes);
+  return 0;
+}
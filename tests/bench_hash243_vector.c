@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+/**
+ * Hash container benchmark
+ *
+ * Compare `hash243_queue_t`, which the requests and responses held hashes in, with `hash243_vector_t` for 1k, 10k
+ * and 100k hashes. Three costs are measured: filling the container, iterating over it, and serializing it as the
+ * response of `find_transactions_by_tag`. The queue is serialized through a cJSON tree, as that response was before.
+ *
+ * Usage:
+ *   bazel run //tests:bench_hash243_vector -- [-i iterations]
+ */
+
+#include <getopt.h>
+#include <time.h>
+#include "serializer/serializer.h"
+#include "test_define.h"
+#include "utils/trinary_kernels.h"
+
+#define BENCH_ITERATIONS 20
+
+static double diff_time(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1000000000.0;
+}
+
+/** The response serialization before the hash vector */
+static char* serialize_queue(hash243_queue_t queue) {
+  hash243_queue_entry_t* q_iter = NULL;
+  tryte_t trytes[NUM_TRYTES_HASH + 1];
+  cJSON* json_root = cJSON_CreateArray();
+
+  trytes[NUM_TRYTES_HASH] = '\0';
+  CDL_FOREACH(queue, q_iter) {
+    ta_flex_trits_to_trytes(trytes, NUM_TRYTES_HASH, q_iter->hash, NUM_TRITS_HASH, NUM_TRITS_HASH);
+    cJSON_AddItemToArray(json_root, cJSON_CreateString((const char*)trytes));
+  }
+  char* json = cJSON_PrintUnformatted(json_root);
+  cJSON_Delete(json_root);
+  return json;
+}
+
+/** Sum the first trit of every hash, so the iteration is not optimized out */
+static long checksum_queue(hash243_queue_t queue) {
+  hash243_queue_entry_t* q_iter = NULL;
+  long sum = 0;
+  CDL_FOREACH(queue, q_iter) { sum += q_iter->hash[0]; }
+  return sum;
+}
+
+static long checksum_vector(hash243_vector_t const* const vec) {
+  flex_trit_t const* hash = NULL;
+  long sum = 0;
+  HASH243_VECTOR_FOREACH(vec, hash) { sum += hash[0]; }
+  return sum;
+}
+
+static void bench_size(flex_trit_t const* const hash, const int hash_num, const int iterations) {
+  struct timespec start, end;
+  double queue_fill = 0, queue_iter = 0, queue_json = 0, vector_fill = 0, vector_iter = 0, vector_json = 0;
+  long queue_sum = 0, vector_sum = 0;
+  char *queue_out = NULL, *vector_out = NULL;
+
+  for (int i = 0; i < iterations; i++) {
+    hash243_queue_t queue = NULL;
+    ta_find_transactions_by_tag_res_t res;
+    hash243_vector_init(&res.hashes, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int j = 0; j < hash_num; j++) {
+      hash243_queue_push(&queue, hash);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    queue_fill += diff_time(start, end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int j = 0; j < hash_num; j++) {
+      hash243_vector_push(&res.hashes, hash);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    vector_fill += diff_time(start, end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    queue_sum = checksum_queue(queue);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    queue_iter += diff_time(start, end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    vector_sum = checksum_vector(&res.hashes);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    vector_iter += diff_time(start, end);
+
+    free(queue_out);
+    free(vector_out);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    queue_out = serialize_queue(queue);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    queue_json += diff_time(start, end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (ta_find_transactions_by_tag_res_serialize(&res, &vector_out) != SC_OK) {
+      fprintf(stderr, "Serializing %d hashes failed\n", hash_num);
+      exit(EXIT_FAILURE);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    vector_json += diff_time(start, end);
+
+    hash243_queue_free(&queue);
+    hash243_vector_free(&res.hashes);
+  }
+
+  if (queue_sum != vector_sum || strcmp(queue_out, vector_out)) {
+    fprintf(stderr, "Outputs of the queue and the vector differ\n");
+    exit(EXIT_FAILURE);
+  }
+  printf("%d hashes, output: %zu bytes\n", hash_num, strlen(vector_out));
+  printf("  Fill: queue %lf ms, vector %lf ms\n", queue_fill * 1000 / iterations, vector_fill * 1000 / iterations);
+  printf("  Iterate: queue %lf ms, vector %lf ms\n", queue_iter * 1000 / iterations, vector_iter * 1000 / iterations);
+  printf("  Serialize: queue %lf ms, vector %lf ms\n", queue_json * 1000 / iterations,
+         vector_json * 1000 / iterations);
+  free(queue_out);
+  free(vector_out);
+}
+
+int main(int argc, char** argv) {
+  int iterations = BENCH_ITERATIONS, opt_char;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  while ((opt_char = getopt(argc, argv, "i:")) != -1) {
+    switch (opt_char) {
+      case 'i':
+        iterations = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-i iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+
+  if (logger_helper_init(LOGGER_ERR) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+
+  flex_trits_from_trytes(hash, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  for (int hash_num = 1000; hash_num <= 100000; hash_num *= 10) {
+    bench_size(hash, hash_num, iterations);
+  }
+
+  logger_helper_destroy();
+  return 0;
+}
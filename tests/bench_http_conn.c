@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+/**
+ * HTTP connection scaling benchmark
+ *
+ * Open many concurrent keep-alive connections to a running tangle-accelerator, then send one request on every
+ * connection per round, leaving the connections idle between rounds like IoT clients reporting periodically. The
+ * connect time, the throughput and latency of each round, and the connections the server dropped are reported.
+ *
+ * The default path is answered by the HTTP front-end itself, so the front-end is measured rather than IRI or the
+ * cache. Compare the two HTTP modes by running tangle-accelerator with and without `--http_thread_pool T`, with
+ * `--http_conn_limit` above the number of connections, and with enough file descriptors for both processes:
+ *
+ *   ulimit -n 20000
+ *   bazel run //accelerator -- --http_thread_pool T --http_conn_limit 12000
+ *   bazel run //tests:bench_http_conn -- -c 10000
+ *
+ * Usage:
+ *   bazel run //tests:bench_http_conn -- [-H host] [-p port] [-c connections] [-r rounds] [-i idle_seconds]
+ *                                        [-u path] [-t timeout_seconds]
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_HOST "127.0.0.1"
+#define BENCH_PORT 8000
+#define BENCH_CONNECTIONS 10000
+#define BENCH_ROUNDS 5
+#define BENCH_IDLE 1
+#define BENCH_PATH "/"
+#define BENCH_TIMEOUT 30
+#define BENCH_BUF_SIZE 2048
+#define BENCH_EVENTS 1024
+
+typedef struct bench_opt_s {
+  char const* host;
+  int port;
+  int connections;
+  int rounds;
+  int idle;
+  char const* path;
+  int timeout;
+} bench_opt_t;
+
+typedef struct bench_conn_s {
+  int fd;                    /**< -1 once the connection failed or was closed */
+  bool pending;              /**< Waiting for the connection or a response */
+  struct timespec sent;      /**< Time the request was sent */
+  size_t len;                /**< Bytes of the response received */
+  char buf[BENCH_BUF_SIZE];  /**< The response, NUL terminated */
+} bench_conn_t;
+
+static double diff_time(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1000000000.0;
+}
+
+static int cmp_double(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+static void conn_close(int epfd, bench_conn_t* const conn) {
+  epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+  close(conn->fd);
+  conn->fd = -1;
+  conn->pending = false;
+}
+
+/** Whether the buffer holds a whole response, i.e. the header and a body of Content-Length bytes */
+static bool response_complete(bench_conn_t const* const conn) {
+  char const* end = strstr(conn->buf, "\r\n\r\n");
+  if (end == NULL) {
+    return false;
+  }
+  size_t header_len = end - conn->buf + 4, body_len = 0;
+  char const* field = strstr(conn->buf, "Content-Length:");
+  if (field && field < end) {
+    body_len = strtoul(field + strlen("Content-Length:"), NULL, 10);
+  }
+  return conn->len >= header_len + body_len;
+}
+
+/**
+ * Wait for the pending connections, handling connection completions when `connecting` and responses otherwise.
+ * Latencies of the responses are appended to `latencies`. Returns the number of connections still pending at the
+ * timeout.
+ */
+static int wait_pending(int epfd, int pending, const bool connecting, const int timeout, double* const latencies,
+                        int* const num_latencies) {
+  struct epoll_event events[BENCH_EVENTS];
+  struct timespec start, now;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (pending > 0) {
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (diff_time(start, now) > timeout) {
+      break;
+    }
+    int num_events = epoll_wait(epfd, events, BENCH_EVENTS, 100);
+    for (int e = 0; e < num_events; e++) {
+      bench_conn_t* conn = events[e].data.ptr;
+      if (!conn->pending) {
+        continue;
+      }
+
+      if (connecting) {
+        int err = 0;
+        socklen_t err_len = sizeof(err);
+        getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &err, &err_len);
+        if (err || (events[e].events & (EPOLLERR | EPOLLHUP))) {
+          conn_close(epfd, conn);
+        } else {
+          conn->pending = false;
+        }
+        pending--;
+        continue;
+      }
+
+      ssize_t ret = read(conn->fd, conn->buf + conn->len, BENCH_BUF_SIZE - 1 - conn->len);
+      if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        continue;
+      }
+      if (ret > 0) {
+        conn->len += ret;
+        conn->buf[conn->len] = '\0';
+      }
+      if (ret <= 0 || conn->len == BENCH_BUF_SIZE - 1) {
+        // Closed by the server, or a response larger than the benchmark expects
+        conn_close(epfd, conn);
+        pending--;
+      } else if (response_complete(conn)) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        latencies[(*num_latencies)++] = diff_time(conn->sent, now);
+        conn->pending = false;
+        pending--;
+      }
+    }
+  }
+  return pending;
+}
+
+static int open_connections(int epfd, bench_conn_t* const conns, bench_opt_t const* const opt) {
+  struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(opt->port)};
+  int pending = 0;
+
+  if (inet_pton(AF_INET, opt->host, &addr.sin_addr) != 1) {
+    fprintf(stderr, "Invalid IPv4 address %s\n", opt->host);
+    return -1;
+  }
+
+  for (int i = 0; i < opt->connections; i++) {
+    bench_conn_t* conn = &conns[i];
+    conn->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (conn->fd < 0) {
+      // Out of file descriptors, the benchmark goes on with the connections opened so far
+      fprintf(stderr, "Opening connection %d failed: %s\n", i, strerror(errno));
+      break;
+    }
+    if (connect(conn->fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+      close(conn->fd);
+      conn->fd = -1;
+      continue;
+    }
+    struct epoll_event event = {.events = EPOLLOUT, .data.ptr = conn};
+    epoll_ctl(epfd, EPOLL_CTL_ADD, conn->fd, &event);
+    conn->pending = true;
+    pending++;
+  }
+  return pending;
+}
+
+static void run(bench_opt_t const* const opt) {
+  struct timespec start, end;
+  char request[512];
+  int epfd = epoll_create1(0);
+  bench_conn_t* conns = calloc(opt->connections, sizeof(bench_conn_t));
+  double* latencies = malloc(opt->connections * sizeof(double));
+  int request_len = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\n\r\n",
+                             opt->path, opt->host);
+
+  if (epfd < 0 || conns == NULL || latencies == NULL) {
+    fprintf(stderr, "Initializing the benchmark failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (int i = 0; i < opt->connections; i++) {
+    conns[i].fd = -1;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int pending = open_connections(epfd, conns, opt);
+  if (pending < 0) {
+    exit(EXIT_FAILURE);
+  }
+  wait_pending(epfd, pending, true, opt->timeout, NULL, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  int num_open = 0;
+  for (int i = 0; i < opt->connections; i++) {
+    if (conns[i].pending) {
+      conn_close(epfd, &conns[i]);
+    }
+    num_open += conns[i].fd >= 0;
+  }
+  printf("%d/%d connections opened in %lf s\n", num_open, opt->connections, diff_time(start, end));
+
+  for (int round = 0; round < opt->rounds; round++) {
+    int num_latencies = 0, sent = 0;
+    pending = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < opt->connections; i++) {
+      bench_conn_t* conn = &conns[i];
+      if (conn->fd < 0) {
+        continue;
+      }
+      struct epoll_event event = {.events = EPOLLIN, .data.ptr = conn};
+      epoll_ctl(epfd, EPOLL_CTL_MOD, conn->fd, &event);
+      conn->len = 0;
+      clock_gettime(CLOCK_MONOTONIC, &conn->sent);
+      if (write(conn->fd, request, request_len) != request_len) {
+        conn_close(epfd, conn);
+        continue;
+      }
+      conn->pending = true;
+      pending++;
+      sent++;
+    }
+    int timed_out = wait_pending(epfd, pending, false, opt->timeout, latencies, &num_latencies);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    // Connections without response are not reused
+    num_open = 0;
+    for (int i = 0; i < opt->connections; i++) {
+      if (conns[i].pending) {
+        conn_close(epfd, &conns[i]);
+      }
+      num_open += conns[i].fd >= 0;
+    }
+
+    double elapsed = diff_time(start, end);
+    printf("Round %d: %d/%d responses, %d timed out, %d connections open\n", round + 1, num_latencies, sent,
+           timed_out, num_open);
+    if (num_latencies) {
+      qsort(latencies, num_latencies, sizeof(double), cmp_double);
+      printf("  %lf requests/s, latency p50 %lf ms, p99 %lf ms, max %lf ms\n", num_latencies / elapsed,
+             latencies[num_latencies / 2] * 1000, latencies[num_latencies * 99 / 100] * 1000,
+             latencies[num_latencies - 1] * 1000);
+    }
+    if (round + 1 < opt->rounds) {
+      sleep(opt->idle);
+    }
+  }
+
+  for (int i = 0; i < opt->connections; i++) {
+    if (conns[i].fd >= 0) {
+      close(conns[i].fd);
+    }
+  }
+  close(epfd);
+  free(conns);
+  free(latencies);
+}
+
+int main(int argc, char** argv) {
+  bench_opt_t opt = {.host = BENCH_HOST,
+                     .port = BENCH_PORT,
+                     .connections = BENCH_CONNECTIONS,
+                     .rounds = BENCH_ROUNDS,
+                     .idle = BENCH_IDLE,
+                     .path = BENCH_PATH,
+                     .timeout = BENCH_TIMEOUT};
+  int opt_char;
+
+  while ((opt_char = getopt(argc, argv, "H:p:c:r:i:u:t:")) != -1) {
+    switch (opt_char) {
+      case 'H':
+        opt.host = optarg;
+        break;
+      case 'p':
+        opt.port = atoi(optarg);
+        break;
+      case 'c':
+        opt.connections = atoi(optarg);
+        break;
+      case 'r':
+        opt.rounds = atoi(optarg);
+        break;
+      case 'i':
+        opt.idle = atoi(optarg);
+        break;
+      case 'u':
+        opt.path = optarg;
+        break;
+      case 't':
+        opt.timeout = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "Usage: %s [-H host] [-p port] [-c connections] [-r rounds] [-i idle_seconds] [-u path] "
+                "[-t timeout_seconds]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  if (opt.connections <= 0) {
+    fprintf(stderr, "The number of connections must be positive\n");
+    return EXIT_FAILURE;
+  }
+
+  // Every connection takes a file descriptor
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < (rlim_t)opt.connections + 16) {
+    limit.rlim_cur = limit.rlim_max < (rlim_t)opt.connections + 16 ? limit.rlim_max : (rlim_t)opt.connections + 16;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+
+  run(&opt);
+  return 0;
+}
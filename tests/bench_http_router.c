@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+/**
+ * HTTP route dispatch benchmark
+ *
+ * Compare the dispatch of the HTTP API before the route table, which compiled and ran the regular expression of each
+ * route in turn until one matched, with regular expressions compiled once and with `http_router_t`. Every URL of the
+ * API, plus an invalid one, is dispatched in each iteration.
+ *
+ * Usage:
+ *   bazel run //tests:bench_http_router -- [-i iterations]
+ */
+
+#include <getopt.h>
+#include <regex.h>
+#include <time.h>
+#include "accelerator/http_router.h"
+#include "test_define.h"
+
+#define BENCH_ITERATIONS 10000
+#define ROUTE_NUM 9
+
+// Regular expressions of the routes in the order they were tried
+static char const* const route_regex[ROUTE_NUM] = {
+    "/address", "/transaction/hash", "/transaction/object", "/tips/pair", "/tips",
+    "/transaction", "/mam/[A-Z9]{81}", "/mam", "/tryte",
+};
+
+static char const* const route_patterns[ROUTE_NUM] = {
+    "/address", "/transaction/hash", "/transaction/object", "/tips/pair", "/tips",
+    "/transaction", "/mam/{hash}", "/mam", "/tryte",
+};
+
+// URLs of the routes in the same order, and an invalid path
+static char const* const urls[ROUTE_NUM + 1] = {
+    "/address", "/transaction/hash", "/transaction/object", "/tips/pair", "/tips", "/transaction",
+    "/mam/" TRYTES_81_1, "/mam", "/tryte", "/invalid/path",
+};
+
+static double diff_time(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1000000000.0;
+}
+
+/** The dispatch before the route table */
+static int match_regcomp(char const* const url) {
+  for (int route = 0; route < ROUTE_NUM; route++) {
+    regex_t reg;
+    if (regcomp(&reg, route_regex[route], REG_EXTENDED | REG_NOSUB) != 0) {
+      return HTTP_ROUTE_NONE;
+    }
+    int ret = regexec(&reg, url, 0, NULL, 0);
+    regfree(&reg);
+    if (ret == 0) {
+      return route;
+    }
+  }
+  return HTTP_ROUTE_NONE;
+}
+
+static int match_precompiled(regex_t const* const regs, char const* const url) {
+  for (int route = 0; route < ROUTE_NUM; route++) {
+    if (regexec(&regs[route], url, 0, NULL, 0) == 0) {
+      return route;
+    }
+  }
+  return HTTP_ROUTE_NONE;
+}
+
+static int match_router(http_router_t const* const router, char const* const url) {
+  http_route_match_t match;
+  http_router_match(router, url, &match);
+  return match.route;
+}
+
+int main(int argc, char** argv) {
+  int iterations = BENCH_ITERATIONS, opt_char;
+  struct timespec start, end;
+  double regcomp_time = 0, precompiled_time = 0, router_time = 0;
+  long regcomp_sum = 0, precompiled_sum = 0, router_sum = 0;
+  regex_t regs[ROUTE_NUM];
+  http_router_t router;
+
+  while ((opt_char = getopt(argc, argv, "i:")) != -1) {
+    switch (opt_char) {
+      case 'i':
+        iterations = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-i iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+
+  if (http_router_init(&router) != SC_OK) {
+    return EXIT_FAILURE;
+  }
+  for (int route = 0; route < ROUTE_NUM; route++) {
+    if (regcomp(&regs[route], route_regex[route], REG_EXTENDED | REG_NOSUB) != 0 ||
+        http_router_add(&router, route_patterns[route], route) != SC_OK) {
+      fprintf(stderr, "Adding route %s failed\n", route_patterns[route]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The sums of the matched routes keep the loops from being optimized out, and are compared at the end
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    for (int u = 0; u <= ROUTE_NUM; u++) {
+      regcomp_sum += match_regcomp(urls[u]);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  regcomp_time = diff_time(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    for (int u = 0; u <= ROUTE_NUM; u++) {
+      precompiled_sum += match_precompiled(regs, urls[u]);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  precompiled_time = diff_time(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    for (int u = 0; u <= ROUTE_NUM; u++) {
+      router_sum += match_router(&router, urls[u]);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  router_time = diff_time(start, end);
+
+  if (regcomp_sum != router_sum || precompiled_sum != router_sum) {
+    fprintf(stderr, "Dispatched routes differ\n");
+    return EXIT_FAILURE;
+  }
+
+  long dispatches = (long)iterations * (ROUTE_NUM + 1);
+  printf("%ld dispatches\n", dispatches);
+  printf("  regcomp per request: %lf ns/dispatch\n", regcomp_time * 1000000000 / dispatches);
+  printf("  Precompiled regex: %lf ns/dispatch\n", precompiled_time * 1000000000 / dispatches);
+  printf("  Route table: %lf ns/dispatch\n", router_time * 1000000000 / dispatches);
+
+  for (int route = 0; route < ROUTE_NUM; route++) {
+    regfree(&regs[route]);
+  }
+  http_router_free(&router);
+  return 0;
+}
@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+/**
+ * IRI connection pool benchmark
+ *
+ * Two fake IRI nodes answer findTransactions after a fixed delay, standing for the time a real node spends on a
+ * request, and every few responses after a much longer one, standing for the occasional slow response of a real node.
+ * Worker threads then call them the way the request threads of tangle-accelerator do: first sharing one client service
+ * of the first node behind a global lock, as all requests did before the pool, then checking connections to both
+ * nodes out of the IRI connection pool, and last with hedged reads on top of the pool. The throughput and the latency
+ * percentiles of every run are reported.
+ *
+ * Usage:
+ *   bazel run //tests:bench_iri_pool -- [-w workers] [-s pool_size] [-n calls_per_worker] [-d delay_ms] [-p port]
+ *                                       [-t slow_every] [-T slow_ms] [-H hedge_budget]
+ */
+
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "cclient/api/core/core_api.h"
+#include "utils/iri_pool.h"
+
+#define BENCH_WORKERS 10
+#define BENCH_POOL_SIZE 10
+#define BENCH_CALLS 50
+#define BENCH_DELAY_MS 5
+#define BENCH_PORT 14299
+#define BENCH_SLOW_EVERY 50
+#define BENCH_SLOW_MS 100
+#define BENCH_HEDGE_BUDGET 5
+#define BENCH_BUF_SIZE 4096
+
+#define FAKE_IRI_TIP "ZIJGAJ9AADLRPWNCYNNHUHRRAC9QOUDATEDQUMTNOTABUVRPTSTFQDGZKFYUUIE9ZEBIVCCXXXLKX9999"
+#define FAKE_IRI_BODY "{\"hashes\":[\"" FAKE_IRI_TIP "\"],\"duration\":0}"
+
+typedef struct bench_opt_s {
+  int workers;
+  int pool_size;
+  int calls;
+  int delay_ms;
+  int port;
+  int slow_every;
+  int slow_ms;
+  int hedge_budget;
+} bench_opt_t;
+
+typedef struct bench_worker_s {
+  iota_client_service_t* shared; /**< Service of all workers behind `shared_lock`, NULL to use the pool */
+  pthread_mutex_t* shared_lock;
+  int calls;
+  double* latencies; /**< Latency of each call in milliseconds */
+  int failures;
+} bench_worker_t;
+
+static char const fake_iri_node_info[] =
+    "{\"appName\":\"IRI\",\"appVersion\":\"1.8.6\",\"latestMilestone\":\"" FAKE_IRI_TIP
+    "\",\"latestMilestoneIndex\":1000,\"latestSolidSubtangleMilestone\":\"" FAKE_IRI_TIP
+    "\",\"latestSolidSubtangleMilestoneIndex\":1000,\"milestoneStartIndex\":0,\"neighbors\":0,\"packetsQueueSize\":0,"
+    "\"time\":0,\"tips\":1,\"transactionsToRequest\":0,\"features\":[],\"coordinatorAddress\":\"" FAKE_IRI_TIP
+    "\",\"duration\":0}";
+static int fake_iri_delay_ms, fake_iri_slow_every, fake_iri_slow_ms;
+static int fake_iri_responses;
+static pthread_mutex_t fake_iri_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static double diff_ms(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0;
+}
+
+static int cmp_double(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+/** Answer one request of a connection after the delay, or the slow one every few requests, then close it like IRI */
+static void* fake_iri_conn(void* arg) {
+  int fd = (int)(intptr_t)arg;
+  char buf[BENCH_BUF_SIZE], response[BENCH_BUF_SIZE];
+  size_t len = 0;
+
+  while (len < sizeof(buf) - 1) {
+    ssize_t got = recv(fd, buf + len, sizeof(buf) - 1 - len, 0);
+    if (got <= 0) {
+      break;
+    }
+    len += got;
+    buf[len] = '\0';
+    char const* end = strstr(buf, "\r\n\r\n");
+    char const* field = strcasestr(buf, "Content-Length:");
+    if (end && (field == NULL || len >= (end - buf) + 4 + strtoul(field + strlen("Content-Length:"), NULL, 10))) {
+      break;
+    }
+  }
+
+  // Health checks of the pool are answered right away and are not counted
+  char const* body = FAKE_IRI_BODY;
+  if (strstr(buf, "getNodeInfo")) {
+    body = fake_iri_node_info;
+  } else {
+    pthread_mutex_lock(&fake_iri_lock);
+    bool slow = fake_iri_slow_every > 0 && ++fake_iri_responses % fake_iri_slow_every == 0;
+    pthread_mutex_unlock(&fake_iri_lock);
+    usleep((slow ? fake_iri_slow_ms : fake_iri_delay_ms) * 1000);
+  }
+  int response_len = snprintf(response, sizeof(response),
+                              "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n"
+                              "Connection: close\r\n\r\n%s",
+                              strlen(body), body);
+  send(fd, response, response_len, 0);
+  close(fd);
+  return NULL;
+}
+
+static void* fake_iri_listen(void* arg) {
+  int listen_fd = (int)(intptr_t)arg;
+  for (;;) {
+    int fd = accept(listen_fd, NULL, NULL);
+    if (fd < 0) {
+      return NULL;
+    }
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, fake_iri_conn, (void*)(intptr_t)fd) != 0) {
+      close(fd);
+      continue;
+    }
+    pthread_detach(thread);
+  }
+}
+
+static int fake_iri_start(const int port) {
+  struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port)};
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0), one = 1;
+  pthread_t thread;
+
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  if (listen_fd < 0 || bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, 1024) != 0) {
+    perror("fake IRI");
+    return -1;
+  }
+  pthread_create(&thread, NULL, fake_iri_listen, (void*)(intptr_t)listen_fd);
+  pthread_detach(thread);
+  return 0;
+}
+
+static void* bench_worker(void* arg) {
+  bench_worker_t* worker = arg;
+  struct timespec start, end;
+
+  flex_trit_t address[FLEX_TRIT_SIZE_243] = {};
+  find_transactions_req_t* req = find_transactions_req_new();
+  hash243_queue_push(&req->addresses, address);
+
+  for (int i = 0; i < worker->calls; i++) {
+    find_transactions_res_t* res = find_transactions_res_new();
+    bool failed = false;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (worker->shared) {
+      pthread_mutex_lock(worker->shared_lock);
+      failed = iota_client_find_transactions(worker->shared, req, res) != RC_OK;
+      pthread_mutex_unlock(worker->shared_lock);
+    } else {
+      iota_client_service_t* service = iri_pool_acquire();
+      failed = iri_pool_find_transactions(service, req, res) != SC_OK;
+      iri_pool_release(service);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    worker->latencies[i] = diff_ms(start, end);
+    if (failed) {
+      worker->failures++;
+    }
+    find_transactions_res_free(&res);
+  }
+  find_transactions_req_free(&req);
+  return NULL;
+}
+
+static void bench_run(char const* const name, bench_opt_t const* const opt, iota_client_service_t* const shared) {
+  int total = opt->workers * opt->calls, failures = 0;
+  double* latencies = (double*)calloc(total, sizeof(double));
+  bench_worker_t* workers = (bench_worker_t*)calloc(opt->workers, sizeof(bench_worker_t));
+  pthread_t* threads = (pthread_t*)calloc(opt->workers, sizeof(pthread_t));
+  pthread_mutex_t shared_lock = PTHREAD_MUTEX_INITIALIZER;
+  struct timespec start, end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int w = 0; w < opt->workers; w++) {
+    workers[w] = (bench_worker_t){
+        .shared = shared, .shared_lock = &shared_lock, .calls = opt->calls, .latencies = latencies + w * opt->calls};
+    pthread_create(&threads[w], NULL, bench_worker, &workers[w]);
+  }
+  for (int w = 0; w < opt->workers; w++) {
+    pthread_join(threads[w], NULL);
+    failures += workers[w].failures;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  qsort(latencies, total, sizeof(double), cmp_double);
+  double elapsed = diff_ms(start, end) / 1000.0;
+  printf("%-16s %8.1f calls/s  p50 %7.2f ms  p95 %7.2f ms  p99 %7.2f ms  failed %d\n", name, total / elapsed,
+         latencies[total / 2], latencies[total * 95 / 100], latencies[total * 99 / 100], failures);
+
+  free(threads);
+  free(workers);
+  free(latencies);
+}
+
+int main(int argc, char* argv[]) {
+  bench_opt_t opt = {.workers = BENCH_WORKERS,
+                     .pool_size = BENCH_POOL_SIZE,
+                     .calls = BENCH_CALLS,
+                     .delay_ms = BENCH_DELAY_MS,
+                     .port = BENCH_PORT,
+                     .slow_every = BENCH_SLOW_EVERY,
+                     .slow_ms = BENCH_SLOW_MS,
+                     .hedge_budget = BENCH_HEDGE_BUDGET};
+  iota_client_service_t service = {.http = {.path = "/",
+                                            .content_type = "application/json",
+                                            .accept = "application/json",
+                                            .host = "127.0.0.1",
+                                            .api_version = 1},
+                                   .serializer_type = SR_JSON};
+  char nodes[32];
+  int opt_char;
+
+  while ((opt_char = getopt(argc, argv, "w:s:n:d:p:t:T:H:")) != -1) {
+    switch (opt_char) {
+      case 'w':
+        opt.workers = atoi(optarg);
+        break;
+      case 's':
+        opt.pool_size = atoi(optarg);
+        break;
+      case 'n':
+        opt.calls = atoi(optarg);
+        break;
+      case 'd':
+        opt.delay_ms = atoi(optarg);
+        break;
+      case 'p':
+        opt.port = atoi(optarg);
+        break;
+      case 't':
+        opt.slow_every = atoi(optarg);
+        break;
+      case 'T':
+        opt.slow_ms = atoi(optarg);
+        break;
+      case 'H':
+        opt.hedge_budget = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "Usage: %s [-w workers] [-s pool_size] [-n calls_per_worker] [-d delay_ms] [-p port] [-t slow_every] "
+                "[-T slow_ms] [-H hedge_budget]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  if (opt.workers <= 0 || opt.calls <= 0 || opt.pool_size <= 0 || opt.pool_size > UINT8_MAX || opt.hedge_budget < 0 ||
+      opt.hedge_budget > 100) {
+    fprintf(stderr, "Invalid options\n");
+    return EXIT_FAILURE;
+  }
+
+  fake_iri_delay_ms = opt.delay_ms;
+  fake_iri_slow_every = opt.slow_every;
+  fake_iri_slow_ms = opt.slow_ms;
+  if (fake_iri_start(opt.port) != 0 || fake_iri_start(opt.port + 1) != 0) {
+    return EXIT_FAILURE;
+  }
+  service.http.port = opt.port;
+  snprintf(nodes, sizeof(nodes), "127.0.0.1:%d", opt.port + 1);
+  if (iota_client_core_init(&service) != RC_OK) {
+    fprintf(stderr, "Initializing IRI connections failed\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("%d workers, %d calls each, IRI answering in %d ms and in %d ms every %d calls, pool of %d connections\n",
+         opt.workers, opt.calls, opt.delay_ms, opt.slow_ms, opt.slow_every, opt.pool_size);
+  bench_run("global lock", &opt, &service);
+
+  // Each connection pool is shared by both nodes
+  if (iri_pool_init(&service, nodes, (opt.pool_size + 1) / 2, 0, 0, 0, 0, 0) != SC_OK) {
+    fprintf(stderr, "Initializing IRI connections failed\n");
+    return EXIT_FAILURE;
+  }
+  bench_run("connection pool", &opt, NULL);
+  iri_pool_destroy();
+
+  if (iri_pool_init(&service, nodes, (opt.pool_size + 1) / 2, 0, opt.hedge_budget, 0, 0, 0) != SC_OK) {
+    fprintf(stderr, "Initializing IRI connections failed\n");
+    return EXIT_FAILURE;
+  }
+  bench_run("hedged reads", &opt, NULL);
+  iri_pool_destroy();
+
+  iota_client_core_destroy(&service);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,430 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+/**
+ * PoW throughput benchmark
+ *
+ * Measure nonce searches per second and the latency distribution of the PoW backend over a range of MWM values,
+ * thread counts and bundle sizes, and the completion time of concurrently submitted bundles with and without the PoW
+ * scheduler. The result is written in the JSON format of Google Benchmark, so runs of different
+ * releases or machines can be compared with the usual tooling (e.g. `compare.py`).
+ *
+ * dcurl selects its backend (CPU/SSE/AVX, GPU, FPGA) when it is built, see `third_party/dcurl/build/local.mk`.
+ * Benchmark each backend by rebuilding dcurl and tagging the run with `-l <backend>`.
+ *
+ * Usage:
+ *   bazel run //tests:bench_pow -- [-m min_mwm] [-M max_mwm] [-t max_threads] [-b max_bundle_size] [-n samples]
+ *                                  [-c concurrent_bundles] [-w pow_workers] [-l backend_label] [-o output.json]
+ */
+
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "cJSON.h"
+#include "test_define.h"
+#include "utils/pow.h"
+
+#define BENCH_MWM_MIN 9
+#define BENCH_MWM_MAX 14
+#define BENCH_BUNDLE_MAX 20
+#define BENCH_SAMPLES 5
+#define BENCH_CONCURRENT_BUNDLES 50
+
+static const int bundle_sizes[] = {1, 2, 5, 10, 15, 20};
+static const int bundle_sizes_num = sizeof(bundle_sizes) / sizeof(int);
+
+typedef struct bench_opt_s {
+  int mwm_min;
+  int mwm_max;
+  int max_threads;
+  int max_bundle;
+  int samples;
+  int concurrency;
+  int pow_workers;
+  const char* label;
+  const char* output;
+} bench_opt_t;
+
+/** One bundle submitted concurrently with the others */
+typedef struct bench_submit_s {
+  bundle_transactions_t* bundle;
+  const flex_trit_t* trunk;
+  const flex_trit_t* branch;
+  uint8_t mwm;
+  const struct timespec* start; /**< Time when all bundles were submitted */
+  double latency;               /**< Completion time since `start` */
+  status_t ret;
+} bench_submit_t;
+
+static double diff_time(struct timespec start, struct timespec end) {
+  struct timespec diff;
+  if (end.tv_nsec - start.tv_nsec < 0) {
+    diff.tv_sec = end.tv_sec - start.tv_sec - 1;
+    diff.tv_nsec = end.tv_nsec - start.tv_nsec + 1000000000;
+  } else {
+    diff.tv_sec = end.tv_sec - start.tv_sec;
+    diff.tv_nsec = end.tv_nsec - start.tv_nsec;
+  }
+  return (diff.tv_sec + diff.tv_nsec / 1000000000.0);
+}
+
+static int cmp_double(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted sample set
+static double percentile(const double* sorted, int num, double p) {
+  int rank = (int)ceil(p / 100.0 * num);
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+/**
+ * Append and return one Google Benchmark style result entry. Latencies are in seconds, reported in milliseconds.
+ */
+static cJSON* bench_report(cJSON* benchmarks, const char* name, double* latency, double cpu_sum, int num,
+                         int items_per_sample) {
+  double sum = 0, mean = 0, var = 0, items_per_second = 0;
+
+  qsort(latency, num, sizeof(double), cmp_double);
+  for (int i = 0; i < num; i++) {
+    sum += latency[i];
+  }
+  mean = sum / num;
+  items_per_second = sum > 0 ? (double)items_per_sample * num / sum : 0;
+  for (int i = 0; i < num; i++) {
+    var += (latency[i] - mean) * (latency[i] - mean);
+  }
+
+  cJSON* entry = cJSON_CreateObject();
+  cJSON_AddStringToObject(entry, "name", name);
+  cJSON_AddStringToObject(entry, "run_name", name);
+  cJSON_AddStringToObject(entry, "run_type", "iteration");
+  cJSON_AddNumberToObject(entry, "iterations", num);
+  cJSON_AddNumberToObject(entry, "real_time", mean * 1e3);
+  cJSON_AddNumberToObject(entry, "cpu_time", cpu_sum / num * 1e3);
+  cJSON_AddStringToObject(entry, "time_unit", "ms");
+  cJSON_AddNumberToObject(entry, "items_per_second", items_per_second);
+  cJSON_AddNumberToObject(entry, "min", latency[0] * 1e3);
+  cJSON_AddNumberToObject(entry, "p50", percentile(latency, num, 50) * 1e3);
+  cJSON_AddNumberToObject(entry, "p90", percentile(latency, num, 90) * 1e3);
+  cJSON_AddNumberToObject(entry, "p99", percentile(latency, num, 99) * 1e3);
+  cJSON_AddNumberToObject(entry, "max", latency[num - 1] * 1e3);
+  cJSON_AddNumberToObject(entry, "stddev", sqrt(var / num) * 1e3);
+  cJSON_AddItemToArray(benchmarks, entry);
+
+  fprintf(stderr, "%-32s %10.3f ms %12.3f items/s\n", name, mean * 1e3, items_per_second);
+  return entry;
+}
+
+// Thread counts are swept in powers of two, always ending with `max` itself. Return 0 when the sweep is done.
+static int next_thread_count(int threads, int max) {
+  if (threads >= max) {
+    return 0;
+  }
+  return threads * 2 > max ? max : threads * 2;
+}
+
+static void bench_time_start(struct timespec* real, struct timespec* cpu) {
+  clock_gettime(CLOCK_MONOTONIC, real);
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, cpu);
+}
+
+static void bench_time_end(struct timespec* real, struct timespec* cpu, double* latency, double* cpu_sum) {
+  struct timespec real_end, cpu_end;
+  clock_gettime(CLOCK_MONOTONIC, &real_end);
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_end);
+  *latency = diff_time(*real, real_end);
+  *cpu_sum += diff_time(*cpu, cpu_end);
+}
+
+/**
+ * Single nonce search for every MWM and thread count. Each sample uses a different attachment timestamp, so the
+ * backend does not search the same nonce space twice.
+ */
+static int bench_nonce(const bench_opt_t* opt, cJSON* benchmarks) {
+  iota_transaction_t tx;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  double latency[opt->samples];
+  char name[64];
+
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t*)TRYTES_2673_1,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(&tx, tx_trits, false);
+
+  for (int mwm = opt->mwm_min; mwm <= opt->mwm_max; mwm++) {
+    for (int threads = 1; threads; threads = next_thread_count(threads, opt->max_threads)) {
+      double cpu_sum = 0;
+      struct timespec real_start, cpu_start;
+
+      for (int i = 0; i < opt->samples; i++) {
+        transaction_set_attachment_timestamp(&tx, TIMESTAMP + (mwm * 1000 + threads) * 1000 + i);
+        transaction_serialize_on_flex_trits(&tx, tx_trits);
+
+        bench_time_start(&real_start, &cpu_start);
+        flex_trit_t* nonce = ta_pow_flex_threads(tx_trits, mwm, threads);
+        bench_time_end(&real_start, &cpu_start, &latency[i], &cpu_sum);
+        if (nonce == NULL) {
+          fprintf(stderr, "PoW failed at mwm %d with %d threads\n", mwm, threads);
+          return -1;
+        }
+        free(nonce);
+      }
+
+      snprintf(name, sizeof(name), "pow_nonce/mwm:%d/threads:%d", mwm, threads);
+      bench_report(benchmarks, name, latency, cpu_sum, opt->samples, 1);
+    }
+  }
+  return 0;
+}
+
+/**
+ * Whole bundle PoW through `ta_pow()`, which chains the trunk of each transaction to the previous one.
+ */
+static int bench_bundle(const bench_opt_t* opt, cJSON* benchmarks) {
+  iota_transaction_t tx;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243], branch[FLEX_TRIT_SIZE_243];
+  double latency[opt->samples];
+  char name[64];
+
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t*)TRYTES_2673_1,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(&tx, tx_trits, false);
+  flex_trits_from_trytes(trunk, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  flex_trits_from_trytes(branch, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_2, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+
+  for (int mwm = opt->mwm_min; mwm <= opt->mwm_max; mwm++) {
+    for (int s = 0; s < bundle_sizes_num && bundle_sizes[s] <= opt->max_bundle; s++) {
+      double cpu_sum = 0;
+      struct timespec real_start, cpu_start;
+
+      for (int i = 0; i < opt->samples; i++) {
+        bundle_transactions_t* bundle = NULL;
+        bundle_transactions_new(&bundle);
+        for (int idx = 0; idx < bundle_sizes[s]; idx++) {
+          transaction_set_current_index(&tx, idx);
+          transaction_set_last_index(&tx, bundle_sizes[s] - 1);
+          bundle_transactions_add(bundle, &tx);
+        }
+
+        bench_time_start(&real_start, &cpu_start);
+        status_t ret = ta_pow(bundle, trunk, branch, mwm);
+        bench_time_end(&real_start, &cpu_start, &latency[i], &cpu_sum);
+        bundle_transactions_free(&bundle);
+        if (ret != SC_OK) {
+          fprintf(stderr, "Bundle PoW failed at mwm %d with %d transactions\n", mwm, bundle_sizes[s]);
+          return -1;
+        }
+      }
+
+      snprintf(name, sizeof(name), "pow_bundle/mwm:%d/txs:%d", mwm, bundle_sizes[s]);
+      bench_report(benchmarks, name, latency, cpu_sum, opt->samples, bundle_sizes[s]);
+    }
+  }
+  return 0;
+}
+
+static void* bench_submit_bundle(void* arg) {
+  bench_submit_t* submit = (bench_submit_t*)arg;
+  struct timespec end;
+
+  submit->ret = ta_pow(submit->bundle, submit->trunk, submit->branch, submit->mwm);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  submit->latency = diff_time(*submit->start, end);
+  return NULL;
+}
+
+/**
+ * Submit `concurrency` bundles of mixed sizes at once and measure the completion time of each one, first with every
+ * request doing its own PoW and then through the PoW scheduler.
+ */
+static int bench_concurrent(const bench_opt_t* opt, cJSON* benchmarks) {
+  iota_transaction_t tx;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243], branch[FLEX_TRIT_SIZE_243];
+  bench_submit_t submits[opt->concurrency];
+  pthread_t threads[opt->concurrency];
+  double latency[opt->concurrency];
+  struct timespec start, cpu_start;
+  char name[64];
+  int ret = 0;
+
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t*)TRYTES_2673_1,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(&tx, tx_trits, false);
+  flex_trits_from_trytes(trunk, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  flex_trits_from_trytes(branch, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_2, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+
+  for (int scheduled = 0; scheduled <= 1 && ret == 0; scheduled++) {
+    double cpu_sum = 0;
+    int txs = 0;
+
+    if (scheduled && pow_scheduler_start(opt->pow_workers) != SC_OK) {
+      fprintf(stderr, "Starting PoW scheduler failed\n");
+      return -1;
+    }
+
+    for (int i = 0; i < opt->concurrency; i++) {
+      int size = bundle_sizes[i % bundle_sizes_num] <= opt->max_bundle ? bundle_sizes[i % bundle_sizes_num] : 1;
+      submits[i] = (bench_submit_t){
+          .bundle = NULL, .trunk = trunk, .branch = branch, .mwm = opt->mwm_min, .start = &start, .ret = SC_OK};
+      bundle_transactions_new(&submits[i].bundle);
+      for (int idx = 0; idx < size; idx++) {
+        transaction_set_current_index(&tx, idx);
+        transaction_set_last_index(&tx, size - 1);
+        bundle_transactions_add(submits[i].bundle, &tx);
+      }
+      txs += size;
+    }
+
+    bench_time_start(&start, &cpu_start);
+    for (int i = 0; i < opt->concurrency; i++) {
+      pthread_create(&threads[i], NULL, bench_submit_bundle, &submits[i]);
+    }
+    for (int i = 0; i < opt->concurrency; i++) {
+      pthread_join(threads[i], NULL);
+    }
+    double makespan = 0;
+    bench_time_end(&start, &cpu_start, &makespan, &cpu_sum);
+
+    for (int i = 0; i < opt->concurrency; i++) {
+      latency[i] = submits[i].latency;
+      if (submits[i].ret != SC_OK) {
+        fprintf(stderr, "Concurrent bundle PoW failed\n");
+        ret = -1;
+      }
+      bundle_transactions_free(&submits[i].bundle);
+    }
+
+    if (scheduled) {
+      pow_scheduler_stop();
+      snprintf(name, sizeof(name), "pow_concurrent/mwm:%d/bundles:%d/workers:%d", opt->mwm_min, opt->concurrency,
+               opt->pow_workers);
+    } else {
+      snprintf(name, sizeof(name), "pow_concurrent/mwm:%d/bundles:%d/workers:0", opt->mwm_min, opt->concurrency);
+    }
+    // `real_time` is the mean completion time of a bundle, `items_per_second` the transaction throughput of the run
+    cJSON* entry = bench_report(benchmarks, name, latency, cpu_sum, opt->concurrency, 0);
+    cJSON_ReplaceItemInObject(entry, "items_per_second", cJSON_CreateNumber(txs / makespan));
+    cJSON_AddNumberToObject(entry, "makespan", makespan * 1e3);
+  }
+  return ret;
+}
+
+static cJSON* bench_context(const bench_opt_t* opt, const char* executable) {
+  char date[32], host[64] = {0};
+  time_t now = time(NULL);
+  cJSON* context = cJSON_CreateObject();
+
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+  gethostname(host, sizeof(host) - 1);
+  cJSON_AddStringToObject(context, "date", date);
+  cJSON_AddStringToObject(context, "host_name", host);
+  cJSON_AddStringToObject(context, "executable", executable);
+  cJSON_AddNumberToObject(context, "num_cpus", sysconf(_SC_NPROCESSORS_ONLN));
+  cJSON_AddStringToObject(context, "pow_backend", opt->label);
+  cJSON_AddNumberToObject(context, "samples", opt->samples);
+#if defined(NDEBUG)
+  cJSON_AddStringToObject(context, "library_build_type", "release");
+#else
+  cJSON_AddStringToObject(context, "library_build_type", "debug");
+#endif
+  return context;
+}
+
+int main(int argc, char** argv) {
+  int ret = EXIT_SUCCESS, opt_char;
+  bench_opt_t opt = {.mwm_min = BENCH_MWM_MIN,
+                     .mwm_max = BENCH_MWM_MAX,
+                     .max_threads = sysconf(_SC_NPROCESSORS_ONLN),
+                     .max_bundle = BENCH_BUNDLE_MAX,
+                     .samples = BENCH_SAMPLES,
+                     .concurrency = BENCH_CONCURRENT_BUNDLES,
+                     .pow_workers = POW_WORKERS,
+                     .label = "dcurl",
+                     .output = NULL};
+
+  while ((opt_char = getopt(argc, argv, "m:M:t:b:n:c:w:l:o:")) != -1) {
+    switch (opt_char) {
+      case 'm':
+        opt.mwm_min = atoi(optarg);
+        break;
+      case 'M':
+        opt.mwm_max = atoi(optarg);
+        break;
+      case 't':
+        opt.max_threads = atoi(optarg);
+        break;
+      case 'b':
+        opt.max_bundle = atoi(optarg);
+        break;
+      case 'n':
+        opt.samples = atoi(optarg);
+        break;
+      case 'c':
+        opt.concurrency = atoi(optarg);
+        break;
+      case 'w':
+        opt.pow_workers = atoi(optarg);
+        break;
+      case 'l':
+        opt.label = optarg;
+        break;
+      case 'o':
+        opt.output = optarg;
+        break;
+      default:
+        fprintf(stderr,
+                "Usage: %s [-m min_mwm] [-M max_mwm] [-t max_threads] [-b max_bundle_size] [-n samples] "
+                "[-c concurrent_bundles] [-w pow_workers] [-l backend_label] [-o output.json]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  if (opt.samples <= 0 || opt.max_threads <= 0 || opt.concurrency <= 0 || opt.pow_workers <= 0 ||
+      opt.mwm_min > opt.mwm_max) {
+    fprintf(stderr, "Invalid benchmark options\n");
+    return EXIT_FAILURE;
+  }
+
+  if (logger_helper_init(LOGGER_ERR) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+  pow_logger_init();
+  pow_init();
+
+  cJSON* json_root = cJSON_CreateObject();
+  cJSON* benchmarks = cJSON_CreateArray();
+  cJSON_AddItemToObject(json_root, "context", bench_context(&opt, argv[0]));
+  cJSON_AddItemToObject(json_root, "benchmarks", benchmarks);
+
+  if (bench_nonce(&opt, benchmarks) || bench_bundle(&opt, benchmarks) || bench_concurrent(&opt, benchmarks)) {
+    ret = EXIT_FAILURE;
+  }
+
+  char* json_result = cJSON_Print(json_root);
+  FILE* out = opt.output ? fopen(opt.output, "w") : stdout;
+  if (out) {
+    fprintf(out, "%s\n", json_result);
+    if (out != stdout) {
+      fclose(out);
+    }
+  } else {
+    fprintf(stderr, "Cannot open %s\n", opt.output);
+    ret = EXIT_FAILURE;
+  }
+
+  free(json_result);
+  cJSON_Delete(json_root);
+  pow_destroy();
+  pow_logger_release();
+  return ret;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+/**
+ * Transaction object serialization benchmark
+ *
+ * Compare serializing a transaction array by building a cJSON tree and printing it with the streaming JSON writer
+ * used by `ta_find_transaction_objects_res_serialize()`. Both outputs are checked to be identical. The CBOR encoding
+ * of the same array is measured as well, for its time and size, and so is the list view projection
+ * `fields=hash,address,value,timestamp`.
+ *
+ * Usage:
+ *   bazel run //tests:bench_serializer -- [-n transactions] [-i iterations]
+ */
+
+#include <getopt.h>
+#include <time.h>
+#include "serializer/serializer.h"
+#include "test_define.h"
+
+#define BENCH_TXNS 100
+#define BENCH_ITERATIONS 1000
+
+static double diff_time(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1000000000.0;
+}
+
+/** The serialization path before the streaming writer */
+static status_t serialize_cjson(const transaction_array_t* const txns, char** obj) {
+  status_t ret = SC_OK;
+  iota_transaction_t* txn = NULL;
+  cJSON* json_root = cJSON_CreateArray();
+
+  TX_OBJS_FOREACH(txns, txn) {
+    cJSON* txn_obj = cJSON_CreateObject();
+    ret = iota_transaction_to_json_object(txn, TA_TXN_FIELDS_ALL, &txn_obj);
+    if (ret != SC_OK) {
+      cJSON_Delete(txn_obj);
+      goto done;
+    }
+    cJSON_AddItemToArray(json_root, txn_obj);
+  }
+  *obj = cJSON_PrintUnformatted(json_root);
+
+done:
+  cJSON_Delete(json_root);
+  return ret;
+}
+
+static status_t serialize_cbor(const transaction_array_t* const txns, char** obj) {
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_CBOR};
+  return ta_transaction_array_serialize(txns, &opt, obj, NULL);
+}
+
+/** Members a list view asks for */
+#define BENCH_LIST_VIEW_FIELDS (TA_TXN_FIELD_HASH | TA_TXN_FIELD_ADDRESS | TA_TXN_FIELD_VALUE | TA_TXN_FIELD_TIMESTAMP)
+
+static status_t serialize_list_view(const transaction_array_t* const txns, char** obj) {
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_JSON, .fields = BENCH_LIST_VIEW_FIELDS};
+  return ta_transaction_array_serialize(txns, &opt, obj, NULL);
+}
+
+static double bench_run(status_t (*serialize)(const transaction_array_t* const, char**),
+                        const transaction_array_t* const txns, const int iterations) {
+  struct timespec start, end;
+  char* json_result = NULL;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    if (serialize(txns, &json_result) != SC_OK) {
+      return -1;
+    }
+    free(json_result);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return diff_time(start, end) / iterations;
+}
+
+int main(int argc, char** argv) {
+  int txn_num = BENCH_TXNS, iterations = BENCH_ITERATIONS, opt_char;
+  char *json_cjson = NULL, *json_writer = NULL;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  transaction_array_t* txns = transaction_array_new();
+
+  while ((opt_char = getopt(argc, argv, "n:i:")) != -1) {
+    switch (opt_char) {
+      case 'n':
+        txn_num = atoi(optarg);
+        break;
+      case 'i':
+        iterations = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-n transactions] [-i iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+
+  if (logger_helper_init(LOGGER_ERR) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t*)TRYTES_2673_1,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t* txn = transaction_deserialize(tx_trits, true);
+  for (int i = 0; i < txn_num; i++) {
+    transaction_array_push_back(txns, txn);
+  }
+
+  if (serialize_cjson(txns, &json_cjson) != SC_OK ||
+      ta_find_transaction_objects_res_serialize(txns, &json_writer) != SC_OK || strcmp(json_cjson, json_writer)) {
+    fprintf(stderr, "Outputs of cJSON and the streaming writer differ\n");
+    return EXIT_FAILURE;
+  }
+
+  double cjson_time = bench_run(serialize_cjson, txns, iterations);
+  double writer_time = bench_run(ta_find_transaction_objects_res_serialize, txns, iterations);
+  double cbor_time = bench_run(serialize_cbor, txns, iterations);
+  double list_view_time = bench_run(serialize_list_view, txns, iterations);
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_CBOR};
+  char* cbor = NULL;
+  size_t cbor_len = 0;
+  char* list_view = NULL;
+  if (ta_transaction_array_serialize(txns, &opt, &cbor, &cbor_len) != SC_OK ||
+      serialize_list_view(txns, &list_view) != SC_OK) {
+    return EXIT_FAILURE;
+  }
+  printf("Transactions: %d, iterations: %d, output: %zu bytes\n", txn_num, iterations, strlen(json_writer));
+  printf("cJSON tree: %lf ms\n", cjson_time * 1000);
+  printf("Streaming writer: %lf ms\n", writer_time * 1000);
+  printf("Speedup: %.2fx\n", cjson_time / writer_time);
+  printf("CBOR: %lf ms, output: %zu bytes (%.2fx smaller)\n", cbor_time * 1000, cbor_len,
+         (double)strlen(json_writer) / cbor_len);
+  printf("List view fields: %lf ms, output: %zu bytes (%.2fx smaller)\n", list_view_time * 1000, strlen(list_view),
+         (double)strlen(json_writer) / strlen(list_view));
+
+  free(json_cjson);
+  free(json_writer);
+  free(cbor);
+  free(list_view);
+  transaction_free(txn);
+  transaction_array_free(txns);
+  logger_helper_destroy();
+  return 0;
+}
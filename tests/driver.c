@@ -141,7 +141,7 @@ void test_send_transfer(void) {
 
   for (size_t count = 0; count < TEST_COUNT; count++) {
     test_time_start(&start_time);
-    TEST_ASSERT_EQUAL_INT32(SC_OK, api_send_transfer(&ta_core.iconf, &ta_core.service, json, &json_result));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_send_transfer(&ta_core.iconf, json, &json_result));
     test_time_end(&start_time, &end_time, &sum);
     free(json_result);
   }
@@ -155,7 +155,7 @@ void test_send_trytes(void) {
 
   for (size_t count = 0; count < TEST_COUNT; count++) {
     test_time_start(&start_time);
-    TEST_ASSERT_EQUAL_INT32(SC_OK, api_send_trytes(&ta_core.iconf, &ta_core.service, json, &json_result));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_send_trytes(&ta_core.iconf, json, &json_result));
     test_time_end(&start_time, &end_time, &sum);
     free(json_result);
   }
@@ -183,7 +183,7 @@ void test_find_transaction_objects(void) {
 
   for (size_t count = 0; count < TEST_COUNT; count++) {
     test_time_start(&start_time);
-    TEST_ASSERT_EQUAL_INT32(SC_OK, api_find_transaction_objects(&ta_core.service, json, &json_result));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_find_transaction_objects(&ta_core.service, json, NULL, &json_result, NULL));
     test_time_end(&start_time, &end_time, &sum);
     free(json_result);
   }
@@ -211,7 +211,8 @@ void test_find_transactions_obj_by_tag(void) {
   for (size_t count = 0; count < TEST_COUNT; count++) {
     test_time_start(&start_time);
 
-    TEST_ASSERT_EQUAL_INT32(SC_OK, api_find_transactions_obj_by_tag(&ta_core.service, driver_tag_msg, &json_result));
+    TEST_ASSERT_EQUAL_INT32(
+        SC_OK, api_find_transactions_obj_by_tag(&ta_core.service, driver_tag_msg, NULL, &json_result, NULL));
     test_time_end(&start_time, &end_time, &sum);
     free(json_result);
   }
@@ -226,7 +227,7 @@ void test_send_mam_message(void) {
 
   for (size_t count = 0; count < TEST_COUNT; count++) {
     test_time_start(&start_time);
-    TEST_ASSERT_EQUAL_INT32(SC_OK, api_mam_send_message(&ta_core.iconf, &ta_core.service, json, &json_result));
+    TEST_ASSERT_EQUAL_INT32(SC_OK, api_mam_send_message(&ta_core.iconf, json, &json_result));
     send_mam_res_deserialize(json_result, res);
 
     test_time_end(&start_time, &end_time, &sum);
@@ -269,6 +270,17 @@ void test_proxy_apis() {
   }
 }
 
+void test_proxy_api_wrapper() {
+  char* json_result = NULL;
+  for (int i = 0; i < proxy_apis_num; i++) {
+    char const* json = proxy_apis_g[i].json ? proxy_apis_g[i].json : "{\"command\":\"getNodeInfo\"}";
+    TEST_ASSERT_EQUAL_INT32(SC_OK, proxy_api_wrapper(&ta_core.service, json, &json_result));
+    free(json_result);
+  }
+  TEST_ASSERT_EQUAL_INT32(SC_SERIALIZER_INVALID_REQ,
+                          proxy_api_wrapper(&ta_core.service, "{\"command\":\"removeNeighbors\"}", &json_result));
+}
+
 int main(void) {
   srand(time(NULL));
 
@@ -280,7 +292,7 @@ int main(void) {
   }
 
   ta_config_default_init(&ta_core.info, &ta_core.iconf, &ta_core.cache, &ta_core.service);
-  ta_config_set(&ta_core.cache, &ta_core.service);
+  ta_config_set(&ta_core.info, &ta_core.cache, &ta_core.service);
 
   printf("Total samples for each API test: %d\n", TEST_COUNT);
   RUN_TEST(test_generate_address);
@@ -295,6 +307,7 @@ int main(void) {
   RUN_TEST(test_find_transactions_by_tag);
   RUN_TEST(test_find_transactions_obj_by_tag);
   RUN_TEST(test_proxy_apis);
+  RUN_TEST(test_proxy_api_wrapper);
   ta_config_destroy(&ta_core.service);
   return UNITY_END();
 }
@@ -79,7 +79,6 @@ retcode_t iota_client_get_transaction_objects(iota_client_service_t const* const
   return APIMockObj.iota_client_get_transaction_objects(serv, tx_hashes, out_tx_objs);
 }
 
-status_t ta_send_trytes(iota_config_t const* const tangle, const iota_client_service_t* const service,
-                        hash8019_array_p trytes) {
-  return APIMockObj.ta_send_trytes(tangle, service, trytes);
+status_t ta_send_trytes(iota_config_t const* const tangle, hash8019_array_p trytes) {
+  return APIMockObj.ta_send_trytes(tangle, trytes);
 }
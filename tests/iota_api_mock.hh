@@ -51,8 +51,7 @@ class IotaAPI {
                                                         transaction_array_t* out_tx_objs) {
     return RC_OK;
   }
-  virtual status_t ta_send_trytes(iota_config_t const* const tangle, const iota_client_service_t* const service,
-                                  hash8019_array_p trytes) {
+  virtual status_t ta_send_trytes(iota_config_t const* const tangle, hash8019_array_p trytes) {
     return SC_OK;
   }
 };
@@ -83,6 +82,5 @@ class APIMock : public IotaAPI {
   MOCK_METHOD3(iota_client_get_transaction_objects,
                retcode_t(iota_client_service_t const* const serv, get_trytes_req_t* const tx_hashes,
                          transaction_array_t* out_tx_objs));
-  MOCK_METHOD3(ta_send_trytes, status_t(iota_config_t const* const tangle, const iota_client_service_t* const service,
-                                        hash8019_array_p trytes));
+  MOCK_METHOD2(ta_send_trytes, status_t(iota_config_t const* const tangle, hash8019_array_p trytes));
 };
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+# All Rights Reserved.
+# This is free software; you can redistribute it and/or modify it under the
+# terms of the MIT license. A copy of the license can be found in the file
+# "LICENSE" at the root of this distribution.
+
+# Stand-in IRI node answering the commands tangle-accelerator sends with canned
+# results, after an optional delay. Run several of them to try the load
+# balancing of IRI nodes, e.g. with one lagging behind on milestones:
+#
+#   python3 fake_iri.py --port 14265 &
+#   python3 fake_iri.py --port 14266 --delay 50 &
+#   python3 fake_iri.py --port 14267 --lag 10 &
+#   bazel run //accelerator -- --iri_port 14265 --iri_nodes localhost:14266,localhost:14267 --verbose
+
+import argparse
+import json
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+HASH = "9" * 81
+TRYTES = "9" * 2673
+
+
+def results(command, req, args):
+    if command == "getNodeInfo":
+        return {
+            "appName": "fake-iri",
+            "appVersion": "1.8.6",
+            "coordinatorAddress": HASH,
+            "features": [],
+            "latestMilestone": HASH,
+            "latestMilestoneIndex": args.milestone,
+            "latestSolidSubtangleMilestone": HASH,
+            "latestSolidSubtangleMilestoneIndex": args.milestone - args.lag,
+            "milestoneStartIndex": 0,
+            "neighbors": 0,
+            "packetsQueueSize": 0,
+            "time": int(time.time() * 1000),
+            "tips": 1,
+            "transactionsToRequest": 0
+        }
+    if command == "getTips":
+        return {"hashes": [HASH]}
+    if command == "getTransactionsToApprove":
+        return {"trunkTransaction": HASH, "branchTransaction": HASH}
+    if command == "findTransactions":
+        return {"hashes": []}
+    if command == "getTrytes":
+        return {"trytes": [TRYTES for _ in req.get("hashes", [])]}
+    if command == "getInclusionStates":
+        return {"states": [False for _ in req.get("transactions", [])]}
+    if command == "getBalances":
+        return {
+            "balances": ["0" for _ in req.get("addresses", [])],
+            "references": [HASH],
+            "milestoneIndex": args.milestone
+        }
+    if command == "checkConsistency":
+        return {"state": True}
+    if command in ("storeTransactions", "broadcastTransactions"):
+        return {}
+    return None
+
+
+def handler(args):
+    class FakeIriHandler(BaseHTTPRequestHandler):
+        def do_POST(self):
+            body = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+            try:
+                req = json.loads(body)
+            except ValueError:
+                req = {}
+            res = results(req.get("command"), req, args)
+            time.sleep(args.delay / 1000)
+
+            status = 200
+            if res is None:
+                status = 400
+                res = {"error": "Command [%s] is unknown" % req.get("command")}
+            res["duration"] = args.delay
+            payload = json.dumps(res).encode()
+            self.send_response(status)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(payload)))
+            self.end_headers()
+            self.wfile.write(payload)
+
+        def log_message(self, format, *log_args):
+            if args.verbose:
+                super().log_message(format, *log_args)
+
+    return FakeIriHandler
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Stand-in IRI node")
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--port", type=int, default=14265)
+    parser.add_argument("--delay",
+                        type=int,
+                        default=0,
+                        help="milliseconds before each response")
+    parser.add_argument("--milestone",
+                        type=int,
+                        default=1000,
+                        help="latest milestone index")
+    parser.add_argument("--lag",
+                        type=int,
+                        default=0,
+                        help="milestones the solid milestone lags behind")
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    ThreadingHTTPServer((args.host, args.port), handler(args)).serve_forever()
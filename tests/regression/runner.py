@@ -538,6 +538,32 @@ class Regression_Test(unittest.TestCase):
 
         eval_stat(time_cost, "find transaction objects")
 
+    def test_find_transactions_obj_by_tag_cbor(self):
+        logging.debug(
+            "\n================================find transaction objects by tag in CBOR================================"
+        )
+        rand_tag = gen_rand_trytes(27)
+        tx_post_data = {
+            "value": 0,
+            "message": gen_rand_trytes(30),
+            "tag": rand_tag,
+            "address": gen_rand_trytes(81)
+        }
+        sent_transaction_obj = API("/transaction/",
+                                   post_data=json.dumps(tx_post_data))
+        logging.debug("sent_transaction_obj = " + repr(sent_transaction_obj))
+
+        # Without page parameters the objects are not streamed in JSON, but encoded in CBOR as asked for
+        r = requests.get(url + "/tag/" + rand_tag,
+                         headers={"Accept": "application/cbor"},
+                         timeout=TIMEOUT)
+        logging.debug("response = " + repr(r.content))
+        self.assertEqual(STATUS_CODE_200, str(r.status_code))
+        self.assertIn("application/cbor", r.headers["content-type"])
+        # An array of one transaction map, holding its "hash" as a text key
+        self.assertEqual(0x81, r.content[0])
+        self.assertIn(b"\x64hash", r.content)
+
     def test_get_tips(self):
         logging.debug(
             "\n================================get_tips================================"
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <pthread.h>
+#include "test_define.h"
+#include "utils/arena.h"
+
+#define TEST_ALLOC_NUM 100
+
+void test_alloc(void) {
+  char buf[256];
+  arena_t arena;
+
+  arena_init(&arena, buf, sizeof(buf));
+  for (int i = 1; i <= TEST_ALLOC_NUM; i++) {
+    char* mem = (char*)arena_alloc(&arena, i);
+    TEST_ASSERT_NOT_NULL(mem);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)mem % sizeof(long double));
+    memset(mem, i, i);
+  }
+  // 100 allocations of up to 100 bytes outgrow the buffer
+  TEST_ASSERT_TRUE(arena.num_blocks > 0);
+
+  char* str = arena_strndup(&arena, "TANGLEACCELERATOR", 6);
+  TEST_ASSERT_EQUAL_STRING("TANGLE", str);
+  arena_reset(&arena);
+  TEST_ASSERT_NULL(arena.blocks);
+  TEST_ASSERT_EQUAL_PTR(buf, arena_alloc(&arena, 1));
+  arena_reset(&arena);
+}
+
+void test_oversized_alloc(void) {
+  arena_t arena;
+
+  arena_init(&arena, NULL, 0);
+  char* small = (char*)arena_alloc(&arena, 16);
+  char* large = (char*)arena_alloc(&arena, ARENA_BLOCK_SIZE * 4);
+  TEST_ASSERT_NOT_NULL(large);
+  memset(large, 0xff, ARENA_BLOCK_SIZE * 4);
+  // The oversized block does not take the place of the current block
+  TEST_ASSERT_EQUAL_PTR(small + 16, arena_alloc(&arena, 16));
+  TEST_ASSERT_EQUAL(2, arena.num_blocks);
+  arena_reset(&arena);
+}
+
+void test_rewind(void) {
+  arena_t arena;
+
+  arena_init(&arena, NULL, 0);
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < TEST_ALLOC_NUM; i++) {
+      TEST_ASSERT_NOT_NULL(arena_alloc(&arena, ARENA_BLOCK_SIZE / 4));
+    }
+    TEST_ASSERT_NOT_NULL(arena_alloc(&arena, ARENA_BLOCK_SIZE * 2));
+    arena_rewind(&arena);
+    TEST_ASSERT_NULL(arena.blocks);
+    TEST_ASSERT_NOT_NULL(arena.spare);
+  }
+  // Blocks of the first round are reused by the next ones, only the oversized ones are allocated again
+  size_t blocks = (TEST_ALLOC_NUM + 2) / 3;
+  TEST_ASSERT_EQUAL(blocks + 3, arena.num_blocks);
+  arena_reset(&arena);
+  TEST_ASSERT_NULL(arena.spare);
+}
+
+static void* thread_arena(void* arg) {
+  arena_t** out = (arena_t**)arg;
+  *out = arena_thread_local();
+  TEST_ASSERT_NOT_NULL(arena_alloc(*out, ARENA_THREAD_BUFFER_SIZE));
+  arena_rewind(*out);
+  return NULL;
+}
+
+void test_thread_local(void) {
+  arena_t *main_arena = arena_thread_local(), *other_arena = NULL;
+  pthread_t thread;
+
+  TEST_ASSERT_NOT_NULL(main_arena);
+  TEST_ASSERT_EQUAL_PTR(main_arena, arena_thread_local());
+  TEST_ASSERT_EQUAL(ARENA_THREAD_BUFFER_SIZE, main_arena->initial_size);
+
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, thread_arena, &other_arena));
+  TEST_ASSERT_EQUAL_INT(0, pthread_join(thread, NULL));
+  TEST_ASSERT_NOT_NULL(other_arena);
+  TEST_ASSERT_TRUE(main_arena != other_arena);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_alloc);
+  RUN_TEST(test_oversized_alloc);
+  RUN_TEST(test_rewind);
+  RUN_TEST(test_thread_local);
+  return UNITY_END();
+}
@@ -6,9 +6,21 @@
  * "LICENSE" at the root of this distribution.
  */
 
+#include <pthread.h>
 #include "test_define.h"
 #include "utils/cache.h"
 
+#define TEST_THREADS 8
+#define TEST_ROUNDS 100
+#define TEST_KEYS 4
+#define TEST_KEY_LEN 16
+#define TEST_VALUE_LEN 8
+
+typedef struct test_caller_s {
+  int id;
+  int mismatches; /**< Values read back which another thread wrote, or missing */
+} test_caller_t;
+
 void test_cache_del(void) {
   const char* key = TRYTES_81_1;
   cache_del(key);
@@ -28,12 +40,61 @@ void test_cache_set(void) {
   cache_set(key, value);
 }
 
+/** Write keys of its own and read them back, while other threads do the same on the same connection */
+static void* write_and_read(void* arg) {
+  test_caller_t* caller = (test_caller_t*)arg;
+  char keys[TEST_KEYS * TEST_KEY_LEN + 1];
+  char values[TEST_KEYS * TEST_VALUE_LEN + 1];
+  char read[TEST_KEYS * TEST_VALUE_LEN];
+  bool found[TEST_KEYS];
+
+  for (int i = 0; i < TEST_KEYS; i++) {
+    snprintf(keys + i * TEST_KEY_LEN, TEST_KEY_LEN + 1, "test_cache_%02d_%02d", caller->id, i);
+  }
+  for (int round = 0; round < TEST_ROUNDS; round++) {
+    for (int i = 0; i < TEST_KEYS; i++) {
+      snprintf(values + i * TEST_VALUE_LEN, TEST_VALUE_LEN + 1, "%02d%02d%04d", caller->id, i, round);
+    }
+    if (cache_mset(keys, TEST_KEY_LEN, values, TEST_VALUE_LEN, TEST_KEYS) != SC_OK ||
+        cache_mget(keys, TEST_KEY_LEN, TEST_KEYS, read, TEST_VALUE_LEN, found) != SC_OK) {
+      caller->mismatches++;
+      continue;
+    }
+    for (int i = 0; i < TEST_KEYS; i++) {
+      if (!found[i] || memcmp(read + i * TEST_VALUE_LEN, values + i * TEST_VALUE_LEN, TEST_VALUE_LEN)) {
+        caller->mismatches++;
+      }
+    }
+  }
+  for (int i = 0; i < TEST_KEYS; i++) {
+    char key[TEST_KEY_LEN + 1] = {0};
+    memcpy(key, keys + i * TEST_KEY_LEN, TEST_KEY_LEN);
+    cache_del(key);
+  }
+  return NULL;
+}
+
+void test_cache_concurrent(void) {
+  pthread_t threads[TEST_THREADS];
+  test_caller_t callers[TEST_THREADS];
+
+  for (int i = 0; i < TEST_THREADS; i++) {
+    callers[i] = (test_caller_t){.id = i, .mismatches = 0};
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[i], NULL, write_and_read, &callers[i]));
+  }
+  for (int i = 0; i < TEST_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+    TEST_ASSERT_EQUAL_INT(0, callers[i].mismatches);
+  }
+}
+
 int main(void) {
   UNITY_BEGIN();
   cache_init(true, REDIS_HOST, REDIS_PORT);
   RUN_TEST(test_cache_set);
   RUN_TEST(test_cache_get);
   RUN_TEST(test_cache_del);
+  RUN_TEST(test_cache_concurrent);
   cache_stop();
   return UNITY_END();
 }
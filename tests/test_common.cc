@@ -44,10 +44,13 @@ TEST(GetTxnObjTest, GetTrytesTest) {
   flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t*)TRYTES_2673_2,
                          NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
   iota_transaction_t* expected_txn = transaction_deserialize(tx_trits, true);
-  hash243_queue_push(&req->hashes, transaction_hash(expected_txn));
+  hash243_vector_push(&req->hashes, transaction_hash(expected_txn));
+
+  arena_t arena;
+  arena_init(&arena, NULL, 0);
 
   EXPECT_CALL(APIMockObj, iota_client_get_transaction_objects(_, _, _)).Times(AtLeast(0));
-  EXPECT_EQ(ta_find_transaction_objects(&service, req, res), 0);
+  EXPECT_EQ(ta_find_transaction_objects(&service, &arena, req, res), 0);
 
   iota_transaction_t* txn = transaction_array_at(res, 0);
   EXPECT_EQ(
@@ -66,6 +69,7 @@ TEST(GetTxnObjTest, GetTrytesTest) {
   ta_find_transaction_objects_req_free(&req);
   transaction_array_free(res);
   transaction_free(expected_txn);
+  arena_reset(&arena);
 }
 
 TEST(SendTransferTest, SendTransferTest) {
@@ -84,10 +88,10 @@ TEST(SendTransferTest, SendTransferTest) {
   req->msg_len = NUM_TRITS_SIGNATURE;
   flex_trits_slice(req->message, req->msg_len, msg_trits, req->msg_len, 0, req->msg_len);
 
-  EXPECT_CALL(APIMockObj, ta_send_trytes(_, _, _)).Times(AtLeast(1));
+  EXPECT_CALL(APIMockObj, ta_send_trytes(_, _)).Times(AtLeast(1));
   EXPECT_CALL(APIMockObj, iota_client_find_transactions(_, _, _)).Times(AtLeast(1));
 
-  EXPECT_EQ(ta_send_transfer(&tangle, &service, req, res), 0);
+  EXPECT_EQ(ta_send_transfer(&tangle, req, res), 0);
   txn_hash = hash243_queue_peek(res->hash);
   EXPECT_FALSE(memcmp(txn_hash, hash_trits_1, sizeof(flex_trit_t) * FLEX_TRIT_SIZE_243));
 
@@ -130,7 +134,7 @@ TEST(SendTrytesTest, SendTrytesTest) {
                          NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
   hash_array_push(trytes, tx_trits);
 
-  EXPECT_EQ(ta_send_trytes(&tangle, &service, trytes), SC_OK);
+  EXPECT_EQ(ta_send_trytes(&tangle, trytes), SC_OK);
 
   trits_count = flex_trits_to_trytes(trytes_out, NUM_TRYTES_SERIALIZED_TRANSACTION, hash_array_at(trytes, 0),
                                      NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
@@ -150,6 +154,8 @@ TEST(SendTrytesTest, SendTrytesTest) {
 int main(int argc, char** argv) {
   // GTest manage to cleanup after testing, so only need to initialize here
   cache_init(true, REDIS_HOST, REDIS_PORT);
+  // Without connections of its own the pool hands out the mocked service to the APIs checking one out
+  iri_pool_init(&service, NULL, 0, 0, 0, 0, 0, 0);
   ::testing::GTEST_FLAG(throw_on_failure) = true;
   ::testing::InitGoogleMock(&argc, argv);
   return RUN_ALL_TESTS();
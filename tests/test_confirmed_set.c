@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "test_define.h"
+#include "utils/confirmed_set.h"
+
+#define TEST_HASH_NUM 3
+
+static hash243_queue_t hashes = NULL;
+
+static void check_confirmed(bool const* const expected) {
+  bool confirmed[TEST_HASH_NUM];
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_find(hashes, confirmed));
+  for (int i = 0; i < TEST_HASH_NUM; i++) {
+    TEST_ASSERT_EQUAL(expected[i], confirmed[i]);
+  }
+}
+
+void test_confirmed_set_add(void) {
+  const bool none[TEST_HASH_NUM] = {false, false, false};
+  const bool some[TEST_HASH_NUM] = {true, false, true};
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_init(TEST_HASH_NUM));
+  check_confirmed(none);
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_add(hashes, some));
+  check_confirmed(some);
+  // Adding them again changes nothing
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_add(hashes, some));
+  check_confirmed(some);
+  confirmed_set_destroy();
+}
+
+void test_confirmed_set_evict(void) {
+  const bool all[TEST_HASH_NUM] = {true, true, true};
+  const bool last[TEST_HASH_NUM] = {false, true, true};
+
+  // Without the cache, the oldest transaction is forgotten once memory is full
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_init(TEST_HASH_NUM - 1));
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_add(hashes, NULL));
+  check_confirmed(last);
+  confirmed_set_destroy();
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_init(TEST_HASH_NUM));
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_add(hashes, NULL));
+  check_confirmed(all);
+  confirmed_set_destroy();
+}
+
+void test_confirmed_set_without_memory(void) {
+  const bool none[TEST_HASH_NUM] = {false, false, false};
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_init(0));
+  TEST_ASSERT_EQUAL_INT(SC_OK, confirmed_set_add(hashes, NULL));
+  check_confirmed(none);
+  confirmed_set_destroy();
+}
+
+int main(void) {
+  char const* const trytes[TEST_HASH_NUM] = {TRYTES_81_1, TRYTES_81_2, TRYTES_81_3};
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  UNITY_BEGIN();
+
+  cache_init(false, NULL, 0);
+  for (int i = 0; i < TEST_HASH_NUM; i++) {
+    flex_trits_from_trytes(hash, NUM_TRITS_HASH, (tryte_t const*)trytes[i], NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+    hash243_queue_push(&hashes, hash);
+  }
+
+  RUN_TEST(test_confirmed_set_add);
+  RUN_TEST(test_confirmed_set_evict);
+  RUN_TEST(test_confirmed_set_without_memory);
+
+  hash243_queue_free(&hashes);
+  return UNITY_END();
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "test_define.h"
+#include "utils/hash243_vector.h"
+
+#define TEST_HASH_NUM 100
+
+static void hash_fill(flex_trit_t* const hash, const int seed) { memset(hash, seed % 27 - 13, FLEX_TRIT_SIZE_243); }
+
+static void push_hashes(hash243_vector_t* const vec) {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  for (int i = 0; i < TEST_HASH_NUM; i++) {
+    hash_fill(hash, i);
+    TEST_ASSERT_EQUAL_INT(SC_OK, hash243_vector_push(vec, hash));
+  }
+}
+
+static void check_hashes(hash243_vector_t const* const vec) {
+  flex_trit_t expected[FLEX_TRIT_SIZE_243];
+  flex_trit_t const* hash = NULL;
+  int i = 0;
+
+  TEST_ASSERT_EQUAL_INT(TEST_HASH_NUM, hash243_vector_count(vec));
+  HASH243_VECTOR_FOREACH(vec, hash) {
+    hash_fill(expected, i);
+    TEST_ASSERT_EQUAL_MEMORY(expected, hash, FLEX_TRIT_SIZE_243);
+    TEST_ASSERT_EQUAL_PTR(hash, hash243_vector_at(vec, i));
+    i++;
+  }
+  TEST_ASSERT_EQUAL_INT(TEST_HASH_NUM, i);
+  TEST_ASSERT_NULL(hash243_vector_at(vec, TEST_HASH_NUM));
+}
+
+void test_push(void) {
+  hash243_vector_t vec;
+  flex_trit_t const* hash = NULL;
+
+  hash243_vector_init(&vec, NULL);
+  HASH243_VECTOR_FOREACH(&vec, hash) { TEST_FAIL(); }
+  push_hashes(&vec);
+  check_hashes(&vec);
+  hash243_vector_free(&vec);
+  TEST_ASSERT_EQUAL_INT(0, hash243_vector_count(&vec));
+}
+
+void test_push_arena(void) {
+  arena_t arena;
+  hash243_vector_t vec;
+
+  arena_init(&arena, NULL, 0);
+  hash243_vector_init(&vec, &arena);
+  TEST_ASSERT_EQUAL_INT(SC_OK, hash243_vector_reserve(&vec, TEST_HASH_NUM));
+  flex_trit_t* hashes = vec.hashes;
+  push_hashes(&vec);
+  // The reserved room is enough, the hashes never moved
+  TEST_ASSERT_EQUAL_PTR(hashes, vec.hashes);
+  check_hashes(&vec);
+  hash243_vector_free(&vec);
+  arena_reset(&arena);
+}
+
+void test_queue_adapters(void) {
+  arena_t arena;
+  hash243_vector_t vec, copy;
+  hash243_queue_t queue = NULL;
+  hash243_queue_entry_t* q_iter = NULL;
+  int i = 0;
+
+  arena_init(&arena, NULL, 0);
+  hash243_vector_init(&vec, NULL);
+  hash243_vector_init(&copy, &arena);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, hash243_vector_to_queue(&vec, &arena, &queue));
+  TEST_ASSERT_NULL(queue);
+
+  push_hashes(&vec);
+  TEST_ASSERT_EQUAL_INT(SC_OK, hash243_vector_to_queue(&vec, &arena, &queue));
+  TEST_ASSERT_EQUAL_INT(TEST_HASH_NUM, hash243_queue_count(queue));
+  CDL_FOREACH(queue, q_iter) {
+    TEST_ASSERT_EQUAL_MEMORY(hash243_vector_at(&vec, i), q_iter->hash, FLEX_TRIT_SIZE_243);
+    i++;
+  }
+  TEST_ASSERT_EQUAL_INT(TEST_HASH_NUM, i);
+  TEST_ASSERT_EQUAL_PTR(queue->prev, &queue[TEST_HASH_NUM - 1]);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, hash243_vector_append_queue(&copy, queue));
+  check_hashes(&copy);
+
+  hash243_vector_free(&vec);
+  arena_reset(&arena);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_push);
+  RUN_TEST(test_push_arena);
+  RUN_TEST(test_queue_adapters);
+  return UNITY_END();
+}
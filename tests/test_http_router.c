@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "accelerator/http_router.h"
+#include "test_define.h"
+
+// Routes of the HTTP API, and a route of each parameter type
+enum {
+  ROUTE_ADDRESS,
+  ROUTE_TXN_HASH,
+  ROUTE_TXN_OBJ,
+  ROUTE_TIPS_PAIR,
+  ROUTE_TIPS,
+  ROUTE_TXN,
+  ROUTE_RECV_MAM,
+  ROUTE_SEND_MAM,
+  ROUTE_TRYTE,
+  ROUTE_TAG_HASHES,
+  ROUTE_TAG_LATEST,
+  ROUTE_NUM
+};
+
+static char const* const route_patterns[ROUTE_NUM] = {
+    [ROUTE_ADDRESS] = "/address",
+    [ROUTE_TXN_HASH] = "/transaction/hash",
+    [ROUTE_TXN_OBJ] = "/transaction/object",
+    [ROUTE_TIPS_PAIR] = "/tips/pair",
+    [ROUTE_TIPS] = "/tips",
+    [ROUTE_TXN] = "/transaction",
+    [ROUTE_RECV_MAM] = "/mam/{hash}",
+    [ROUTE_SEND_MAM] = "/mam",
+    [ROUTE_TRYTE] = "/tryte",
+    [ROUTE_TAG_HASHES] = "/tag/{tag}/hashes",
+    [ROUTE_TAG_LATEST] = "/tag/latest/hashes",
+};
+
+static http_router_t router;
+
+static void check_route(char const* const url, const int route) {
+  http_route_match_t match;
+  TEST_ASSERT_EQUAL_INT(SC_OK, http_router_match(&router, url, &match));
+  TEST_ASSERT_EQUAL_INT(route, match.route);
+}
+
+static void check_no_route(char const* const url) {
+  http_route_match_t match;
+  TEST_ASSERT_EQUAL_INT(SC_HTTP_URL_NOT_MATCH, http_router_match(&router, url, &match));
+  TEST_ASSERT_EQUAL_INT(HTTP_ROUTE_NONE, match.route);
+  TEST_ASSERT_EQUAL_INT(0, match.num_params);
+}
+
+void test_literal_routes(void) {
+  for (int route = 0; route < ROUTE_NUM; route++) {
+    if (strchr(route_patterns[route], '{') == NULL) {
+      check_route(route_patterns[route], route);
+    }
+  }
+  // Empty segments are skipped
+  check_route("/tips/", ROUTE_TIPS);
+  check_route("//tips//pair", ROUTE_TIPS_PAIR);
+
+  check_no_route("/");
+  check_no_route("");
+  check_no_route("/tip");
+  check_no_route("/tipsx");
+  check_no_route("/TIPS");
+  check_no_route("/transaction/hash/extra");
+  check_no_route("/unknown/tips");
+}
+
+void test_hash_param(void) {
+  http_route_match_t match;
+  char const* url = "/mam/" TRYTES_81_1;
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, http_router_match(&router, url, &match));
+  TEST_ASSERT_EQUAL_INT(ROUTE_RECV_MAM, match.route);
+  TEST_ASSERT_EQUAL_INT(1, match.num_params);
+  TEST_ASSERT_EQUAL_PTR(url + strlen("/mam/"), match.params[0].value);
+  TEST_ASSERT_EQUAL_INT(NUM_TRYTES_HASH, match.params[0].len);
+  check_route("/mam/" TRYTES_81_1 "/", ROUTE_RECV_MAM);
+
+  // Only 81 trytes are a hash
+  check_no_route("/mam/" TAG_MSG);
+  check_no_route("/mam/" TRYTES_81_1 "9");
+  check_no_route("/mam/" TRYTES_81_1 "/" TRYTES_81_2);
+  char lower[] = "/mam/" TRYTES_81_1;
+  lower[10] = 'a';
+  check_no_route(lower);
+}
+
+void test_tag_param(void) {
+  http_route_match_t match;
+  char const* url = "/tag/" TAG_MSG "/hashes";
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, http_router_match(&router, url, &match));
+  TEST_ASSERT_EQUAL_INT(ROUTE_TAG_HASHES, match.route);
+  TEST_ASSERT_EQUAL_INT(1, match.num_params);
+  TEST_ASSERT_EQUAL_MEMORY(TAG_MSG, match.params[0].value, TAG_MSG_LEN);
+  TEST_ASSERT_EQUAL_INT(TAG_MSG_LEN, match.params[0].len);
+  check_route("/tag/A/hashes", ROUTE_TAG_HASHES);
+
+  // The literal segment is preferred, other tags still match the parameter
+  check_route("/tag/latest/hashes", ROUTE_TAG_LATEST);
+  check_route("/tag/LATEST/hashes", ROUTE_TAG_HASHES);
+
+  check_no_route("/tag/" TAG_MSG "9/hashes");
+  check_no_route("/tag/" TAG_MSG);
+  check_no_route("/tag/TANGLE-ACCELERATOR/hashes");
+}
+
+void test_invalid_patterns(void) {
+  TEST_ASSERT_EQUAL_INT(SC_HTTP_INVALID_ROUTE, http_router_add(&router, "/tips", ROUTE_NUM));
+  TEST_ASSERT_EQUAL_INT(SC_HTTP_INVALID_ROUTE, http_router_add(&router, "/mam/{hash}/", ROUTE_NUM));
+  TEST_ASSERT_EQUAL_INT(SC_HTTP_INVALID_ROUTE, http_router_add(&router, "/bundle/{bundle}", ROUTE_NUM));
+  TEST_ASSERT_EQUAL_INT(SC_HTTP_INVALID_ROUTE, http_router_add(&router, "tips", ROUTE_NUM));
+  TEST_ASSERT_EQUAL_INT(SC_HTTP_INVALID_ROUTE, http_router_add(&router, "/bundle", HTTP_ROUTE_NONE));
+  TEST_ASSERT_EQUAL_INT(SC_HTTP_INVALID_ROUTE,
+                        http_router_add(&router, "/{tag}/{tag}/{tag}/{tag}/{tag}", ROUTE_NUM));
+
+  // Failed patterns left the registered routes as they were
+  check_route("/mam/" TRYTES_81_1, ROUTE_RECV_MAM);
+  check_no_route("/mam/" TRYTES_81_1 "/" TAG_MSG);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  if (http_router_init(&router) != SC_OK) {
+    return EXIT_FAILURE;
+  }
+  for (int route = 0; route < ROUTE_NUM; route++) {
+    if (http_router_add(&router, route_patterns[route], route) != SC_OK) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  RUN_TEST(test_literal_routes);
+  RUN_TEST(test_hash_param);
+  RUN_TEST(test_tag_param);
+  RUN_TEST(test_invalid_patterns);
+
+  http_router_free(&router);
+  return UNITY_END();
+}
@@ -0,0 +1,427 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "test_define.h"
+#include "utils/iri_pool.h"
+#include "utils/time.h"
+
+#define TEST_POOL_SIZE 2
+#define TEST_STUB_PORT 14290
+#define TEST_STUB_SLOW_MS 300
+#define TEST_BREAKER_COOLDOWN_MS 200
+#define TEST_STUB_BUF_SIZE 4096
+#define TEST_STUB_HASH_SLOW "SLOW99999999999999999999999999999999999999999999999999999999999999999999999999999"
+#define TEST_STUB_HASH_FAST "FAST99999999999999999999999999999999999999999999999999999999999999999999999999999"
+
+/** Local IRI node, answering findTransactions with a hash of its own after a delay set by the tests */
+typedef struct stub_node_s {
+  int port;
+  char const* hash;
+  int delay_ms;
+  int answered; /**< findTransactions calls answered */
+  bool down;    /**< Connections are closed without an answer */
+} stub_node_t;
+
+typedef struct stub_conn_s {
+  stub_node_t* node;
+  int fd;
+} stub_conn_t;
+
+static iota_client_service_t service;
+static stub_node_t stub_nodes[2] = {{TEST_STUB_PORT, TEST_STUB_HASH_SLOW, 0, 0, false},
+                                    {TEST_STUB_PORT + 1, TEST_STUB_HASH_FAST, 0, 0, false}};
+static pthread_mutex_t stub_lock = PTHREAD_MUTEX_INITIALIZER;
+static char const stub_node_info[] =
+    "{\"appName\":\"IRI\",\"appVersion\":\"1.8.6\",\"latestMilestone\":\"" TEST_STUB_HASH_FAST
+    "\",\"latestMilestoneIndex\":1000,\"latestSolidSubtangleMilestone\":\"" TEST_STUB_HASH_FAST
+    "\",\"latestSolidSubtangleMilestoneIndex\":1000,\"milestoneStartIndex\":0,\"neighbors\":0,\"packetsQueueSize\":0,"
+    "\"time\":0,\"tips\":1,\"transactionsToRequest\":0,\"features\":[],\"coordinatorAddress\":\"" TEST_STUB_HASH_FAST
+    "\",\"duration\":0}";
+
+/** Answer the request of a connection and close it like IRI, health checks right away */
+static void* stub_node_conn(void* arg) {
+  stub_conn_t* conn = arg;
+  char buf[TEST_STUB_BUF_SIZE], body[TEST_STUB_BUF_SIZE], response[TEST_STUB_BUF_SIZE];
+  size_t len = 0;
+
+  while (len < sizeof(buf) - 1) {
+    ssize_t got = recv(conn->fd, buf + len, sizeof(buf) - 1 - len, 0);
+    if (got <= 0) {
+      break;
+    }
+    len += got;
+    buf[len] = '\0';
+    char const* end = strstr(buf, "\r\n\r\n");
+    char const* field = strcasestr(buf, "Content-Length:");
+    if (end && (field == NULL || len >= (end - buf) + 4 + strtoul(field + strlen("Content-Length:"), NULL, 10))) {
+      break;
+    }
+  }
+
+  pthread_mutex_lock(&stub_lock);
+  bool down = conn->node->down;
+  pthread_mutex_unlock(&stub_lock);
+  if (down) {
+    close(conn->fd);
+    free(conn);
+    return NULL;
+  }
+
+  if (len > 0 && strstr(buf, "getNodeInfo")) {
+    snprintf(body, sizeof(body), "%s", stub_node_info);
+  } else {
+    pthread_mutex_lock(&stub_lock);
+    int delay_ms = conn->node->delay_ms;
+    pthread_mutex_unlock(&stub_lock);
+    usleep(delay_ms * 1000);
+    snprintf(body, sizeof(body), "{\"hashes\":[\"%s\"],\"duration\":0}", conn->node->hash);
+    // Counted before the answer is sent, so that a call is counted once its caller has the answer
+    pthread_mutex_lock(&stub_lock);
+    conn->node->answered++;
+    pthread_mutex_unlock(&stub_lock);
+  }
+  int response_len = snprintf(response, sizeof(response),
+                              "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n"
+                              "Connection: close\r\n\r\n%s",
+                              strlen(body), body);
+  send(conn->fd, response, response_len, 0);
+  close(conn->fd);
+  free(conn);
+  return NULL;
+}
+
+static void* stub_node_listen(void* arg) {
+  stub_node_t* node = arg;
+  struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(node->port)};
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0), one = 1;
+
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  if (listen_fd < 0 || bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, 64) != 0) {
+    perror("stub IRI node");
+    return NULL;
+  }
+  for (;;) {
+    stub_conn_t* conn = malloc(sizeof(stub_conn_t));
+    pthread_t thread;
+    if (conn == NULL || (conn->fd = accept(listen_fd, NULL, NULL)) < 0) {
+      free(conn);
+      continue;
+    }
+    conn->node = node;
+    if (pthread_create(&thread, NULL, stub_node_conn, conn) != 0) {
+      close(conn->fd);
+      free(conn);
+      continue;
+    }
+    pthread_detach(thread);
+  }
+  return NULL;
+}
+
+static void stub_node_set_delay(stub_node_t* const node, const int delay_ms) {
+  pthread_mutex_lock(&stub_lock);
+  node->delay_ms = delay_ms;
+  pthread_mutex_unlock(&stub_lock);
+}
+
+static void stub_node_set_down(stub_node_t* const node, const bool down) {
+  pthread_mutex_lock(&stub_lock);
+  node->down = down;
+  pthread_mutex_unlock(&stub_lock);
+}
+
+static int stub_node_answered(stub_node_t* const node) {
+  pthread_mutex_lock(&stub_lock);
+  int answered = node->answered;
+  pthread_mutex_unlock(&stub_lock);
+  return answered;
+}
+
+/**
+ * Pool of TEST_POOL_SIZE connections to each stub node, with enough findTransactions calls answered right away by the
+ * first node for the latency to hedge after to be known. Returns a connection to the first node, the others are idle.
+ */
+static iota_client_service_t* stub_pool_init(const uint8_t hedge_budget, find_transactions_req_t* const req) {
+  iota_client_service_t* slow = NULL;
+  iota_client_service_t* conns[2 * TEST_POOL_SIZE];
+  iota_client_service_t stub = service;
+  stub.http.host = "127.0.0.1";
+  stub.http.port = stub_nodes[0].port;
+  char nodes[32];
+  snprintf(nodes, sizeof(nodes), "127.0.0.1:%d", stub_nodes[1].port);
+
+  stub_node_set_delay(&stub_nodes[0], 0);
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_init(&stub, nodes, TEST_POOL_SIZE, 0, hedge_budget, 0, 0, 0));
+  for (int i = 0; i < 2 * TEST_POOL_SIZE; i++) {
+    conns[i] = iri_pool_acquire();
+    if (slow == NULL && conns[i]->http.port == stub_nodes[0].port) {
+      slow = conns[i];
+    }
+  }
+  TEST_ASSERT_NOT_NULL(slow);
+  for (int i = 0; i < 2 * TEST_POOL_SIZE; i++) {
+    if (conns[i] != slow) {
+      iri_pool_release(conns[i]);
+    }
+  }
+
+  for (int i = 0; i < 32; i++) {
+    find_transactions_res_t* res = find_transactions_res_new();
+    TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_find_transactions(slow, req, res));
+    find_transactions_res_free(&res);
+  }
+  return slow;
+}
+
+/**
+ * Send findTransactions and check the node whose answer was taken
+ */
+static uint64_t stub_find_transactions(iota_client_service_t* const conn, find_transactions_req_t* const req,
+                                       char const* const hash) {
+  tryte_t trytes[NUM_TRYTES_HASH + 1] = {};
+  find_transactions_res_t* res = find_transactions_res_new();
+  uint64_t start = current_timestamp_ms();
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_find_transactions(conn, req, res));
+  uint64_t latency_ms = current_timestamp_ms() - start;
+  TEST_ASSERT_EQUAL_INT(1, hash243_queue_count(res->hashes));
+  flex_trits_to_trytes(trytes, NUM_TRYTES_HASH, hash243_queue_peek(res->hashes), NUM_TRITS_HASH, NUM_TRITS_HASH);
+  TEST_ASSERT_EQUAL_STRING(hash, (char*)trytes);
+  find_transactions_res_free(&res);
+  return latency_ms;
+}
+
+void test_iri_pool_acquire(void) {
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_init(&service, NULL, TEST_POOL_SIZE, 0, 0, 0, 0, 0));
+
+  iota_client_service_t* first = iri_pool_acquire();
+  iota_client_service_t* second = iri_pool_acquire();
+  TEST_ASSERT_NOT_NULL(first);
+  TEST_ASSERT_NOT_NULL(second);
+  TEST_ASSERT_TRUE(first != second);
+  TEST_ASSERT_TRUE(first != &service);
+  TEST_ASSERT_EQUAL_STRING(service.http.host, first->http.host);
+  TEST_ASSERT_EQUAL_UINT16(service.http.port, second->http.port);
+
+  // A returned connection is checked out again
+  iri_pool_release(first);
+  TEST_ASSERT_EQUAL_PTR(first, iri_pool_acquire());
+
+  // Without an idle connection the check out gives up instead of waiting
+  TEST_ASSERT_NULL(iri_pool_try_acquire());
+  iri_pool_release(second);
+  TEST_ASSERT_EQUAL_PTR(second, iri_pool_try_acquire());
+
+  iri_pool_release(first);
+  iri_pool_release(second);
+  iri_pool_destroy();
+}
+
+void test_iri_pool_shared(void) {
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_init(&service, NULL, 0, 0, 0, 0, 0, 0));
+
+  // Without connections every request shares the service
+  TEST_ASSERT_EQUAL_PTR(&service, iri_pool_acquire());
+  TEST_ASSERT_EQUAL_PTR(&service, iri_pool_acquire());
+  TEST_ASSERT_NULL(iri_pool_try_acquire());
+  iri_pool_release(&service);
+  iri_pool_release(&service);
+  iri_pool_destroy();
+}
+
+void test_iri_pool_nodes(void) {
+  // Nothing listens on these ports, so the nodes are all out of rotation and all of them are used
+  iota_client_service_t unreachable = service;
+  unreachable.http.host = "127.0.0.1";
+  unreachable.http.port = 1;
+  iota_client_service_t* conns[3];
+  bool seen[3] = {false, false, false};
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_init(&unreachable, "127.0.0.1:2,,127.0.0.1:3", 1, 0, 0, 0, 0, 0));
+  for (int i = 0; i < 3; i++) {
+    conns[i] = iri_pool_acquire();
+    TEST_ASSERT_EQUAL_STRING("127.0.0.1", conns[i]->http.host);
+    TEST_ASSERT_TRUE(conns[i]->http.port >= 1 && conns[i]->http.port <= 3);
+    seen[conns[i]->http.port - 1] = true;
+  }
+  // One connection to each node
+  TEST_ASSERT_TRUE(seen[0] && seen[1] && seen[2]);
+  for (int i = 0; i < 3; i++) {
+    iri_pool_release(conns[i]);
+  }
+  iri_pool_destroy();
+}
+
+void test_iri_pool_invalid_nodes(void) {
+  TEST_ASSERT_EQUAL_INT(SC_CONF_PARSER_ERROR, iri_pool_init(&service, "localhost", 1, 0, 0, 0, 0, 0));
+  TEST_ASSERT_EQUAL_INT(SC_CONF_PARSER_ERROR, iri_pool_init(&service, "localhost:14265,:14266", 1, 0, 0, 0, 0, 0));
+  TEST_ASSERT_EQUAL_INT(SC_CONF_PARSER_ERROR, iri_pool_init(&service, "localhost:port", 1, 0, 0, 0, 0, 0));
+}
+
+void test_iri_pool_read_failed(void) {
+  iota_client_service_t unreachable = service;
+  unreachable.http.host = "127.0.0.1";
+  unreachable.http.port = 1;
+  find_transactions_req_t* req = find_transactions_req_new();
+  find_transactions_res_t* res = find_transactions_res_new();
+  flex_trit_t hash[FLEX_TRIT_SIZE_243] = {};
+  hash243_queue_push(&req->addresses, hash);
+
+  // Hedging allowed on every call, calls to unreachable nodes still fail instead of waiting for an answer
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_init(&unreachable, "127.0.0.1:2", TEST_POOL_SIZE, 0, 100, 0, 0, 0));
+  iota_client_service_t* conn = iri_pool_acquire();
+  for (int i = 0; i < 64; i++) {
+    TEST_ASSERT_EQUAL_INT(SC_CCLIENT_FAILED_RESPONSE, iri_pool_find_transactions(conn, req, res));
+  }
+  TEST_ASSERT_EQUAL_INT(0, hash243_queue_count(res->hashes));
+  iri_pool_release(conn);
+  iri_pool_destroy();
+
+  find_transactions_req_free(&req);
+  find_transactions_res_free(&res);
+}
+
+void test_iri_pool_hedge(void) {
+  iota_client_service_t* conns[2 * TEST_POOL_SIZE - 1];
+  find_transactions_req_t* req = find_transactions_req_new();
+  flex_trit_t hash[FLEX_TRIT_SIZE_243] = {};
+  hash243_queue_push(&req->addresses, hash);
+
+  // Hedging allowed on every call, the first node turns slow once the latency of its calls is known
+  iota_client_service_t* slow = stub_pool_init(100, req);
+  stub_node_set_delay(&stub_nodes[0], TEST_STUB_SLOW_MS);
+  int answered = stub_node_answered(&stub_nodes[0]);
+
+  // The answer of the hedge is handed to the caller without waiting for the first node
+  TEST_ASSERT_TRUE(stub_find_transactions(slow, req, TEST_STUB_HASH_FAST) < TEST_STUB_SLOW_MS);
+  TEST_ASSERT_EQUAL_INT(answered, stub_node_answered(&stub_nodes[0]));
+
+  // The call which lost holds its connection to the first node until it is answered, so the last acquire waits for it
+  for (int i = 0; i < 2 * TEST_POOL_SIZE - 1; i++) {
+    conns[i] = iri_pool_acquire();
+  }
+  TEST_ASSERT_EQUAL_INT(answered + 1, stub_node_answered(&stub_nodes[0]));
+  for (int i = 0; i < 2 * TEST_POOL_SIZE - 1; i++) {
+    iri_pool_release(conns[i]);
+  }
+  iri_pool_release(slow);
+  iri_pool_destroy();
+
+  find_transactions_req_free(&req);
+}
+
+void test_iri_pool_hedge_budget(void) {
+  find_transactions_req_t* req = find_transactions_req_new();
+  flex_trit_t hash[FLEX_TRIT_SIZE_243] = {};
+  hash243_queue_push(&req->addresses, hash);
+
+  // The 32 calls recording latencies earn 1.6 hedges out of a 5% budget
+  iota_client_service_t* slow = stub_pool_init(5, req);
+  stub_node_set_delay(&stub_nodes[0], TEST_STUB_SLOW_MS);
+
+  // The first slow call spends the hedge, and the next one waits for the first node
+  TEST_ASSERT_TRUE(stub_find_transactions(slow, req, TEST_STUB_HASH_FAST) < TEST_STUB_SLOW_MS);
+  TEST_ASSERT_TRUE(stub_find_transactions(slow, req, TEST_STUB_HASH_SLOW) >= TEST_STUB_SLOW_MS);
+
+  iri_pool_release(slow);
+  iri_pool_destroy();
+
+  find_transactions_req_free(&req);
+}
+
+void test_iri_pool_breaker(void) {
+  iota_client_service_t unreachable = service;
+  unreachable.http.host = "127.0.0.1";
+  unreachable.http.port = 1;
+  get_tips_res_t* res = get_tips_res_new();
+
+  // Half of the calls failing trips the breaker, once enough calls were seen
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_init(&unreachable, NULL, 1, 0, 0, 50, 0, 10000));
+  iota_client_service_t* conn = iri_pool_acquire();
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_check(conn));
+  for (int i = 0; i < 10; i++) {
+    TEST_ASSERT_EQUAL_INT(SC_CCLIENT_FAILED_RESPONSE, iri_pool_get_tips(conn, res));
+  }
+  // Then calls fail fast, including the ones of the extended API, until the cooldown is over
+  TEST_ASSERT_EQUAL_INT(SC_CCLIENT_IRI_UNAVAILABLE, iri_pool_get_tips(conn, res));
+  TEST_ASSERT_EQUAL_INT(SC_CCLIENT_IRI_UNAVAILABLE, iri_pool_check(conn));
+  TEST_ASSERT_EQUAL_UINT32(10, iri_pool_retry_after());
+  iri_pool_release(conn);
+  iri_pool_destroy();
+
+  get_tips_res_free(&res);
+}
+
+void test_iri_pool_breaker_check(void) {
+  iota_client_service_t stub = service;
+  stub.http.host = "127.0.0.1";
+  stub.http.port = stub_nodes[0].port;
+  get_tips_res_t* res = get_tips_res_new();
+
+  // A single node is never health-checked, so its breaker only recovers through the calls of the requests
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_init(&stub, NULL, 1, 0, 0, 50, 0, TEST_BREAKER_COOLDOWN_MS));
+  iota_client_service_t* conn = iri_pool_acquire();
+  TEST_ASSERT_EQUAL_UINT32(1, iri_pool_retry_after());
+  stub_node_set_down(&stub_nodes[0], true);
+  for (int i = 0; i < 10; i++) {
+    TEST_ASSERT_EQUAL_INT(SC_CCLIENT_FAILED_RESPONSE, iri_pool_get_tips(conn, res));
+  }
+  TEST_ASSERT_EQUAL_INT(SC_CCLIENT_IRI_UNAVAILABLE, iri_pool_check(conn));
+
+  // Once the cooldown is over, a check probes the node, which is still down and trips the breaker again
+  usleep(TEST_BREAKER_COOLDOWN_MS * 1000);
+  TEST_ASSERT_EQUAL_INT(SC_CCLIENT_IRI_UNAVAILABLE, iri_pool_check(conn));
+  TEST_ASSERT_EQUAL_INT(SC_CCLIENT_IRI_UNAVAILABLE, iri_pool_check(conn));
+
+  // The next probe after the node is back closes the breaker, without any other call
+  stub_node_set_down(&stub_nodes[0], false);
+  usleep(TEST_BREAKER_COOLDOWN_MS * 1000);
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_check(conn));
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_check(conn));
+  TEST_ASSERT_EQUAL_INT(SC_OK, iri_pool_get_tips(conn, res));
+  iri_pool_release(conn);
+  iri_pool_destroy();
+
+  get_tips_res_free(&res);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  service.http.path = "/";
+  service.http.content_type = "application/json";
+  service.http.accept = "application/json";
+  service.http.host = IRI_HOST;
+  service.http.port = IRI_PORT;
+  service.http.api_version = 1;
+  service.serializer_type = SR_JSON;
+  for (int i = 0; i < 2; i++) {
+    pthread_t thread;
+    pthread_create(&thread, NULL, stub_node_listen, &stub_nodes[i]);
+    pthread_detach(thread);
+  }
+
+  RUN_TEST(test_iri_pool_acquire);
+  RUN_TEST(test_iri_pool_shared);
+  RUN_TEST(test_iri_pool_nodes);
+  RUN_TEST(test_iri_pool_invalid_nodes);
+  RUN_TEST(test_iri_pool_read_failed);
+  RUN_TEST(test_iri_pool_hedge);
+  RUN_TEST(test_iri_pool_hedge_budget);
+  RUN_TEST(test_iri_pool_breaker);
+  RUN_TEST(test_iri_pool_breaker_check);
+
+  return UNITY_END();
+}
@@ -22,17 +22,17 @@ void test_get_column_from_edgeTable(CassSession* session) {
       {TRANSACTION_6},  // approvees T7
       {TRANSACTION_5}   // approvees T7
   };
-  hash243_queue_t res_hash = NULL;
-  hash243_queue_entry_t* iter243 = NULL;
+  hash243_vector_t res_hash;
+  flex_trit_t const* hash = NULL;
+  hash243_vector_init(&res_hash, NULL);
   get_column_from_edgeTable(session, &res_hash, (cass_byte_t*)ADDRESS_2, "bundle");
   get_column_from_edgeTable(session, &res_hash, (cass_byte_t*)ADDRESS_1, "bundle");
   get_column_from_edgeTable(session, &res_hash, (cass_byte_t*)TRANSACTION_7, "hash");
   size_t idx = 0;
-  CDL_FOREACH(res_hash, iter243) {
-    TEST_ASSERT_EQUAL_MEMORY(iter243->hash, (flex_trit_t*)expected_result[idx++],
-                             sizeof(flex_trit_t) * FLEX_TRIT_SIZE_243);
+  HASH243_VECTOR_FOREACH(&res_hash, hash) {
+    TEST_ASSERT_EQUAL_MEMORY(hash, (flex_trit_t*)expected_result[idx++], sizeof(flex_trit_t) * FLEX_TRIT_SIZE_243);
   }
-  hash243_queue_free(&res_hash);
+  hash243_vector_free(&res_hash);
   TEST_ASSERT_EQUAL_INT(idx, sizeof(expected_result) / (sizeof(char) * FLEX_TRIT_SIZE_243));
 }
 
@@ -53,8 +53,8 @@ void test_get_transactions(CassSession* session) {
       {TRANSACTION_5}   // approvees T7
   };
 
-  hash243_queue_t transactions = NULL;
-  hash243_queue_entry_t* iter243 = NULL;
+  hash243_vector_t transactions;
+  flex_trit_t const* hash = NULL;
   hash243_queue_t bundles = NULL;
   hash243_queue_t addresses = NULL;
   hash243_queue_t approvees = NULL;
@@ -67,18 +67,19 @@ void test_get_transactions(CassSession* session) {
   hash243_queue_push(&approvees, (flex_trit_t const* const)TRANSACTION_6);
   hash243_queue_push(&approvees, (flex_trit_t const* const)TRANSACTION_7);
 
+  hash243_vector_init(&transactions, NULL);
   get_transactions(session, &transactions, bundles, addresses, approvees);
 
   size_t idx = 0;
-  CDL_FOREACH(transactions, iter243) {
-    TEST_ASSERT_EQUAL_MEMORY(iter243->hash, (flex_trit_t*)expected_response_transactions[idx++],
+  HASH243_VECTOR_FOREACH(&transactions, hash) {
+    TEST_ASSERT_EQUAL_MEMORY(hash, (flex_trit_t*)expected_response_transactions[idx++],
                              sizeof(flex_trit_t) * NUM_FLEX_TRITS_HASH);
   }
   TEST_ASSERT_EQUAL_INT(idx, sizeof(expected_response_transactions) / (sizeof(char) * NUM_FLEX_TRITS_HASH));
   hash243_queue_free(&bundles);
   hash243_queue_free(&addresses);
   hash243_queue_free(&approvees);
-  hash243_queue_free(&transactions);
+  hash243_vector_free(&transactions);
 }
 
 void test_scylla(void) {
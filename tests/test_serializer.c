@@ -6,8 +6,13 @@
  * "LICENSE" at the root of this distribution.
  */
 
+#include <limits.h>
+#include "serializer/cbor_writer.h"
+#include "serializer/json_tokenizer.h"
+#include "serializer/json_writer.h"
 #include "serializer/serializer.h"
 #include "test_define.h"
+#include "utils/trinary_kernels.h"
 
 void test_serialize_ta_generate_address(void) {
   const char* json = "[\"" TRYTES_81_1 "\",\"" TRYTES_81_2 "\"]";
@@ -131,8 +136,8 @@ void test_serialize_ta_find_transactions_by_tag(void) {
   flex_trits_from_trytes(hash_trits_1, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
   flex_trits_from_trytes(hash_trits_2, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_2, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
 
-  hash243_queue_push(&res->hashes, hash_trits_1);
-  hash243_queue_push(&res->hashes, hash_trits_2);
+  hash243_vector_push(&res->hashes, hash_trits_1);
+  hash243_vector_push(&res->hashes, hash_trits_2);
 
   ta_find_transactions_by_tag_res_serialize(res, &json_result);
 
@@ -275,6 +280,20 @@ void test_deserialize_ta_send_trytes_req(void) {
   hash_array_free(out_trytes);
 }
 
+void test_deserialize_ta_send_trytes_req_invalid(void) {
+  char trytes[NUM_TRYTES_SERIALIZED_TRANSACTION + 1] = TRYTES_2673_1;
+  char json[NUM_TRYTES_SERIALIZED_TRANSACTION + 16];
+  hash8019_array_p out_trytes = hash8019_array_new();
+
+  // A lowercase character in the middle of otherwise valid trytes
+  trytes[NUM_TRYTES_SERIALIZED_TRANSACTION / 2] = 'a';
+  snprintf(json, sizeof(json), "{\"trytes\":[\"%s\"]}", trytes);
+  TEST_ASSERT_EQUAL(SC_SERIALIZER_INVALID_REQ, ta_send_trytes_req_deserialize(json, out_trytes));
+  TEST_ASSERT_EQUAL(0, hash_array_len(out_trytes));
+
+  hash_array_free(out_trytes);
+}
+
 void test_serialize_ta_send_trytes_res(void) {
   const char* json = "{\"trytes\":[\"" TRYTES_2673_1 "\",\"" TRYTES_2673_2 "\"]}";
   char* json_result;
@@ -301,25 +320,688 @@ void test_mqtt_device_id_deserialize(void) {
   const char* json = "{\"device_id\":\"" DEVICE_ID "\", \"trytes\":[\"" TRYTES_2673_1 "\",\"" TRYTES_2673_2 "\"]}";
   const int id_len = 32;
   char device_id[id_len + 1];
-  TEST_ASSERT_EQUAL_INT(SC_OK, mqtt_device_id_deserialize(json, device_id));
+  TEST_ASSERT_EQUAL_INT(SC_OK, mqtt_device_id_deserialize(json, device_id, sizeof(device_id)));
 
   TEST_ASSERT_EQUAL_STRING(device_id, DEVICE_ID);
+
+  // The ID and its NUL must fit the buffer
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_JSON_PARSE, mqtt_device_id_deserialize(json, device_id, id_len));
 }
 
 void test_mqtt_tag_req_deserialize(void) {
   const char* json = "{\"device_id\":\"" DEVICE_ID "\", \"tag\":\"" TAG_MSG "\"}";
   char tag[NUM_TRYTES_TAG + 1];
-  TEST_ASSERT_EQUAL_INT(SC_OK, mqtt_tag_req_deserialize(json, tag));
+  TEST_ASSERT_EQUAL_INT(SC_OK, mqtt_tag_req_deserialize(json, tag, sizeof(tag)));
 
   TEST_ASSERT_EQUAL_STRING(tag, TAG_MSG);
 }
 
+void test_proxy_apis_command_req_deserialize(void) {
+  const char* json = "{\"command\":\"getTrytes\", \"hashes\":[\"" TRYTES_81_1 "\"]}";
+  char command[TA_PROXY_COMMAND_MAX_LEN + 1];
+  TEST_ASSERT_EQUAL_INT(SC_OK, proxy_apis_command_req_deserialize(json, command));
+  TEST_ASSERT_EQUAL_STRING("getTrytes", command);
+
+  // Missing, non-string and overlong commands
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, proxy_apis_command_req_deserialize("{\"hashes\":[]}", command));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, proxy_apis_command_req_deserialize("{\"command\":1}", command));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ,
+                        proxy_apis_command_req_deserialize("{\"command\":\"" TRYTES_81_1 "\"}", command));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_JSON_PARSE, proxy_apis_command_req_deserialize("{\"command\":", command));
+}
+
 void test_mqtt_transaction_hash_req_deserialize(void) {
   const char* json = "{\"device_id\":\"" DEVICE_ID "\", \"hash\":\"" TRYTES_81_1 "\"}";
   char hash[NUM_TRYTES_HASH + 1];
-  TEST_ASSERT_EQUAL_INT(SC_OK, mqtt_transaction_hash_req_deserialize(json, hash));
+  TEST_ASSERT_EQUAL_INT(SC_OK, mqtt_transaction_hash_req_deserialize(json, hash, sizeof(hash)));
 
   TEST_ASSERT_EQUAL_STRING(hash, TRYTES_81_1);
+
+  char tag[NUM_TRYTES_TAG + 1];
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_JSON_PARSE, mqtt_transaction_hash_req_deserialize(json, tag, sizeof(tag)));
+}
+
+void test_serialize_ta_send_transfer_res(void) {
+  char *json = NULL, *json_result = NULL;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+  transaction_array_t* res = transaction_array_new();
+  cJSON* json_root = cJSON_CreateObject();
+
+  flex_trits_from_trytes(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION, (const tryte_t*)TRYTES_2673_1,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t* txn = transaction_deserialize(tx_trits, true);
+  transaction_array_push_back(res, txn);
+
+  // The streaming writer must produce exactly what cJSON does
+  TEST_ASSERT_EQUAL_INT(SC_OK, iota_transaction_to_json_object(txn, TA_TXN_FIELDS_ALL, &json_root));
+  json = cJSON_PrintUnformatted(json_root);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_send_transfer_res_serialize(res, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+
+  cJSON_Delete(json_root);
+  transaction_array_free(res);
+  transaction_free(txn);
+  free(json);
+  free(json_result);
+}
+
+void test_json_writer(void) {
+  const char* json = "{\"message\":\"\\\"\\\\\\b\\f\\n\\r\\t\\u0001\",\"numbers\":[0,-1,2779530283277761,1e+15,0.1],"
+                     "\"empty\":[]}";
+  const char* message = "\"\\\b\f\n\r\t\x01";
+  json_writer_t writer;
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, json_writer_init(&writer, 1));
+  json_writer_begin_object(&writer);
+  json_writer_key(&writer, "message");
+  json_writer_string(&writer, message, strlen(message));
+  json_writer_key(&writer, "numbers");
+  json_writer_begin_array(&writer);
+  json_writer_int(&writer, 0);
+  json_writer_int(&writer, -1);
+  json_writer_int(&writer, 2779530283277761LL);
+  json_writer_int(&writer, 1000000000000000LL);
+  json_writer_number(&writer, 0.1);
+  json_writer_end_array(&writer);
+  json_writer_key(&writer, "empty");
+  json_writer_begin_array(&writer);
+  json_writer_end_array(&writer);
+  TEST_ASSERT_EQUAL_INT(SC_OK, json_writer_end_object(&writer));
+  TEST_ASSERT_EQUAL_STRING(json, writer.buf);
+
+  // The buffer is reused for the next document
+  json_writer_reset(&writer);
+  json_writer_begin_array(&writer);
+  json_writer_end_array(&writer);
+  TEST_ASSERT_EQUAL_STRING("[]", writer.buf);
+
+  // Serialized values are copied as they are
+  json_writer_reset(&writer);
+  json_writer_begin_array(&writer);
+  json_writer_raw(&writer, "{\"a\":1}", strlen("{\"a\":1}"));
+  json_writer_raw(&writer, "[]", strlen("[]"));
+  json_writer_end_array(&writer);
+  TEST_ASSERT_EQUAL_STRING("[{\"a\":1},[]]", writer.buf);
+  json_writer_free(&writer);
+}
+
+void test_cbor_writer(void) {
+  // Examples of RFC 7049 Appendix A
+  const uint8_t cbor[] = {0x83, 0x00, 0x17, 0x18, 0x18, 0x19, 0x03, 0xe8, 0x1a, 0x00, 0x0f, 0x42, 0x40, 0x1b, 0x00,
+                          0x00, 0x00, 0xe8, 0xd4, 0xa5, 0x10, 0x00, 0x20, 0x39, 0x03, 0xe7, 0x3b, 0x7f, 0xff, 0xff,
+                          0xff, 0xff, 0xff, 0xff, 0xff, 0xa2, 0x64, 0x49, 0x45, 0x54, 0x46, 0x44, 0x01, 0x02, 0x03,
+                          0x04, 0x60, 0x40};
+  const uint8_t bytes[] = {0x01, 0x02, 0x03, 0x04};
+  cbor_writer_t writer;
+  size_t len = 0;
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, cbor_writer_init(&writer, 1));
+  // The writer does not track containers, heads and items are checked as one sequence
+  cbor_writer_array(&writer, 3);
+  cbor_writer_int(&writer, 0);
+  cbor_writer_int(&writer, 23);
+  cbor_writer_int(&writer, 24);
+  cbor_writer_int(&writer, 1000);
+  cbor_writer_int(&writer, 1000000);
+  cbor_writer_int(&writer, 1000000000000LL);
+  cbor_writer_int(&writer, -1);
+  cbor_writer_int(&writer, -1000);
+  cbor_writer_int(&writer, INT64_MIN);
+  cbor_writer_map(&writer, 2);
+  cbor_writer_text(&writer, "IETF", 4);
+  cbor_writer_bytes(&writer, bytes, sizeof(bytes));
+  cbor_writer_text(&writer, "", 0);
+  TEST_ASSERT_EQUAL_INT(SC_OK, cbor_writer_bytes(&writer, NULL, 0));
+
+  uint8_t* out = cbor_writer_detach(&writer, &len);
+  TEST_ASSERT_EQUAL(sizeof(cbor), len);
+  TEST_ASSERT_EQUAL_MEMORY(cbor, out, len);
+  free(out);
+}
+
+/** Check a CBOR text string key at `*p` and move past it */
+static void assert_cbor_key(uint8_t const** const p, char const* const key) {
+  size_t len = strlen(key);
+  TEST_ASSERT_TRUE(len < 56);
+  if (len < 24) {
+    TEST_ASSERT_EQUAL(0x60 | len, (*p)[0]);
+    *p += 1;
+  } else {
+    TEST_ASSERT_EQUAL(0x78, (*p)[0]);
+    TEST_ASSERT_EQUAL(len, (*p)[1]);
+    *p += 2;
+  }
+  TEST_ASSERT_EQUAL_MEMORY(key, *p, len);
+  *p += len;
+}
+
+/** Check a CBOR byte string of packed trits at `*p` and move past it */
+static void assert_cbor_trits(uint8_t const** const p, flex_trit_t const* const trits, const size_t num_trits) {
+  uint8_t packed[TA_PACKED_TRITS_LEN(NUM_TRITS_SIGNATURE)];
+  size_t len = ta_flex_trits_to_bytes(packed, sizeof(packed), trits, num_trits, num_trits);
+  if (len < 24) {
+    TEST_ASSERT_EQUAL(0x40 | len, (*p)[0]);
+    *p += 1;
+  } else if (len <= UINT8_MAX) {
+    TEST_ASSERT_EQUAL(0x58, (*p)[0]);
+    TEST_ASSERT_EQUAL(len, (*p)[1]);
+    *p += 2;
+  } else {
+    TEST_ASSERT_EQUAL(0x59, (*p)[0]);
+    TEST_ASSERT_EQUAL(len, ((*p)[1] << 8) | (*p)[2]);
+    *p += 3;
+  }
+  TEST_ASSERT_EQUAL_MEMORY(packed, *p, len);
+  *p += len;
+}
+
+void test_serialize_ta_transaction_array_cbor(void) {
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_CBOR};
+  flex_trit_t msg_trits[FLEX_TRIT_SIZE_6561], hash_trits[FLEX_TRIT_SIZE_243], null_trits[FLEX_TRIT_SIZE_243] = {};
+  char* result = NULL;
+  size_t result_len = 0;
+  transaction_array_t* res = transaction_array_new();
+  iota_transaction_t* txn = transaction_new();
+
+  flex_trits_from_trytes(hash_trits, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  flex_trits_from_trytes(msg_trits, NUM_TRITS_SIGNATURE, (const tryte_t*)TRYTES_2187_1, NUM_TRYTES_SIGNATURE,
+                         NUM_TRYTES_SIGNATURE);
+  transaction_set_hash(txn, hash_trits);
+  transaction_set_signature(txn, msg_trits);
+  transaction_set_address(txn, hash_trits);
+  transaction_set_value(txn, -VALUE);
+  transaction_set_timestamp(txn, TIMESTAMP);
+  transaction_array_push_back(res, txn);
+  transaction_array_push_back(res, txn);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_array_serialize(res, &opt, &result, &result_len));
+
+  uint8_t const* p = (uint8_t const*)result;
+  // Array of 2 maps of 16 members
+  TEST_ASSERT_EQUAL(0x82, *p++);
+  for (int i = 0; i < 2; i++) {
+    TEST_ASSERT_EQUAL(0xb0, *p++);
+    assert_cbor_key(&p, "hash");
+    assert_cbor_trits(&p, hash_trits, NUM_TRITS_HASH);
+    assert_cbor_key(&p, "signature_and_message_fragment");
+    assert_cbor_trits(&p, msg_trits, NUM_TRITS_SIGNATURE);
+    assert_cbor_key(&p, "address");
+    assert_cbor_trits(&p, hash_trits, NUM_TRITS_HASH);
+    assert_cbor_key(&p, "value");
+    TEST_ASSERT_EQUAL(0x38, *p++);
+    TEST_ASSERT_EQUAL(VALUE - 1, *p++);
+    assert_cbor_key(&p, "obsolete_tag");
+    assert_cbor_trits(&p, null_trits, NUM_TRITS_TAG);
+    assert_cbor_key(&p, "timestamp");
+    TEST_ASSERT_EQUAL(0x1a, *p++);
+    TEST_ASSERT_EQUAL(TIMESTAMP, ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+    p += 4;
+    assert_cbor_key(&p, "current_index");
+    TEST_ASSERT_EQUAL(0x00, *p++);
+    assert_cbor_key(&p, "last_index");
+    TEST_ASSERT_EQUAL(0x00, *p++);
+    assert_cbor_key(&p, "bundle_hash");
+    assert_cbor_trits(&p, null_trits, NUM_TRITS_HASH);
+    assert_cbor_key(&p, "trunk_transaction_hash");
+    assert_cbor_trits(&p, null_trits, NUM_TRITS_HASH);
+    assert_cbor_key(&p, "branch_transaction_hash");
+    assert_cbor_trits(&p, null_trits, NUM_TRITS_HASH);
+    assert_cbor_key(&p, "tag");
+    assert_cbor_trits(&p, null_trits, NUM_TRITS_TAG);
+    assert_cbor_key(&p, "attachment_timestamp");
+    TEST_ASSERT_EQUAL(0x00, *p++);
+    assert_cbor_key(&p, "attachment_timestamp_lower_bound");
+    TEST_ASSERT_EQUAL(0x00, *p++);
+    assert_cbor_key(&p, "attachment_timestamp_upper_bound");
+    TEST_ASSERT_EQUAL(0x00, *p++);
+    assert_cbor_key(&p, "nonce");
+    assert_cbor_trits(&p, null_trits, NUM_TRITS_NONCE);
+  }
+  TEST_ASSERT_EQUAL(result_len, p - (uint8_t const*)result);
+  free(result);
+
+  // The same array in JSON is what ta_find_transaction_objects_res_serialize() returns
+  char* json_result = NULL;
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_array_serialize(res, NULL, &result, &result_len));
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_find_transaction_objects_res_serialize(res, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json_result, result);
+  TEST_ASSERT_EQUAL(strlen(json_result), result_len);
+  free(result);
+  free(json_result);
+
+  transaction_array_free(res);
+  transaction_free(txn);
+}
+
+void test_response_format_from_accept(void) {
+  TEST_ASSERT_EQUAL(TA_RESPONSE_FORMAT_JSON, ta_response_format_from_accept(NULL));
+  TEST_ASSERT_EQUAL(TA_RESPONSE_FORMAT_JSON, ta_response_format_from_accept("*/*"));
+  TEST_ASSERT_EQUAL(TA_RESPONSE_FORMAT_JSON, ta_response_format_from_accept("application/json"));
+  TEST_ASSERT_EQUAL(TA_RESPONSE_FORMAT_CBOR, ta_response_format_from_accept("application/cbor"));
+  TEST_ASSERT_EQUAL(TA_RESPONSE_FORMAT_CBOR, ta_response_format_from_accept("application/json, application/cbor"));
+  TEST_ASSERT_EQUAL_STRING("application/cbor", ta_response_format_content_type(TA_RESPONSE_FORMAT_CBOR));
+}
+
+void test_txn_fields_parse(void) {
+  uint32_t fields = 0;
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_txn_fields_parse(NULL, &fields));
+  TEST_ASSERT_EQUAL(0, fields);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_txn_fields_parse("", &fields));
+  TEST_ASSERT_EQUAL(0, fields);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_txn_fields_parse("value,hash,nonce", &fields));
+  TEST_ASSERT_EQUAL(TA_TXN_FIELD_HASH | TA_TXN_FIELD_VALUE | TA_TXN_FIELD_NONCE, fields);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_txn_fields_parse("attachment_timestamp,tag,", &fields));
+  TEST_ASSERT_EQUAL(TA_TXN_FIELD_ATTACHMENT_TIMESTAMP | TA_TXN_FIELD_TAG, fields);
+  // Names are matched as a whole
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, ta_txn_fields_parse("hash,attachment_timestamp_lower", &fields));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, ta_txn_fields_parse("hash,,value", &fields));
+}
+
+void test_serialize_ta_transaction_array_fields(void) {
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_JSON,
+                                .fields = TA_TXN_FIELD_HASH | TA_TXN_FIELD_VALUE | TA_TXN_FIELD_TIMESTAMP};
+  flex_trit_t hash_trits[FLEX_TRIT_SIZE_243];
+  char expected[NUM_TRYTES_HASH + 128];
+  char* result = NULL;
+  size_t result_len = 0;
+  transaction_array_t* res = transaction_array_new();
+  iota_transaction_t* txn = transaction_new();
+
+  flex_trits_from_trytes(hash_trits, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  transaction_set_hash(txn, hash_trits);
+  transaction_set_value(txn, -VALUE);
+  transaction_set_timestamp(txn, TIMESTAMP);
+  transaction_array_push_back(res, txn);
+
+  snprintf(expected, sizeof(expected), "{\"hash\":\"%s\",\"value\":%d,\"timestamp\":%d}", TRYTES_81_1, -VALUE,
+           TIMESTAMP);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_object_serialize(res, &opt, &result, &result_len));
+  TEST_ASSERT_EQUAL_STRING(expected, result);
+  free(result);
+
+  // The cJSON serializer projects the same way
+  cJSON* json_root = cJSON_CreateObject();
+  TEST_ASSERT_EQUAL_INT(SC_OK, iota_transaction_to_json_object(txn, opt.fields, &json_root));
+  result = cJSON_PrintUnformatted(json_root);
+  TEST_ASSERT_EQUAL_STRING(expected, result);
+  cJSON_Delete(json_root);
+  free(result);
+
+  // CBOR maps only count the selected members
+  opt.format = TA_RESPONSE_FORMAT_CBOR;
+  opt.fields = TA_TXN_FIELD_HASH | TA_TXN_FIELD_VALUE;
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_array_serialize(res, &opt, &result, &result_len));
+  uint8_t const* p = (uint8_t const*)result;
+  TEST_ASSERT_EQUAL(0x81, *p++);
+  TEST_ASSERT_EQUAL(0xa2, *p++);
+  assert_cbor_key(&p, "hash");
+  assert_cbor_trits(&p, hash_trits, NUM_TRITS_HASH);
+  assert_cbor_key(&p, "value");
+  TEST_ASSERT_EQUAL(0x38, *p++);
+  TEST_ASSERT_EQUAL(VALUE - 1, *p++);
+  TEST_ASSERT_EQUAL(result_len, p - (uint8_t const*)result);
+  free(result);
+
+  transaction_array_free(res);
+  transaction_free(txn);
+}
+
+void test_serialize_ta_transaction_page(void) {
+  const uint32_t fields = TA_TXN_FIELD_HASH | TA_TXN_FIELD_VALUE;
+  flex_trit_t hash_trits[FLEX_TRIT_SIZE_243];
+  char* expected = NULL;
+  char* result = NULL;
+  size_t result_len = 0;
+  char joined[1024] = {0};
+  transaction_array_t* res = transaction_array_new();
+  transaction_array_t* first = transaction_array_new();
+  transaction_array_t* second = transaction_array_new();
+  transaction_array_t* empty = transaction_array_new();
+  iota_transaction_t* txn = transaction_new();
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_JSON, .fields = fields};
+
+  flex_trits_from_trytes(hash_trits, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  transaction_set_hash(txn, hash_trits);
+  for (int i = 0; i < 3; i++) {
+    transaction_set_value(txn, i);
+    transaction_array_push_back(res, txn);
+    transaction_array_push_back(i < 2 ? first : second, txn);
+  }
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_array_serialize(res, &opt, &expected, NULL));
+
+  // Pages concatenated in order are the whole array
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_page_serialize(first, fields, true, false, &result, &result_len));
+  TEST_ASSERT_EQUAL('[', result[0]);
+  TEST_ASSERT_EQUAL(strlen(result), result_len);
+  strcat(joined, result);
+  free(result);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_page_serialize(second, fields, false, true, &result, &result_len));
+  TEST_ASSERT_EQUAL(',', result[0]);
+  strcat(joined, result);
+  free(result);
+  TEST_ASSERT_EQUAL_STRING(expected, joined);
+
+  // The last page of a result whose size is a multiple of the page size is empty
+  joined[0] = '\0';
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_page_serialize(res, fields, true, false, &result, &result_len));
+  strcat(joined, result);
+  free(result);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_page_serialize(empty, fields, false, true, &result, &result_len));
+  TEST_ASSERT_EQUAL_STRING("]", result);
+  strcat(joined, result);
+  free(result);
+  TEST_ASSERT_EQUAL_STRING(expected, joined);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_page_serialize(empty, fields, true, true, &result, &result_len));
+  TEST_ASSERT_EQUAL_STRING("[]", result);
+  TEST_ASSERT_EQUAL(2, result_len);
+  free(result);
+
+  free(expected);
+  transaction_array_free(res);
+  transaction_array_free(first);
+  transaction_array_free(second);
+  transaction_array_free(empty);
+  transaction_free(txn);
+}
+
+void test_page_req_parse(void) {
+  ta_page_req_t page;
+  bool paged = true;
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_page_req_parse(NULL, "", NULL, &page, &paged));
+  TEST_ASSERT_FALSE(paged);
+  TEST_ASSERT_EQUAL(TA_PAGE_DEFAULT_LIMIT, page.limit);
+  TEST_ASSERT_EQUAL(0, page.cursor);
+  TEST_ASSERT_EQUAL(0, page.since);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_page_req_parse(NULL, "200", NULL, &page, &paged));
+  TEST_ASSERT_TRUE(paged);
+  TEST_ASSERT_EQUAL(TA_PAGE_DEFAULT_LIMIT, page.limit);
+  TEST_ASSERT_EQUAL(200, page.cursor);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_page_req_parse("1000000", NULL, "1570000000", &page, &paged));
+  TEST_ASSERT_EQUAL(TA_PAGE_MAX_LIMIT, page.limit);
+  TEST_ASSERT_EQUAL(1570000000, page.since);
+
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, ta_page_req_parse("0", NULL, NULL, &page, &paged));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, ta_page_req_parse("-1", NULL, NULL, &page, &paged));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, ta_page_req_parse(NULL, "12a", NULL, &page, &paged));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, ta_page_req_parse(NULL, NULL, " 1", &page, &paged));
+}
+
+void test_serialize_ta_hash_page_res(void) {
+  const char* json = "{\"hashes\":[\"" TRYTES_81_1 "\",\"" TRYTES_81_2 "\"],\"cursor\":\"42\"}";
+  char* json_result = NULL;
+  hash243_vector_t hashes;
+  flex_trit_t hash_trits_1[FLEX_TRIT_SIZE_243], hash_trits_2[FLEX_TRIT_SIZE_243];
+  flex_trits_from_trytes(hash_trits_1, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  flex_trits_from_trytes(hash_trits_2, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_2, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  hash243_vector_init(&hashes, NULL);
+
+  // A page past the last hash is empty rather than an error, so polling clients keep their cursor
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_hash_page_res_serialize(&hashes, 7, &json_result));
+  TEST_ASSERT_EQUAL_STRING("{\"hashes\":[],\"cursor\":\"7\"}", json_result);
+  free(json_result);
+
+  hash243_vector_push(&hashes, hash_trits_1);
+  hash243_vector_push(&hashes, hash_trits_2);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_hash_page_res_serialize(&hashes, 42, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+  free(json_result);
+  hash243_vector_free(&hashes);
+}
+
+void test_serialize_ta_transaction_page_res(void) {
+  flex_trit_t hash_trits[FLEX_TRIT_SIZE_243];
+  char* array = NULL;
+  char* result = NULL;
+  size_t result_len = 0;
+  char expected[1024];
+  transaction_array_t* res = transaction_array_new();
+  iota_transaction_t* txn = transaction_new();
+  ta_txn_serialize_opt_t opt = {.format = TA_RESPONSE_FORMAT_JSON, .fields = TA_TXN_FIELD_HASH | TA_TXN_FIELD_VALUE};
+
+  flex_trits_from_trytes(hash_trits, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  transaction_set_hash(txn, hash_trits);
+  transaction_set_value(txn, 100);
+  transaction_array_push_back(res, txn);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_array_serialize(res, &opt, &array, NULL));
+
+  snprintf(expected, sizeof(expected), "{\"transactions\":%s,\"cursor\":\"5\"}", array);
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_page_res_serialize(res, &opt, 5, &result, &result_len));
+  TEST_ASSERT_EQUAL_STRING(expected, result);
+  free(result);
+
+  // The CBOR page is a map of the transactions and the cursor
+  opt.format = TA_RESPONSE_FORMAT_CBOR;
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_transaction_page_res_serialize(res, &opt, 5, &result, &result_len));
+  uint8_t const* p = (uint8_t const*)result;
+  TEST_ASSERT_EQUAL(0xa2, *p++);
+  assert_cbor_key(&p, "transactions");
+  TEST_ASSERT_EQUAL(0x81, *p);
+  // The cursor closes the map
+  TEST_ASSERT_EQUAL_MEMORY("\x66" "cursor" "\x61" "5", result + result_len - 9, 9);
+  free(result);
+
+  free(array);
+  transaction_array_free(res);
+  transaction_free(txn);
+}
+
+void test_deserialize_txn_fields_req(void) {
+  ta_find_transaction_objects_req_t* req = ta_find_transaction_objects_req_new();
+  uint32_t fields = 0;
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_find_transaction_objects_req_deserialize(
+                                   "{\"hashes\":[\"" TRYTES_81_1 "\"],\"fields\":[\"address\",\"bundle_hash\"]}", req));
+  TEST_ASSERT_EQUAL(TA_TXN_FIELD_ADDRESS | TA_TXN_FIELD_BUNDLE_HASH, req->fields);
+  ta_find_transaction_objects_req_free(&req);
+
+  req = ta_find_transaction_objects_req_new();
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ,
+                        ta_find_transaction_objects_req_deserialize(
+                            "{\"hashes\":[\"" TRYTES_81_1 "\"],\"fields\":[\"address\",\"signature\"]}", req));
+  ta_find_transaction_objects_req_free(&req);
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, mqtt_txn_fields_req_deserialize("{\"device_id\":\"" DEVICE_ID "\"}", &fields));
+  TEST_ASSERT_EQUAL(0, fields);
+  TEST_ASSERT_EQUAL_INT(SC_OK, mqtt_txn_fields_req_deserialize(
+                                   "{\"device_id\":\"" DEVICE_ID "\",\"fields\":\"hash,timestamp\"}", &fields));
+  TEST_ASSERT_EQUAL(TA_TXN_FIELD_HASH | TA_TXN_FIELD_TIMESTAMP, fields);
+}
+
+void test_json_tokenizer(void) {
+  char json[] = "{\"message\":\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\ud83d\\ude00\", \"numbers\" : [-12.5e1, 3e10, true,"
+                "false, null], \"empty\":{}}";
+  char arena_buf[64];
+  arena_t arena;
+  json_token_t* root = NULL;
+  json_token_t* token = NULL;
+
+  // The buffer is too small for the tokens, which then go to heap blocks
+  arena_init(&arena, arena_buf, sizeof(arena_buf));
+  TEST_ASSERT_EQUAL_INT(SC_OK, json_tokenize(json, &arena, &root));
+  TEST_ASSERT_EQUAL_INT(JSON_TOKEN_OBJECT, root->type);
+  TEST_ASSERT_EQUAL_INT(3, root->size);
+
+  token = json_token_get_string(root, "message");
+  TEST_ASSERT_NOT_NULL(token);
+  TEST_ASSERT_EQUAL_STRING("\"\\/\b\f\n\r\t\xc3\xa9\xf0\x9f\x98\x80", token->str);
+  TEST_ASSERT_EQUAL_INT(strlen(token->str), token->len);
+
+  token = json_token_get(root, "numbers");
+  TEST_ASSERT_EQUAL_INT(JSON_TOKEN_ARRAY, token->type);
+  TEST_ASSERT_EQUAL_INT(5, token->size);
+  token = token->child;
+  TEST_ASSERT_EQUAL_INT(-125, token->integer);
+  TEST_ASSERT_EQUAL_INT(INT_MAX, token->next->integer);
+  TEST_ASSERT_EQUAL_INT(JSON_TOKEN_TRUE, token->next->next->type);
+  TEST_ASSERT_EQUAL_INT(JSON_TOKEN_FALSE, token->next->next->next->type);
+  TEST_ASSERT_EQUAL_INT(JSON_TOKEN_NULL, token->next->next->next->next->type);
+  TEST_ASSERT_NULL(token->next->next->next->next->next);
+
+  TEST_ASSERT_EQUAL_INT(JSON_TOKEN_OBJECT, json_token_get(root, "empty")->type);
+  TEST_ASSERT_NULL(json_token_get(root, "Message"));
+  TEST_ASSERT_NULL(json_token_get_string(root, "numbers"));
+  TEST_ASSERT_TRUE(arena.num_blocks > 0);
+  arena_reset(&arena);
+
+  char const* const malformed[] = {"", "{", "{\"a\"}", "{\"a\":}", "[1,]", "[\"\\x\"]", "[\"\\ud83d\"]",
+                                   "{\"a\":1 \"b\":2}"};
+  for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+    char buf[16];
+    strcpy(buf, malformed[i]);
+    TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_JSON_PARSE, json_tokenize(buf, &arena, &root));
+  }
+  arena_reset(&arena);
+}
+
+void test_json_scanner(void) {
+  char const json[] = " {\"hashes\":[\"" TRYTES_81_1 "\",\"]}\\\"{\"],\"empty\":{}} \r\n";
+  json_scanner_t scanner;
+
+  // Every split of the document into two chunks is scanned the same
+  for (size_t split = 0; split <= strlen(json); split++) {
+    json_scanner_init(&scanner);
+    TEST_ASSERT_EQUAL_INT(SC_OK, json_scanner_feed(&scanner, json, split));
+    TEST_ASSERT_FALSE(split < strlen(json) - 3 && json_scanner_complete(&scanner));
+    TEST_ASSERT_EQUAL_INT(SC_OK, json_scanner_feed(&scanner, json + split, strlen(json) - split));
+    TEST_ASSERT_TRUE(json_scanner_complete(&scanner));
+  }
+
+  char const* const malformed[] = {"\"a\"", "1", "{}}", "{]", "[}", "{} {}", "{\"a\n\"}", "{}x"};
+  for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+    json_scanner_init(&scanner);
+    TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_JSON_PARSE, json_scanner_feed(&scanner, malformed[i], strlen(malformed[i])));
+  }
+  json_scanner_init(&scanner);
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_JSON_PARSE, json_scanner_feed(&scanner, "{\"a\":\0}", 7));
+
+  // Nesting is limited as in the tokenizer
+  char deep[JSON_TOKENIZER_MAX_DEPTH + 1];
+  memset(deep, '[', sizeof(deep));
+  json_scanner_init(&scanner);
+  TEST_ASSERT_EQUAL_INT(SC_OK, json_scanner_feed(&scanner, deep, JSON_TOKENIZER_MAX_DEPTH));
+  TEST_ASSERT_FALSE(json_scanner_complete(&scanner));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_JSON_PARSE, json_scanner_feed(&scanner, deep, 1));
+}
+
+void test_deserialize_ta_find_transaction_objects_req_insitu(void) {
+  char json[] = "{\"hashes\":[\"" TRYTES_81_1 "\",\"" TRYTES_81_2 "\"]}";
+  char arena_buf[512];
+  arena_t arena;
+  ta_find_transaction_objects_req_t* req = ta_find_transaction_objects_req_new();
+  flex_trit_t hash_trits[FLEX_TRIT_SIZE_243];
+
+  arena_init(&arena, arena_buf, sizeof(arena_buf));
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_find_transaction_objects_req_deserialize_insitu(json, &arena, req));
+  // Tokens fit in the stack buffer
+  TEST_ASSERT_EQUAL_INT(0, arena.num_blocks);
+  arena_reset(&arena);
+
+  TEST_ASSERT_EQUAL_INT(2, hash243_vector_count(&req->hashes));
+  flex_trits_from_trytes(hash_trits, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  TEST_ASSERT_EQUAL_MEMORY(hash_trits, hash243_vector_at(&req->hashes, 0), FLEX_TRIT_SIZE_243);
+  flex_trits_from_trytes(hash_trits, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_2, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  TEST_ASSERT_EQUAL_MEMORY(hash_trits, hash243_vector_at(&req->hashes, 1), FLEX_TRIT_SIZE_243);
+  ta_find_transaction_objects_req_free(&req);
+
+  // A hash of the right length with characters outside the tryte alphabet
+  char invalid_hash[] = "{\"hashes\":[\"" TRYTES_81_1 "\"]}";
+  invalid_hash[12] = 'a';
+  req = ta_find_transaction_objects_req_new();
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ,
+                        ta_find_transaction_objects_req_deserialize_insitu(invalid_hash, &arena, req));
+  arena_reset(&arena);
+  ta_find_transaction_objects_req_free(&req);
+}
+
+void test_deserialize_ta_find_transactions_req_insitu(void) {
+  char json[] = "{\"tags\":[\"TANGLE\",\"" TAG_MSG "\"],\"addresses\":[\"" TRYTES_81_1 "\"],\"fields\":\"hash\"}";
+  char empty[] = "{\"tags\":[]}";
+  char short_address[] = "{\"addresses\":[\"ABC\"]}";
+  char invalid_tag[] = "{\"tags\":[\"tangle\"]}";
+  char arena_buf[512];
+  arena_t arena;
+  uint32_t fields = 0;
+  flex_trit_t tag_trits[FLEX_TRIT_SIZE_81];
+  find_transactions_req_t* req = find_transactions_req_new();
+
+  arena_init(&arena, arena_buf, sizeof(arena_buf));
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_find_transactions_req_deserialize_insitu(json, &arena, req, &fields));
+  TEST_ASSERT_EQUAL_INT(2, hash81_queue_count(req->tags));
+  TEST_ASSERT_EQUAL_INT(1, hash243_queue_count(req->addresses));
+  TEST_ASSERT_EQUAL_INT(0, hash243_queue_count(req->bundles));
+  TEST_ASSERT_EQUAL_INT(TA_TXN_FIELD_HASH, fields);
+  // Short tags are padded with '9'
+  flex_trits_from_trytes(tag_trits, NUM_TRITS_TAG, (const tryte_t*)"TANGLE999999999999999999999", NUM_TRYTES_TAG,
+                         NUM_TRYTES_TAG);
+  TEST_ASSERT_EQUAL_MEMORY(tag_trits, req->tags->hash, FLEX_TRIT_SIZE_81);
+  find_transactions_req_free(&req);
+
+  req = find_transactions_req_new();
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ,
+                        ta_find_transactions_req_deserialize_insitu(empty, &arena, req, NULL));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ,
+                        ta_find_transactions_req_deserialize_insitu(short_address, &arena, req, NULL));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ,
+                        ta_find_transactions_req_deserialize_insitu(invalid_tag, &arena, req, NULL));
+  arena_reset(&arena);
+  find_transactions_req_free(&req);
+}
+
+void test_deserialize_ta_batch_req_insitu(void) {
+  char json[] = "{\"device_id\":\"ID\",\"requests\":[{\"command\":\"get_tips_pair\"},"
+                "{\"command\":\"find_transactions_by_tag\",\"tag\":\"" TAG_MSG "\"},"
+                "{\"command\":\"find_transaction_objects\",\"hashes\":[\"" TRYTES_81_1 "\"],"
+                "\"fields\":\"hash,value\"}]}";
+  char unknown[] = "{\"requests\":[{\"command\":\"send_transfer\"}]}";
+  char no_tag[] = "{\"requests\":[{\"command\":\"find_transactions_obj_by_tag\"}]}";
+  char empty[] = "{\"requests\":[]}";
+  char arena_buf[1024];
+  arena_t arena;
+  ta_batch_req_t* req = (ta_batch_req_t*)malloc(sizeof(ta_batch_req_t));
+  flex_trit_t hash_trits[FLEX_TRIT_SIZE_243];
+
+  arena_init(&arena, arena_buf, sizeof(arena_buf));
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_batch_req_deserialize_insitu(json, &arena, req));
+  TEST_ASSERT_EQUAL_INT(3, req->num);
+  TEST_ASSERT_EQUAL_INT(TA_BATCH_GET_TIPS_PAIR, req->reqs[0].cmd);
+  TEST_ASSERT_EQUAL_INT(TA_BATCH_FIND_TXN_BY_TAG, req->reqs[1].cmd);
+  TEST_ASSERT_EQUAL_STRING(TAG_MSG, req->reqs[1].tag);
+  TEST_ASSERT_EQUAL_INT(TA_BATCH_FIND_TRANSACTION_OBJECTS, req->reqs[2].cmd);
+  TEST_ASSERT_EQUAL_INT(TA_TXN_FIELD_HASH | TA_TXN_FIELD_VALUE, req->reqs[2].fields);
+  TEST_ASSERT_EQUAL_INT(1, hash243_vector_count(&req->reqs[2].hashes));
+  flex_trits_from_trytes(hash_trits, NUM_TRITS_HASH, (const tryte_t*)TRYTES_81_1, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  TEST_ASSERT_EQUAL_MEMORY(hash_trits, hash243_vector_at(&req->reqs[2].hashes, 0), FLEX_TRIT_SIZE_243);
+
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, ta_batch_req_deserialize_insitu(unknown, &arena, req));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, ta_batch_req_deserialize_insitu(no_tag, &arena, req));
+  TEST_ASSERT_EQUAL_INT(SC_SERIALIZER_INVALID_REQ, ta_batch_req_deserialize_insitu(empty, &arena, req));
+  arena_reset(&arena);
+  free(req);
+}
+
+void test_serialize_ta_batch_res(void) {
+  const char* json = "{\"results\":[{\"hashes\":[]},{\"error\":1234},[\"A\"]]}";
+  char* results[] = {"{\"hashes\":[]}", NULL, "[\"A\"]"};
+  status_t rets[] = {SC_OK, 1234, SC_OK};
+  char* json_result = NULL;
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, ta_batch_res_serialize(results, rets, 3, &json_result));
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+  free(json_result);
+}
+
+void test_mqtt_busy_res_serialize(void) {
+  const char* json = "{\"message\":\"Service is busy, retry later\",\"retry_after\":3}";
+  char* json_result;
+  TEST_ASSERT_EQUAL_INT(SC_OK, mqtt_busy_res_serialize(3, &json_result));
+
+  TEST_ASSERT_EQUAL_STRING(json, json_result);
+  free(json_result);
 }
 
 int main(void) {
@@ -340,10 +1022,31 @@ int main(void) {
   RUN_TEST(test_deserialize_send_mam_message_response);
   RUN_TEST(test_deserialize_send_mam_message);
   RUN_TEST(test_deserialize_ta_send_trytes_req);
+  RUN_TEST(test_deserialize_ta_send_trytes_req_invalid);
   RUN_TEST(test_serialize_ta_send_trytes_res);
   RUN_TEST(test_mqtt_device_id_deserialize);
   RUN_TEST(test_mqtt_tag_req_deserialize);
   RUN_TEST(test_mqtt_transaction_hash_req_deserialize);
+  RUN_TEST(test_serialize_ta_send_transfer_res);
+  RUN_TEST(test_json_writer);
+  RUN_TEST(test_mqtt_busy_res_serialize);
+  RUN_TEST(test_json_tokenizer);
+  RUN_TEST(test_json_scanner);
+  RUN_TEST(test_deserialize_ta_find_transaction_objects_req_insitu);
+  RUN_TEST(test_deserialize_ta_find_transactions_req_insitu);
+  RUN_TEST(test_deserialize_ta_batch_req_insitu);
+  RUN_TEST(test_serialize_ta_batch_res);
+  RUN_TEST(test_cbor_writer);
+  RUN_TEST(test_serialize_ta_transaction_array_cbor);
+  RUN_TEST(test_response_format_from_accept);
+  RUN_TEST(test_txn_fields_parse);
+  RUN_TEST(test_serialize_ta_transaction_array_fields);
+  RUN_TEST(test_serialize_ta_transaction_page);
+  RUN_TEST(test_page_req_parse);
+  RUN_TEST(test_serialize_ta_hash_page_res);
+  RUN_TEST(test_serialize_ta_transaction_page_res);
+  RUN_TEST(test_deserialize_txn_fields_req);
+  RUN_TEST(test_proxy_apis_command_req_deserialize);
   serializer_logger_release();
   return UNITY_END();
 }
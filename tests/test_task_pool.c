@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include <pthread.h>
+#include "test_define.h"
+#include "utils/task_pool.h"
+
+#define TEST_TASK_NUM 64
+#define TEST_WORKERS 4
+#define TEST_CALLERS 4
+
+typedef struct test_task_s {
+  int input;
+  int output;
+  pthread_t thread; /**< Thread which ran the task */
+} test_task_t;
+
+static void square(void* arg) {
+  test_task_t* task = (test_task_t*)arg;
+  task->output = task->input * task->input;
+  task->thread = pthread_self();
+}
+
+/** Run TEST_TASK_NUM tasks and check every one of them was run once, returns the number of threads which ran them */
+static int run_tasks(void) {
+  test_task_t args[TEST_TASK_NUM];
+  task_pool_task_t tasks[TEST_TASK_NUM];
+  pthread_t threads[TEST_TASK_NUM];
+  int num_threads = 0;
+
+  for (int i = 0; i < TEST_TASK_NUM; i++) {
+    args[i] = (test_task_t){.input = i, .output = -1};
+    tasks[i] = (task_pool_task_t){.func = square, .arg = &args[i]};
+  }
+  task_pool_run(tasks, TEST_TASK_NUM);
+
+  for (int i = 0; i < TEST_TASK_NUM; i++) {
+    TEST_ASSERT_EQUAL(i * i, args[i].output);
+    int j = 0;
+    while (j < num_threads && !pthread_equal(threads[j], args[i].thread)) {
+      j++;
+    }
+    if (j == num_threads) {
+      threads[num_threads++] = args[i].thread;
+    }
+  }
+  return num_threads;
+}
+
+static void* run_tasks_thread(void* arg) {
+  (void)arg;
+  run_tasks();
+  return NULL;
+}
+
+void test_run_without_workers(void) {
+  // Without workers every task is run by the calling thread
+  TEST_ASSERT_EQUAL(1, run_tasks());
+  task_pool_run(NULL, 0);
+}
+
+void test_run_with_workers(void) {
+  TEST_ASSERT_EQUAL_INT(SC_OK, task_pool_start(TEST_WORKERS));
+  TEST_ASSERT_TRUE(run_tasks() <= TEST_WORKERS + 1);
+  task_pool_stop();
+}
+
+void test_concurrent_callers(void) {
+  pthread_t callers[TEST_CALLERS];
+
+  TEST_ASSERT_EQUAL_INT(SC_OK, task_pool_start(TEST_WORKERS));
+  for (int i = 0; i < TEST_CALLERS; i++) {
+    TEST_ASSERT_EQUAL(0, pthread_create(&callers[i], NULL, run_tasks_thread, NULL));
+  }
+  for (int i = 0; i < TEST_CALLERS; i++) {
+    pthread_join(callers[i], NULL);
+  }
+  task_pool_stop();
+
+  // Tasks are run in the calling thread again once the pool is stopped
+  TEST_ASSERT_EQUAL(1, run_tasks());
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  task_pool_init();
+  RUN_TEST(test_run_without_workers);
+  RUN_TEST(test_run_with_workers);
+  RUN_TEST(test_concurrent_callers);
+  task_pool_destroy();
+
+  return UNITY_END();
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "test_define.h"
+#include "utils/trinary_kernels.h"
+
+/** Long enough to run every kernel through several vector steps and every tail length */
+#define TEST_MAX_LEN 100
+/** Number of tryte values */
+#define TRYTE_SPACE 27
+
+static char const tryte_alphabet[] = "9ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+/** Run a test with the kernels of every instruction set the build and the CPU support */
+#define FOREACH_ISA(isa)                                                                         \
+  for (trinary_kernels_isa_t isa = TRINARY_KERNELS_SCALAR; isa < TRINARY_KERNELS_ISA_NUM; isa++) \
+    if (trinary_kernels_select(isa))
+
+static void fill_trits(flex_trit_t* const trits, const size_t len, const int seed) {
+  for (size_t i = 0; i < len; i++) {
+    trits[i] = (seed + i) % TRYTE_SPACE - 13;
+  }
+}
+
+void test_to_trytes(void) {
+  flex_trit_t trits[TEST_MAX_LEN];
+  tryte_t expect[TEST_MAX_LEN + 1], result[TEST_MAX_LEN + 1];
+
+  FOREACH_ISA(isa) {
+    for (size_t len = 0; len <= TEST_MAX_LEN; len++) {
+      // Rotating the values puts every tryte value at every position
+      for (int seed = 0; seed < TRYTE_SPACE; seed++) {
+        fill_trits(trits, len, seed);
+        memset(expect, 0, sizeof(expect));
+        memset(result, 0, sizeof(result));
+        TEST_ASSERT_EQUAL(flex_trits_to_trytes(expect, len, trits, len * 3, len * 3),
+                          ta_flex_trits_to_trytes(result, len, trits, len * 3, len * 3));
+        TEST_ASSERT_EQUAL_MEMORY(expect, result, sizeof(expect));
+      }
+    }
+  }
+}
+
+void test_from_trytes(void) {
+  tryte_t trytes[TEST_MAX_LEN];
+  flex_trit_t expect[TEST_MAX_LEN + 1], result[TEST_MAX_LEN + 1];
+
+  FOREACH_ISA(isa) {
+    for (size_t len = 0; len <= TEST_MAX_LEN; len++) {
+      for (int seed = 0; seed < TRYTE_SPACE; seed++) {
+        for (size_t i = 0; i < len; i++) {
+          trytes[i] = tryte_alphabet[(seed + i) % TRYTE_SPACE];
+        }
+        memset(expect, 0, sizeof(expect));
+        memset(result, 0, sizeof(result));
+        TEST_ASSERT_EQUAL(flex_trits_from_trytes(expect, len * 3, trytes, len, len),
+                          ta_flex_trits_from_trytes(result, len * 3, trytes, len, len));
+        TEST_ASSERT_EQUAL_MEMORY(expect, result, sizeof(expect));
+      }
+    }
+  }
+}
+
+void test_round_trip_transaction(void) {
+  flex_trit_t trits[FLEX_TRIT_SIZE_8019], expect[FLEX_TRIT_SIZE_8019];
+  tryte_t trytes[NUM_TRYTES_SERIALIZED_TRANSACTION];
+
+  fill_trits(expect, FLEX_TRIT_SIZE_8019, 0);
+  FOREACH_ISA(isa) {
+    TEST_ASSERT_EQUAL(NUM_TRYTES_SERIALIZED_TRANSACTION,
+                      ta_flex_trits_to_trytes(trytes, NUM_TRYTES_SERIALIZED_TRANSACTION, expect,
+                                              NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION));
+    TEST_ASSERT_TRUE(ta_trytes_validate(trytes, NUM_TRYTES_SERIALIZED_TRANSACTION));
+    TEST_ASSERT_EQUAL(NUM_TRYTES_SERIALIZED_TRANSACTION,
+                      ta_flex_trits_from_trytes(trits, NUM_TRITS_SERIALIZED_TRANSACTION, trytes,
+                                                NUM_TRYTES_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION));
+    TEST_ASSERT_EQUAL_MEMORY(expect, trits, sizeof(expect));
+  }
+}
+
+void test_short_buffers(void) {
+  flex_trit_t trits[FLEX_TRIT_SIZE_243] = {};
+  tryte_t trytes[NUM_TRYTES_HASH];
+
+  FOREACH_ISA(isa) {
+    TEST_ASSERT_EQUAL(0, ta_flex_trits_to_trytes(trytes, NUM_TRYTES_HASH - 1, trits, NUM_TRITS_HASH, NUM_TRITS_HASH));
+    TEST_ASSERT_EQUAL(0, ta_flex_trits_to_trytes(trytes, NUM_TRYTES_HASH, trits, NUM_TRITS_HASH - 3, NUM_TRITS_HASH));
+    TEST_ASSERT_EQUAL(0,
+                      ta_flex_trits_from_trytes(trits, NUM_TRITS_HASH - 3, trytes, NUM_TRYTES_HASH, NUM_TRYTES_HASH));
+    TEST_ASSERT_EQUAL(0,
+                      ta_flex_trits_from_trytes(trits, NUM_TRITS_HASH, trytes, NUM_TRYTES_HASH - 1, NUM_TRYTES_HASH));
+  }
+}
+
+/** Reference packing, one trit at a time */
+static void pack_trits(int8_t* const bytes, flex_trit_t const* const trytes, const size_t num_trytes) {
+  trit_t trits[TEST_MAX_LEN * 3 + 5] = {};
+  for (size_t i = 0; i < num_trytes; i++) {
+    int v = trytes[i];
+    for (int j = 0; j < 3; j++) {
+      trits[i * 3 + j] = ((v % 3) + 4) % 3 - 1;
+      v = (v - trits[i * 3 + j]) / 3;
+    }
+  }
+  for (size_t i = 0; i * 5 < num_trytes * 3; i++) {
+    trit_t const* t = trits + i * 5;
+    bytes[i] = t[0] + 3 * t[1] + 9 * t[2] + 27 * t[3] + 81 * t[4];
+  }
+}
+
+void test_to_bytes(void) {
+  flex_trit_t trits[TEST_MAX_LEN];
+  int8_t expect[TEST_MAX_LEN + 1], result[TEST_MAX_LEN + 1];
+
+  for (size_t len = 0; len <= TEST_MAX_LEN; len++) {
+    for (int seed = 0; seed < TRYTE_SPACE; seed++) {
+      fill_trits(trits, len, seed);
+      memset(expect, 0, sizeof(expect));
+      memset(result, 0, sizeof(result));
+      pack_trits(expect, trits, len);
+      TEST_ASSERT_EQUAL(TA_PACKED_TRITS_LEN(len * 3),
+                        ta_flex_trits_to_bytes((uint8_t*)result, TEST_MAX_LEN, trits, len * 3, len * 3));
+      TEST_ASSERT_EQUAL_MEMORY(expect, result, sizeof(expect));
+    }
+  }
+
+  // Hashes and messages
+  TEST_ASSERT_EQUAL(49, TA_PACKED_TRITS_LEN(NUM_TRITS_HASH));
+  TEST_ASSERT_EQUAL(1313, TA_PACKED_TRITS_LEN(NUM_TRITS_SIGNATURE));
+  TEST_ASSERT_EQUAL(0, ta_flex_trits_to_bytes((uint8_t*)result, 48, trits, NUM_TRITS_HASH, NUM_TRITS_HASH));
+}
+
+void test_validate(void) {
+  tryte_t trytes[TEST_MAX_LEN];
+
+  FOREACH_ISA(isa) {
+    for (size_t len = 1; len <= TEST_MAX_LEN; len++) {
+      memset(trytes, 'A', len);
+      TEST_ASSERT_TRUE(ta_trytes_validate(trytes, len));
+      // Every byte value at every position
+      for (size_t pos = 0; pos < len; pos++) {
+        for (int c = 0; c < 256; c++) {
+          trytes[pos] = (tryte_t)c;
+          bool expect = c == '9' || (c >= 'A' && c <= 'Z');
+          TEST_ASSERT_EQUAL(expect, ta_trytes_validate(trytes, len));
+        }
+        trytes[pos] = 'A';
+      }
+    }
+    TEST_ASSERT_TRUE(ta_trytes_validate(trytes, 0));
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_to_trytes);
+  RUN_TEST(test_from_trytes);
+  RUN_TEST(test_round_trip_transaction);
+  RUN_TEST(test_short_buffers);
+  RUN_TEST(test_to_bytes);
+  RUN_TEST(test_validate);
+  return UNITY_END();
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "arena.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Alignment of every allocation, enough for any scalar type */
+#define ARENA_ALIGN sizeof(long double)
+
+/** Offset of the usable memory in a heap block */
+#define ARENA_BLOCK_HEADER ((sizeof(arena_block_t) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+void arena_init(arena_t* const arena, void* const buf, const size_t size) {
+  arena->initial = (char*)buf;
+  arena->initial_size = buf ? size : 0;
+  arena->blocks = NULL;
+  arena->spare = NULL;
+  arena->num_blocks = 0;
+  arena->ptr = arena->initial;
+  arena->end = arena->initial + arena->initial_size;
+}
+
+void* arena_alloc(arena_t* const arena, const size_t size) {
+  uintptr_t aligned = ((uintptr_t)arena->ptr + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1);
+
+  if (arena->ptr == NULL || size > (uintptr_t)arena->end - aligned || aligned > (uintptr_t)arena->end) {
+    // Oversized requests get a block of their own, the rest of the current block is still used afterwards
+    size_t block_size = size > ARENA_BLOCK_SIZE - ARENA_BLOCK_HEADER ? size + ARENA_BLOCK_HEADER : ARENA_BLOCK_SIZE;
+    arena_block_t* block = NULL;
+    if (block_size == ARENA_BLOCK_SIZE && arena->spare) {
+      block = arena->spare;
+      arena->spare = block->next;
+    } else {
+      block = (arena_block_t*)malloc(block_size);
+      if (block == NULL) {
+        return NULL;
+      }
+      block->size = block_size;
+      arena->num_blocks++;
+    }
+    block->next = arena->blocks;
+    arena->blocks = block;
+
+    char* mem = (char*)block + ARENA_BLOCK_HEADER;
+    if (block_size == ARENA_BLOCK_SIZE) {
+      arena->ptr = mem + size;
+      arena->end = (char*)block + block_size;
+    }
+    return mem;
+  }
+
+  arena->ptr = (char*)aligned + size;
+  return (void*)aligned;
+}
+
+char* arena_strndup(arena_t* const arena, char const* const str, const size_t len) {
+  char* copy = (char*)arena_alloc(arena, len + 1);
+  if (copy == NULL) {
+    return NULL;
+  }
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+  return copy;
+}
+
+static void arena_blocks_free(arena_block_t* block) {
+  while (block) {
+    arena_block_t* next = block->next;
+    free(block);
+    block = next;
+  }
+}
+
+void arena_reset(arena_t* const arena) {
+  arena_blocks_free(arena->blocks);
+  arena_blocks_free(arena->spare);
+  arena->blocks = NULL;
+  arena->spare = NULL;
+  arena->ptr = arena->initial;
+  arena->end = arena->initial + arena->initial_size;
+}
+
+void arena_rewind(arena_t* const arena) {
+  arena_block_t* block = arena->blocks;
+  while (block) {
+    arena_block_t* next = block->next;
+    if (block->size == ARENA_BLOCK_SIZE) {
+      block->next = arena->spare;
+      arena->spare = block;
+    } else {
+      free(block);
+    }
+    block = next;
+  }
+  arena->blocks = NULL;
+  arena->ptr = arena->initial;
+  arena->end = arena->initial + arena->initial_size;
+}
+
+static pthread_key_t thread_arena_key;
+static pthread_once_t thread_arena_once = PTHREAD_ONCE_INIT;
+
+static void thread_arena_destroy(void* ptr) {
+  arena_t* arena = (arena_t*)ptr;
+  arena_reset(arena);
+  free(arena);
+}
+
+static void thread_arena_key_create(void) { pthread_key_create(&thread_arena_key, thread_arena_destroy); }
+
+arena_t* arena_thread_local(void) {
+  pthread_once(&thread_arena_once, thread_arena_key_create);
+  arena_t* arena = (arena_t*)pthread_getspecific(thread_arena_key);
+  if (arena == NULL) {
+    // The buffer lives right behind the arena, so one allocation makes up the whole arena
+    arena = (arena_t*)malloc(sizeof(arena_t) + ARENA_THREAD_BUFFER_SIZE);
+    if (arena == NULL) {
+      return NULL;
+    }
+    arena_init(arena, arena + 1, ARENA_THREAD_BUFFER_SIZE);
+    if (pthread_setspecific(thread_arena_key, arena)) {
+      free(arena);
+      return NULL;
+    }
+  }
+  return arena;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_ARENA_H_
+#define UTILS_ARENA_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file arena.h
+ * @brief Bump allocator for memory living as long as one request
+ *
+ * Allocations are carved out of a caller provided buffer, usually on the stack, and then out of heap blocks chained
+ * behind it. Nothing is freed one by one, the whole arena is released at the end of the request.
+ *
+ * Each thread also owns an arena of its own, see arena_thread_local(). It is rewound instead of released between
+ * requests, so the heap blocks it grew stay around for the next requests of the thread.
+ */
+
+/** Size of the heap blocks added when the current block is full */
+#define ARENA_BLOCK_SIZE 8192
+
+/** Size of the initial buffer of the per-thread arenas */
+#define ARENA_THREAD_BUFFER_SIZE 65536
+
+typedef struct arena_block_s {
+  struct arena_block_s* next;
+  size_t size; /**< Size of the block including its header */
+} arena_block_t;
+
+/** Bump allocator */
+typedef struct arena_s {
+  char* ptr;             /**< Next free byte of the current block */
+  char* end;             /**< End of the current block */
+  char* initial;         /**< Caller provided buffer */
+  size_t initial_size;   /**< Size of the caller provided buffer */
+  arena_block_t* blocks; /**< Heap blocks, the newest first */
+  arena_block_t* spare;  /**< Heap blocks kept by arena_rewind() for reuse */
+  size_t num_blocks;     /**< Number of heap blocks allocated since initialized */
+} arena_t;
+
+/**
+ * @brief Initialize an arena
+ *
+ * @param[out] arena The arena
+ * @param[in] buf Buffer for the first allocations, may be NULL
+ * @param[in] size Size of `buf`
+ */
+void arena_init(arena_t* const arena, void* const buf, const size_t size);
+
+/**
+ * @brief Allocate memory aligned for any type
+ *
+ * @param[in] arena The arena
+ * @param[in] size Number of bytes
+ *
+ * @return Pointer to the memory, or NULL on OOM
+ */
+void* arena_alloc(arena_t* const arena, const size_t size);
+
+/**
+ * @brief Copy a string into the arena
+ *
+ * @param[in] arena The arena
+ * @param[in] str String to copy
+ * @param[in] len Length of the string
+ *
+ * @return NUL terminated copy, or NULL on OOM
+ */
+char* arena_strndup(arena_t* const arena, char const* const str, const size_t len);
+
+/**
+ * @brief Release all the allocations, keeping the caller provided buffer for reuse
+ *
+ * @param[in] arena The arena
+ */
+void arena_reset(arena_t* const arena);
+
+/**
+ * @brief Release all the allocations, keeping the heap blocks for reuse
+ *
+ * Unlike arena_reset(), blocks of the default size are not freed but reused by the next allocations. Blocks of
+ * oversized allocations are freed.
+ *
+ * @param[in] arena The arena
+ */
+void arena_rewind(arena_t* const arena);
+
+/**
+ * @brief Get the arena of the calling thread
+ *
+ * The arena is created with a buffer of ARENA_THREAD_BUFFER_SIZE on the first call of each thread, and destroyed when
+ * the thread exits. Users rewind it with arena_rewind() once they are done with their allocations.
+ *
+ * @return The arena, or NULL on OOM
+ */
+arena_t* arena_thread_local(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_ARENA_H_
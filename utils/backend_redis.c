@@ -7,14 +7,19 @@
  */
 
 #include <hiredis/hiredis.h>
+#include <stdarg.h>
 #include "cache.h"
+#include "utils/handles/lock.h"
 #include "utils/logger_helper.h"
 
 #define BR_LOGGER "backend_redis"
+/** Members added by one ZADD command, larger sets are added in several commands */
+#define BR_ZADD_BATCH 1000
 
 /* private data used by cache_t */
 typedef struct {
   redisContext* rc;
+  lock_handle_t lock; /**< A hiredis context is not thread-safe, this serializes each command with its reply */
 } connection_private;
 #define CONN(c) ((connection_private*)(c.conn))
 
@@ -91,6 +96,197 @@ static status_t redis_set(redisContext* c, const char* const key, const char* co
   return ret;
 }
 
+static status_t redis_zadd(redisContext* c, const char* const key, const double score, char const* const members,
+                           const size_t member_len, const size_t num, const uint32_t ttl) {
+  status_t ret = SC_OK;
+  char score_str[32];
+  size_t batch = num < BR_ZADD_BATCH ? num : BR_ZADD_BATCH;
+  // ZADD key NX score member [score member ...]
+  char const** argv = (char const**)malloc((3 + 2 * batch) * sizeof(char*));
+  size_t* argvlen = (size_t*)malloc((3 + 2 * batch) * sizeof(size_t));
+  if (key == NULL || members == NULL) {
+    ret = SC_CACHE_NULL;
+    ta_log_error("%s\n", "SC_CACHE_NULL");
+    goto done;
+  }
+  if (argv == NULL || argvlen == NULL) {
+    ret = SC_CACHE_OOM;
+    ta_log_error("%s\n", "SC_CACHE_OOM");
+    goto done;
+  }
+
+  argv[0] = "ZADD";
+  argvlen[0] = strlen("ZADD");
+  argv[1] = key;
+  argvlen[1] = strlen(key);
+  argv[2] = "NX";
+  argvlen[2] = strlen("NX");
+  size_t score_len = snprintf(score_str, sizeof(score_str), "%.0f", score);
+  for (size_t added = 0; added < num; added += batch) {
+    size_t count = num - added < batch ? num - added : batch;
+    for (size_t i = 0; i < count; i++) {
+      argv[3 + 2 * i] = score_str;
+      argvlen[3 + 2 * i] = score_len;
+      argv[4 + 2 * i] = members + (added + i) * member_len;
+      argvlen[4 + 2 * i] = member_len;
+    }
+    redisReply* reply = redisCommandArgv(c, 3 + 2 * count, argv, argvlen);
+    if (reply == NULL || reply->type != REDIS_REPLY_INTEGER) {
+      ret = SC_CACHE_FAILED_RESPONSE;
+      ta_log_error("%s\n", "SC_CACHE_FAILED_RESPONSE");
+    }
+    freeReplyObject(reply);
+    if (ret != SC_OK) {
+      goto done;
+    }
+  }
+  if (ttl) {
+    redisReply* reply = redisCommand(c, "EXPIRE %s %u", key, ttl);
+    if (reply == NULL || reply->type != REDIS_REPLY_INTEGER) {
+      ret = SC_CACHE_FAILED_RESPONSE;
+      ta_log_error("%s\n", "SC_CACHE_FAILED_RESPONSE");
+    }
+    freeReplyObject(reply);
+  }
+
+done:
+  free(argv);
+  free(argvlen);
+  return ret;
+}
+
+static status_t redis_mget(redisContext* c, char const* const keys, const size_t key_len, const size_t num,
+                           char* const values, const size_t value_len, bool* const found) {
+  status_t ret = SC_OK;
+  // MGET key [key ...]
+  char const** argv = (char const**)malloc((1 + num) * sizeof(char*));
+  size_t* argvlen = (size_t*)malloc((1 + num) * sizeof(size_t));
+  if (keys == NULL || values == NULL || found == NULL) {
+    ret = SC_CACHE_NULL;
+    ta_log_error("%s\n", "SC_CACHE_NULL");
+    goto done;
+  }
+  if (argv == NULL || argvlen == NULL) {
+    ret = SC_CACHE_OOM;
+    ta_log_error("%s\n", "SC_CACHE_OOM");
+    goto done;
+  }
+
+  argv[0] = "MGET";
+  argvlen[0] = strlen("MGET");
+  for (size_t i = 0; i < num; i++) {
+    argv[1 + i] = keys + i * key_len;
+    argvlen[1 + i] = key_len;
+    found[i] = false;
+  }
+  redisReply* reply = redisCommandArgv(c, 1 + num, argv, argvlen);
+  if (reply == NULL || reply->type != REDIS_REPLY_ARRAY || reply->elements != num) {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", "SC_CACHE_FAILED_RESPONSE");
+  } else {
+    for (size_t i = 0; i < num; i++) {
+      redisReply* element = reply->element[i];
+      // Missing keys are nil
+      if (element->type == REDIS_REPLY_STRING && (size_t)element->len == value_len) {
+        memcpy(values + i * value_len, element->str, value_len);
+        found[i] = true;
+      }
+    }
+  }
+  freeReplyObject(reply);
+
+done:
+  free(argv);
+  free(argvlen);
+  return ret;
+}
+
+static status_t redis_mset(redisContext* c, char const* const keys, const size_t key_len, char const* const values,
+                           const size_t value_len, const size_t num) {
+  status_t ret = SC_OK;
+  // MSET key value [key value ...]
+  char const** argv = (char const**)malloc((1 + 2 * num) * sizeof(char*));
+  size_t* argvlen = (size_t*)malloc((1 + 2 * num) * sizeof(size_t));
+  if (keys == NULL || values == NULL) {
+    ret = SC_CACHE_NULL;
+    ta_log_error("%s\n", "SC_CACHE_NULL");
+    goto done;
+  }
+  if (argv == NULL || argvlen == NULL) {
+    ret = SC_CACHE_OOM;
+    ta_log_error("%s\n", "SC_CACHE_OOM");
+    goto done;
+  }
+
+  argv[0] = "MSET";
+  argvlen[0] = strlen("MSET");
+  for (size_t i = 0; i < num; i++) {
+    argv[1 + 2 * i] = keys + i * key_len;
+    argvlen[1 + 2 * i] = key_len;
+    argv[2 + 2 * i] = values + i * value_len;
+    argvlen[2 + 2 * i] = value_len;
+  }
+  redisReply* reply = redisCommandArgv(c, 1 + 2 * num, argv, argvlen);
+  if (reply == NULL || reply->type != REDIS_REPLY_STATUS) {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", "SC_CACHE_FAILED_RESPONSE");
+  }
+  freeReplyObject(reply);
+
+done:
+  free(argv);
+  free(argvlen);
+  return ret;
+}
+
+static status_t redis_integer_command(redisContext* c, size_t* const count, const char* const format, ...) {
+  status_t ret = SC_OK;
+  va_list args;
+
+  va_start(args, format);
+  redisReply* reply = redisvCommand(c, format, args);
+  va_end(args);
+  if (reply == NULL || reply->type != REDIS_REPLY_INTEGER) {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", "SC_CACHE_FAILED_RESPONSE");
+  } else {
+    *count = reply->integer;
+  }
+
+  freeReplyObject(reply);
+  return ret;
+}
+
+static status_t redis_zrange(redisContext* c, const char* const key, const size_t start, const size_t num,
+                             char* const members, const size_t member_len, size_t* const count) {
+  status_t ret = SC_OK;
+  *count = 0;
+  if (key == NULL || members == NULL) {
+    ta_log_error("%s\n", "SC_CACHE_NULL");
+    return SC_CACHE_NULL;
+  }
+  if (num == 0) {
+    return SC_OK;
+  }
+
+  redisReply* reply = redisCommand(c, "ZRANGE %s %zu %zu", key, start, start + num - 1);
+  if (reply == NULL || reply->type != REDIS_REPLY_ARRAY) {
+    ret = SC_CACHE_FAILED_RESPONSE;
+    ta_log_error("%s\n", "SC_CACHE_FAILED_RESPONSE");
+  } else {
+    for (size_t i = 0; i < reply->elements && *count < num; i++) {
+      redisReply* element = reply->element[i];
+      if (element->type == REDIS_REPLY_STRING && (size_t)element->len == member_len) {
+        memcpy(members + *count * member_len, element->str, member_len);
+        (*count)++;
+      }
+    }
+  }
+
+  freeReplyObject(reply);
+  return ret;
+}
+
 /*
  * Public functions
  */
@@ -102,6 +298,11 @@ bool cache_init(bool state, const char* host, int port) {
   }
 
   cache.conn = (connection_private*)malloc(sizeof(connection_private));
+  if (cache.conn == NULL) {
+    cache_state = false;
+    return false;
+  }
+  lock_handle_init(&CONN(cache)->lock);
   CONN(cache)->rc = redisConnect(host, port);
   if (CONN(cache)->rc) {
     return true;
@@ -112,6 +313,7 @@ bool cache_init(bool state, const char* host, int port) {
 void cache_stop() {
   if (cache_state == true && CONN(cache)->rc) {
     redisFree(CONN(cache)->rc);
+    lock_handle_destroy(&CONN(cache)->lock);
 
     if (CONN(cache)) {
       free(CONN(cache));
@@ -124,7 +326,10 @@ status_t cache_del(const char* const key) {
     ta_log_error("%s\n", "SC_CACHE_OFF");
     return SC_CACHE_OFF;
   }
-  return redis_del(CONN(cache)->rc, key);
+  lock_handle_lock(&CONN(cache)->lock);
+  status_t ret = redis_del(CONN(cache)->rc, key);
+  lock_handle_unlock(&CONN(cache)->lock);
+  return ret;
 }
 
 status_t cache_get(const char* const key, char* res) {
@@ -132,7 +337,10 @@ status_t cache_get(const char* const key, char* res) {
     ta_log_error("%s\n", "SC_CACHE_OFF");
     return SC_CACHE_OFF;
   }
-  return redis_get(CONN(cache)->rc, key, res);
+  lock_handle_lock(&CONN(cache)->lock);
+  status_t ret = redis_get(CONN(cache)->rc, key, res);
+  lock_handle_unlock(&CONN(cache)->lock);
+  return ret;
 }
 
 status_t cache_set(const char* const key, const char* const value) {
@@ -140,5 +348,84 @@ status_t cache_set(const char* const key, const char* const value) {
     ta_log_error("%s\n", "SC_CACHE_OFF");
     return SC_CACHE_OFF;
   }
-  return redis_set(CONN(cache)->rc, key, value);
+  lock_handle_lock(&CONN(cache)->lock);
+  status_t ret = redis_set(CONN(cache)->rc, key, value);
+  lock_handle_unlock(&CONN(cache)->lock);
+  return ret;
+}
+
+status_t cache_mget(char const* const keys, const size_t key_len, const size_t num, char* const values,
+                    const size_t value_len, bool* const found) {
+  if (!cache_state) {
+    ta_log_error("%s\n", "SC_CACHE_OFF");
+    return SC_CACHE_OFF;
+  }
+  if (num == 0) {
+    return SC_OK;
+  }
+  lock_handle_lock(&CONN(cache)->lock);
+  status_t ret = redis_mget(CONN(cache)->rc, keys, key_len, num, values, value_len, found);
+  lock_handle_unlock(&CONN(cache)->lock);
+  return ret;
+}
+
+status_t cache_mset(char const* const keys, const size_t key_len, char const* const values, const size_t value_len,
+                    const size_t num) {
+  if (!cache_state) {
+    ta_log_error("%s\n", "SC_CACHE_OFF");
+    return SC_CACHE_OFF;
+  }
+  if (num == 0) {
+    return SC_OK;
+  }
+  lock_handle_lock(&CONN(cache)->lock);
+  status_t ret = redis_mset(CONN(cache)->rc, keys, key_len, values, value_len, num);
+  lock_handle_unlock(&CONN(cache)->lock);
+  return ret;
+}
+
+status_t cache_zset_add(const char* const key, const double score, char const* const members, const size_t member_len,
+                        const size_t num, const uint32_t ttl) {
+  if (!cache_state) {
+    ta_log_error("%s\n", "SC_CACHE_OFF");
+    return SC_CACHE_OFF;
+  }
+  lock_handle_lock(&CONN(cache)->lock);
+  status_t ret = redis_zadd(CONN(cache)->rc, key, score, members, member_len, num, ttl);
+  lock_handle_unlock(&CONN(cache)->lock);
+  return ret;
+}
+
+status_t cache_zset_count(const char* const key, size_t* const count) {
+  if (!cache_state) {
+    ta_log_error("%s\n", "SC_CACHE_OFF");
+    return SC_CACHE_OFF;
+  }
+  lock_handle_lock(&CONN(cache)->lock);
+  status_t ret = redis_integer_command(CONN(cache)->rc, count, "ZCARD %s", key);
+  lock_handle_unlock(&CONN(cache)->lock);
+  return ret;
+}
+
+status_t cache_zset_count_below(const char* const key, const double score, size_t* const count) {
+  if (!cache_state) {
+    ta_log_error("%s\n", "SC_CACHE_OFF");
+    return SC_CACHE_OFF;
+  }
+  lock_handle_lock(&CONN(cache)->lock);
+  status_t ret = redis_integer_command(CONN(cache)->rc, count, "ZCOUNT %s -inf (%.0f", key, score);
+  lock_handle_unlock(&CONN(cache)->lock);
+  return ret;
+}
+
+status_t cache_zset_range(const char* const key, const size_t start, const size_t num, char* const members,
+                          const size_t member_len, size_t* const count) {
+  if (!cache_state) {
+    ta_log_error("%s\n", "SC_CACHE_OFF");
+    return SC_CACHE_OFF;
+  }
+  lock_handle_lock(&CONN(cache)->lock);
+  status_t ret = redis_zrange(CONN(cache)->rc, key, start, num, members, member_len, count);
+  lock_handle_unlock(&CONN(cache)->lock);
+  return ret;
 }
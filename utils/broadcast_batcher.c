@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "broadcast_batcher.h"
+#include <string.h>
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/iri_pool.h"
+#include "utils/logger_helper.h"
+#include "utils/time.h"
+
+#define BROADCAST_BATCHER_LOGGER "broadcast_batcher"
+
+/** Trytes of concurrent requests sent with one store and one broadcast call */
+typedef struct broadcast_batch_s {
+  const iota_client_service_t* service;
+  store_transactions_req_t* req;
+  size_t waiters; /**< Requests other than the leader waiting for the result */
+  status_t ret;
+  bool done;
+  cond_handle_t cond; /**< Signaled when the batch is full, done, or a waiter leaves */
+} broadcast_batch_t;
+
+static struct broadcast_batcher_s {
+  lock_handle_t lock;
+  broadcast_batch_t* open; /**< Batch still collecting trytes, owned by its leader */
+  uint16_t window;         /**< Batching window in milliseconds */
+  uint16_t batch_size;     /**< Number of transactions which flushes the batch early */
+} batcher;
+
+static logger_id_t logger_id;
+
+void broadcast_batcher_logger_init() { logger_id = logger_helper_enable(BROADCAST_BATCHER_LOGGER, LOGGER_DEBUG, true); }
+
+int broadcast_batcher_logger_release() {
+  logger_helper_release(logger_id);
+  if (logger_helper_destroy() != RC_OK) {
+    ta_log_critical("Destroying logger failed %s.\n", BROADCAST_BATCHER_LOGGER);
+    return EXIT_FAILURE;
+  }
+
+  return 0;
+}
+
+void broadcast_batcher_init(const uint16_t window, const uint16_t batch_size) {
+  lock_handle_init(&batcher.lock);
+  batcher.open = NULL;
+  batcher.window = window;
+  batcher.batch_size = batch_size;
+}
+
+void broadcast_batcher_destroy() { lock_handle_destroy(&batcher.lock); }
+
+static status_t store_and_broadcast(const iota_client_service_t* const service, store_transactions_req_t* const req) {
+  status_t ret = iri_pool_check(service);
+  if (ret != SC_OK) {
+    return ret;
+  }
+  ta_log_debug("Broadcasting %zu transactions\n", hash_array_len(req->trytes));
+  if (iota_client_store_and_broadcast(service, req) != RC_OK) {
+    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+    return SC_CCLIENT_FAILED_RESPONSE;
+  }
+  return SC_OK;
+}
+
+static void batch_add_trytes(broadcast_batch_t* const batch, const hash8019_array_p trytes) {
+  flex_trit_t* elt = NULL;
+  HASH_ARRAY_FOREACH(trytes, elt) { hash_array_push(batch->req->trytes, elt); }
+}
+
+/**
+ * Wait in the open batch until its leader has sent it. Must be called with the batcher lock held.
+ */
+static status_t batch_join(broadcast_batch_t* const batch, const hash8019_array_p trytes) {
+  status_t ret = SC_OK;
+
+  batch_add_trytes(batch, trytes);
+  batch->waiters++;
+  if (hash_array_len(batch->req->trytes) >= batcher.batch_size) {
+    // Wake up the leader to flush the full batch
+    cond_handle_broadcast(&batch->cond);
+  }
+
+  while (!batch->done) {
+    cond_handle_wait(&batch->cond, &batcher.lock);
+  }
+  ret = batch->ret;
+
+  // The batch lives on the stack of the leader, which waits for every waiter to leave
+  if (--batch->waiters == 0) {
+    cond_handle_broadcast(&batch->cond);
+  }
+  return ret;
+}
+
+/**
+ * Requests on different connections of the IRI connection pool still reach the same node
+ */
+static bool same_node(const iota_client_service_t* const a, const iota_client_service_t* const b) {
+  return a == b || (a->http.port == b->http.port && !strcmp(a->http.host, b->http.host));
+}
+
+/**
+ * Collect trytes of concurrent requests during the window, then send them. Must be called with the batcher lock
+ * held, and returns with the lock released.
+ */
+static status_t batch_lead(const iota_client_service_t* const service, const hash8019_array_p trytes) {
+  status_t ret = SC_OK;
+  broadcast_batch_t batch = {.service = service, .waiters = 0, .ret = SC_OK, .done = false};
+
+  batch.req = store_transactions_req_new();
+  if (batch.req == NULL) {
+    lock_handle_unlock(&batcher.lock);
+    ta_log_error("%s\n", "SC_CCLIENT_OOM");
+    return SC_CCLIENT_OOM;
+  }
+  cond_handle_init(&batch.cond);
+  batch_add_trytes(&batch, trytes);
+  batcher.open = &batch;
+
+  uint64_t deadline = current_timestamp_ms() + batcher.window;
+  for (uint64_t now = current_timestamp_ms(); now < deadline && hash_array_len(batch.req->trytes) < batcher.batch_size;
+       now = current_timestamp_ms()) {
+    cond_handle_timedwait(&batch.cond, &batcher.lock, deadline - now);
+  }
+  // Requests arriving from now on start the next batch
+  batcher.open = NULL;
+  lock_handle_unlock(&batcher.lock);
+
+  ret = store_and_broadcast(service, batch.req);
+
+  lock_handle_lock(&batcher.lock);
+  batch.ret = ret;
+  batch.done = true;
+  cond_handle_broadcast(&batch.cond);
+  while (batch.waiters) {
+    cond_handle_wait(&batch.cond, &batcher.lock);
+  }
+  lock_handle_unlock(&batcher.lock);
+
+  cond_handle_destroy(&batch.cond);
+  store_transactions_req_free(&batch.req);
+  return ret;
+}
+
+status_t broadcast_batcher_submit(const iota_client_service_t* const service, const hash8019_array_p trytes) {
+  status_t ret = SC_OK;
+  store_transactions_req_t* req = NULL;
+
+  if (service == NULL || trytes == NULL) {
+    ta_log_error("%s\n", "SC_TA_NULL");
+    return SC_TA_NULL;
+  }
+
+  lock_handle_lock(&batcher.lock);
+  if (batcher.window && batcher.open == NULL) {
+    return batch_lead(service, trytes);
+  }
+  if (batcher.window && same_node(batcher.open->service, service)) {
+    ret = batch_join(batcher.open, trytes);
+    lock_handle_unlock(&batcher.lock);
+    return ret;
+  }
+  lock_handle_unlock(&batcher.lock);
+
+  // Batching is off, or the open batch targets another node
+  req = store_transactions_req_new();
+  if (req == NULL) {
+    ta_log_error("%s\n", "SC_CCLIENT_OOM");
+    return SC_CCLIENT_OOM;
+  }
+  flex_trit_t* elt = NULL;
+  HASH_ARRAY_FOREACH(trytes, elt) { hash_array_push(req->trytes, elt); }
+  ret = store_and_broadcast(service, req);
+  store_transactions_req_free(&req);
+  return ret;
+}
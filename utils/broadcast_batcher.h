@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_BROADCAST_BATCHER_H_
+#define UTILS_BROADCAST_BATCHER_H_
+
+#include <stdint.h>
+#include "accelerator/errors.h"
+#include "cclient/api/extended/extended_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file broadcast_batcher.h
+ * @brief Coalesce storeTransactions and broadcastTransactions of concurrent requests
+ *
+ * The first request which submits trytes becomes the leader of a batch. It waits for the batching window or until
+ * the batch is full, then sends all the trytes collected in the meantime with one store and one broadcast call. The
+ * other requests of the batch block until the leader is done and get the same result.
+ */
+
+/**
+ * Initialize logger
+ */
+void broadcast_batcher_logger_init();
+
+/**
+ * Release logger
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int broadcast_batcher_logger_release();
+
+/**
+ * Initialize the broadcast batcher
+ *
+ * @param[in] window Batching window in milliseconds, zero sends every request on its own
+ * @param[in] batch_size Number of transactions which flushes a batch before the window ends
+ */
+void broadcast_batcher_init(const uint16_t window, const uint16_t batch_size);
+
+/**
+ * Destroy the broadcast batcher
+ */
+void broadcast_batcher_destroy();
+
+/**
+ * Store and broadcast attached trytes, coalesced with the trytes of concurrent requests
+ *
+ * @param[in] service IRI node end point service
+ * @param[in] trytes Attached transaction trytes
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t broadcast_batcher_submit(const iota_client_service_t* const service, const hash8019_array_p trytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_BROADCAST_BATCHER_H_
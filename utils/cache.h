@@ -10,6 +10,7 @@
 #define UTILS_CACHE_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -23,6 +24,10 @@ extern "C" {
 /**
  * @file cache.h
  * @brief Implementation of cache interface
+ *
+ * The cache is one connection shared by the whole process. Requests may call it from any thread, their commands are
+ * sent one at a time.
+ *
  * @example test_cache.c
  */
 
@@ -100,6 +105,98 @@ status_t cache_get(const char* const key, char* res);
  */
 status_t cache_set(const char* const key, const char* const value);
 
+/**
+ * Get the values of several keys with one round trip
+ *
+ * @param[in] keys `num` keys of `key_len` bytes, back to back
+ * @param[in] key_len Length of each key
+ * @param[in] num Number of keys
+ * @param[out] values Values of `value_len` bytes, back to back in the order of the keys, room for `num` of them
+ * @param[in] value_len Length of each value, values of another length are left out
+ * @param[out] found Whether the value of each key was found
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_mget(char const* const keys, const size_t key_len, const size_t num, char* const values,
+                    const size_t value_len, bool* const found);
+
+/**
+ * Set the values of several keys with one round trip, overwriting the values already set
+ *
+ * @param[in] keys `num` keys of `key_len` bytes, back to back
+ * @param[in] key_len Length of each key
+ * @param[in] values `num` values of `value_len` bytes, back to back in the order of the keys
+ * @param[in] value_len Length of each value
+ * @param[in] num Number of keys
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_mset(char const* const keys, const size_t key_len, char const* const values, const size_t value_len,
+                    const size_t num);
+
+/**
+ * Add members to a sorted set, keeping the score of the members already in it, and reset the expiry of the set
+ *
+ * @param[in] key Key of the sorted set
+ * @param[in] score Score of the new members
+ * @param[in] members `num` members of `member_len` bytes, back to back
+ * @param[in] member_len Length of each member
+ * @param[in] num Number of members
+ * @param[in] ttl Seconds the set is kept after this call, 0 to keep it forever
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_zset_add(const char* const key, const double score, char const* const members, const size_t member_len,
+                        const size_t num, const uint32_t ttl);
+
+/**
+ * Count the members of a sorted set
+ *
+ * @param[in] key Key of the sorted set
+ * @param[out] count Number of members, 0 if there is no such set
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_zset_count(const char* const key, size_t* const count);
+
+/**
+ * Count the members of a sorted set with a score lower than `score`
+ *
+ * @param[in] key Key of the sorted set
+ * @param[in] score Exclusive upper bound of the scores
+ * @param[out] count Number of members
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_zset_count_below(const char* const key, const double score, size_t* const count);
+
+/**
+ * Get members of a sorted set in the order of their scores
+ *
+ * @param[in] key Key of the sorted set
+ * @param[in] start Rank of the first member
+ * @param[in] num Maximum number of members
+ * @param[out] members Members of `member_len` bytes, back to back, room for `num` of them
+ * @param[in] member_len Length of each member, members of another length are skipped
+ * @param[out] count Number of members written
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t cache_zset_range(const char* const key, const size_t start, const size_t num, char* const members,
+                          const size_t member_len, size_t* const count);
+
 #ifdef __cplusplus
 }
 #endif
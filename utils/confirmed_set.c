@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "confirmed_set.h"
+#include <stdlib.h>
+#include <string.h>
+#include "common/model/transaction.h"
+#include "uthash.h"
+#include "utils/cache.h"
+#include "utils/handles/lock.h"
+#include "utils/logger_helper.h"
+#include "utils/trinary_kernels.h"
+
+#define CONFIRMED_SET_LOGGER "confirmed_set"
+/** Hashes looked up in or written to the cache with one round trip */
+#define CONFIRMED_SET_CHUNK 16
+/** Cache key of a confirmed transaction, followed by its hash */
+#define CONFIRMED_KEY_PREFIX "confirmed:"
+#define CONFIRMED_KEY_PREFIX_LEN (sizeof(CONFIRMED_KEY_PREFIX) - 1)
+#define CONFIRMED_KEY_LEN (CONFIRMED_KEY_PREFIX_LEN + NUM_TRYTES_HASH)
+
+typedef struct confirmed_set_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  UT_hash_handle hh;
+} confirmed_set_entry_t;
+
+static struct confirmed_set_s {
+  lock_handle_t lock;
+  confirmed_set_entry_t* entries; /**< Ring of `capacity` entries, the oldest one is replaced once all are used */
+  confirmed_set_entry_t* table;   /**< Hash table of the used entries */
+  size_t capacity;
+  size_t count; /**< Number of used entries */
+  size_t next;  /**< Entry used by the next transaction */
+} set;
+
+/** Transactions looked up in or written to the cache together */
+typedef struct confirmed_set_batch_s {
+  char keys[CONFIRMED_SET_CHUNK * CONFIRMED_KEY_LEN];
+  flex_trit_t const* hashes[CONFIRMED_SET_CHUNK];
+  size_t index[CONFIRMED_SET_CHUNK]; /**< Index of each transaction in the request */
+  size_t num;
+} confirmed_set_batch_t;
+
+static logger_id_t logger_id;
+
+void confirmed_set_logger_init() { logger_id = logger_helper_enable(CONFIRMED_SET_LOGGER, LOGGER_DEBUG, true); }
+
+int confirmed_set_logger_release() {
+  logger_helper_release(logger_id);
+  if (logger_helper_destroy() != RC_OK) {
+    ta_log_critical("Destroying logger failed %s.\n", CONFIRMED_SET_LOGGER);
+    return EXIT_FAILURE;
+  }
+
+  return 0;
+}
+
+status_t confirmed_set_init(const size_t capacity) {
+  lock_handle_init(&set.lock);
+  set.table = NULL;
+  set.count = set.next = 0;
+  set.capacity = capacity;
+  set.entries = NULL;
+  if (capacity == 0) {
+    return SC_OK;
+  }
+
+  set.entries = (confirmed_set_entry_t*)calloc(capacity, sizeof(confirmed_set_entry_t));
+  if (set.entries == NULL) {
+    set.capacity = 0;
+    ta_log_error("%s\n", "SC_UTILS_OOM");
+    return SC_UTILS_OOM;
+  }
+  return SC_OK;
+}
+
+void confirmed_set_destroy() {
+  HASH_CLEAR(hh, set.table);
+  free(set.entries);
+  set.entries = NULL;
+  set.capacity = set.count = set.next = 0;
+  lock_handle_destroy(&set.lock);
+}
+
+/**
+ * Look a transaction up in memory, with the lock held
+ */
+static bool confirmed_set_contains(flex_trit_t const* const hash) {
+  confirmed_set_entry_t* entry = NULL;
+  HASH_FIND(hh, set.table, hash, FLEX_TRIT_SIZE_243, entry);
+  return entry != NULL;
+}
+
+/**
+ * Keep a transaction in memory, with the lock held. The oldest one is pushed out once all entries are used.
+ */
+static void confirmed_set_insert(flex_trit_t const* const hash) {
+  if (set.capacity == 0 || confirmed_set_contains(hash)) {
+    return;
+  }
+
+  confirmed_set_entry_t* entry = &set.entries[set.next];
+  if (set.count == set.capacity) {
+    HASH_DEL(set.table, entry);
+  } else {
+    set.count++;
+  }
+  memcpy(entry->hash, hash, FLEX_TRIT_SIZE_243);
+  HASH_ADD(hh, set.table, hash, FLEX_TRIT_SIZE_243, entry);
+  set.next = (set.next + 1) % set.capacity;
+}
+
+static void confirmed_set_batch_push(confirmed_set_batch_t* const batch, flex_trit_t const* const hash,
+                                     const size_t index) {
+  char* key = batch->keys + batch->num * CONFIRMED_KEY_LEN;
+  memcpy(key, CONFIRMED_KEY_PREFIX, CONFIRMED_KEY_PREFIX_LEN);
+  ta_flex_trits_to_trytes((tryte_t*)(key + CONFIRMED_KEY_PREFIX_LEN), NUM_TRYTES_HASH, hash, NUM_TRITS_HASH,
+                          NUM_TRITS_HASH);
+  batch->hashes[batch->num] = hash;
+  batch->index[batch->num] = index;
+  batch->num++;
+}
+
+/**
+ * Look the transactions of a batch up in the cache, and keep the confirmed ones in memory
+ */
+static void confirmed_set_batch_find(confirmed_set_batch_t* const batch, bool* const confirmed) {
+  char values[CONFIRMED_SET_CHUNK];
+  bool found[CONFIRMED_SET_CHUNK];
+
+  // Without the cache the transactions are unknown
+  if (batch->num > 0 && cache_mget(batch->keys, CONFIRMED_KEY_LEN, batch->num, values, 1, found) == SC_OK) {
+    lock_handle_lock(&set.lock);
+    for (size_t i = 0; i < batch->num; i++) {
+      if (found[i]) {
+        confirmed[batch->index[i]] = true;
+        confirmed_set_insert(batch->hashes[i]);
+      }
+    }
+    lock_handle_unlock(&set.lock);
+  }
+  batch->num = 0;
+}
+
+/**
+ * Write the transactions of a batch into the cache. A failed write only costs another IRI request later.
+ */
+static void confirmed_set_batch_store(confirmed_set_batch_t* const batch) {
+  char values[CONFIRMED_SET_CHUNK];
+  if (batch->num > 0) {
+    memset(values, '1', sizeof(values));
+    cache_mset(batch->keys, CONFIRMED_KEY_LEN, values, 1, batch->num);
+  }
+  batch->num = 0;
+}
+
+status_t confirmed_set_find(hash243_queue_t const hashes, bool* const confirmed) {
+  confirmed_set_batch_t batch = {.num = 0};
+  hash243_queue_entry_t* iter = NULL;
+  size_t index = 0;
+  if (confirmed == NULL) {
+    ta_log_error("%s\n", "SC_UTILS_NULL");
+    return SC_UTILS_NULL;
+  }
+
+  CDL_FOREACH(hashes, iter) {
+    lock_handle_lock(&set.lock);
+    confirmed[index] = confirmed_set_contains(iter->hash);
+    lock_handle_unlock(&set.lock);
+
+    if (!confirmed[index]) {
+      confirmed_set_batch_push(&batch, iter->hash, index);
+      if (batch.num == CONFIRMED_SET_CHUNK) {
+        confirmed_set_batch_find(&batch, confirmed);
+      }
+    }
+    index++;
+  }
+  confirmed_set_batch_find(&batch, confirmed);
+  return SC_OK;
+}
+
+status_t confirmed_set_add(hash243_queue_t const hashes, bool const* const confirmed) {
+  confirmed_set_batch_t batch = {.num = 0};
+  hash243_queue_entry_t* iter = NULL;
+  size_t index = 0;
+
+  CDL_FOREACH(hashes, iter) {
+    if (confirmed == NULL || confirmed[index]) {
+      lock_handle_lock(&set.lock);
+      confirmed_set_insert(iter->hash);
+      lock_handle_unlock(&set.lock);
+
+      confirmed_set_batch_push(&batch, iter->hash, index);
+      if (batch.num == CONFIRMED_SET_CHUNK) {
+        confirmed_set_batch_store(&batch);
+      }
+    }
+    index++;
+  }
+  confirmed_set_batch_store(&batch);
+  return SC_OK;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_CONFIRMED_SET_H_
+#define UTILS_CONFIRMED_SET_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "accelerator/errors.h"
+#include "utils/containers/hash/hash243_queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file confirmed_set.h
+ * @brief Transactions known to be confirmed
+ *
+ * A confirmed transaction stays confirmed, so its inclusion state is never asked to IRI again once it is known. The
+ * most recently added transactions are kept in memory, and all of them in the cache, where the ones pushed out of
+ * memory are still found by every tangle-accelerator sharing the cache.
+ *
+ * @example test_confirmed_set.c
+ */
+
+/**
+ * Initialize logger
+ */
+void confirmed_set_logger_init();
+
+/**
+ * Release logger
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int confirmed_set_logger_release();
+
+/**
+ * Initialize the confirmed set
+ *
+ * @param[in] capacity Transactions kept in memory, zero to keep them in the cache only
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t confirmed_set_init(const size_t capacity);
+
+/**
+ * Release the transactions kept in memory
+ */
+void confirmed_set_destroy();
+
+/**
+ * Find which transactions are known to be confirmed. The ones found in the cache only are kept in memory from then on.
+ *
+ * @param[in] hashes Transaction hashes
+ * @param[out] confirmed Whether each transaction is known to be confirmed, in the order of `hashes`
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t confirmed_set_find(hash243_queue_t const hashes, bool* const confirmed);
+
+/**
+ * Add confirmed transactions
+ *
+ * @param[in] hashes Transaction hashes
+ * @param[in] confirmed Whether each transaction is confirmed, in the order of `hashes`. NULL to add all of them.
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t confirmed_set_add(hash243_queue_t const hashes, bool const* const confirmed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_CONFIRMED_SET_H_
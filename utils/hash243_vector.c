@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "hash243_vector.h"
+#include <stdlib.h>
+#include <string.h>
+
+void hash243_vector_init(hash243_vector_t* const vec, arena_t* const arena) {
+  vec->hashes = NULL;
+  vec->count = 0;
+  vec->capacity = 0;
+  vec->arena = arena;
+}
+
+status_t hash243_vector_reserve(hash243_vector_t* const vec, const size_t capacity) {
+  if (capacity <= vec->capacity) {
+    return SC_OK;
+  }
+
+  flex_trit_t* hashes = NULL;
+  if (vec->arena) {
+    // The arena cannot grow an allocation in place, the old hashes stay behind until the arena is released
+    hashes = (flex_trit_t*)arena_alloc(vec->arena, capacity * FLEX_TRIT_SIZE_243);
+    if (hashes && vec->count) {
+      memcpy(hashes, vec->hashes, vec->count * FLEX_TRIT_SIZE_243);
+    }
+  } else {
+    hashes = (flex_trit_t*)realloc(vec->hashes, capacity * FLEX_TRIT_SIZE_243);
+  }
+  if (hashes == NULL) {
+    return SC_UTILS_OOM;
+  }
+  vec->hashes = hashes;
+  vec->capacity = capacity;
+  return SC_OK;
+}
+
+status_t hash243_vector_push(hash243_vector_t* const vec, flex_trit_t const* const hash) {
+  if (vec->count == vec->capacity) {
+    status_t ret = hash243_vector_reserve(vec, vec->capacity ? vec->capacity * 2 : HASH243_VECTOR_INITIAL_CAPACITY);
+    if (ret != SC_OK) {
+      return ret;
+    }
+  }
+  memcpy(vec->hashes + vec->count * FLEX_TRIT_SIZE_243, hash, FLEX_TRIT_SIZE_243);
+  vec->count++;
+  return SC_OK;
+}
+
+void hash243_vector_free(hash243_vector_t* const vec) {
+  if (vec->arena == NULL) {
+    free(vec->hashes);
+  }
+  vec->hashes = NULL;
+  vec->count = 0;
+  vec->capacity = 0;
+}
+
+status_t hash243_vector_append_queue(hash243_vector_t* const vec, hash243_queue_t const queue) {
+  hash243_queue_entry_t* q_iter = NULL;
+  status_t ret = hash243_vector_reserve(vec, vec->count + hash243_queue_count(queue));
+  if (ret != SC_OK) {
+    return ret;
+  }
+
+  CDL_FOREACH(queue, q_iter) {
+    memcpy(vec->hashes + vec->count * FLEX_TRIT_SIZE_243, q_iter->hash, FLEX_TRIT_SIZE_243);
+    vec->count++;
+  }
+  return SC_OK;
+}
+
+status_t hash243_vector_to_queue(hash243_vector_t const* const vec, arena_t* const arena,
+                                 hash243_queue_t* const queue) {
+  *queue = NULL;
+  if (vec->count == 0) {
+    return SC_OK;
+  }
+
+  hash243_queue_entry_t* entries =
+      (hash243_queue_entry_t*)arena_alloc(arena, vec->count * sizeof(hash243_queue_entry_t));
+  if (entries == NULL) {
+    return SC_UTILS_OOM;
+  }
+
+  // Link the entries into the circular doubly linked list of utlist, the head being the first hash
+  for (size_t i = 0; i < vec->count; i++) {
+    memcpy(entries[i].hash, vec->hashes + i * FLEX_TRIT_SIZE_243, FLEX_TRIT_SIZE_243);
+    entries[i].next = &entries[(i + 1) % vec->count];
+    entries[i].prev = &entries[(i + vec->count - 1) % vec->count];
+  }
+  *queue = entries;
+  return SC_OK;
+}
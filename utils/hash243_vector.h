@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_HASH243_VECTOR_H_
+#define UTILS_HASH243_VECTOR_H_
+
+#include <stddef.h>
+#include "accelerator/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/arena.h"
+#include "utils/containers/hash/hash243_queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file hash243_vector.h
+ * @brief Contiguous array of 243 trits hashes
+ *
+ * The hashes are stored back to back as FLEX_TRIT_SIZE_243 bytes each, so pushing a hash is a copy into the array
+ * instead of one allocation per hash as with `hash243_queue_t`, and iterating over them is a walk through one buffer.
+ * The storage is taken from an arena when one is given, so request scoped vectors are released with the arena.
+ *
+ * `hash243_queue_t` is still the type of the cclient requests and responses, the adapters below convert between
+ * both at that boundary.
+ *
+ * @example test_hash243_vector.c
+ */
+
+/** Hashes reserved by the first push */
+#define HASH243_VECTOR_INITIAL_CAPACITY 16
+
+typedef struct hash243_vector_s {
+  flex_trit_t* hashes; /**< `count` hashes of FLEX_TRIT_SIZE_243 bytes */
+  size_t count;        /**< Number of hashes */
+  size_t capacity;     /**< Number of hashes `hashes` can hold */
+  arena_t* arena;      /**< Arena of `hashes`, NULL for the heap */
+} hash243_vector_t;
+
+/**
+ * @brief The hash vector iterator, `hash` points to the flex trits of each hash in order.
+ */
+#define HASH243_VECTOR_FOREACH(vec, hash)                                                              \
+  for (hash = (vec)->hashes; hash != NULL && hash < (vec)->hashes + (vec)->count * FLEX_TRIT_SIZE_243; \
+       hash += FLEX_TRIT_SIZE_243)
+
+/**
+ * @brief Initialize an empty vector
+ *
+ * @param[out] vec The vector
+ * @param[in] arena Arena to allocate the hashes from, NULL for the heap
+ */
+void hash243_vector_init(hash243_vector_t* const vec, arena_t* const arena);
+
+/**
+ * @brief Make room for `capacity` hashes
+ *
+ * @param[in] vec The vector
+ * @param[in] capacity Number of hashes
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_OOM on error
+ */
+status_t hash243_vector_reserve(hash243_vector_t* const vec, const size_t capacity);
+
+/**
+ * @brief Append a copy of a hash
+ *
+ * @param[in] vec The vector
+ * @param[in] hash FLEX_TRIT_SIZE_243 bytes of flex trits
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_OOM on error
+ */
+status_t hash243_vector_push(hash243_vector_t* const vec, flex_trit_t const* const hash);
+
+/**
+ * @brief Get the hash at an index
+ *
+ * @param[in] vec The vector
+ * @param[in] index Index of the hash
+ *
+ * @return The flex trits of the hash, or NULL when out of range
+ */
+static inline flex_trit_t* hash243_vector_at(hash243_vector_t const* const vec, const size_t index) {
+  return index < vec->count ? vec->hashes + index * FLEX_TRIT_SIZE_243 : NULL;
+}
+
+/**
+ * @brief Get the number of hashes
+ *
+ * @param[in] vec The vector
+ *
+ * @return Number of hashes
+ */
+static inline size_t hash243_vector_count(hash243_vector_t const* const vec) { return vec->count; }
+
+/**
+ * @brief Release the hashes of a heap vector, and empty the vector
+ *
+ * Hashes allocated from an arena are released with the arena.
+ *
+ * @param[in] vec The vector
+ */
+void hash243_vector_free(hash243_vector_t* const vec);
+
+/**
+ * @brief Append the hashes of a cclient queue
+ *
+ * The vector grows once for the whole queue.
+ *
+ * @param[in] vec The vector
+ * @param[in] queue Hashes to append
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_OOM on error
+ */
+status_t hash243_vector_append_queue(hash243_vector_t* const vec, hash243_queue_t const queue);
+
+/**
+ * @brief Lay the hashes out as a cclient queue in an arena
+ *
+ * All the entries of the queue are taken in one allocation from the arena, which gives a queue to pass to cclient
+ * requests without one allocation per hash. The queue does not own its entries, so it has to be detached from the
+ * request, e.g. set to NULL, instead of being released with `hash243_queue_free()`.
+ *
+ * @param[in] vec The vector
+ * @param[in] arena Arena of the queue entries
+ * @param[out] queue The queue, NULL for an empty vector
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_OOM on error
+ */
+status_t hash243_vector_to_queue(hash243_vector_t const* const vec, arena_t* const arena, hash243_queue_t* const queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_HASH243_VECTOR_H_
@@ -0,0 +1,1105 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "iri_pool.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+#include "utils/logger_helper.h"
+#include "utils/time.h"
+
+#define IRI_POOL_LOGGER "iri_pool"
+/** Milliseconds between two health checks of the nodes */
+#define IRI_HEALTH_INTERVAL_MS 5000
+/** Weight of the latest health check in the latency average of a node */
+#define IRI_LATENCY_EWMA_WEIGHT 0.3
+/** Latest read calls of a kind whose latencies give the delay before hedging */
+#define IRI_HEDGE_WINDOW 128
+/** Read calls of a kind recorded before they are hedged */
+#define IRI_HEDGE_MIN_SAMPLES 32
+/** Percentile of the latencies after which a read call is hedged */
+#define IRI_HEDGE_PERCENTILE 95
+/** Hedges saved up from the budget at most, so that a burst of slow calls cannot hedge all of them */
+#define IRI_HEDGE_BURST 10.0
+/** Latest calls to a node whose outcomes trip its circuit breaker */
+#define IRI_BREAKER_WINDOW 20
+/** Calls to a node recorded before its circuit breaker may trip */
+#define IRI_BREAKER_MIN_CALLS 10
+
+/** Calls sent through the pool, the read calls which may be hedged first */
+typedef enum iri_pool_call_e {
+  IRI_CALL_FIND_TRANSACTIONS,
+  IRI_CALL_GET_TRYTES,
+  IRI_CALL_GET_BALANCES,
+  IRI_CALL_HEDGED_NUM,
+  IRI_CALL_GET_INCLUSION_STATES = IRI_CALL_HEDGED_NUM,
+  IRI_CALL_CHECK_CONSISTENCY,
+  IRI_CALL_GET_TIPS,
+  IRI_CALL_GET_TRANSACTIONS_TO_APPROVE,
+  IRI_CALL_GET_NODE_INFO,
+} iri_pool_call_t;
+
+/** States of the circuit breaker of a node */
+typedef enum iri_pool_breaker_state_e {
+  IRI_BREAKER_CLOSED,    /**< Calls are sent to the node */
+  IRI_BREAKER_OPEN,      /**< Calls fail fast until the cooldown is over */
+  IRI_BREAKER_HALF_OPEN, /**< A single call probes the node, the others fail fast */
+} iri_pool_breaker_state_t;
+
+/** Circuit breaker of a node */
+typedef struct iri_pool_breaker_s {
+  iri_pool_breaker_state_t state;
+  bool bad[IRI_BREAKER_WINDOW]; /**< Ring of the latest calls, true for the failed and the slow ones */
+  uint8_t count;                /**< Calls in the ring */
+  uint8_t next;                 /**< Position of the next call in the ring */
+  uint8_t bad_count;            /**< Failed and slow calls in the ring */
+  uint64_t opened_at;           /**< Time the breaker tripped in milliseconds */
+} iri_pool_breaker_t;
+
+/** Latencies of the latest read calls of a kind */
+typedef struct iri_pool_latency_s {
+  uint32_t samples_ms[IRI_HEDGE_WINDOW]; /**< Ring of latencies */
+  uint32_t count;                        /**< Calls recorded, of which the ring holds the latest */
+  uint64_t hedge_after_ms;               /**< Percentile latency, 0 until enough calls are recorded */
+} iri_pool_latency_t;
+
+/** A full node, and the connections of the pool to it */
+typedef struct iri_pool_node_s {
+  iota_client_service_t probe;  /**< Connection of the health checks */
+  bool probe_ready;             /**< `probe` is initialized */
+  char* host;                   /**< Host of an extra node, NULL for the configured one */
+  iota_client_service_t** idle; /**< Stack of the connections not checked out */
+  uint8_t idle_count;
+  uint32_t in_flight;        /**< Connections checked out */
+  double latency_ms;         /**< Average latency of the health checks, 0 before the first one */
+  uint64_t solid_milestone;  /**< Latest solid subtangle milestone index */
+  uint64_t latest_milestone; /**< Latest milestone index */
+  bool reachable;            /**< The last health check was answered */
+  bool healthy;              /**< The node is in rotation */
+  iri_pool_breaker_t breaker;
+} iri_pool_node_t;
+
+/** A hedged read call, shared by its caller and the calls sent to the nodes */
+typedef struct iri_pool_hedge_s {
+  iri_pool_call_t call;
+  void* req;       /**< Copy of the request, which the calls may use after the caller returned */
+  void* res;       /**< Response of the first successful call, NULL until then */
+  retcode_t ret;   /**< Result of the first successful call, or of the latest failed one */
+  uint8_t running; /**< Calls not answered yet */
+  uint8_t refs;    /**< Calls and caller holding the hedge */
+} iri_pool_hedge_t;
+
+/** One of the calls of a hedged read call, sent to a node */
+typedef struct iri_pool_attempt_s {
+  iri_pool_hedge_t* hedge;
+  iota_client_service_t* service; /**< Connection checked out for the call, returned once the call is answered */
+  iri_pool_node_t* node;
+  bool hedge_call;                 /**< The call is the hedge, not the first call */
+  struct iri_pool_attempt_s* next; /**< Next call waiting for a worker */
+} iri_pool_attempt_t;
+
+static struct iri_pool_s {
+  lock_handle_t lock;
+  cond_handle_t cond;              /**< Signaled when a connection is returned or the checker stops */
+  iota_client_service_t* shared;   /**< Service used by every request when the pool is empty */
+  iota_client_service_t* services; /**< Connections of the pool, `size` of them for each node in order */
+  iri_pool_node_t* nodes;
+  uint8_t node_count;
+  uint8_t size; /**< Connections to each node */
+  uint32_t max_milestone_lag;
+  thread_handle_t checker;
+  bool running;              /**< The health checker and the workers are running */
+  uint8_t hedge_budget;      /**< Percentage of the read calls which may be hedged, 0 to never hedge */
+  double hedge_tokens;       /**< Hedges allowed right now, earned by every read call */
+  uint32_t hedging;          /**< Calls of hedged reads not answered yet */
+  thread_handle_t* workers;  /**< Workers sending the calls of hedged reads, started when none is idle */
+  uint32_t worker_count;     /**< Workers started */
+  uint32_t worker_max;       /**< Workers started at most, one for each connection, 0 when reads are never hedged */
+  uint32_t idle_workers;     /**< Workers without a call to send */
+  iri_pool_attempt_t* queue; /**< Calls handed to idle workers, not taken yet */
+  cond_handle_t worker_cond; /**< Signaled when a call is queued or the workers stop */
+  iri_pool_latency_t latencies[IRI_CALL_HEDGED_NUM];
+  uint8_t breaker_error_rate;  /**< Percentage of failed or slow calls tripping a circuit breaker, 0 to never trip */
+  uint32_t breaker_latency_ms; /**< Calls slower than this count as failed, 0 for no limit */
+  uint32_t breaker_cooldown_ms; /**< Time a tripped breaker fails calls fast before a call probes the node again */
+} pool;
+
+static logger_id_t logger_id;
+
+void iri_pool_logger_init() { logger_id = logger_helper_enable(IRI_POOL_LOGGER, LOGGER_DEBUG, true); }
+
+int iri_pool_logger_release() {
+  logger_helper_release(logger_id);
+  if (logger_helper_destroy() != RC_OK) {
+    ta_log_critical("Destroying logger failed %s.\n", IRI_POOL_LOGGER);
+    return EXIT_FAILURE;
+  }
+
+  return 0;
+}
+
+/**
+ * Count the nodes of a comma separated list of host:port, empty entries are skipped
+ */
+static uint8_t iri_pool_count_nodes(char const* const nodes) {
+  uint8_t count = 0;
+  for (char const* iter = nodes; iter && *iter; iter++) {
+    if (*iter != ',' && (iter == nodes || iter[-1] == ',')) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * Set the extra nodes of a comma separated list of host:port, following the configured one
+ */
+static status_t iri_pool_parse_nodes(char const* const nodes) {
+  char* list = strdup(nodes);
+  char* save = NULL;
+  uint8_t index = 1;
+  status_t ret = SC_OK;
+  if (list == NULL) {
+    ta_log_error("%s\n", "SC_TA_OOM");
+    return SC_TA_OOM;
+  }
+
+  for (char* node = strtok_r(list, ",", &save); node; node = strtok_r(NULL, ",", &save), index++) {
+    char* port = strrchr(node, ':');
+    long port_num = port ? strtol(port + 1, NULL, 10) : 0;
+    if (port == NULL || port == node || port_num <= 0 || port_num > UINT16_MAX) {
+      ret = SC_CONF_PARSER_ERROR;
+      ta_log_error("Invalid IRI node %s\n", node);
+      break;
+    }
+    *port = '\0';
+    pool.nodes[index].host = strdup(node);
+    if (pool.nodes[index].host == NULL) {
+      ret = SC_TA_OOM;
+      ta_log_error("%s\n", "SC_TA_OOM");
+      break;
+    }
+    pool.nodes[index].probe.http.host = pool.nodes[index].host;
+    pool.nodes[index].probe.http.port = port_num;
+  }
+
+  free(list);
+  return ret;
+}
+
+/**
+ * Trip the circuit breaker of a node, with the lock held
+ */
+static void iri_pool_breaker_trip(iri_pool_node_t* const node) {
+  node->breaker.state = IRI_BREAKER_OPEN;
+  node->breaker.opened_at = current_timestamp_ms();
+  ta_log_warning("IRI node %s:%u is failing, its calls fail fast for %d ms\n", node->probe.http.host,
+                 node->probe.http.port, pool.breaker_cooldown_ms);
+}
+
+/**
+ * Tell whether a call may be sent to a node, with the lock held. Once the cooldown of a tripped breaker is over, the
+ * call is let through to probe the node, and it is the only one until it is answered.
+ */
+static bool iri_pool_breaker_allow(iri_pool_node_t* const node) {
+  switch (node->breaker.state) {
+    case IRI_BREAKER_CLOSED:
+      return true;
+    case IRI_BREAKER_OPEN:
+      if (current_timestamp_ms() - node->breaker.opened_at < pool.breaker_cooldown_ms) {
+        return false;
+      }
+      node->breaker.state = IRI_BREAKER_HALF_OPEN;
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * Record the outcome of a call to a node, with the lock held. The breaker trips once enough of the latest calls failed
+ * or were too slow, and the answer of a probe closes or trips it again.
+ */
+static void iri_pool_breaker_record(iri_pool_node_t* const node, const retcode_t ret, const uint64_t latency_ms) {
+  iri_pool_breaker_t* breaker = &node->breaker;
+  if (pool.breaker_error_rate == 0) {
+    return;
+  }
+
+  bool bad = ret != RC_OK || (pool.breaker_latency_ms && latency_ms > pool.breaker_latency_ms);
+
+  if (breaker->state == IRI_BREAKER_HALF_OPEN) {
+    if (bad) {
+      iri_pool_breaker_trip(node);
+    } else {
+      memset(breaker, 0, sizeof(iri_pool_breaker_t));
+      ta_log_info("IRI node %s:%u recovered\n", node->probe.http.host, node->probe.http.port);
+    }
+    return;
+  }
+  // Calls sent before the breaker tripped are answered late
+  if (breaker->state == IRI_BREAKER_OPEN) {
+    return;
+  }
+
+  if (breaker->count == IRI_BREAKER_WINDOW) {
+    breaker->bad_count -= breaker->bad[breaker->next];
+  } else {
+    breaker->count++;
+  }
+  breaker->bad[breaker->next] = bad;
+  breaker->bad_count += bad;
+  breaker->next = (breaker->next + 1) % IRI_BREAKER_WINDOW;
+  if (breaker->count >= IRI_BREAKER_MIN_CALLS && breaker->bad_count * 100 >= breaker->count * pool.breaker_error_rate) {
+    iri_pool_breaker_trip(node);
+  }
+}
+
+/**
+ * Check the health of every node, and take the unreachable ones and the ones lagging behind on milestones out of
+ * rotation
+ */
+static void iri_pool_check_health() {
+  uint64_t latest_milestone = 0;
+
+  for (uint8_t i = 0; i < pool.node_count; i++) {
+    iri_pool_node_t* node = &pool.nodes[i];
+    get_node_info_res_t* res = get_node_info_res_new();
+    uint64_t start = current_timestamp_ms();
+    bool reachable = res && iota_client_get_node_info(&node->probe, res) == RC_OK;
+    double latency_ms = (double)(current_timestamp_ms() - start);
+
+    lock_handle_lock(&pool.lock);
+    node->reachable = reachable;
+    // The health check probes a node whose breaker tripped, instead of a request
+    if (node->breaker.state == IRI_BREAKER_OPEN && iri_pool_breaker_allow(node)) {
+      iri_pool_breaker_record(node, reachable ? RC_OK : RC_ERROR, (uint64_t)latency_ms);
+    }
+    if (reachable) {
+      if (node->latency_ms == 0) {
+        node->latency_ms = latency_ms;
+      } else {
+        node->latency_ms += (latency_ms - node->latency_ms) * IRI_LATENCY_EWMA_WEIGHT;
+      }
+      node->solid_milestone = res->latest_solid_subtangle_milestone_index;
+      node->latest_milestone = res->latest_milestone_index;
+      if (node->latest_milestone > latest_milestone) {
+        latest_milestone = node->latest_milestone;
+      }
+    }
+    lock_handle_unlock(&pool.lock);
+    get_node_info_res_free(&res);
+  }
+
+  lock_handle_lock(&pool.lock);
+  for (uint8_t i = 0; i < pool.node_count; i++) {
+    iri_pool_node_t* node = &pool.nodes[i];
+    bool healthy = node->reachable && node->solid_milestone + pool.max_milestone_lag >= latest_milestone;
+    if (healthy != node->healthy) {
+      ta_log_info("IRI node %s:%u %s rotation\n", node->probe.http.host, node->probe.http.port,
+                  healthy ? "back in" : "taken out of");
+    }
+    node->healthy = healthy;
+  }
+  // Requests waiting for a connection may pick a node back in rotation
+  cond_handle_broadcast(&pool.cond);
+  lock_handle_unlock(&pool.lock);
+}
+
+static void* iri_pool_checker(void* arg) {
+  (void)arg;
+  lock_handle_lock(&pool.lock);
+  while (pool.running) {
+    lock_handle_unlock(&pool.lock);
+    iri_pool_check_health();
+    lock_handle_lock(&pool.lock);
+    // The condition is signaled whenever a connection is returned as well, which must not bring the next check forward
+    uint64_t next_check = current_timestamp_ms() + IRI_HEALTH_INTERVAL_MS, now = 0;
+    while (pool.running && (now = current_timestamp_ms()) < next_check) {
+      cond_handle_timedwait(&pool.cond, &pool.lock, next_check - now);
+    }
+  }
+  lock_handle_unlock(&pool.lock);
+  return NULL;
+}
+
+status_t iri_pool_init(iota_client_service_t* const service, char const* const nodes, const uint8_t size,
+                       const uint32_t max_milestone_lag, const uint8_t hedge_budget, const uint8_t breaker_error_rate,
+                       const uint32_t breaker_latency_ms, const uint32_t breaker_cooldown_ms) {
+  status_t ret = SC_OK;
+  if (service == NULL) {
+    ta_log_error("%s\n", "SC_TA_NULL");
+    return SC_TA_NULL;
+  }
+
+  lock_handle_init(&pool.lock);
+  cond_handle_init(&pool.cond);
+  cond_handle_init(&pool.worker_cond);
+  pool.shared = service;
+  pool.node_count = pool.size = 0;
+  pool.max_milestone_lag = max_milestone_lag;
+  pool.running = false;
+  pool.hedge_budget = hedge_budget;
+  pool.hedge_tokens = 0;
+  pool.hedging = 0;
+  pool.workers = NULL;
+  pool.worker_count = pool.worker_max = pool.idle_workers = 0;
+  pool.queue = NULL;
+  memset(pool.latencies, 0, sizeof(pool.latencies));
+  pool.breaker_error_rate = breaker_error_rate;
+  pool.breaker_latency_ms = breaker_latency_ms;
+  pool.breaker_cooldown_ms = breaker_cooldown_ms;
+  if (size == 0) {
+    if (nodes && *nodes) {
+      ta_log_warning("%s\n", "Extra IRI nodes are not used without an IRI connection pool");
+    }
+    return SC_OK;
+  }
+
+  uint8_t node_count = 1 + iri_pool_count_nodes(nodes);
+  pool.nodes = (iri_pool_node_t*)calloc(node_count, sizeof(iri_pool_node_t));
+  pool.services = (iota_client_service_t*)calloc(node_count * size, sizeof(iota_client_service_t));
+  if (pool.nodes == NULL || pool.services == NULL) {
+    ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    goto done;
+  }
+  // Nodes are released by `iri_pool_destroy()` from now on, whatever part of them is set
+  pool.node_count = node_count;
+  for (uint8_t i = 0; i < node_count; i++) {
+    pool.nodes[i].probe.http = service->http;
+    pool.nodes[i].probe.serializer_type = service->serializer_type;
+    pool.nodes[i].healthy = true;
+  }
+  if (node_count > 1 && (ret = iri_pool_parse_nodes(nodes)) != SC_OK) {
+    goto done;
+  }
+
+  for (uint8_t n = 0; n < node_count; n++) {
+    iri_pool_node_t* node = &pool.nodes[n];
+    node->idle = (iota_client_service_t**)calloc(size, sizeof(iota_client_service_t*));
+    if (node->idle == NULL || iota_client_core_init(&node->probe) != RC_OK) {
+      ret = SC_TA_OOM;
+      ta_log_error("%s\n", "SC_TA_OOM");
+      goto done;
+    }
+    node->probe_ready = true;
+    for (uint8_t i = 0; i < size; i++) {
+      iota_client_service_t* conn = &pool.services[n * size + i];
+      conn->http = node->probe.http;
+      conn->serializer_type = node->probe.serializer_type;
+      if (iota_client_core_init(conn) != RC_OK) {
+        ret = SC_TA_OOM;
+        ta_log_error("%s\n", "SC_TA_OOM");
+        goto done;
+      }
+      node->idle[node->idle_count++] = conn;
+    }
+  }
+  pool.size = size;
+
+  // A single node stays in rotation whatever its health, so it is only checked with more nodes to choose from
+  if (node_count > 1) {
+    pool.running = true;
+    if (thread_handle_create(&pool.checker, iri_pool_checker, NULL)) {
+      pool.running = false;
+      ret = SC_UTILS_THREAD_CREATE;
+      ta_log_error("%s\n", "SC_UTILS_THREAD_CREATE");
+      goto done;
+    }
+  }
+  // Reads are only hedged with another node to send the hedge to
+  if (node_count > 1 && hedge_budget > 0) {
+    // Every call of a hedged read holds a connection, so there are never more of them than connections
+    pool.worker_max = node_count * size;
+    pool.workers = (thread_handle_t*)calloc(pool.worker_max, sizeof(thread_handle_t));
+    if (pool.workers == NULL) {
+      ret = SC_TA_OOM;
+      ta_log_error("%s\n", "SC_TA_OOM");
+    }
+  }
+
+done:
+  if (ret != SC_OK) {
+    iri_pool_destroy();
+  }
+  return ret;
+}
+
+void iri_pool_destroy() {
+  bool running = pool.running;
+  lock_handle_lock(&pool.lock);
+  // Calls of hedged reads already answered by another node still hold connections
+  while (pool.hedging > 0) {
+    cond_handle_wait(&pool.cond, &pool.lock);
+  }
+  pool.running = false;
+  cond_handle_broadcast(&pool.cond);
+  cond_handle_broadcast(&pool.worker_cond);
+  lock_handle_unlock(&pool.lock);
+  if (running) {
+    thread_handle_join(pool.checker, NULL);
+  }
+  for (uint32_t i = 0; i < pool.worker_count; i++) {
+    thread_handle_join(pool.workers[i], NULL);
+  }
+  free(pool.workers);
+  pool.workers = NULL;
+  pool.worker_count = pool.worker_max = pool.idle_workers = 0;
+
+  // All connections are idle once the requests are done
+  for (uint8_t i = 0; i < pool.node_count; i++) {
+    iri_pool_node_t* node = &pool.nodes[i];
+    for (uint8_t j = 0; j < node->idle_count; j++) {
+      iota_client_core_destroy(node->idle[j]);
+    }
+    if (node->probe_ready) {
+      iota_client_core_destroy(&node->probe);
+    }
+    free(node->idle);
+    free(node->host);
+  }
+  free(pool.nodes);
+  free(pool.services);
+  pool.nodes = NULL;
+  pool.services = NULL;
+  pool.node_count = pool.size = 0;
+  cond_handle_destroy(&pool.worker_cond);
+  cond_handle_destroy(&pool.cond);
+  lock_handle_destroy(&pool.lock);
+}
+
+/**
+ * Load of a node, its latency weighted by the requests already on it
+ */
+static double iri_pool_node_load(iri_pool_node_t const* const node) {
+  return node->latency_ms * (node->in_flight + 1);
+}
+
+/**
+ * Pick the less loaded of two candidates picked at random, which spreads requests by latency without sending all of
+ * them to the single fastest node
+ */
+static iri_pool_node_t* iri_pool_pick_node(iri_pool_node_t** const candidates, const uint8_t num) {
+  if (num <= 1) {
+    return num ? candidates[0] : NULL;
+  }
+
+  uint8_t first = rand() % num, second = rand() % (num - 1);
+  if (second >= first) {
+    second++;
+  }
+  return iri_pool_node_load(candidates[second]) < iri_pool_node_load(candidates[first]) ? candidates[second]
+                                                                                        : candidates[first];
+}
+
+/**
+ * Tell whether a node is in rotation and its calls are not failing fast, with the lock held
+ */
+static bool iri_pool_node_usable(iri_pool_node_t const* const node) {
+  return node->healthy && node->breaker.state == IRI_BREAKER_CLOSED;
+}
+
+/**
+ * Choose a node with an idle connection, with the lock held. Nodes out of rotation or with a tripped breaker are only
+ * used when no node is usable, and then a request probes a node whose breaker cooled down.
+ */
+static iri_pool_node_t* iri_pool_choose_node() {
+  iri_pool_node_t* candidates[UINT8_MAX];
+  uint8_t num = 0;
+  bool any_usable = false;
+
+  for (uint8_t i = 0; i < pool.node_count; i++) {
+    any_usable |= iri_pool_node_usable(&pool.nodes[i]);
+  }
+  for (uint8_t i = 0; i < pool.node_count; i++) {
+    if (pool.nodes[i].idle_count > 0 && (iri_pool_node_usable(&pool.nodes[i]) || !any_usable)) {
+      candidates[num++] = &pool.nodes[i];
+    }
+  }
+  return iri_pool_pick_node(candidates, num);
+}
+
+/**
+ * Check out an idle connection of a node, with the lock held. Returns NULL when all of them are checked out.
+ */
+static iota_client_service_t* iri_pool_checkout(iri_pool_node_t* const node) {
+  if (node->idle_count == 0) {
+    return NULL;
+  }
+  node->in_flight++;
+  return node->idle[--node->idle_count];
+}
+
+/**
+ * Return a connection checked out, with the lock held
+ */
+static void iri_pool_checkin(iota_client_service_t* const service) {
+  iri_pool_node_t* node = &pool.nodes[(service - pool.services) / pool.size];
+  node->idle[node->idle_count++] = service;
+  node->in_flight--;
+  // Waiters may only accept a connection of a healthy node, so all of them check again
+  cond_handle_broadcast(&pool.cond);
+}
+
+iota_client_service_t* iri_pool_acquire() {
+  iri_pool_node_t* node = NULL;
+  if (pool.size == 0) {
+    return pool.shared;
+  }
+
+  lock_handle_lock(&pool.lock);
+  while ((node = iri_pool_choose_node()) == NULL) {
+    cond_handle_wait(&pool.cond, &pool.lock);
+  }
+  iota_client_service_t* service = iri_pool_checkout(node);
+  lock_handle_unlock(&pool.lock);
+  return service;
+}
+
+iota_client_service_t* iri_pool_try_acquire() {
+  iri_pool_node_t* node = NULL;
+  iota_client_service_t* service = NULL;
+  if (pool.size == 0) {
+    return NULL;
+  }
+
+  lock_handle_lock(&pool.lock);
+  if ((node = iri_pool_choose_node()) != NULL) {
+    service = iri_pool_checkout(node);
+  }
+  lock_handle_unlock(&pool.lock);
+  return service;
+}
+
+void iri_pool_release(iota_client_service_t* const service) {
+  if (pool.size == 0 || service == NULL) {
+    return;
+  }
+
+  lock_handle_lock(&pool.lock);
+  iri_pool_checkin(service);
+  lock_handle_unlock(&pool.lock);
+}
+
+/**
+ * Send a call to a node
+ */
+static retcode_t iri_pool_call(const iri_pool_call_t call, iota_client_service_t const* const service,
+                               void const* const req, void* const res) {
+  switch (call) {
+    case IRI_CALL_FIND_TRANSACTIONS:
+      return iota_client_find_transactions(service, req, res);
+    case IRI_CALL_GET_TRYTES:
+      return iota_client_get_trytes(service, req, res);
+    case IRI_CALL_GET_BALANCES:
+      return iota_client_get_balances(service, req, res);
+    case IRI_CALL_GET_INCLUSION_STATES:
+      return iota_client_get_inclusion_states(service, req, res);
+    case IRI_CALL_CHECK_CONSISTENCY:
+      return iota_client_check_consistency(service, req, res);
+    case IRI_CALL_GET_TIPS:
+      return iota_client_get_tips(service, res);
+    case IRI_CALL_GET_TRANSACTIONS_TO_APPROVE:
+      return iota_client_get_transactions_to_approve(service, req, res);
+    case IRI_CALL_GET_NODE_INFO:
+      return iota_client_get_node_info(service, res);
+    default:
+      return RC_ERROR;
+  }
+}
+
+/**
+ * Copy the request of a read call, so that the calls to the nodes may outlive their caller
+ */
+static void* iri_pool_req_copy(const iri_pool_call_t call, void const* const req) {
+  switch (call) {
+    case IRI_CALL_FIND_TRANSACTIONS: {
+      find_transactions_req_t const* src = req;
+      find_transactions_req_t* dst = find_transactions_req_new();
+      if (dst && (hash243_queue_copy(&dst->bundles, src->bundles, hash243_queue_count(src->bundles)) != RC_OK ||
+                  hash243_queue_copy(&dst->addresses, src->addresses, hash243_queue_count(src->addresses)) != RC_OK ||
+                  hash81_queue_copy(&dst->tags, src->tags, hash81_queue_count(src->tags)) != RC_OK ||
+                  hash243_queue_copy(&dst->approvees, src->approvees, hash243_queue_count(src->approvees)) != RC_OK)) {
+        find_transactions_req_free(&dst);
+      }
+      return dst;
+    }
+    case IRI_CALL_GET_TRYTES: {
+      get_trytes_req_t const* src = req;
+      get_trytes_req_t* dst = get_trytes_req_new();
+      if (dst && hash243_queue_copy(&dst->hashes, src->hashes, hash243_queue_count(src->hashes)) != RC_OK) {
+        get_trytes_req_free(&dst);
+      }
+      return dst;
+    }
+    case IRI_CALL_GET_BALANCES: {
+      get_balances_req_t const* src = req;
+      get_balances_req_t* dst = get_balances_req_new();
+      if (dst && (hash243_queue_copy(&dst->addresses, src->addresses, hash243_queue_count(src->addresses)) != RC_OK ||
+                  hash243_queue_copy(&dst->tips, src->tips, hash243_queue_count(src->tips)) != RC_OK)) {
+        get_balances_req_free(&dst);
+      }
+      if (dst) {
+        dst->threshold = src->threshold;
+      }
+      return dst;
+    }
+    default:
+      return NULL;
+  }
+}
+
+static void iri_pool_req_free(const iri_pool_call_t call, void* const req) {
+  find_transactions_req_t* find_req = req;
+  get_trytes_req_t* trytes_req = req;
+  get_balances_req_t* balances_req = req;
+  switch (call) {
+    case IRI_CALL_FIND_TRANSACTIONS:
+      find_transactions_req_free(&find_req);
+      break;
+    case IRI_CALL_GET_TRYTES:
+      get_trytes_req_free(&trytes_req);
+      break;
+    case IRI_CALL_GET_BALANCES:
+      get_balances_req_free(&balances_req);
+      break;
+    default:
+      break;
+  }
+}
+
+static void* iri_pool_res_new(const iri_pool_call_t call) {
+  switch (call) {
+    case IRI_CALL_FIND_TRANSACTIONS:
+      return find_transactions_res_new();
+    case IRI_CALL_GET_TRYTES:
+      return get_trytes_res_new();
+    case IRI_CALL_GET_BALANCES:
+      return get_balances_res_new();
+    default:
+      return NULL;
+  }
+}
+
+static void iri_pool_res_free(const iri_pool_call_t call, void* const res) {
+  find_transactions_res_t* find_res = res;
+  get_trytes_res_t* trytes_res = res;
+  get_balances_res_t* balances_res = res;
+  switch (call) {
+    case IRI_CALL_FIND_TRANSACTIONS:
+      find_transactions_res_free(&find_res);
+      break;
+    case IRI_CALL_GET_TRYTES:
+      get_trytes_res_free(&trytes_res);
+      break;
+    case IRI_CALL_GET_BALANCES:
+      get_balances_res_free(&balances_res);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * Swap the contents of two responses, which hands the response of a node to the caller
+ */
+static void iri_pool_res_swap(const iri_pool_call_t call, void* const a, void* const b) {
+  switch (call) {
+    case IRI_CALL_FIND_TRANSACTIONS: {
+      find_transactions_res_t tmp = *(find_transactions_res_t*)a;
+      *(find_transactions_res_t*)a = *(find_transactions_res_t*)b;
+      *(find_transactions_res_t*)b = tmp;
+      break;
+    }
+    case IRI_CALL_GET_TRYTES: {
+      get_trytes_res_t tmp = *(get_trytes_res_t*)a;
+      *(get_trytes_res_t*)a = *(get_trytes_res_t*)b;
+      *(get_trytes_res_t*)b = tmp;
+      break;
+    }
+    case IRI_CALL_GET_BALANCES: {
+      get_balances_res_t tmp = *(get_balances_res_t*)a;
+      *(get_balances_res_t*)a = *(get_balances_res_t*)b;
+      *(get_balances_res_t*)b = tmp;
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+static int cmp_uint32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * Record the latency of a read call answered by the node it was sent to first, with the lock held. The latency to
+ * hedge after is updated every few calls.
+ */
+static void iri_pool_record_latency(const iri_pool_call_t call, const uint64_t latency_ms) {
+  iri_pool_latency_t* latency = &pool.latencies[call];
+  latency->samples_ms[latency->count++ % IRI_HEDGE_WINDOW] = latency_ms > UINT32_MAX ? UINT32_MAX : latency_ms;
+  if (latency->count < IRI_HEDGE_MIN_SAMPLES || latency->count % (IRI_HEDGE_WINDOW / 8) != 0) {
+    return;
+  }
+
+  uint32_t sorted[IRI_HEDGE_WINDOW];
+  uint32_t num = latency->count < IRI_HEDGE_WINDOW ? latency->count : IRI_HEDGE_WINDOW;
+  memcpy(sorted, latency->samples_ms, num * sizeof(uint32_t));
+  qsort(sorted, num, sizeof(uint32_t), cmp_uint32);
+  // Calls answered within a millisecond are not worth hedging, and zero stands for an unknown latency
+  latency->hedge_after_ms = sorted[num * IRI_HEDGE_PERCENTILE / 100];
+  if (latency->hedge_after_ms == 0) {
+    latency->hedge_after_ms = 1;
+  }
+}
+
+/**
+ * Node of a connection of the pool, NULL for the shared service
+ */
+static iri_pool_node_t* iri_pool_node_of(iota_client_service_t const* const service) {
+  if (pool.size == 0 || service < pool.services || service >= pool.services + pool.node_count * pool.size) {
+    return NULL;
+  }
+  return &pool.nodes[(service - pool.services) / pool.size];
+}
+
+/**
+ * Choose the node of a hedge among the usable nodes with an idle connection but the one of the first call, with the
+ * lock held
+ */
+static iri_pool_node_t* iri_pool_choose_hedge_node(iri_pool_node_t const* const first) {
+  iri_pool_node_t* candidates[UINT8_MAX];
+  uint8_t num = 0;
+
+  for (uint8_t i = 0; i < pool.node_count; i++) {
+    if (&pool.nodes[i] != first && pool.nodes[i].idle_count > 0 && iri_pool_node_usable(&pool.nodes[i])) {
+      candidates[num++] = &pool.nodes[i];
+    }
+  }
+  return iri_pool_pick_node(candidates, num);
+}
+
+/**
+ * Release a hedged read call held by a call or the caller, with the lock held
+ */
+static void iri_pool_hedge_release(iri_pool_hedge_t* const hedge) {
+  if (--hedge->refs > 0) {
+    return;
+  }
+  iri_pool_req_free(hedge->call, hedge->req);
+  if (hedge->res) {
+    iri_pool_res_free(hedge->call, hedge->res);
+  }
+  free(hedge);
+}
+
+static void* iri_pool_attempt_run(void* arg) {
+  iri_pool_attempt_t* attempt = (iri_pool_attempt_t*)arg;
+  iri_pool_hedge_t* hedge = attempt->hedge;
+  iri_pool_call_t call = hedge->call;
+  void* res = iri_pool_res_new(call);
+  uint64_t start = current_timestamp_ms();
+  retcode_t ret = res ? iri_pool_call(call, attempt->service, hedge->req, res) : RC_OOM;
+  uint64_t latency_ms = current_timestamp_ms() - start;
+
+  lock_handle_lock(&pool.lock);
+  iri_pool_breaker_record(attempt->node, ret, latency_ms);
+  // The connection is only returned once the call is answered, even when the caller already took another answer
+  iri_pool_checkin(attempt->service);
+  if (!attempt->hedge_call && ret == RC_OK) {
+    // Slow answers of the first node count even when a hedge won, or the latency to hedge after would drift down
+    iri_pool_record_latency(call, latency_ms);
+  }
+  if (hedge->res == NULL) {
+    hedge->ret = ret;
+    if (ret == RC_OK) {
+      hedge->res = res;
+      res = NULL;
+    }
+  }
+  if (res) {
+    iri_pool_res_free(call, res);
+  }
+  free(attempt);
+  hedge->running--;
+  iri_pool_hedge_release(hedge);
+  // Nothing of the pool is used from now on, so it may be destroyed
+  pool.hedging--;
+  cond_handle_broadcast(&pool.cond);
+  lock_handle_unlock(&pool.lock);
+  return NULL;
+}
+
+/**
+ * Send the calls handed to the workers, until the pool is destroyed
+ */
+static void* iri_pool_worker(void* arg) {
+  (void)arg;
+  lock_handle_lock(&pool.lock);
+  for (;;) {
+    while (pool.queue == NULL && pool.running) {
+      cond_handle_wait(&pool.worker_cond, &pool.lock);
+    }
+    iri_pool_attempt_t* attempt = pool.queue;
+    if (attempt == NULL) {
+      break;
+    }
+    pool.queue = attempt->next;
+    lock_handle_unlock(&pool.lock);
+    iri_pool_attempt_run(attempt);
+    lock_handle_lock(&pool.lock);
+    pool.idle_workers++;
+  }
+  lock_handle_unlock(&pool.lock);
+  return NULL;
+}
+
+/**
+ * Hand a call to an idle worker, starting one when none is idle, with the lock held
+ */
+static bool iri_pool_worker_submit(iri_pool_attempt_t* const attempt) {
+  if (pool.idle_workers == 0) {
+    if (pool.worker_count == pool.worker_max ||
+        thread_handle_create(&pool.workers[pool.worker_count], iri_pool_worker, NULL)) {
+      return false;
+    }
+    pool.worker_count++;
+    pool.idle_workers++;
+  }
+  // Queued calls never outnumber the idle workers, so the call is taken right away
+  pool.idle_workers--;
+  attempt->next = pool.queue;
+  pool.queue = attempt;
+  cond_handle_signal(&pool.worker_cond);
+  return true;
+}
+
+/**
+ * Send a read call to a node from a worker, on an idle connection checked out until the call is answered, with the
+ * lock held. Fails when the node has no idle connection or no worker is left.
+ *
+ * @param[in] hedge Hedged read call
+ * @param[in] node Node to send the call to
+ * @param[in] hedge_call The call is the hedge, not the first call
+ */
+static bool iri_pool_attempt_start(iri_pool_hedge_t* const hedge, iri_pool_node_t* const node, const bool hedge_call) {
+  iri_pool_attempt_t* attempt = (iri_pool_attempt_t*)malloc(sizeof(iri_pool_attempt_t));
+  if (attempt == NULL) {
+    return false;
+  }
+
+  attempt->hedge = hedge;
+  attempt->service = iri_pool_checkout(node);
+  attempt->node = node;
+  attempt->hedge_call = hedge_call;
+  attempt->next = NULL;
+  if (attempt->service == NULL) {
+    free(attempt);
+    return false;
+  }
+  if (!iri_pool_worker_submit(attempt)) {
+    iri_pool_checkin(attempt->service);
+    free(attempt);
+    return false;
+  }
+  hedge->running++;
+  hedge->refs++;
+  pool.hedging++;
+  return true;
+}
+
+/**
+ * Map the result of a call to a status, failing fast when the call was not sent
+ */
+static status_t iri_pool_status(const bool sent, const retcode_t ret) {
+  if (!sent) {
+    ta_log_error("%s\n", "SC_CCLIENT_IRI_UNAVAILABLE");
+    return SC_CCLIENT_IRI_UNAVAILABLE;
+  }
+  if (ret != RC_OK) {
+    ta_log_error("%s\n", "SC_CCLIENT_FAILED_RESPONSE");
+    return SC_CCLIENT_FAILED_RESPONSE;
+  }
+  return SC_OK;
+}
+
+/**
+ * Send a call through the circuit breaker of the node of the connection. A read call is hedged as well: the same call
+ * is sent to another node once the first one takes longer than most calls of its kind, and the first successful
+ * answer is taken. Only a call which may be hedged, with hedges left in the budget and enough latencies recorded, is
+ * handed to a worker, so that its caller can take the answer of the hedge without waiting for the first node. Each
+ * call handed to a worker checks out a connection of its own and holds it until it is answered, so that a call which
+ * lost still counts against the connections of its node. Other calls, and every call while its node has no idle
+ * connection or all the workers are busy, are sent from the calling thread on the connection of the caller.
+ */
+static status_t iri_pool_send(const iri_pool_call_t call, iota_client_service_t const* const service,
+                              void const* const req, void* const res) {
+  iri_pool_hedge_t* hedge = NULL;
+  bool hedged = false;
+  uint64_t hedge_after_ms = 0;
+  retcode_t ret = RC_OK;
+  // The shared service of an empty pool and services from outside the pool have no breaker
+  iri_pool_node_t* first = iri_pool_node_of(service);
+  if (first == NULL) {
+    return iri_pool_status(true, iri_pool_call(call, service, req, res));
+  }
+
+  lock_handle_lock(&pool.lock);
+  if (!iri_pool_breaker_allow(first)) {
+    lock_handle_unlock(&pool.lock);
+    return iri_pool_status(false, RC_ERROR);
+  }
+  if (call < IRI_CALL_HEDGED_NUM && pool.hedge_budget > 0 && pool.node_count > 1) {
+    pool.hedge_tokens += pool.hedge_budget / 100.0;
+    if (pool.hedge_tokens > IRI_HEDGE_BURST) {
+      pool.hedge_tokens = IRI_HEDGE_BURST;
+    }
+    hedge_after_ms = pool.latencies[call].hedge_after_ms;
+    hedged = hedge_after_ms > 0 && pool.hedge_tokens >= 1;
+  }
+  lock_handle_unlock(&pool.lock);
+
+  if (hedged && (hedge = (iri_pool_hedge_t*)calloc(1, sizeof(iri_pool_hedge_t))) != NULL) {
+    hedge->call = call;
+    hedge->refs = 1;
+    hedge->req = iri_pool_req_copy(call, req);
+  }
+  lock_handle_lock(&pool.lock);
+  if (hedge == NULL || hedge->req == NULL || !iri_pool_attempt_start(hedge, first, false)) {
+    lock_handle_unlock(&pool.lock);
+    if (hedge) {
+      iri_pool_req_free(call, hedge->req);
+      free(hedge);
+    }
+
+    uint64_t start = current_timestamp_ms();
+    ret = iri_pool_call(call, service, req, res);
+    uint64_t latency_ms = current_timestamp_ms() - start;
+    lock_handle_lock(&pool.lock);
+    iri_pool_breaker_record(first, ret, latency_ms);
+    if (ret == RC_OK && call < IRI_CALL_HEDGED_NUM) {
+      iri_pool_record_latency(call, latency_ms);
+    }
+    lock_handle_unlock(&pool.lock);
+    return iri_pool_status(true, ret);
+  }
+
+  uint64_t deadline = current_timestamp_ms() + hedge_after_ms, now = 0;
+  while (hedge->res == NULL && hedge->running > 0 && (now = current_timestamp_ms()) < deadline) {
+    cond_handle_timedwait(&pool.cond, &pool.lock, deadline - now);
+  }
+  // A failed first call is retried on another node as well
+  if (hedge->res == NULL && pool.hedge_tokens >= 1) {
+    iri_pool_node_t* node = iri_pool_choose_hedge_node(first);
+    if (node && iri_pool_attempt_start(hedge, node, true)) {
+      pool.hedge_tokens -= 1;
+    }
+  }
+  while (hedge->res == NULL && hedge->running > 0) {
+    cond_handle_wait(&pool.cond, &pool.lock);
+  }
+
+  ret = hedge->ret;
+  if (hedge->res) {
+    iri_pool_res_swap(call, res, hedge->res);
+  }
+  iri_pool_hedge_release(hedge);
+  lock_handle_unlock(&pool.lock);
+  return iri_pool_status(true, ret);
+}
+
+status_t iri_pool_check(iota_client_service_t const* const service) {
+  iri_pool_node_t* node = iri_pool_node_of(service);
+  if (node == NULL) {
+    return SC_OK;
+  }
+
+  lock_handle_lock(&pool.lock);
+  bool allowed = iri_pool_breaker_allow(node);
+  bool probe = allowed && node->breaker.state == IRI_BREAKER_HALF_OPEN;
+  lock_handle_unlock(&pool.lock);
+  if (!probe) {
+    return iri_pool_status(allowed, RC_OK);
+  }
+
+  // The calls let through are not sent by the pool, so the node is probed with getNodeInfo instead of them
+  get_node_info_res_t* res = get_node_info_res_new();
+  uint64_t start = current_timestamp_ms();
+  retcode_t ret = res ? iota_client_get_node_info(service, res) : RC_OOM;
+  uint64_t latency_ms = current_timestamp_ms() - start;
+  get_node_info_res_free(&res);
+
+  lock_handle_lock(&pool.lock);
+  iri_pool_breaker_record(node, ret, latency_ms);
+  allowed = node->breaker.state == IRI_BREAKER_CLOSED;
+  lock_handle_unlock(&pool.lock);
+  return iri_pool_status(allowed, RC_OK);
+}
+
+uint32_t iri_pool_retry_after() {
+  uint64_t now = current_timestamp_ms(), wait = UINT64_MAX;
+  lock_handle_lock(&pool.lock);
+  for (uint8_t i = 0; i < pool.node_count; i++) {
+    iri_pool_breaker_t const* breaker = &pool.nodes[i].breaker;
+    if (breaker->state == IRI_BREAKER_OPEN) {
+      uint64_t elapsed = now - breaker->opened_at;
+      uint64_t left = elapsed < pool.breaker_cooldown_ms ? pool.breaker_cooldown_ms - elapsed : 0;
+      wait = left < wait ? left : wait;
+    }
+  }
+  lock_handle_unlock(&pool.lock);
+
+  // Without a tripped breaker a probe is on its way, and clients should never be told to retry immediately anyway
+  return wait == UINT64_MAX || wait == 0 ? 1 : (wait + 999) / 1000;
+}
+
+status_t iri_pool_find_transactions(iota_client_service_t const* const service,
+                                    find_transactions_req_t const* const req, find_transactions_res_t* const res) {
+  return iri_pool_send(IRI_CALL_FIND_TRANSACTIONS, service, req, res);
+}
+
+status_t iri_pool_get_trytes(iota_client_service_t const* const service, get_trytes_req_t const* const req,
+                             get_trytes_res_t* const res) {
+  return iri_pool_send(IRI_CALL_GET_TRYTES, service, req, res);
+}
+
+status_t iri_pool_get_balances(iota_client_service_t const* const service, get_balances_req_t const* const req,
+                               get_balances_res_t* const res) {
+  return iri_pool_send(IRI_CALL_GET_BALANCES, service, req, res);
+}
+
+status_t iri_pool_get_inclusion_states(iota_client_service_t const* const service,
+                                       get_inclusion_states_req_t const* const req,
+                                       get_inclusion_states_res_t* const res) {
+  return iri_pool_send(IRI_CALL_GET_INCLUSION_STATES, service, req, res);
+}
+
+status_t iri_pool_check_consistency(iota_client_service_t const* const service,
+                                    check_consistency_req_t const* const req, check_consistency_res_t* const res) {
+  return iri_pool_send(IRI_CALL_CHECK_CONSISTENCY, service, req, res);
+}
+
+status_t iri_pool_get_tips(iota_client_service_t const* const service, get_tips_res_t* const res) {
+  return iri_pool_send(IRI_CALL_GET_TIPS, service, NULL, res);
+}
+
+status_t iri_pool_get_transactions_to_approve(iota_client_service_t const* const service,
+                                              get_transactions_to_approve_req_t const* const req,
+                                              get_transactions_to_approve_res_t* const res) {
+  return iri_pool_send(IRI_CALL_GET_TRANSACTIONS_TO_APPROVE, service, req, res);
+}
+
+status_t iri_pool_get_node_info(iota_client_service_t const* const service, get_node_info_res_t* const res) {
+  return iri_pool_send(IRI_CALL_GET_NODE_INFO, service, NULL, res);
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_IRI_POOL_H_
+#define UTILS_IRI_POOL_H_
+
+#include <stdint.h>
+#include "accelerator/errors.h"
+#include "cclient/api/core/core_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file iri_pool.h
+ * @brief Fixed pool of IRI connections checked out by the requests
+ *
+ * Each connection is a client service of its own, configured like the one given to `iri_pool_init()`. A request
+ * checks one out for its IRI calls and returns it once done, so requests call IRI concurrently while the number of
+ * concurrent IRI calls stays bounded by the pool size. The service given to `iri_pool_init()` is shared by all
+ * requests when the pool is empty.
+ *
+ * With more than one full node, the pool holds connections to each of them and a request gets a connection to one of
+ * two nodes picked at random, the one with the lower latency weighted by its requests in flight. The latency of a node
+ * is averaged over periodic getNodeInfo health checks, which also take a node out of rotation while it is unreachable
+ * or its solid milestone lags behind the latest milestone of all nodes.
+ *
+ * Read calls sent with `iri_pool_find_transactions()`, `iri_pool_get_trytes()` or `iri_pool_get_balances()` may be
+ * hedged: once the node of the connection takes longer to answer than the 95th percentile of the latest calls of the
+ * same kind, the same call is sent to another healthy node and the first answer wins. Hedges are limited to a budget
+ * given as a percentage of the read calls. The calls of a read which may be hedged are sent by workers kept by the
+ * pool, each on a connection of its own held until it is answered, so the calls to a node never outnumber its
+ * connections.
+ *
+ * Every node has a circuit breaker fed by the calls sent with the `iri_pool_*()` call functions. It trips when too
+ * many of the latest calls failed or were too slow, and then calls to the node fail fast with
+ * SC_CCLIENT_IRI_UNAVAILABLE instead of waiting for the socket timeout. Requests are sent to other nodes meanwhile.
+ * Once a cooldown is over, a single call probes the node, and its answer closes the breaker or trips it again.
+ *
+ * @example test_iri_pool.c
+ */
+
+/**
+ * Initialize logger
+ */
+void iri_pool_logger_init();
+
+/**
+ * Release logger
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int iri_pool_logger_release();
+
+/**
+ * Initialize the connections of the pool and start checking the health of the nodes
+ *
+ * @param[in] service Configuration of the connections to the first node, which must outlive the pool
+ * @param[in] nodes Other full nodes as host:port separated by commas, NULL for none
+ * @param[in] size Number of connections to each node, zero to share `service` without any bound
+ * @param[in] max_milestone_lag Milestones a node may lag behind before it is taken out of rotation
+ * @param[in] hedge_budget Percentage of the read calls which may be hedged, zero to never hedge
+ * @param[in] breaker_error_rate Percentage of failed or slow calls tripping the breaker of a node, zero to never trip
+ * @param[in] breaker_latency_ms Calls slower than this count as failed for the breakers, zero for no limit
+ * @param[in] breaker_cooldown_ms Milliseconds a tripped breaker fails calls fast before a call probes its node again
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t iri_pool_init(iota_client_service_t* const service, char const* const nodes, const uint8_t size,
+                       const uint32_t max_milestone_lag, const uint8_t hedge_budget, const uint8_t breaker_error_rate,
+                       const uint32_t breaker_latency_ms, const uint32_t breaker_cooldown_ms);
+
+/**
+ * Stop the health checks and destroy the connections of the pool. None of them may be checked out.
+ */
+void iri_pool_destroy();
+
+/**
+ * Check a connection out of a node in rotation, waiting for one to be returned when all of them are in use
+ *
+ * @return Connection to pass to the APIs, returned with `iri_pool_release()`
+ */
+iota_client_service_t* iri_pool_acquire();
+
+/**
+ * Check a connection out of a node in rotation without waiting
+ *
+ * @return
+ * - Connection to pass to the APIs, returned with `iri_pool_release()`
+ * - NULL when every connection is in use or the pool has no connection of its own
+ */
+iota_client_service_t* iri_pool_try_acquire();
+
+/**
+ * Return a connection checked out with `iri_pool_acquire()`
+ *
+ * @param[in] service Connection to return
+ */
+void iri_pool_release(iota_client_service_t* const service);
+
+/**
+ * Tell whether calls may be sent with a connection, for the calls of the extended API which cannot go through the
+ * breaker of its node. Once the cooldown of a tripped breaker is over, the check probes the node with getNodeInfo
+ * itself, and lets the calls through when the node answers. Meanwhile, other checks of the node fail fast.
+ *
+ * @param[in] service Connection checked out with `iri_pool_acquire()`
+ *
+ * @return
+ * - SC_OK when calls may be sent
+ * - SC_CCLIENT_IRI_UNAVAILABLE while the breaker of the node is not closed
+ */
+status_t iri_pool_check(iota_client_service_t const* const service);
+
+/**
+ * Suggest when a client rejected while IRI is unavailable should retry
+ *
+ * @return Seconds until the first tripped breaker may probe its node again, at least 1
+ */
+uint32_t iri_pool_retry_after();
+
+/**
+ * Call `iota_client_find_transactions()` through the breaker of the node of a connection, hedged when slow
+ *
+ * @param[in] service Connection checked out with `iri_pool_acquire()`
+ * @param[in] req Request
+ * @param[out] res Empty response, filled with the first answer
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_IRI_UNAVAILABLE while the breaker of the node fails calls fast
+ * - SC_CCLIENT_FAILED_RESPONSE when the call failed
+ */
+status_t iri_pool_find_transactions(iota_client_service_t const* const service,
+                                    find_transactions_req_t const* const req, find_transactions_res_t* const res);
+
+/**
+ * Call `iota_client_get_trytes()` through the breaker of the node of a connection, hedged when slow
+ *
+ * @param[in] service Connection checked out with `iri_pool_acquire()`
+ * @param[in] req Request
+ * @param[out] res Empty response, filled with the first answer
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_IRI_UNAVAILABLE while the breaker of the node fails calls fast
+ * - SC_CCLIENT_FAILED_RESPONSE when the call failed
+ */
+status_t iri_pool_get_trytes(iota_client_service_t const* const service, get_trytes_req_t const* const req,
+                             get_trytes_res_t* const res);
+
+/**
+ * Call `iota_client_get_balances()` through the breaker of the node of a connection, hedged when slow
+ *
+ * @param[in] service Connection checked out with `iri_pool_acquire()`
+ * @param[in] req Request
+ * @param[out] res Empty response, filled with the first answer
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_IRI_UNAVAILABLE while the breaker of the node fails calls fast
+ * - SC_CCLIENT_FAILED_RESPONSE when the call failed
+ */
+status_t iri_pool_get_balances(iota_client_service_t const* const service, get_balances_req_t const* const req,
+                               get_balances_res_t* const res);
+
+/**
+ * Call `iota_client_get_inclusion_states()` through the breaker of the node of a connection
+ *
+ * @param[in] service Connection checked out with `iri_pool_acquire()`
+ * @param[in] req Request
+ * @param[out] res Response
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_IRI_UNAVAILABLE while the breaker of the node fails calls fast
+ * - SC_CCLIENT_FAILED_RESPONSE when the call failed
+ */
+status_t iri_pool_get_inclusion_states(iota_client_service_t const* const service,
+                                       get_inclusion_states_req_t const* const req,
+                                       get_inclusion_states_res_t* const res);
+
+/**
+ * Call `iota_client_check_consistency()` through the breaker of the node of a connection
+ *
+ * @param[in] service Connection checked out with `iri_pool_acquire()`
+ * @param[in] req Request
+ * @param[out] res Response
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_IRI_UNAVAILABLE while the breaker of the node fails calls fast
+ * - SC_CCLIENT_FAILED_RESPONSE when the call failed
+ */
+status_t iri_pool_check_consistency(iota_client_service_t const* const service,
+                                    check_consistency_req_t const* const req, check_consistency_res_t* const res);
+
+/**
+ * Call `iota_client_get_tips()` through the breaker of the node of a connection
+ *
+ * @param[in] service Connection checked out with `iri_pool_acquire()`
+ * @param[out] res Response
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_IRI_UNAVAILABLE while the breaker of the node fails calls fast
+ * - SC_CCLIENT_FAILED_RESPONSE when the call failed
+ */
+status_t iri_pool_get_tips(iota_client_service_t const* const service, get_tips_res_t* const res);
+
+/**
+ * Call `iota_client_get_transactions_to_approve()` through the breaker of the node of a connection
+ *
+ * @param[in] service Connection checked out with `iri_pool_acquire()`
+ * @param[in] req Request
+ * @param[out] res Response
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_IRI_UNAVAILABLE while the breaker of the node fails calls fast
+ * - SC_CCLIENT_FAILED_RESPONSE when the call failed
+ */
+status_t iri_pool_get_transactions_to_approve(iota_client_service_t const* const service,
+                                              get_transactions_to_approve_req_t const* const req,
+                                              get_transactions_to_approve_res_t* const res);
+
+/**
+ * Call `iota_client_get_node_info()` through the breaker of the node of a connection
+ *
+ * @param[in] service Connection checked out with `iri_pool_acquire()`
+ * @param[out] res Response
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_CCLIENT_IRI_UNAVAILABLE while the breaker of the node fails calls fast
+ * - SC_CCLIENT_FAILED_RESPONSE when the call failed
+ */
+status_t iri_pool_get_node_info(iota_client_service_t const* const service, get_node_info_res_t* const res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_IRI_POOL_H_
@@ -7,13 +7,56 @@
  */
 
 #include "pow.h"
+#include <unistd.h>
 #include "common/helpers/digest.h"
 #include "third_party/dcurl/src/dcurl.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
 #include "utils/logger_helper.h"
+#include "utils/macros.h"
 #include "utils/time.h"
 
 #define POW_LOGGER "pow"
 
+/** A bundle waiting for PoW */
+typedef struct pow_job_s {
+  const bundle_transactions_t* bundle;
+  iota_transaction_t* tx;                /**< Next transaction to attach */
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243]; /**< Trunk of the next transaction */
+  const flex_trit_t* branch;
+  uint8_t mwm;
+  size_t remaining; /**< Number of transactions left in the bundle */
+  status_t ret;
+  uint64_t elapsed; /**< Duration of the last step in milliseconds */
+  bool done;
+  cond_handle_t cond; /**< Signaled once the bundle is done */
+  struct pow_job_s* next;
+} pow_job_t;
+
+/** Fixed worker pool which interleaves the transactions of pending bundles */
+static struct pow_scheduler_s {
+  lock_handle_t lock;
+  cond_handle_t cond; /**< Signaled when a bundle is queued or the scheduler stops */
+  pow_job_t* head;    /**< Run queue of pending bundles */
+  pow_job_t* tail;
+  size_t queued; /**< Bundles in the run queue */
+  thread_handle_t* workers;
+  uint8_t worker_count;
+  uint8_t busy; /**< Workers running a step */
+  int cores;    /**< Threads of the PoW backend shared by the running steps */
+  bool running;
+} scheduler;
+
+/** Admission control in front of the PoW path, protected by the scheduler lock */
+static struct pow_admission_s {
+  uint16_t queue_size; /**< Maximum number of admitted requests, zero for unlimited */
+  uint32_t sla;        /**< Maximum estimated wait in milliseconds, zero for unlimited */
+  uint16_t admitted;   /**< Requests holding an admission */
+  size_t pending_txs;  /**< Transactions of queued bundles still waiting for PoW */
+  double tx_ms;        /**< Moving average of the PoW duration of a single transaction */
+} admission;
+
 static logger_id_t logger_id;
 
 void pow_logger_init() { logger_id = logger_helper_enable(POW_LOGGER, LOGGER_DEBUG, true); }
@@ -28,23 +71,40 @@ int pow_logger_release() {
   return 0;
 }
 
-void pow_init() { dcurl_init(); }
+void pow_init() {
+  lock_handle_init(&scheduler.lock);
+  cond_handle_init(&scheduler.cond);
+  dcurl_init();
+}
 
-void pow_destroy() { dcurl_destroy(); }
+void pow_destroy() {
+  pow_scheduler_stop();
+  dcurl_destroy();
+  cond_handle_destroy(&scheduler.cond);
+  lock_handle_destroy(&scheduler.lock);
+}
 
 static int8_t* ta_pow_dcurl(int8_t* trytes, int mwm, int threads) { return dcurl_entry(trytes, mwm, threads); }
 
 flex_trit_t* ta_pow_flex(const flex_trit_t* const trits_in, const uint8_t mwm) {
+  return ta_pow_flex_threads(trits_in, mwm, 0);
+}
+
+flex_trit_t* ta_pow_flex_threads(const flex_trit_t* const trits_in, const uint8_t mwm, const int threads) {
   tryte_t trytes_in[NUM_TRYTES_SERIALIZED_TRANSACTION];
   tryte_t nonce_trytes[NUM_TRYTES_NONCE];
 
   flex_trits_to_trytes(trytes_in, NUM_TRYTES_SERIALIZED_TRANSACTION, trits_in, NUM_TRITS_SERIALIZED_TRANSACTION,
                        NUM_TRITS_SERIALIZED_TRANSACTION);
-  int8_t* ret_trytes = ta_pow_dcurl(trytes_in, mwm, 0);
+  int8_t* ret_trytes = ta_pow_dcurl(trytes_in, mwm, threads);
+  if (ret_trytes == NULL) {
+    return NULL;
+  }
   memcpy(nonce_trytes, ret_trytes + NUM_TRYTES_SERIALIZED_TRANSACTION - NUM_TRYTES_NONCE, NUM_TRYTES_NONCE);
 
   flex_trit_t* nonce_trits = (flex_trit_t*)calloc(NUM_TRITS_NONCE, sizeof(flex_trit_t));
   if (!nonce_trits) {
+    free(ret_trytes);
     return NULL;
   }
   flex_trits_from_trytes(nonce_trits, NUM_TRITS_NONCE, (const tryte_t*)nonce_trytes, NUM_TRYTES_NONCE,
@@ -54,56 +114,321 @@ flex_trit_t* ta_pow_flex(const flex_trit_t* const trits_in, const uint8_t mwm) {
   return nonce_trits;
 }
 
+/**
+ * Split the PoW of a bundle into single transaction steps, so the scheduler can interleave bundles of different
+ * requests. The transactions are processed from the tail to the head of the bundle, since the trunk of each
+ * transaction is the hash of the next one.
+ */
+static status_t pow_job_init(pow_job_t* const job, const bundle_transactions_t* bundle,
+                             const flex_trit_t* const trunk, const flex_trit_t* const branch, const uint8_t mwm) {
+  job->bundle = bundle;
+  job->branch = branch;
+  job->mwm = mwm;
+  job->ret = SC_OK;
+  job->done = false;
+  job->next = NULL;
+
+  job->tx = (iota_transaction_t*)utarray_back(bundle);
+  if (job->tx == NULL) {
+    ta_log_error("%s\n", "SC_TA_NULL");
+    return SC_TA_NULL;
+  }
+  job->remaining = transaction_last_index(job->tx) + 1;
+  memcpy(job->trunk, trunk, FLEX_TRIT_SIZE_243);
+
+  return SC_OK;
+}
+
+/**
+ * Attach the next transaction of the job
+ *
+ * @return
+ * - true if the whole bundle is done or an error occurred
+ * - false if there are transactions left
+ */
+static bool pow_job_step(pow_job_t* const job, const int threads) {
+  iota_transaction_t* tx = job->tx;
+  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
+
+  job->elapsed = current_timestamp_ms();
+
+  // set trunk, branch, and attachment timestamp
+  transaction_set_trunk(tx, job->trunk);
+  transaction_set_branch(tx, job->branch);
+  transaction_set_attachment_timestamp(tx, current_timestamp_ms());
+  transaction_set_attachment_timestamp_upper(tx, 3812798742493LL);
+  transaction_set_attachment_timestamp_lower(tx, 0);
+
+  if (transaction_serialize_on_flex_trits(tx, tx_trits) == 0) {
+    job->ret = SC_CCLIENT_INVALID_FLEX_TRITS;
+    ta_log_error("%s\n", "SC_CCLIENT_INVALID_FLEX_TRITS");
+    return true;
+  }
+
+  // get nonce
+  flex_trit_t* nonce = ta_pow_flex_threads(tx_trits, job->mwm, threads);
+  if (nonce == NULL) {
+    job->ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    return true;
+  }
+  transaction_set_nonce(tx, nonce);
+  free(nonce);
+
+  transaction_serialize_on_flex_trits(tx, tx_trits);
+  flex_trit_t* digest = iota_flex_digest(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION);
+  if (digest == NULL) {
+    job->ret = SC_TA_OOM;
+    ta_log_error("%s\n", "SC_TA_OOM");
+    return true;
+  }
+  memcpy(job->trunk, digest, FLEX_TRIT_SIZE_243);
+  free(digest);
+  job->elapsed = current_timestamp_ms() - job->elapsed;
+
+  job->remaining--;
+  job->tx = (iota_transaction_t*)utarray_prev(job->bundle, tx);
+  return job->remaining == 0 || job->tx == NULL;
+}
+
+/**
+ * Update the admission statistics after a step of the job. Must be called with the scheduler lock held.
+ *
+ * @param[in] job The job which just did a step
+ * @param[in] before Transactions left in the job before the step
+ * @param[in] finished Whether the job is finished
+ */
+static void pow_admission_account(const pow_job_t* const job, const size_t before, const bool finished) {
+  size_t done_txs = finished ? before : before - job->remaining;
+
+  admission.pending_txs -= done_txs < admission.pending_txs ? done_txs : admission.pending_txs;
+  if (job->ret == SC_OK) {
+    // Exponentially weighted moving average, so the estimate follows the recent load of the backend
+    admission.tx_ms = admission.tx_ms == 0 ? job->elapsed : admission.tx_ms + (job->elapsed - admission.tx_ms) / 8;
+  }
+}
+
+static void pow_queue_push(pow_job_t* const job) {
+  job->next = NULL;
+  scheduler.queued++;
+  if (scheduler.tail) {
+    scheduler.tail->next = job;
+  } else {
+    scheduler.head = job;
+  }
+  scheduler.tail = job;
+}
+
+static pow_job_t* pow_queue_pop() {
+  pow_job_t* job = scheduler.head;
+  if (job) {
+    scheduler.queued--;
+    scheduler.head = job->next;
+    if (scheduler.head == NULL) {
+      scheduler.tail = NULL;
+    }
+  }
+  return job;
+}
+
+/**
+ * Threads of the PoW backend for the step a worker is starting. Must be called with the scheduler lock held, after
+ * the worker counted itself busy and popped its job.
+ *
+ * The cores are split among the steps running now and the bundles idle workers are about to pick up, so a lone
+ * bundle gets every core instead of a fixed share of them.
+ */
+static int pow_scheduler_threads() {
+  size_t running = scheduler.busy + scheduler.queued;
+  if (running > scheduler.worker_count) {
+    running = scheduler.worker_count;
+  }
+  return scheduler.cores > (int)running ? scheduler.cores / (int)running : 1;
+}
+
+static void* pow_scheduler_worker(void* arg) {
+  UNUSED(arg);
+  lock_handle_lock(&scheduler.lock);
+  while (true) {
+    while (scheduler.running && scheduler.head == NULL) {
+      cond_handle_wait(&scheduler.cond, &scheduler.lock);
+    }
+    if (!scheduler.running) {
+      break;
+    }
+
+    pow_job_t* job = pow_queue_pop();
+    size_t before = job->remaining;
+    scheduler.busy++;
+    int threads = pow_scheduler_threads();
+    lock_handle_unlock(&scheduler.lock);
+    bool finished = pow_job_step(job, threads);
+    lock_handle_lock(&scheduler.lock);
+    scheduler.busy--;
+    pow_admission_account(job, before, finished);
+
+    if (finished) {
+      job->done = true;
+      cond_handle_signal(&job->cond);
+    } else {
+      // Round-robin between pending bundles: the bundle waits behind the others for its next transaction
+      pow_queue_push(job);
+    }
+  }
+  lock_handle_unlock(&scheduler.lock);
+  return NULL;
+}
+
+status_t pow_scheduler_start(const uint8_t workers) {
+  status_t ret = SC_OK;
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+  if (workers == 0) {
+    return SC_OK;
+  }
+
+  scheduler.workers = (thread_handle_t*)calloc(workers, sizeof(thread_handle_t));
+  if (scheduler.workers == NULL) {
+    ta_log_error("%s\n", "SC_TA_OOM");
+    return SC_TA_OOM;
+  }
+  scheduler.cores = cores > 0 ? (int)cores : 1;
+  scheduler.head = scheduler.tail = NULL;
+  scheduler.queued = 0;
+  scheduler.busy = 0;
+
+  lock_handle_lock(&scheduler.lock);
+  scheduler.running = true;
+  lock_handle_unlock(&scheduler.lock);
+
+  for (scheduler.worker_count = 0; scheduler.worker_count < workers; scheduler.worker_count++) {
+    if (thread_handle_create(&scheduler.workers[scheduler.worker_count], pow_scheduler_worker, NULL)) {
+      ret = SC_UTILS_THREAD_CREATE;
+      ta_log_error("%s\n", "SC_UTILS_THREAD_CREATE");
+      pow_scheduler_stop();
+      break;
+    }
+  }
+
+  if (ret == SC_OK) {
+    ta_log_info("PoW scheduler started with %d workers sharing %d threads\n", workers, scheduler.cores);
+  }
+  return ret;
+}
+
+void pow_scheduler_stop() {
+  pow_job_t* job = NULL;
+
+  lock_handle_lock(&scheduler.lock);
+  scheduler.running = false;
+  cond_handle_broadcast(&scheduler.cond);
+  lock_handle_unlock(&scheduler.lock);
+
+  for (uint8_t i = 0; i < scheduler.worker_count; i++) {
+    thread_handle_join(scheduler.workers[i], NULL);
+  }
+  free(scheduler.workers);
+  scheduler.workers = NULL;
+  scheduler.worker_count = 0;
+
+  // Fail the bundles which were still waiting for a worker
+  lock_handle_lock(&scheduler.lock);
+  while ((job = pow_queue_pop()) != NULL) {
+    pow_admission_account(job, job->remaining, true);
+    job->ret = SC_UTILS_POW_SCHEDULER_STOPPED;
+    job->done = true;
+    cond_handle_signal(&job->cond);
+  }
+  lock_handle_unlock(&scheduler.lock);
+}
+
 status_t ta_pow(const bundle_transactions_t* bundle, const flex_trit_t* const trunk, const flex_trit_t* const branch,
                 const uint8_t mwm) {
-  status_t ret = SC_OK;
-  iota_transaction_t* tx;
-  flex_trit_t* ctrunk = (flex_trit_t*)calloc(FLEX_TRIT_SIZE_243, sizeof(flex_trit_t));
-  flex_trit_t tx_trits[FLEX_TRIT_SIZE_8019];
-  size_t cur_idx = 0;
+  pow_job_t job;
+  bool scheduled = false;
 
-  tx = (iota_transaction_t*)utarray_back(bundle);
-  if (tx == NULL) {
-    ret = SC_TA_NULL;
-    ta_log_error("%s\n", "SC_TA_NULL");
-    goto done;
-  }
-  cur_idx = transaction_last_index(tx) + 1;
-  memcpy(ctrunk, trunk, FLEX_TRIT_SIZE_243);
-
-  do {
-    cur_idx--;
-    // set trunk, branch, and attachment timestamp
-    transaction_set_trunk(tx, ctrunk);
-    transaction_set_branch(tx, branch);
-    transaction_set_attachment_timestamp(tx, current_timestamp_ms());
-    transaction_set_attachment_timestamp_upper(tx, 3812798742493LL);
-    transaction_set_attachment_timestamp_lower(tx, 0);
-
-    transaction_serialize_on_flex_trits(tx, tx_trits);
-    if (tx_trits == NULL) {
-      ret = SC_CCLIENT_INVALID_FLEX_TRITS;
-      ta_log_error("%s\n", "SC_CCLIENT_INVALID_FLEX_TRITS");
-      goto done;
+  if (pow_job_init(&job, bundle, trunk, branch, mwm) != SC_OK) {
+    return SC_TA_NULL;
+  }
+
+  lock_handle_lock(&scheduler.lock);
+  admission.pending_txs += job.remaining;
+  if (scheduler.running) {
+    scheduled = true;
+    cond_handle_init(&job.cond);
+    pow_queue_push(&job);
+    cond_handle_signal(&scheduler.cond);
+    while (!job.done) {
+      cond_handle_wait(&job.cond, &scheduler.lock);
     }
+  }
+  lock_handle_unlock(&scheduler.lock);
 
-    // get nonce
-    flex_trit_t* nonce = ta_pow_flex(tx_trits, mwm);
-    if (nonce == NULL) {
-      ret = SC_TA_OOM;
-      ta_log_error("%s\n", "SC_TA_OOM");
-      goto done;
+  if (scheduled) {
+    cond_handle_destroy(&job.cond);
+  } else {
+    // Without the scheduler the calling thread does the whole bundle with all cores
+    bool finished = false;
+    while (!finished) {
+      size_t before = job.remaining;
+      finished = pow_job_step(&job, 0);
+      lock_handle_lock(&scheduler.lock);
+      pow_admission_account(&job, before, finished);
+      lock_handle_unlock(&scheduler.lock);
     }
-    transaction_set_nonce(tx, nonce);
+  }
+
+  return job.ret;
+}
+
+/**
+ * Estimate the time in milliseconds a new bundle waits before its PoW is done. Must be called with the scheduler
+ * lock held.
+ */
+static uint32_t pow_admission_estimate() {
+  uint8_t parallelism = scheduler.running && scheduler.worker_count ? scheduler.worker_count : 1;
+  return (uint32_t)((admission.pending_txs / parallelism + 1) * admission.tx_ms);
+}
 
-    free(ctrunk);
-    transaction_serialize_on_flex_trits(tx, tx_trits);
-    ctrunk = iota_flex_digest(tx_trits, NUM_TRITS_SERIALIZED_TRANSACTION);
-    tx = (iota_transaction_t*)utarray_prev(bundle, tx);
-    free(nonce);
-  } while (cur_idx != 0 && tx != NULL);
+void pow_admission_init(const uint16_t queue_size, const uint32_t sla) {
+  lock_handle_lock(&scheduler.lock);
+  admission.queue_size = queue_size;
+  admission.sla = sla;
+  lock_handle_unlock(&scheduler.lock);
+}
+
+status_t pow_admission_acquire() {
+  status_t ret = SC_OK;
 
-done:
-  free(ctrunk);
+  lock_handle_lock(&scheduler.lock);
+  if (admission.queue_size && admission.admitted >= admission.queue_size) {
+    ret = SC_UTILS_POW_OVERLOADED;
+  } else if (admission.sla && pow_admission_estimate() > admission.sla) {
+    ret = SC_UTILS_POW_OVERLOADED;
+  } else {
+    admission.admitted++;
+  }
+  lock_handle_unlock(&scheduler.lock);
+
+  if (ret != SC_OK) {
+    ta_log_error("%s\n", "SC_UTILS_POW_OVERLOADED");
+  }
   return ret;
 }
+
+void pow_admission_release() {
+  lock_handle_lock(&scheduler.lock);
+  if (admission.admitted) {
+    admission.admitted--;
+  }
+  lock_handle_unlock(&scheduler.lock);
+}
+
+uint32_t pow_admission_retry_after() {
+  lock_handle_lock(&scheduler.lock);
+  uint32_t wait = pow_admission_estimate();
+  lock_handle_unlock(&scheduler.lock);
+
+  // Round up to whole seconds, clients should never be told to retry immediately
+  return wait / 1000 + 1;
+}
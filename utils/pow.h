@@ -49,6 +49,59 @@ void pow_init();
  */
 void pow_destroy();
 
+/**
+ * Start the PoW scheduler
+ *
+ * Transactions of bundles from concurrent requests are interleaved round-robin across a fixed pool of workers, so
+ * bundles share the cores fairly instead of each one grabbing all of them. Every transaction runs the PoW backend
+ * with the cores split among the bundles being attached at that moment, so a lone bundle still uses all of them.
+ * Without the scheduler, `ta_pow()` runs in the calling thread.
+ *
+ * @param[in] workers Number of PoW workers, zero keeps the scheduler off
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t pow_scheduler_start(const uint8_t workers);
+
+/**
+ * Stop the PoW scheduler. Bundles still waiting for a worker fail with SC_UTILS_POW_SCHEDULER_STOPPED.
+ */
+void pow_scheduler_stop();
+
+/**
+ * Configure admission control of the PoW path
+ *
+ * The estimated wait of a new request is derived from the transactions still waiting for PoW and a moving average of
+ * recent PoW durations.
+ *
+ * @param[in] queue_size Maximum number of requests admitted at the same time, zero for unlimited
+ * @param[in] sla Maximum estimated wait in milliseconds, zero for unlimited
+ */
+void pow_admission_init(const uint16_t queue_size, const uint32_t sla);
+
+/**
+ * Admit a request which is going to do PoW. Every successful call must be paired with `pow_admission_release()`.
+ *
+ * @return
+ * - SC_OK on success
+ * - SC_UTILS_POW_OVERLOADED if the queue is full or the estimated wait exceeds the SLA
+ */
+status_t pow_admission_acquire();
+
+/**
+ * Release the admission of a request once its PoW is done
+ */
+void pow_admission_release();
+
+/**
+ * Suggest when a rejected client should retry
+ *
+ * @return Estimated wait in seconds, at least 1
+ */
+uint32_t pow_admission_retry_after();
+
 /**
  * Perform PoW and return the result of flex trits
  *
@@ -59,9 +112,23 @@ void pow_destroy();
  */
 flex_trit_t* ta_pow_flex(const flex_trit_t* const trits_in, const uint8_t mwm);
 
+/**
+ * Perform PoW with a limited number of threads and return the result of flex trits
+ *
+ * @param[in] trits_in Flex trits that does pow
+ * @param[in] mwm Maximum weight magnitude
+ * @param[in] threads Number of threads used by the PoW backend, 0 for all available cores
+ *
+ * @return a flex_trit_t data
+ */
+flex_trit_t* ta_pow_flex_threads(const flex_trit_t* const trits_in, const uint8_t mwm, const int threads);
+
 /**
  * Perform PoW to the given bundle
  *
+ * The call blocks until the whole bundle is attached. When the scheduler is running, the bundle is queued to the
+ * worker pool.
+ *
  * @param[in] bundle Bundle that does pow
  * @param[in] trunk Trunk transaction hash
  * @param[in] branch Branch transaction hash
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "task_pool.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+#include "utils/logger_helper.h"
+#include "utils/macros.h"
+
+#define TASK_POOL_LOGGER "task_pool"
+
+/** Tasks of one `task_pool_run()` call */
+typedef struct task_pool_group_s {
+  task_pool_task_t const* tasks;
+  size_t num;
+  size_t next;        /**< Index of the first task not taken yet */
+  size_t remaining;   /**< Number of tasks not finished yet */
+  cond_handle_t cond; /**< Signaled once the last task is finished */
+  struct task_pool_group_s* next_group;
+} task_pool_group_t;
+
+static struct task_pool_s {
+  lock_handle_t lock;
+  cond_handle_t cond;      /**< Signaled when a group is queued or the pool stops */
+  task_pool_group_t* head; /**< Groups with tasks not taken yet, oldest first */
+  task_pool_group_t* tail;
+  thread_handle_t* workers;
+  uint8_t worker_count;
+  bool running;
+} pool;
+
+static logger_id_t logger_id;
+
+void task_pool_logger_init() { logger_id = logger_helper_enable(TASK_POOL_LOGGER, LOGGER_DEBUG, true); }
+
+int task_pool_logger_release() {
+  logger_helper_release(logger_id);
+  if (logger_helper_destroy() != RC_OK) {
+    ta_log_critical("Destroying logger failed %s.\n", TASK_POOL_LOGGER);
+    return EXIT_FAILURE;
+  }
+
+  return 0;
+}
+
+void task_pool_init() {
+  lock_handle_init(&pool.lock);
+  cond_handle_init(&pool.cond);
+}
+
+void task_pool_destroy() {
+  task_pool_stop();
+  cond_handle_destroy(&pool.cond);
+  lock_handle_destroy(&pool.lock);
+}
+
+static void task_pool_group_remove(task_pool_group_t* const group) {
+  task_pool_group_t* prev = NULL;
+  for (task_pool_group_t* iter = pool.head; iter; prev = iter, iter = iter->next_group) {
+    if (iter == group) {
+      if (prev) {
+        prev->next_group = group->next_group;
+      } else {
+        pool.head = group->next_group;
+      }
+      if (pool.tail == group) {
+        pool.tail = prev;
+      }
+      return;
+    }
+  }
+}
+
+/**
+ * Take the next task of a group, with the lock held. The group leaves the queue with its last task.
+ */
+static task_pool_task_t const* task_pool_group_take(task_pool_group_t* const group) {
+  if (group->next == group->num) {
+    return NULL;
+  }
+  task_pool_task_t const* task = &group->tasks[group->next++];
+  if (group->next == group->num) {
+    task_pool_group_remove(group);
+  }
+  return task;
+}
+
+/**
+ * Mark a task of a group finished, with the lock held
+ */
+static void task_pool_group_finish(task_pool_group_t* const group) {
+  if (--group->remaining == 0) {
+    cond_handle_signal(&group->cond);
+  }
+}
+
+static void* task_pool_worker(void* arg) {
+  UNUSED(arg);
+  lock_handle_lock(&pool.lock);
+  while (true) {
+    while (pool.running && pool.head == NULL) {
+      cond_handle_wait(&pool.cond, &pool.lock);
+    }
+    if (!pool.running) {
+      break;
+    }
+
+    task_pool_group_t* group = pool.head;
+    task_pool_task_t const* task = task_pool_group_take(group);
+    lock_handle_unlock(&pool.lock);
+    task->func(task->arg);
+    lock_handle_lock(&pool.lock);
+    task_pool_group_finish(group);
+  }
+  lock_handle_unlock(&pool.lock);
+  return NULL;
+}
+
+status_t task_pool_start(const uint8_t workers) {
+  status_t ret = SC_OK;
+
+  if (workers == 0) {
+    return SC_OK;
+  }
+
+  pool.workers = (thread_handle_t*)calloc(workers, sizeof(thread_handle_t));
+  if (pool.workers == NULL) {
+    ta_log_error("%s\n", "SC_UTILS_OOM");
+    return SC_UTILS_OOM;
+  }
+  pool.head = pool.tail = NULL;
+
+  lock_handle_lock(&pool.lock);
+  pool.running = true;
+  lock_handle_unlock(&pool.lock);
+
+  for (pool.worker_count = 0; pool.worker_count < workers; pool.worker_count++) {
+    if (thread_handle_create(&pool.workers[pool.worker_count], task_pool_worker, NULL)) {
+      ret = SC_UTILS_THREAD_CREATE;
+      ta_log_error("%s\n", "SC_UTILS_THREAD_CREATE");
+      task_pool_stop();
+      break;
+    }
+  }
+
+  if (ret == SC_OK) {
+    ta_log_info("Task pool started with %d workers\n", workers);
+  }
+  return ret;
+}
+
+void task_pool_stop() {
+  lock_handle_lock(&pool.lock);
+  pool.running = false;
+  cond_handle_broadcast(&pool.cond);
+  lock_handle_unlock(&pool.lock);
+
+  for (uint8_t i = 0; i < pool.worker_count; i++) {
+    thread_handle_join(pool.workers[i], NULL);
+  }
+  free(pool.workers);
+  pool.workers = NULL;
+  pool.worker_count = 0;
+}
+
+void task_pool_run(task_pool_task_t const* const tasks, const size_t num) {
+  task_pool_group_t group = {.tasks = tasks, .num = num, .next = 0, .remaining = num, .next_group = NULL};
+  task_pool_task_t const* task = NULL;
+
+  lock_handle_lock(&pool.lock);
+  if (!pool.running || num < 2) {
+    lock_handle_unlock(&pool.lock);
+    for (size_t i = 0; i < num; i++) {
+      tasks[i].func(tasks[i].arg);
+    }
+    return;
+  }
+
+  cond_handle_init(&group.cond);
+  if (pool.tail) {
+    pool.tail->next_group = &group;
+  } else {
+    pool.head = &group;
+  }
+  pool.tail = &group;
+  cond_handle_broadcast(&pool.cond);
+
+  // The calling thread takes tasks of its own group too, then waits for the ones taken by the workers
+  while ((task = task_pool_group_take(&group)) != NULL) {
+    lock_handle_unlock(&pool.lock);
+    task->func(task->arg);
+    lock_handle_lock(&pool.lock);
+    task_pool_group_finish(&group);
+  }
+  while (group.remaining > 0) {
+    cond_handle_wait(&group.cond, &pool.lock);
+  }
+  lock_handle_unlock(&pool.lock);
+  cond_handle_destroy(&group.cond);
+}
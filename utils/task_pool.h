@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_TASK_POOL_H_
+#define UTILS_TASK_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "accelerator/errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file task_pool.h
+ * @brief Fixed worker pool running the independent parts of a request concurrently
+ *
+ * A request hands an array of tasks to `task_pool_run()`, which returns once all of them are done. The calling thread
+ * runs tasks of its own array as well instead of only waiting, so a request always makes progress even when every
+ * worker is busy with other requests, and tasks are run in the calling thread alone when the pool is not started.
+ *
+ * @example test_task_pool.c
+ */
+
+/** A task, run once by a worker or the calling thread */
+typedef struct task_pool_task_s {
+  void (*func)(void* arg); /**< Function of the task */
+  void* arg;               /**< Argument of `func` */
+} task_pool_task_t;
+
+/**
+ * Initialize logger
+ */
+void task_pool_logger_init();
+
+/**
+ * Release logger
+ *
+ * @return
+ * - zero on success
+ * - EXIT_FAILURE on error
+ */
+int task_pool_logger_release();
+
+/**
+ * Initialize the task pool, without any worker
+ */
+void task_pool_init();
+
+/**
+ * Stop the workers and destroy the task pool
+ */
+void task_pool_destroy();
+
+/**
+ * Start the workers of the task pool
+ *
+ * @param[in] workers Number of workers, zero runs the tasks in the calling thread
+ *
+ * @return
+ * - SC_OK on success
+ * - non-zero on error
+ */
+status_t task_pool_start(const uint8_t workers);
+
+/**
+ * Stop the workers of the task pool. Tasks not taken by a worker yet are run by their calling thread.
+ */
+void task_pool_stop();
+
+/**
+ * Run tasks concurrently and wait for all of them
+ *
+ * @param[in] tasks Tasks to run, in no particular order
+ * @param[in] num Number of tasks
+ */
+void task_pool_run(task_pool_task_t const* const tasks, const size_t num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_TASK_POOL_H_
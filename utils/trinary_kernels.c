@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#include "trinary_kernels.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TRINARY_KERNELS_HAVE_X86
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define TRINARY_KERNELS_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+/*
+ * A tryte value v in [-13, 13] maps to the character
+ * - '9' when v == 0
+ * - 'A' + v - 1 == '@' + v when v > 0
+ * - 'Z' + v + 1 == '[' + v when v < 0
+ * so both directions are one addition or subtraction of a per-byte offset.
+ */
+#define TRYTE_OFFSET_ZERO '9'
+#define TRYTE_OFFSET_POSITIVE '@'
+#define TRYTE_OFFSET_NEGATIVE '['
+/** The last character of a positive tryte */
+#define TRYTE_MAX_POSITIVE 'M'
+
+typedef struct trinary_kernels_s {
+  void (*to_trytes)(tryte_t* const trytes, flex_trit_t const* const trits, const size_t num);
+  void (*from_trytes)(flex_trit_t* const trits, tryte_t const* const trytes, const size_t num);
+  bool (*validate)(tryte_t const* const trytes, const size_t num);
+} trinary_kernels_t;
+
+static inline tryte_t scalar_to_tryte(const flex_trit_t v) {
+  return v + (v > 0 ? TRYTE_OFFSET_POSITIVE : v < 0 ? TRYTE_OFFSET_NEGATIVE : TRYTE_OFFSET_ZERO);
+}
+
+static inline flex_trit_t scalar_from_tryte(const tryte_t c) {
+  return c - (c == TRYTE_OFFSET_ZERO ? TRYTE_OFFSET_ZERO
+                                     : c > TRYTE_MAX_POSITIVE ? TRYTE_OFFSET_NEGATIVE : TRYTE_OFFSET_POSITIVE);
+}
+
+static inline bool scalar_is_tryte(const tryte_t c) { return c == '9' || (c >= 'A' && c <= 'Z'); }
+
+static void scalar_to_trytes(tryte_t* const trytes, flex_trit_t const* const trits, const size_t num) {
+  for (size_t i = 0; i < num; i++) {
+    trytes[i] = scalar_to_tryte(trits[i]);
+  }
+}
+
+static void scalar_from_trytes(flex_trit_t* const trits, tryte_t const* const trytes, const size_t num) {
+  for (size_t i = 0; i < num; i++) {
+    trits[i] = scalar_from_tryte(trytes[i]);
+  }
+}
+
+static bool scalar_validate(tryte_t const* const trytes, const size_t num) {
+  for (size_t i = 0; i < num; i++) {
+    if (!scalar_is_tryte(trytes[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#ifdef TRINARY_KERNELS_HAVE_X86
+__attribute__((target("sse4.1"))) static void sse4_to_trytes(tryte_t* const trytes, flex_trit_t const* const trits,
+                                                             const size_t num) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i offset_zero = _mm_set1_epi8(TRYTE_OFFSET_ZERO);
+  const __m128i offset_positive = _mm_set1_epi8(TRYTE_OFFSET_POSITIVE);
+  const __m128i offset_negative = _mm_set1_epi8(TRYTE_OFFSET_NEGATIVE);
+  size_t i = 0;
+
+  for (; i + 16 <= num; i += 16) {
+    __m128i v = _mm_loadu_si128((__m128i const*)(trits + i));
+    __m128i offset = _mm_blendv_epi8(offset_zero, offset_positive, _mm_cmpgt_epi8(v, zero));
+    offset = _mm_blendv_epi8(offset, offset_negative, _mm_cmplt_epi8(v, zero));
+    _mm_storeu_si128((__m128i*)(trytes + i), _mm_add_epi8(v, offset));
+  }
+  scalar_to_trytes(trytes + i, trits + i, num - i);
+}
+
+__attribute__((target("sse4.1"))) static void sse4_from_trytes(flex_trit_t* const trits, tryte_t const* const trytes,
+                                                               const size_t num) {
+  const __m128i offset_zero = _mm_set1_epi8(TRYTE_OFFSET_ZERO);
+  const __m128i offset_positive = _mm_set1_epi8(TRYTE_OFFSET_POSITIVE);
+  const __m128i offset_negative = _mm_set1_epi8(TRYTE_OFFSET_NEGATIVE);
+  const __m128i max_positive = _mm_set1_epi8(TRYTE_MAX_POSITIVE);
+  size_t i = 0;
+
+  for (; i + 16 <= num; i += 16) {
+    __m128i c = _mm_loadu_si128((__m128i const*)(trytes + i));
+    __m128i offset = _mm_blendv_epi8(offset_positive, offset_negative, _mm_cmpgt_epi8(c, max_positive));
+    offset = _mm_blendv_epi8(offset, offset_zero, _mm_cmpeq_epi8(c, offset_zero));
+    _mm_storeu_si128((__m128i*)(trits + i), _mm_sub_epi8(c, offset));
+  }
+  scalar_from_trytes(trits + i, trytes + i, num - i);
+}
+
+__attribute__((target("sse4.1"))) static bool sse4_validate(tryte_t const* const trytes, const size_t num) {
+  const __m128i nine = _mm_set1_epi8('9');
+  const __m128i before_a = _mm_set1_epi8('A' - 1);
+  const __m128i after_z = _mm_set1_epi8('Z' + 1);
+  size_t i = 0;
+
+  // Bytes above 0x7F are negative in the signed compares, so they fail the range check
+  for (; i + 16 <= num; i += 16) {
+    __m128i c = _mm_loadu_si128((__m128i const*)(trytes + i));
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(c, before_a), _mm_cmplt_epi8(c, after_z));
+    if (_mm_movemask_epi8(_mm_or_si128(letter, _mm_cmpeq_epi8(c, nine))) != 0xFFFF) {
+      return false;
+    }
+  }
+  return scalar_validate(trytes + i, num - i);
+}
+
+__attribute__((target("avx2"))) static void avx2_to_trytes(tryte_t* const trytes, flex_trit_t const* const trits,
+                                                           const size_t num) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i offset_zero = _mm256_set1_epi8(TRYTE_OFFSET_ZERO);
+  const __m256i offset_positive = _mm256_set1_epi8(TRYTE_OFFSET_POSITIVE);
+  const __m256i offset_negative = _mm256_set1_epi8(TRYTE_OFFSET_NEGATIVE);
+  size_t i = 0;
+
+  for (; i + 32 <= num; i += 32) {
+    __m256i v = _mm256_loadu_si256((__m256i const*)(trits + i));
+    __m256i offset = _mm256_blendv_epi8(offset_zero, offset_positive, _mm256_cmpgt_epi8(v, zero));
+    offset = _mm256_blendv_epi8(offset, offset_negative, _mm256_cmpgt_epi8(zero, v));
+    _mm256_storeu_si256((__m256i*)(trytes + i), _mm256_add_epi8(v, offset));
+  }
+  sse4_to_trytes(trytes + i, trits + i, num - i);
+}
+
+__attribute__((target("avx2"))) static void avx2_from_trytes(flex_trit_t* const trits, tryte_t const* const trytes,
+                                                             const size_t num) {
+  const __m256i offset_zero = _mm256_set1_epi8(TRYTE_OFFSET_ZERO);
+  const __m256i offset_positive = _mm256_set1_epi8(TRYTE_OFFSET_POSITIVE);
+  const __m256i offset_negative = _mm256_set1_epi8(TRYTE_OFFSET_NEGATIVE);
+  const __m256i max_positive = _mm256_set1_epi8(TRYTE_MAX_POSITIVE);
+  size_t i = 0;
+
+  for (; i + 32 <= num; i += 32) {
+    __m256i c = _mm256_loadu_si256((__m256i const*)(trytes + i));
+    __m256i offset = _mm256_blendv_epi8(offset_positive, offset_negative, _mm256_cmpgt_epi8(c, max_positive));
+    offset = _mm256_blendv_epi8(offset, offset_zero, _mm256_cmpeq_epi8(c, offset_zero));
+    _mm256_storeu_si256((__m256i*)(trits + i), _mm256_sub_epi8(c, offset));
+  }
+  sse4_from_trytes(trits + i, trytes + i, num - i);
+}
+
+__attribute__((target("avx2"))) static bool avx2_validate(tryte_t const* const trytes, const size_t num) {
+  const __m256i nine = _mm256_set1_epi8('9');
+  const __m256i before_a = _mm256_set1_epi8('A' - 1);
+  const __m256i after_z = _mm256_set1_epi8('Z' + 1);
+  size_t i = 0;
+
+  for (; i + 32 <= num; i += 32) {
+    __m256i c = _mm256_loadu_si256((__m256i const*)(trytes + i));
+    __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(c, before_a), _mm256_cmpgt_epi8(after_z, c));
+    if (_mm256_movemask_epi8(_mm256_or_si256(letter, _mm256_cmpeq_epi8(c, nine))) != -1) {
+      return false;
+    }
+  }
+  return sse4_validate(trytes + i, num - i);
+}
+#endif  // TRINARY_KERNELS_HAVE_X86
+
+#ifdef TRINARY_KERNELS_HAVE_NEON
+static void neon_to_trytes(tryte_t* const trytes, flex_trit_t const* const trits, const size_t num) {
+  const int8x16_t zero = vdupq_n_s8(0);
+  const int8x16_t offset_zero = vdupq_n_s8(TRYTE_OFFSET_ZERO);
+  const int8x16_t offset_positive = vdupq_n_s8(TRYTE_OFFSET_POSITIVE);
+  const int8x16_t offset_negative = vdupq_n_s8(TRYTE_OFFSET_NEGATIVE);
+  size_t i = 0;
+
+  for (; i + 16 <= num; i += 16) {
+    int8x16_t v = vld1q_s8(trits + i);
+    int8x16_t offset = vbslq_s8(vcgtq_s8(v, zero), offset_positive, offset_zero);
+    offset = vbslq_s8(vcltq_s8(v, zero), offset_negative, offset);
+    vst1q_s8(trytes + i, vaddq_s8(v, offset));
+  }
+  scalar_to_trytes(trytes + i, trits + i, num - i);
+}
+
+static void neon_from_trytes(flex_trit_t* const trits, tryte_t const* const trytes, const size_t num) {
+  const int8x16_t offset_zero = vdupq_n_s8(TRYTE_OFFSET_ZERO);
+  const int8x16_t offset_positive = vdupq_n_s8(TRYTE_OFFSET_POSITIVE);
+  const int8x16_t offset_negative = vdupq_n_s8(TRYTE_OFFSET_NEGATIVE);
+  const int8x16_t max_positive = vdupq_n_s8(TRYTE_MAX_POSITIVE);
+  size_t i = 0;
+
+  for (; i + 16 <= num; i += 16) {
+    int8x16_t c = vld1q_s8(trytes + i);
+    int8x16_t offset = vbslq_s8(vcgtq_s8(c, max_positive), offset_negative, offset_positive);
+    offset = vbslq_s8(vceqq_s8(c, offset_zero), offset_zero, offset);
+    vst1q_s8(trits + i, vsubq_s8(c, offset));
+  }
+  scalar_from_trytes(trits + i, trytes + i, num - i);
+}
+
+static bool neon_validate(tryte_t const* const trytes, const size_t num) {
+  const int8x16_t nine = vdupq_n_s8('9');
+  const int8x16_t first = vdupq_n_s8('A');
+  const int8x16_t last = vdupq_n_s8('Z');
+  size_t i = 0;
+
+  for (; i + 16 <= num; i += 16) {
+    int8x16_t c = vld1q_s8(trytes + i);
+    uint8x16_t letter = vandq_u8(vcgeq_s8(c, first), vcleq_s8(c, last));
+    if (vminvq_u8(vorrq_u8(letter, vceqq_s8(c, nine))) == 0) {
+      return false;
+    }
+  }
+  return scalar_validate(trytes + i, num - i);
+}
+#endif  // TRINARY_KERNELS_HAVE_NEON
+
+static trinary_kernels_t const kernels[TRINARY_KERNELS_ISA_NUM] = {
+    [TRINARY_KERNELS_SCALAR] = {scalar_to_trytes, scalar_from_trytes, scalar_validate},
+#ifdef TRINARY_KERNELS_HAVE_X86
+    [TRINARY_KERNELS_SSE4] = {sse4_to_trytes, sse4_from_trytes, sse4_validate},
+    [TRINARY_KERNELS_AVX2] = {avx2_to_trytes, avx2_from_trytes, avx2_validate},
+#endif
+#ifdef TRINARY_KERNELS_HAVE_NEON
+    [TRINARY_KERNELS_NEON] = {neon_to_trytes, neon_from_trytes, neon_validate},
+#endif
+};
+
+/** Kernels in use, resolved at the first call. Every thread resolves the same ISA, so a relaxed store is enough. */
+static trinary_kernels_t const* active = NULL;
+
+static bool isa_supported(const trinary_kernels_isa_t isa) {
+  if (isa >= TRINARY_KERNELS_ISA_NUM || kernels[isa].to_trytes == NULL) {
+    return false;
+  }
+#ifdef TRINARY_KERNELS_HAVE_X86
+  __builtin_cpu_init();
+  if (isa == TRINARY_KERNELS_SSE4) {
+    return __builtin_cpu_supports("sse4.1");
+  }
+  if (isa == TRINARY_KERNELS_AVX2) {
+    return __builtin_cpu_supports("avx2");
+  }
+#endif
+  return true;
+}
+
+static trinary_kernels_t const* kernels_get() {
+  trinary_kernels_t const* k = __atomic_load_n(&active, __ATOMIC_RELAXED);
+  if (k == NULL) {
+    trinary_kernels_isa_t isa = TRINARY_KERNELS_SCALAR;
+    if (isa_supported(TRINARY_KERNELS_NEON)) {
+      isa = TRINARY_KERNELS_NEON;
+    } else if (isa_supported(TRINARY_KERNELS_AVX2)) {
+      isa = TRINARY_KERNELS_AVX2;
+    } else if (isa_supported(TRINARY_KERNELS_SSE4)) {
+      isa = TRINARY_KERNELS_SSE4;
+    }
+    k = &kernels[isa];
+    __atomic_store_n(&active, k, __ATOMIC_RELAXED);
+  }
+  return k;
+}
+
+trinary_kernels_isa_t trinary_kernels_isa() { return kernels_get() - kernels; }
+
+bool trinary_kernels_select(const trinary_kernels_isa_t isa) {
+  if (!isa_supported(isa)) {
+    return false;
+  }
+  __atomic_store_n(&active, &kernels[isa], __ATOMIC_RELAXED);
+  return true;
+}
+
+size_t ta_flex_trits_to_trytes(tryte_t* const trytes, const size_t to_len, flex_trit_t const* const flex_trits,
+                               const size_t len, const size_t num_trits) {
+#if defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+  size_t num_trytes = num_trits / 3;
+  if (num_trits % 3 == 0) {
+    if (num_trits > len || num_trytes > to_len) {
+      return 0;
+    }
+    kernels_get()->to_trytes(trytes, flex_trits, num_trytes);
+    return num_trytes;
+  }
+#endif
+  return flex_trits_to_trytes(trytes, to_len, flex_trits, len, num_trits);
+}
+
+size_t ta_flex_trits_from_trytes(flex_trit_t* const flex_trits, const size_t to_len, tryte_t const* const trytes,
+                                 const size_t len, const size_t num_trytes) {
+#if defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+  if (num_trytes > len || num_trytes * 3 > to_len) {
+    return 0;
+  }
+  kernels_get()->from_trytes(flex_trits, trytes, num_trytes);
+  return num_trytes;
+#else
+  return flex_trits_from_trytes(flex_trits, to_len, trytes, len, num_trytes);
+#endif
+}
+
+/*
+ * Packing tables indexed by u = v + 13 of a tryte value v. The base-3 digits of u are the trits of the tryte plus one,
+ * and likewise a byte is the base-3 number of its 5 trits plus one, minus 121. A group of 5 trytes fills 3 bytes, the
+ * second and fourth trytes straddling two bytes, so each byte is the sum of a few table entries and digit multiples.
+ */
+/** Low 2 trits of a tryte as trits 3 and 4 of a byte, minus 121 */
+static const int8_t pack_low2[27] = {
+    -121, -94, -67, -40, -13, 14, 41, 68, 95, -121, -94, -67, -40, -13, 14, 41, 68, 95, -121, -94, -67, -40, -13, 14,
+    41, 68, 95};
+/** High trit of a tryte as trit 0 of a byte, minus 121 */
+static const int8_t pack_high1[27] = {
+    -121, -121, -121, -121, -121, -121, -121, -121, -121, -120, -120, -120, -120, -120, -120, -120, -120, -120, -119,
+    -119, -119, -119, -119, -119, -119, -119, -119};
+/** Low trit of a tryte as trit 4 of a byte */
+static const uint8_t pack_low1[27] = {
+    0, 81, 162, 0, 81, 162, 0, 81, 162, 0, 81, 162, 0, 81, 162, 0, 81, 162, 0, 81, 162, 0, 81, 162, 0, 81, 162};
+/** High 2 trits of a tryte as trits 0 and 1 of a byte, minus 121 */
+static const int8_t pack_high2[27] = {
+    -121, -121, -121, -120, -120, -120, -119, -119, -119, -118, -118, -118, -117, -117, -117, -116, -116, -116, -115,
+    -115, -115, -114, -114, -114, -113, -113, -113};
+
+/** Pack 5 trytes, i.e. 15 trits, into 3 bytes */
+static inline void pack_trytes(uint8_t* const bytes, flex_trit_t const* const trytes) {
+  unsigned a = trytes[0] + 13, b = trytes[1] + 13, c = trytes[2] + 13, d = trytes[3] + 13, e = trytes[4] + 13;
+  bytes[0] = (uint8_t)(a + pack_low2[b]);
+  bytes[1] = (uint8_t)(pack_high1[b] + 3 * c + pack_low1[d]);
+  bytes[2] = (uint8_t)(pack_high2[d] + 9 * e);
+}
+
+size_t ta_flex_trits_to_bytes(uint8_t* const bytes, const size_t to_len, flex_trit_t const* const flex_trits,
+                              const size_t len, const size_t num_trits) {
+  size_t num_bytes = TA_PACKED_TRITS_LEN(num_trits);
+  if (num_trits > len || num_bytes > to_len) {
+    return 0;
+  }
+
+#if defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+  if (num_trits % 3 == 0) {
+    size_t num_trytes = num_trits / 3, i = 0, j = 0;
+    for (; i + 5 <= num_trytes; i += 5, j += 3) {
+      pack_trytes(bytes + j, flex_trits + i);
+    }
+    if (i < num_trytes) {
+      // Pad the last group with zero trits
+      flex_trit_t tail_trytes[5] = {0};
+      uint8_t tail_bytes[3];
+      memcpy(tail_trytes, flex_trits + i, num_trytes - i);
+      pack_trytes(tail_bytes, tail_trytes);
+      memcpy(bytes + j, tail_bytes, num_bytes - j);
+    }
+    return num_bytes;
+  }
+#endif
+
+  for (size_t i = 0; i < num_bytes; i++) {
+    int value = 0;
+    for (size_t j = i * 5 + 5; j-- > i * 5;) {
+      value = value * 3 + (j < num_trits ? flex_trits_at(flex_trits, len, j) : 0);
+    }
+    bytes[i] = (uint8_t)(int8_t)value;
+  }
+  return num_bytes;
+}
+
+bool ta_trytes_validate(tryte_t const* const trytes, const size_t len) { return kernels_get()->validate(trytes, len); }
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2019 BiiLabs Co., Ltd. and Contributors
+ * All Rights Reserved.
+ * This is free software; you can redistribute it and/or modify it under the
+ * terms of the MIT license. A copy of the license can be found in the file
+ * "LICENSE" at the root of this distribution.
+ */
+
+#ifndef UTILS_TRINARY_KERNELS_H_
+#define UTILS_TRINARY_KERNELS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file trinary_kernels.h
+ * @brief Vectorized conversion between tryte strings and flex trits
+ *
+ * Drop-in replacements of `flex_trits_to_trytes()` and `flex_trits_from_trytes()` for the response and request
+ * paths, which convert several hashes and a 2187 trytes message per transaction. With the 3 trits per byte encoding
+ * every flex trit holds the value of one tryte, so a whole vector of trytes is converted with a few compares and
+ * blends. The widest instruction set supported by the CPU is picked at the first call. Other encodings and lengths
+ * which are not a multiple of a tryte fall back to entangled.
+ *
+ * @example test_trinary_kernels.c
+ */
+
+/** Instruction sets of the kernels */
+typedef enum {
+  TRINARY_KERNELS_SCALAR, /**< Portable C */
+  TRINARY_KERNELS_SSE4,   /**< SSE4.1, 16 trytes per step */
+  TRINARY_KERNELS_AVX2,   /**< AVX2, 32 trytes per step */
+  TRINARY_KERNELS_NEON,   /**< NEON, 16 trytes per step */
+  TRINARY_KERNELS_ISA_NUM
+} trinary_kernels_isa_t;
+
+/**
+ * @brief Convert flex trits to trytes, same as `flex_trits_to_trytes()`
+ *
+ * @param[out] trytes Output trytes
+ * @param[in] to_len Size of `trytes`
+ * @param[in] flex_trits Input flex trits
+ * @param[in] len Number of trits in `flex_trits`
+ * @param[in] num_trits Number of trits to convert
+ *
+ * @return Number of trytes converted, or zero when a buffer is too short
+ */
+size_t ta_flex_trits_to_trytes(tryte_t* const trytes, const size_t to_len, flex_trit_t const* const flex_trits,
+                               const size_t len, const size_t num_trits);
+
+/**
+ * @brief Convert trytes to flex trits, same as `flex_trits_from_trytes()`
+ *
+ * The trytes are not checked, use `ta_trytes_validate()` on untrusted input first.
+ *
+ * @param[out] flex_trits Output flex trits
+ * @param[in] to_len Number of trits `flex_trits` can hold
+ * @param[in] trytes Input trytes
+ * @param[in] len Size of `trytes`
+ * @param[in] num_trytes Number of trytes to convert
+ *
+ * @return Number of trytes converted, or zero when a buffer is too short
+ */
+size_t ta_flex_trits_from_trytes(flex_trit_t* const flex_trits, const size_t to_len, tryte_t const* const trytes,
+                                 const size_t len, const size_t num_trytes);
+
+/**
+ * @brief Pack flex trits into bytes of 5 trits each
+ *
+ * Every byte holds the balanced base-243 value of 5 trits as a signed integer in [-121, 121], the first trit being
+ * the least significant, which is also the layout of `trits_to_bytes()` of entangled. The last byte is padded with
+ * zero trits. Binary responses carry hashes and messages in this form, 1.6 bits per trit instead of 2.67 for trytes.
+ *
+ * @param[out] bytes Output bytes
+ * @param[in] to_len Size of `bytes`
+ * @param[in] flex_trits Input flex trits
+ * @param[in] len Number of trits in `flex_trits`
+ * @param[in] num_trits Number of trits to pack
+ *
+ * @return Number of bytes written, or zero when a buffer is too short
+ */
+size_t ta_flex_trits_to_bytes(uint8_t* const bytes, const size_t to_len, flex_trit_t const* const flex_trits,
+                              const size_t len, const size_t num_trits);
+
+/** Number of bytes `ta_flex_trits_to_bytes()` packs `num_trits` trits into */
+#define TA_PACKED_TRITS_LEN(num_trits) (((num_trits) + 4) / 5)
+
+/**
+ * @brief Check whether a string only contains trytes, i.e. '9' and 'A' to 'Z'
+ *
+ * @param[in] trytes Input string
+ * @param[in] len Length of the string
+ *
+ * @return true if every character is a tryte
+ */
+bool ta_trytes_validate(tryte_t const* const trytes, const size_t len);
+
+/**
+ * @brief Instruction set of the kernels in use
+ *
+ * @return The instruction set
+ */
+trinary_kernels_isa_t trinary_kernels_isa();
+
+/**
+ * @brief Force the kernels of an instruction set, mainly for testing and benchmarking
+ *
+ * @param[in] isa The instruction set
+ *
+ * @return false if the instruction set is not supported by the build or the CPU
+ */
+bool trinary_kernels_select(const trinary_kernels_isa_t isa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UTILS_TRINARY_KERNELS_H_